@@ -0,0 +1,7 @@
+#ifndef PCL_CONFIG_H
+#define PCL_CONFIG_H
+
+#define HAVE_STATX
+#define HAVE_UTIMENSAT
+
+#endif
@@ -50,9 +50,39 @@ extern "C" {
  * @param file file name where the error took place
  * @param func function name where the error took placce
  * @param line line number within file where error took place
+ * @note Not every call is fatal. When memory accounting is enabled, an allocation that takes
+ * a tag over its soft limit succeeds and calls the handler with a \a type of
+ * ::PCL_MEMORY_LIMIT, see pcl/memtag.h. The handler must return in that case rather than
+ * exit, like the default handler does.
  */
 typedef void (*pcl_memory_handler_t)(const char *type, void *ptr, size_t siz, PCL_LOCATION_PARAMS);
 
+/** Allocator backend used by ::pcl_malloc, ::pcl_zalloc, ::pcl_realloc and ::pcl_free.
+ * All functions must be thread-safe and return \c NULL on failure; the memory handler is
+ * invoked by the caller. Returned memory must be suitably aligned for any type.
+ * @see pcl_set_allocator
+ */
+typedef struct
+{
+	/** name of the allocator, for diagnostics */
+	const char *name;
+
+	/** opaque value passed as the first argument to every function */
+	void *ctx;
+
+	/** allocate \a size bytes */
+	void *(*alloc)(void *ctx, size_t size);
+
+	/** allocate \a size zeroed bytes */
+	void *(*zalloc)(void *ctx, size_t size);
+
+	/** resize \a ptr to \a size bytes, \a ptr is never \c NULL */
+	void *(*resize)(void *ctx, void *ptr, size_t size);
+
+	/** release \a ptr, which is never \c NULL */
+	void (*release)(void *ctx, void *ptr);
+} pcl_allocator_t;
+
 #ifdef __doxygen__
 	/** @copydoc pcl_malloc_trace
 	 * @note implemented as a macro
@@ -118,7 +148,8 @@ PCL_PUBLIC void *pcl_free_trace(void *p, PCL_LOCATION_PARAMS);
  */
 PCL_PUBLIC void pcl_cleanup_ptr(void *item);
 
-/** Set the process memory error handler.
+/** Set the process memory error handler. The handler must return when called with the
+ * non-fatal ::PCL_MEMORY_LIMIT type, see ::pcl_memory_handler_t.
  * @param handler new memory error handler
  * @return previous memory error handler or \c NULL if it was unset
  */
@@ -127,6 +158,38 @@ PCL_PUBLIC pcl_memory_handler_t pcl_set_memory_handler(pcl_memory_handler_t hand
 /** Execute process memory error handler. */
 PCL_PUBLIC void pcl_memory_error(const char *type, void *ptr, size_t siz, PCL_LOCATION_PARAMS);
 
+/** Set the process allocator.
+ * Memory must be released by the allocator that created it, so this must be called
+ * before ::pcl_init and before any memory is allocated through PCL. It is typically
+ * the first line in \c main, alongside ::pcl_set_memory_handler.
+ * @param allocator allocator to install, \c NULL restores ::pcl_allocator_libc. The
+ * object is referenced, not copied, and must remain valid for the life of the process.
+ * @return previous allocator or \c NULL on error. Once ::pcl_init has been called this
+ * always fails with \c PCL_EBUSY.
+ */
+PCL_PUBLIC const pcl_allocator_t *pcl_set_allocator(const pcl_allocator_t *allocator);
+
+/** Get the process allocator.
+ * @return pointer to the installed allocator, never \c NULL
+ */
+PCL_PUBLIC const pcl_allocator_t *pcl_get_allocator(void);
+
+/** Get the C library allocator. This is the default.
+ * @return pointer to an allocator that wraps malloc, calloc, realloc and free
+ */
+PCL_PUBLIC const pcl_allocator_t *pcl_allocator_libc(void);
+
+/** Get the thread-caching allocator.
+ * Requests up to 1024 bytes are rounded to one of 20 size classes and served from a
+ * per-thread free list, so the common allocate/free cycle takes no lock. Each thread
+ * caches a bounded number of blocks per class; the surplus, and a thread's whole cache
+ * when it exits, returns to a shared list per class. Empty lists are refilled in batches
+ * from 64K chunks that are retained for reuse rather than returned to the system. Larger
+ * requests go to the C library. Blocks carry a 16 byte header.
+ * @return pointer to the thread-caching allocator
+ */
+PCL_PUBLIC const pcl_allocator_t *pcl_allocator_tcache(void);
+
 #ifdef __doxygen__
 	/** Allocate dynamic memory.
 	 * @param n size in ::pchar_t characters
@@ -0,0 +1,166 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL_ARENA_H
+#define LIBPCL_ARENA_H
+
+/** @defgroup arena Arena
+ * A region allocator. Memory is bumped out of large chunks and never freed individually;
+ * everything is released at once by ::pcl_arena_reset, or back to a savepoint by
+ * ::pcl_arena_rewind. This suits request-scoped work whose objects all die together.
+ * Reset keeps the chunks for reuse, so a long-lived arena stops allocating once it has
+ * grown to its working size. An arena is not thread-safe.
+ * #### Basic Usage
+ * @code
+ * pcl_arena_t *arena = pcl_arena(0);
+ *
+ * for(;;)
+ * {
+ *   request_t *req = pcl_arena_zalloc(arena, sizeof(request_t));
+ *   req->path = pcl_arena_strdup(arena, path);
+ *   req->headers = pcl_array_arena(arena, 16, NULL);
+ *   req->body = pcl_buf_arena(arena, 4096, PclBufBinary);
+ *
+ *   handle_request(req);
+ *
+ *   // releases req, path, headers and body in one step
+ *   pcl_arena_reset(arena);
+ * }
+ * @endcode
+ * @{
+ */
+
+#include <pcl/types.h>
+
+/** Default chunk size of an arena. */
+#define PCL_ARENA_CHUNKSIZE (64 * 1024)
+
+/** Default alignment of arena allocations. */
+#define PCL_ARENA_ALIGN 16
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Savepoint within an arena, see ::pcl_arena_mark. */
+typedef struct
+{
+	/** chunk that was current when the mark was taken */
+	void *chunk;
+
+	/** bytes used within that chunk */
+	size_t used;
+} pcl_arena_mark_t;
+
+/** Create an arena.
+ * @param chunksize size of the chunks allocations are bumped from, 0 for
+ * ::PCL_ARENA_CHUNKSIZE. Larger requests get a chunk of their own.
+ * @return pointer to a new arena that must be freed via ::pcl_arena_free
+ */
+PCL_PUBLIC pcl_arena_t *pcl_arena(size_t chunksize);
+
+/** Allocate memory aligned to ::PCL_ARENA_ALIGN.
+ * @param a pointer to an arena
+ * @param size size in bytes
+ * @return pointer to the memory or \c NULL on error
+ */
+PCL_PUBLIC void *pcl_arena_alloc(pcl_arena_t *a, size_t size);
+
+/** Allocate zeroed memory aligned to ::PCL_ARENA_ALIGN.
+ * @param a pointer to an arena
+ * @param size size in bytes
+ * @return pointer to the memory or \c NULL on error
+ */
+PCL_PUBLIC void *pcl_arena_zalloc(pcl_arena_t *a, size_t size);
+
+/** Allocate memory with a specific alignment.
+ * @param a pointer to an arena
+ * @param size size in bytes
+ * @param align alignment in bytes, which must be a power of two
+ * @return pointer to the memory or \c NULL on error
+ */
+PCL_PUBLIC void *pcl_arena_aligned(pcl_arena_t *a, size_t size, size_t align);
+
+/** Resize an arena allocation. The most recent allocation grows and shrinks in place when
+ * its chunk has room, otherwise the memory is copied to a new allocation. The old memory
+ * is not reclaimed until the arena is reset or rewound.
+ * @param a pointer to an arena
+ * @param ptr pointer to memory allocated from \a a, can be \c NULL
+ * @param oldsize current size of \a ptr in bytes
+ * @param size new size in bytes
+ * @return pointer to the memory or \c NULL on error
+ */
+PCL_PUBLIC void *pcl_arena_realloc(pcl_arena_t *a, void *ptr, size_t oldsize, size_t size);
+
+/** Copy a string into an arena.
+ * @param a pointer to an arena
+ * @param s string to copy
+ * @return pointer to the copy or \c NULL on error
+ */
+PCL_PUBLIC char *pcl_arena_strdup(pcl_arena_t *a, const char *s);
+
+/** Take a savepoint.
+ * @param a pointer to an arena
+ * @param mark pointer to receive the savepoint
+ */
+PCL_PUBLIC void pcl_arena_mark(pcl_arena_t *a, pcl_arena_mark_t *mark);
+
+/** Release everything allocated since a savepoint. Savepoints must be rewound in the reverse
+ * order they were taken; a savepoint taken before a rewind or reset to an earlier point is
+ * no longer valid.
+ * @param a pointer to an arena
+ * @param mark savepoint returned by ::pcl_arena_mark
+ */
+PCL_PUBLIC void pcl_arena_rewind(pcl_arena_t *a, const pcl_arena_mark_t *mark);
+
+/** Release every allocation without freeing the arena's chunks. Oversized chunks are freed.
+ * @param a pointer to an arena
+ */
+PCL_PUBLIC void pcl_arena_reset(pcl_arena_t *a);
+
+/** Get the number of bytes handed out by an arena, including alignment padding.
+ * @param a pointer to an arena
+ * @return number of bytes in use
+ */
+PCL_PUBLIC size_t pcl_arena_used(const pcl_arena_t *a);
+
+/** Release all resources used by an arena, including every allocation.
+ * @param a pointer to an arena, can be \c NULL
+ */
+PCL_PUBLIC void pcl_arena_free(pcl_arena_t *a);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif // LIBPCL_ARENA_H
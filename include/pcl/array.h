@@ -91,6 +91,8 @@ struct tag_pcl_array
 	void **elements;
 	/** Cleanup handler for array elements */
 	pcl_cleanup_t cleanup;
+	/** arena that owns the array or \c NULL, see ::pcl_array_arena */
+	pcl_arena_t *arena;
 };
 
 /** Create an array.
@@ -101,6 +103,17 @@ struct tag_pcl_array
  */
 PCL_PUBLIC pcl_array_t *pcl_array(int initial_capacity, pcl_cleanup_t cleanup);
 
+/** Create an array whose object and element table are allocated from an arena. Growth
+ * copies the table within the arena. ::pcl_array_free still runs the cleanup handler but
+ * releases no memory; that happens when the arena is reset or rewound past the array.
+ * @param arena pointer to an arena
+ * @param initial_capacity initial size of array
+ * @param cleanup pointer to a cleanup routine.
+ * @return pointer to a new array object or \c NULL on error
+ */
+PCL_PUBLIC pcl_array_t *pcl_array_arena(pcl_arena_t *arena, int initial_capacity,
+	pcl_cleanup_t cleanup);
+
 /** Get an element from an array.
  * This is typically not used when iterating over an array, as one can just directly access
  * the element via the \a elements member. However, this is useful for cases when not looping
@@ -36,11 +36,50 @@
  * Perform atomic operations. These functions are useful for updating or fetching a value
  * in an atomic fashion: such as a global variable in a multi-threaded application.
  * Atomic operations, where applicable, are a much faster synchronization technique than Mutexes.
+ *
+ * The \c pcl_atomic_xxx32, \c pcl_atomic_xxx64 and \c pcl_atomic_xxxptr functions are always
+ * inlined and take a \c PCL_ATOMIC_xxx memory order, which should be a constant. A relaxed
+ * statistics counter is then a single instruction:
+ * @code
+ * pcl_atomic_fetch_add64(&stats->requests, 1, PCL_ATOMIC_RELAXED);
+ * @endcode
+ * The older ::pcl_atomic_t functions are sequentially consistent function calls.
  * @{
  */
 
 #include <pcl/types.h>
 
+#ifdef PCL_WINDOWS
+#	include <intrin.h>
+#endif
+
+/** Memory order: atomicity only, no ordering of other memory accesses. */
+#define PCL_ATOMIC_RELAXED 0
+
+/** Memory order: later accesses cannot move before a load. */
+#define PCL_ATOMIC_ACQUIRE 2
+
+/** Memory order: earlier accesses cannot move after a store. */
+#define PCL_ATOMIC_RELEASE 3
+
+/** Memory order: both acquire and release, for read-modify-write operations. */
+#define PCL_ATOMIC_ACQ_REL 4
+
+/** Memory order: acquire and release plus a single total order of all such operations. */
+#define PCL_ATOMIC_SEQ_CST 5
+
+/* The values above match GCC's __ATOMIC_xxx constants */
+#ifdef PCL_WINDOWS
+#	define PCL_ATOMIC_INLINE __forceinline
+#else
+#	define PCL_ATOMIC_INLINE PCL_INLINE __attribute__ ((always_inline))
+#endif
+
+/** Defined when ::pcl_atomic_cas128 is available: x86-64 and ARM64 */
+#if defined(_M_X64) || defined(__x86_64__) || defined(__aarch64__)
+#	define PCL_HAVE_ATOMIC_CAS128
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -81,6 +120,494 @@ PCL_PUBLIC pcl_atomic_t pcl_atomic_compare_exchange(pcl_atomic_t *dest, pcl_atom
  */
 PCL_PUBLIC pcl_atomic_t pcl_atomic_fetch(pcl_atomic_t *dest);
 
+#ifdef PCL_WINDOWS
+
+/* Interlocked intrinsics are full barriers, so every order above relaxed uses one. Weak CAS
+ * is strong.
+ */
+#	define IPCL_ATOMIC_BARRIER() do{ long volatile _b = 0; _InterlockedOr(&_b, 0); }while(0)
+
+PCL_ATOMIC_INLINE int32_t
+pcl_atomic_load32(const int32_t *p, int order)
+{
+	return order == PCL_ATOMIC_RELAXED ? *(const volatile int32_t *) p :
+		(int32_t) _InterlockedOr((long volatile *) p, 0);
+}
+
+PCL_ATOMIC_INLINE void
+pcl_atomic_store32(int32_t *p, int32_t v, int order)
+{
+	if(order == PCL_ATOMIC_RELAXED)
+		*(volatile int32_t *) p = v;
+	else
+		(void) _InterlockedExchange((long volatile *) p, (long) v);
+}
+
+PCL_ATOMIC_INLINE int32_t
+pcl_atomic_exchange32(int32_t *p, int32_t v, int order)
+{
+	(void) order;
+	return (int32_t) _InterlockedExchange((long volatile *) p, (long) v);
+}
+
+PCL_ATOMIC_INLINE int32_t
+pcl_atomic_fetch_add32(int32_t *p, int32_t v, int order)
+{
+	(void) order;
+	return (int32_t) _InterlockedExchangeAdd((long volatile *) p, (long) v);
+}
+
+PCL_ATOMIC_INLINE int32_t
+pcl_atomic_fetch_or32(int32_t *p, int32_t v, int order)
+{
+	(void) order;
+	return (int32_t) _InterlockedOr((long volatile *) p, (long) v);
+}
+
+PCL_ATOMIC_INLINE int32_t
+pcl_atomic_fetch_and32(int32_t *p, int32_t v, int order)
+{
+	(void) order;
+	return (int32_t) _InterlockedAnd((long volatile *) p, (long) v);
+}
+
+PCL_ATOMIC_INLINE int32_t
+pcl_atomic_fetch_xor32(int32_t *p, int32_t v, int order)
+{
+	(void) order;
+	return (int32_t) _InterlockedXor((long volatile *) p, (long) v);
+}
+
+PCL_ATOMIC_INLINE bool
+pcl_atomic_cas32(int32_t *p, int32_t *expected, int32_t desired, int order)
+{
+	long prev = _InterlockedCompareExchange((long volatile *) p, (long) desired, (long) *expected);
+
+	(void) order;
+	if(prev == (long) *expected)
+		return true;
+
+	*expected = (int32_t) prev;
+	return false;
+}
+
+PCL_ATOMIC_INLINE bool
+pcl_atomic_cas32_weak(int32_t *p, int32_t *expected, int32_t desired, int order)
+{
+	return pcl_atomic_cas32(p, expected, desired, order);
+}
+
+PCL_ATOMIC_INLINE int64_t
+pcl_atomic_load64(const int64_t *p, int order)
+{
+	return order == PCL_ATOMIC_RELAXED ? *(const volatile int64_t *) p :
+		(int64_t) _InterlockedOr64((__int64 volatile *) p, 0);
+}
+
+PCL_ATOMIC_INLINE void
+pcl_atomic_store64(int64_t *p, int64_t v, int order)
+{
+	if(order == PCL_ATOMIC_RELAXED)
+		*(volatile int64_t *) p = v;
+	else
+		(void) _InterlockedExchange64((__int64 volatile *) p, v);
+}
+
+PCL_ATOMIC_INLINE int64_t
+pcl_atomic_exchange64(int64_t *p, int64_t v, int order)
+{
+	(void) order;
+	return _InterlockedExchange64((__int64 volatile *) p, v);
+}
+
+PCL_ATOMIC_INLINE int64_t
+pcl_atomic_fetch_add64(int64_t *p, int64_t v, int order)
+{
+	(void) order;
+	return _InterlockedExchangeAdd64((__int64 volatile *) p, v);
+}
+
+PCL_ATOMIC_INLINE int64_t
+pcl_atomic_fetch_or64(int64_t *p, int64_t v, int order)
+{
+	(void) order;
+	return _InterlockedOr64((__int64 volatile *) p, v);
+}
+
+PCL_ATOMIC_INLINE int64_t
+pcl_atomic_fetch_and64(int64_t *p, int64_t v, int order)
+{
+	(void) order;
+	return _InterlockedAnd64((__int64 volatile *) p, v);
+}
+
+PCL_ATOMIC_INLINE int64_t
+pcl_atomic_fetch_xor64(int64_t *p, int64_t v, int order)
+{
+	(void) order;
+	return _InterlockedXor64((__int64 volatile *) p, v);
+}
+
+PCL_ATOMIC_INLINE bool
+pcl_atomic_cas64(int64_t *p, int64_t *expected, int64_t desired, int order)
+{
+	__int64 prev = _InterlockedCompareExchange64((__int64 volatile *) p, desired, *expected);
+
+	(void) order;
+	if(prev == *expected)
+		return true;
+
+	*expected = prev;
+	return false;
+}
+
+PCL_ATOMIC_INLINE bool
+pcl_atomic_cas64_weak(int64_t *p, int64_t *expected, int64_t desired, int order)
+{
+	return pcl_atomic_cas64(p, expected, desired, order);
+}
+
+PCL_ATOMIC_INLINE void *
+pcl_atomic_loadptr(void *const *p, int order)
+{
+	void *v = *(void *const volatile *) p;
+
+	if(order != PCL_ATOMIC_RELAXED)
+		IPCL_ATOMIC_BARRIER();
+	return v;
+}
+
+PCL_ATOMIC_INLINE void
+pcl_atomic_storeptr(void **p, void *v, int order)
+{
+	if(order == PCL_ATOMIC_RELAXED)
+		*(void *volatile *) p = v;
+	else
+		(void) _InterlockedExchangePointer((void *volatile *) p, v);
+}
+
+PCL_ATOMIC_INLINE void *
+pcl_atomic_exchangeptr(void **p, void *v, int order)
+{
+	(void) order;
+	return _InterlockedExchangePointer((void *volatile *) p, v);
+}
+
+PCL_ATOMIC_INLINE bool
+pcl_atomic_casptr(void **p, void **expected, void *desired, int order)
+{
+	void *prev = _InterlockedCompareExchangePointer((void *volatile *) p, desired, *expected);
+
+	(void) order;
+	if(prev == *expected)
+		return true;
+
+	*expected = prev;
+	return false;
+}
+
+PCL_ATOMIC_INLINE bool
+pcl_atomic_casptr_weak(void **p, void **expected, void *desired, int order)
+{
+	return pcl_atomic_casptr(p, expected, desired, order);
+}
+
+#	ifdef PCL_HAVE_ATOMIC_CAS128
+PCL_ATOMIC_INLINE bool
+pcl_atomic_cas128(uint128_t *p, uint128_t *expected, uint128_t desired)
+{
+	return _InterlockedCompareExchange128((__int64 volatile *) p, (__int64) desired.high,
+		(__int64) desired.low, (__int64 *) expected) != 0;
+}
+#	endif
+
+PCL_ATOMIC_INLINE void
+pcl_atomic_fence(int order)
+{
+	if(order != PCL_ATOMIC_RELAXED)
+		IPCL_ATOMIC_BARRIER();
+}
+
+#else
+
+/* failure order of a compare and exchange, which cannot include a release */
+#define IPCL_ATOMIC_FAILORDER(order) \
+	((order) == PCL_ATOMIC_RELEASE ? PCL_ATOMIC_RELAXED : \
+		(order) == PCL_ATOMIC_ACQ_REL ? PCL_ATOMIC_ACQUIRE : (order))
+
+/** Atomically load a value.
+ * @param p pointer to the value
+ * @param order ::PCL_ATOMIC_RELAXED, ::PCL_ATOMIC_ACQUIRE or ::PCL_ATOMIC_SEQ_CST
+ * @return value of \a p
+ */
+PCL_ATOMIC_INLINE int32_t
+pcl_atomic_load32(const int32_t *p, int order)
+{
+	return __atomic_load_n(p, order);
+}
+
+/** Atomically store a value.
+ * @param p pointer to the value
+ * @param v new value
+ * @param order ::PCL_ATOMIC_RELAXED, ::PCL_ATOMIC_RELEASE or ::PCL_ATOMIC_SEQ_CST
+ */
+PCL_ATOMIC_INLINE void
+pcl_atomic_store32(int32_t *p, int32_t v, int order)
+{
+	__atomic_store_n(p, v, order);
+}
+
+/** Atomically replace a value.
+ * @param p pointer to the value
+ * @param v new value
+ * @param order memory order
+ * @return previous value of \a p
+ */
+PCL_ATOMIC_INLINE int32_t
+pcl_atomic_exchange32(int32_t *p, int32_t v, int order)
+{
+	return __atomic_exchange_n(p, v, order);
+}
+
+/** Atomically add to a value.
+ * @param p pointer to the value
+ * @param v value to add, which can be negative to subtract
+ * @param order memory order
+ * @return previous value of \a p
+ */
+PCL_ATOMIC_INLINE int32_t
+pcl_atomic_fetch_add32(int32_t *p, int32_t v, int order)
+{
+	return __atomic_fetch_add(p, v, order);
+}
+
+/** Atomically set bits of a value.
+ * @param p pointer to the value
+ * @param v bits to set
+ * @param order memory order
+ * @return previous value of \a p
+ */
+PCL_ATOMIC_INLINE int32_t
+pcl_atomic_fetch_or32(int32_t *p, int32_t v, int order)
+{
+	return __atomic_fetch_or(p, v, order);
+}
+
+/** Atomically clear bits of a value.
+ * @param p pointer to the value
+ * @param v mask of bits to keep
+ * @param order memory order
+ * @return previous value of \a p
+ */
+PCL_ATOMIC_INLINE int32_t
+pcl_atomic_fetch_and32(int32_t *p, int32_t v, int order)
+{
+	return __atomic_fetch_and(p, v, order);
+}
+
+/** Atomically toggle bits of a value.
+ * @param p pointer to the value
+ * @param v bits to toggle
+ * @param order memory order
+ * @return previous value of \a p
+ */
+PCL_ATOMIC_INLINE int32_t
+pcl_atomic_fetch_xor32(int32_t *p, int32_t v, int order)
+{
+	return __atomic_fetch_xor(p, v, order);
+}
+
+/** Atomically replace a value if it matches an expected one.
+ * @param p pointer to the value
+ * @param expected pointer to the expected value, which receives the current value of \a p
+ * on failure
+ * @param desired new value
+ * @param order memory order on success. On failure, release is dropped from it.
+ * @return true if \a p was replaced and false otherwise
+ */
+PCL_ATOMIC_INLINE bool
+pcl_atomic_cas32(int32_t *p, int32_t *expected, int32_t desired, int order)
+{
+	return __atomic_compare_exchange_n(p, expected, desired, false, order,
+		IPCL_ATOMIC_FAILORDER(order));
+}
+
+/** Same as ::pcl_atomic_cas32 but may fail spuriously, which is cheaper on some processors
+ * when called in a loop.
+ */
+PCL_ATOMIC_INLINE bool
+pcl_atomic_cas32_weak(int32_t *p, int32_t *expected, int32_t desired, int order)
+{
+	return __atomic_compare_exchange_n(p, expected, desired, true, order,
+		IPCL_ATOMIC_FAILORDER(order));
+}
+
+/** @copydoc pcl_atomic_load32 */
+PCL_ATOMIC_INLINE int64_t
+pcl_atomic_load64(const int64_t *p, int order)
+{
+	return __atomic_load_n(p, order);
+}
+
+/** @copydoc pcl_atomic_store32 */
+PCL_ATOMIC_INLINE void
+pcl_atomic_store64(int64_t *p, int64_t v, int order)
+{
+	__atomic_store_n(p, v, order);
+}
+
+/** @copydoc pcl_atomic_exchange32 */
+PCL_ATOMIC_INLINE int64_t
+pcl_atomic_exchange64(int64_t *p, int64_t v, int order)
+{
+	return __atomic_exchange_n(p, v, order);
+}
+
+/** @copydoc pcl_atomic_fetch_add32 */
+PCL_ATOMIC_INLINE int64_t
+pcl_atomic_fetch_add64(int64_t *p, int64_t v, int order)
+{
+	return __atomic_fetch_add(p, v, order);
+}
+
+/** @copydoc pcl_atomic_fetch_or32 */
+PCL_ATOMIC_INLINE int64_t
+pcl_atomic_fetch_or64(int64_t *p, int64_t v, int order)
+{
+	return __atomic_fetch_or(p, v, order);
+}
+
+/** @copydoc pcl_atomic_fetch_and32 */
+PCL_ATOMIC_INLINE int64_t
+pcl_atomic_fetch_and64(int64_t *p, int64_t v, int order)
+{
+	return __atomic_fetch_and(p, v, order);
+}
+
+/** @copydoc pcl_atomic_fetch_xor32 */
+PCL_ATOMIC_INLINE int64_t
+pcl_atomic_fetch_xor64(int64_t *p, int64_t v, int order)
+{
+	return __atomic_fetch_xor(p, v, order);
+}
+
+/** @copydoc pcl_atomic_cas32 */
+PCL_ATOMIC_INLINE bool
+pcl_atomic_cas64(int64_t *p, int64_t *expected, int64_t desired, int order)
+{
+	return __atomic_compare_exchange_n(p, expected, desired, false, order,
+		IPCL_ATOMIC_FAILORDER(order));
+}
+
+/** @copydoc pcl_atomic_cas32_weak */
+PCL_ATOMIC_INLINE bool
+pcl_atomic_cas64_weak(int64_t *p, int64_t *expected, int64_t desired, int order)
+{
+	return __atomic_compare_exchange_n(p, expected, desired, true, order,
+		IPCL_ATOMIC_FAILORDER(order));
+}
+
+/** @copydoc pcl_atomic_load32 */
+PCL_ATOMIC_INLINE void *
+pcl_atomic_loadptr(void *const *p, int order)
+{
+	return __atomic_load_n(p, order);
+}
+
+/** @copydoc pcl_atomic_store32 */
+PCL_ATOMIC_INLINE void
+pcl_atomic_storeptr(void **p, void *v, int order)
+{
+	__atomic_store_n(p, v, order);
+}
+
+/** @copydoc pcl_atomic_exchange32 */
+PCL_ATOMIC_INLINE void *
+pcl_atomic_exchangeptr(void **p, void *v, int order)
+{
+	return __atomic_exchange_n(p, v, order);
+}
+
+/** @copydoc pcl_atomic_cas32 */
+PCL_ATOMIC_INLINE bool
+pcl_atomic_casptr(void **p, void **expected, void *desired, int order)
+{
+	return __atomic_compare_exchange_n(p, expected, desired, false, order,
+		IPCL_ATOMIC_FAILORDER(order));
+}
+
+/** @copydoc pcl_atomic_cas32_weak */
+PCL_ATOMIC_INLINE bool
+pcl_atomic_casptr_weak(void **p, void **expected, void *desired, int order)
+{
+	return __atomic_compare_exchange_n(p, expected, desired, true, order,
+		IPCL_ATOMIC_FAILORDER(order));
+}
+
+#	ifdef PCL_HAVE_ATOMIC_CAS128
+/** Atomically replace a 16-byte value if it matches an expected one, for example a pointer
+ * and a counter. Sequentially consistent. Only available when ::PCL_HAVE_ATOMIC_CAS128 is
+ * defined.
+ * @param p pointer to the value, which must be 16-byte aligned
+ * @param expected pointer to the expected value, which receives the current value of \a p
+ * on failure
+ * @param desired new value
+ * @return true if \a p was replaced and false otherwise
+ */
+PCL_ATOMIC_INLINE bool
+pcl_atomic_cas128(uint128_t *p, uint128_t *expected, uint128_t desired)
+{
+#		ifdef __x86_64__
+	bool ok;
+
+	/* inline so that no -mcx16 or libatomic is required */
+	__asm__ __volatile__("lock cmpxchg16b %1\n\tsetz %0"
+		: "=q" (ok), "+m" (*p), "+a" (expected->low), "+d" (expected->high)
+		: "b" (desired.low), "c" (desired.high)
+		: "memory", "cc");
+
+	return ok;
+#		else
+	/* ARM64 exclusive pair, the store fails if p changed since the load */
+	uint64_t low, high;
+	uint32_t failed;
+
+	do
+	{
+		__asm__ __volatile__("ldaxp %0, %1, %2"
+			: "=&r" (low), "=&r" (high) : "Q" (*p) : "memory");
+
+		if(low != expected->low || high != expected->high)
+		{
+			/* clear the exclusive monitor */
+			__asm__ __volatile__("clrex" ::: "memory");
+			expected->low = low;
+			expected->high = high;
+			return false;
+		}
+
+		__asm__ __volatile__("stlxp %w0, %2, %3, %1"
+			: "=&r" (failed), "=Q" (*p) : "r" (desired.low), "r" (desired.high) : "memory");
+	}
+	while(failed);
+
+	return true;
+#		endif
+}
+#	endif
+
+/** Issue a memory fence.
+ * @param order ::PCL_ATOMIC_ACQUIRE, ::PCL_ATOMIC_RELEASE, ::PCL_ATOMIC_ACQ_REL or
+ * ::PCL_ATOMIC_SEQ_CST. ::PCL_ATOMIC_RELAXED is a no-op.
+ */
+PCL_ATOMIC_INLINE void
+pcl_atomic_fence(int order)
+{
+	__atomic_thread_fence(order);
+}
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
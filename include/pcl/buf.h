@@ -36,9 +36,10 @@
  * The buffer API provides a dynamically sized buffer for putting text and/or binary data.
  * When a buffer is created, a buffer mode must be provided: one of ::PclBufBinary, ::PclBufText,
  * ::PclBufTextW or ::PclBufTextP. Regardless of a buffer's mode, a trailing NUL is added on
- * every put. The space is reserved internally and it not represented in the buffer's
- * current position or length. The buffer thinks in "characters", not bytes. When in binary
- * mode, it still performs character calculations but based on a one byte character.
+ * every put, unless ::pcl_buf_lazynul is enabled. The space is reserved internally and is
+ * not represented in the buffer's current position or length. The buffer thinks in
+ * "characters", not bytes. When in binary mode, it still performs character calculations
+ * but based on a one byte character.
  *
  * ### Binary Mode
  * A binary buffer is an array of data types: integers, strings and blobs. A binary string is
@@ -100,6 +101,7 @@
  */
 
 #include <pcl/types.h>
+#include <string.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -124,6 +126,23 @@ enum pcl_buf_mode
 #endif
 };
 
+/** Growth strategies, see ::pcl_buf_setgrowth. */
+enum pcl_buf_growth
+{
+	/** Capacity is multiplied by a factor, which is 2 by default. */
+	PclBufGrowGeometric,
+
+	/** Geometric growth rounded up to a whole number of pages, which suits large buffers that
+	 * the allocator serves with mmap.
+	 */
+	PclBufGrowPage,
+
+	/** Geometric growth that never exceeds a maximum capacity. Puts that would need more space
+	 * fail with ::PCL_EBUF.
+	 */
+	PclBufGrowCapped
+};
+
 struct tag_pcl_buf
 {
 	/** buffer mode, see ::pcl_buf_mode */
@@ -145,8 +164,49 @@ struct tag_pcl_buf
 
 	/** buffer bytes, always `chrsize * size` wide. */
 	char *data;
+
+	/** growth strategy, see ::pcl_buf_setgrowth */
+	enum pcl_buf_growth growth;
+
+	/** growth factor as a percentage, 0 means 200 */
+	int factor;
+
+	/** maximum capacity in characters for ::PclBufGrowCapped */
+	size_t maxsize;
+
+	/** when true, puts do not NUL terminate, see ::pcl_buf_lazynul */
+	bool lazynul;
+
+	/** arena that owns the buffer or \c NULL, see ::pcl_buf_arena */
+	pcl_arena_t *arena;
 };
 
+/** Append a character without checking capacity. Room must have been made with
+ * ::pcl_buf_reserve and no NUL is written, see ::pcl_buf_terminate.
+ * @note ::PclBufBinary and ::PclBufText modes only
+ * @param b pointer to a buffer
+ * @param c character
+ */
+#define pcl_buf_appendc(b, c) do{ \
+	(b)->data[(b)->pos++] = (char) (c); \
+	if((b)->len < (b)->pos) \
+		(b)->len = (b)->pos; \
+}while(0)
+
+/** Append bytes without checking capacity. Room must have been made with ::pcl_buf_reserve
+ * and no NUL is written, see ::pcl_buf_terminate.
+ * @note ::PclBufBinary and ::PclBufText modes only
+ * @param b pointer to a buffer
+ * @param src pointer to the bytes to append
+ * @param n number of bytes
+ */
+#define pcl_buf_append(b, src, n) do{ \
+	memcpy((b)->data + (b)->pos, (src), (n)); \
+	(b)->pos += (int) (n); \
+	if((b)->len < (b)->pos) \
+		(b)->len = (b)->pos; \
+}while(0)
+
 /** Initializes a buffer object.
  * @param b pointer to a buffer. If this is \c NULL, a buffer will be allocated
  * @param size intial size in characters
@@ -155,6 +215,16 @@ struct tag_pcl_buf
  */
 PCL_PUBLIC pcl_buf_t *pcl_buf_init(pcl_buf_t *b, size_t size, enum pcl_buf_mode mode);
 
+/** Create a buffer whose object and data are allocated from an arena. Growth copies within
+ * the arena and ::pcl_buf_free releases nothing; the memory is reclaimed when the arena is
+ * reset or rewound past the buffer.
+ * @param arena pointer to an arena
+ * @param size intial size in characters
+ * @param mode the buffer mode
+ * @return pointer to a new buffer or \c NULL on error
+ */
+PCL_PUBLIC pcl_buf_t *pcl_buf_arena(pcl_arena_t *arena, size_t size, enum pcl_buf_mode mode);
+
 /** Grow a buffer. Given a \a len, this ensures that writing \a len bytes won't overflow
  * the buffer by reallocating the buffer's internal memory. This is used by all buffer put
  * functions before attempting to write data.
@@ -164,6 +234,41 @@ PCL_PUBLIC pcl_buf_t *pcl_buf_init(pcl_buf_t *b, size_t size, enum pcl_buf_mode
  */
 PCL_PUBLIC pcl_buf_t *pcl_buf_grow(pcl_buf_t *b, int len);
 
+/** Make room for \a len more characters, plus the NUL that follows them. After a successful
+ * reserve, up to \a len characters can be written with ::pcl_buf_append and
+ * ::pcl_buf_appendc.
+ * @param b pointer to a buffer
+ * @param len number of characters
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_buf_reserve(pcl_buf_t *b, int len);
+
+/** Set the strategy used when a buffer must grow. Buffers use ::PclBufGrowGeometric with a
+ * factor of 2 by default.
+ * @param b pointer to a buffer
+ * @param growth the strategy
+ * @param param for ::PclBufGrowGeometric and ::PclBufGrowPage, the growth factor as a
+ * percentage greater than 100 or 0 for the default. For ::PclBufGrowCapped, the maximum
+ * capacity in characters including the NUL.
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_buf_setgrowth(pcl_buf_t *b, enum pcl_buf_growth growth, size_t param);
+
+/** Enable or disable lazy NUL termination. By default, every put writes a NUL after the data.
+ * In lazy mode, puts skip it and ::pcl_buf_terminate must be called before using \c data as a
+ * string. Capacity for the NUL is always reserved.
+ * @param b pointer to a buffer
+ * @param enable true to enable lazy mode. Disabling it terminates the buffer.
+ * @return pointer to \a b or \c NULL on error
+ */
+PCL_PUBLIC pcl_buf_t *pcl_buf_lazynul(pcl_buf_t *b, bool enable);
+
+/** Write a NUL at the current position, not added to the length.
+ * @param b pointer to a buffer
+ * @return pointer to \a b or \c NULL on error
+ */
+PCL_PUBLIC pcl_buf_t *pcl_buf_terminate(pcl_buf_t *b);
+
 /** Reset a buffer to its initial state. This sets the buffer's position and length to zero.
  * @param b pointer to a buffer
  * @return pointer to the \a b argument
@@ -0,0 +1,109 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL_EPOCH_H
+#define LIBPCL_EPOCH_H
+
+/** @defgroup epoch Epoch Reclamation
+ * Epoch based memory reclamation for lock-free and read-mostly structures. Readers wrap
+ * access to shared nodes in ::pcl_epoch_enter and ::pcl_epoch_exit, which only write to a
+ * per-thread slot, so readers never share a cache line. Writers unlink a node and hand it
+ * to ::pcl_epoch_retire instead of freeing it. The node is freed once every thread that
+ * could still hold a reference has left its critical section.
+ *
+ * A global epoch advances when all threads inside a critical section have observed the
+ * current one. Items retired in epoch \c e are freed once the epoch reaches \c e + 2.
+ * Retired items are kept in per-thread lists and reclaimed in batches.
+ *
+ * Threads started with ::pcl_thread are registered through ::PCL_EVENT_THREADINIT, any other
+ * thread is registered on first use. A thread's registration is released by its TLS
+ * destructor and its pending items are handed to whichever thread reclaims next.
+ *
+ * Long running threads can use quiescent state based reclamation instead: enter once and
+ * call ::pcl_epoch_quiescent at points where they hold no references.
+ * @{
+ */
+
+#include <pcl/types.h>
+
+/** Pending items per thread that trigger a reclamation attempt in ::pcl_epoch_retire. */
+#define PCL_EPOCH_BATCH 64
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Begin a read-side critical section. Sections can be nested.
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_epoch_enter(void);
+
+/** End a read-side critical section. References obtained inside it must not be used
+ * afterwards.
+ */
+PCL_PUBLIC void pcl_epoch_exit(void);
+
+/** Declare that the calling thread holds no references obtained before this call, while
+ * staying inside its critical section. Does nothing outside a critical section.
+ */
+PCL_PUBLIC void pcl_epoch_quiescent(void);
+
+/** Defer freeing an item that has been unlinked from a shared structure. Can be called
+ * inside or outside a critical section.
+ * @param item pointer to an item that no new reader can reach
+ * @param cleanup function that frees \a item, \c NULL uses ::pcl_free
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_epoch_retire(void *item, pcl_cleanup_t cleanup);
+
+/** Try to advance the epoch and free every retired item that is safe to free. This
+ * never blocks.
+ * @return number of items freed or -1 on error
+ */
+PCL_PUBLIC int pcl_epoch_reclaim(void);
+
+/** Wait until every item retired so far by the calling thread has been freed.
+ * @return 0 on success or -1 on error. ::PCL_EDEADLK when called inside a critical section.
+ */
+PCL_PUBLIC int pcl_epoch_synchronize(void);
+
+/** Get the number of items the calling thread has retired that are not yet freed.
+ * @return number of pending items
+ */
+PCL_PUBLIC int pcl_epoch_pending(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif // LIBPCL_EPOCH_H
@@ -53,6 +53,11 @@
 /** User-defined events should be greater than or equal to this value */
 #define PCL_EVENT_USERBASE 10
 
+/** Event identifier reserved for handlers receiving every event.
+ * @see pcl_event_register
+ */
+#define PCL_EVENT_ALL 0xFFFFFFFFu
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -65,7 +70,10 @@ typedef void (*pcl_event_handler_t)(uint32_t event, void *data);
 
 /** Dispatches an event to the calling thread.
  * @note dispatching is a per-thread synchronous operation. This function won't return until
- * all event handlers have completed.
+ * all event handlers have completed. It takes no lock: handlers registered via
+ * ::pcl_event_register are called first, followed by those subscribed to \a event via
+ * ::pcl_event_subscribe, each in registration order. Handlers may dispatch events and
+ * register or unregister handlers, which affects later dispatches only.
  * @param event event id to dispatch. The internal event_handlers ignore all events except
  * PCL_EVENT_INIT and PCL_EVENT_THREADINIT. However, applications can create custom events
  * and respond accordingly.
@@ -73,16 +81,32 @@ typedef void (*pcl_event_handler_t)(uint32_t event, void *data);
  */
 PCL_PUBLIC void pcl_event_dispatch(uint32_t event, void *data);
 
-/** Registers a new event handler.
+/** Registers a new event handler that receives every event.
  * @param handler event handler
  */
 PCL_PUBLIC void pcl_event_register(pcl_event_handler_t handler);
 
-/** Unregisters a previously registered event handler.
+/** Unregisters a previously registered event handler. Dispatches already in progress on other
+ * threads may still call it after this returns, so the code it lives in must not be unloaded
+ * right away.
  * @param handler event handler
  */
 PCL_PUBLIC void pcl_event_unregister(pcl_event_handler_t handler);
 
+/** Registers an event handler for a single event. Dispatching other events does not call
+ * it, which is cheaper than filtering within a handler registered via ::pcl_event_register.
+ * @param event event id, ::PCL_EVENT_ALL is the same as ::pcl_event_register
+ * @param handler event handler
+ */
+PCL_PUBLIC void pcl_event_subscribe(uint32_t event, pcl_event_handler_t handler);
+
+/** Unregisters an event handler previously subscribed to an event. As with
+ * ::pcl_event_unregister, in-flight dispatches may still call it after this returns.
+ * @param event event id
+ * @param handler event handler
+ */
+PCL_PUBLIC void pcl_event_unsubscribe(uint32_t event, pcl_event_handler_t handler);
+
 #ifdef __cplusplus
 }
 #endif
@@ -96,6 +96,24 @@ PCL_PUBLIC int pcl_file_read(pcl_file_t *file, void *buf, size_t count);
 
 PCL_PUBLIC int pcl_file_write(pcl_file_t *file, const void *data, size_t count);
 
+/** Write a list of buffers with one gather write, writev on unix. Windows has no gather write
+ * for ordinary handles, so each buffer is written in turn until one is written short.
+ * @param file pointer to a file object
+ * @param iov array of buffers
+ * @param iovcnt number of elements in \a iov, at most ::PCL_MAXIOV are written per call
+ * @return number of bytes written, which can be less than requested, or -1 on error
+ */
+PCL_PUBLIC int pcl_file_writev(pcl_file_t *file, const pcl_iovec_t *iov, int iovcnt);
+
+/** Read into a list of buffers with one scatter read, readv on unix. Windows has no scatter read
+ * for ordinary handles, so each buffer is filled in turn until one is read short.
+ * @param file pointer to a file object
+ * @param iov array of buffers
+ * @param iovcnt number of elements in \a iov, at most ::PCL_MAXIOV are filled per call
+ * @return number of bytes read, zero at end of file, or -1 on error
+ */
+PCL_PUBLIC int pcl_file_readv(pcl_file_t *file, const pcl_iovec_t *iov, int iovcnt);
+
 PCL_PUBLIC int pcl_file_tryread(pcl_file_t *file, void *buf, size_t count, int ms_timeout);
 
 PCL_PUBLIC int pcl_file_trywrite(pcl_file_t *file, const void *data, size_t count, int ms_timeout);
@@ -88,6 +88,11 @@
  */
 #define PCL_JSON_FREEVALONERR 0x10
 
+/** Deliver json lines documents as soon as they are decoded rather than in input order.
+ * @see pcl_json_decode_lines, pcl_json_readlines
+ */
+#define PCL_JSON_UNORDERED 0x20
+
 /** @} */
 
 /** Invalid JSON integer value used as return value.
@@ -240,8 +245,205 @@ PCL_PUBLIC pcl_json_t *pcl_json_decode(const char *json, size_t len, const char
  */
 PCL_PUBLIC char *pcl_json_encode(pcl_json_t *value, bool format);
 
+/** Encode a json object as a string using multiple threads.
+ * Arrays and objects with many members are split into ranges that are encoded concurrently,
+ * smaller ones are encoded serially. The result is identical to ::pcl_json_encode.
+ * @param value pointer to a json object
+ * @param format if true, spaces and tabs will be added to the output.
+ * @param nthreads number of encoding threads including the calling thread. If 1, this is
+ * the same as ::pcl_json_encode.
+ * @return pointer to an allocated json string or \c NULL on error
+ */
+PCL_PUBLIC char *pcl_json_encode_parallel(pcl_json_t *value, bool format, int nthreads);
+
+/** Callback used by the streaming encoders to write out buffered output.
+ * @param data pointer to encoded json text, which is not NUL-terminated
+ * @param len number of bytes in \a data, all of which must be written
+ * @param udata user data pointer given to the encoder
+ * @return 0 on success and -1 on error, which aborts the encoding
+ * @see pcl_json_write_file, pcl_json_write_fp, pcl_json_write_socket, pcl_json_write_ssl
+ */
+typedef int (*pcl_json_write_t)(const void *data, size_t len, void *udata);
+
+/** Encode a json value without holding the whole document in memory.
+ * Output is produced into a fixed size buffer that is handed to \a write whenever it fills.
+ * @code
+ * if(pcl_json_encode_stream(root, false, pcl_json_write_socket, sock) < 0)
+ *   pcl_err_fprintf(stderr, 0, "failed to send response");
+ * @endcode
+ * @param value pointer to a json value
+ * @param format if true, spaces and tabs will be added to the output.
+ * @param write callback invoked with each full buffer and once more with the remainder
+ * @param udata user data passed to \a write
+ * @return 0 on success and -1 on error
+ */
+PCL_PUBLIC int pcl_json_encode_stream(pcl_json_t *value, bool format, pcl_json_write_t write,
+	void *udata);
+
+/** ::pcl_json_write_t that writes to a ::pcl_file_t passed as \a file. */
+PCL_PUBLIC int pcl_json_write_file(const void *data, size_t len, void *file);
+
+/** ::pcl_json_write_t that writes to a \c FILE* passed as \a fp. */
+PCL_PUBLIC int pcl_json_write_fp(const void *data, size_t len, void *fp);
+
+/** ::pcl_json_write_t that sends to a ::pcl_socket_t passed as \a sock. */
+PCL_PUBLIC int pcl_json_write_socket(const void *data, size_t len, void *sock);
+
+/** ::pcl_json_write_t that sends to a ::pcl_ssl_t passed as \a ssl. */
+PCL_PUBLIC int pcl_json_write_ssl(const void *data, size_t len, void *ssl);
+
+/** Create a json writer, which emits a document one value at a time without building it first.
+ * The output is identical to ::pcl_json_encode of the equivalent document.
+ * @code
+ * pcl_json_writer_t *w = pcl_json_writer(false, pcl_json_write_fp, stdout);
+ *
+ * pcl_json_writer_beginarr(w);
+ *
+ * while((row = next_row()))
+ * {
+ *   pcl_json_writer_value(w, row);
+ *   pcl_json_free(row);
+ * }
+ *
+ * pcl_json_writer_end(w);
+ * pcl_json_writer_close(w);
+ * @endcode
+ * @param format if true, spaces and tabs will be added to the output.
+ * @param write callback invoked with each full buffer
+ * @param udata user data passed to \a write
+ * @return pointer to a writer that must be released with ::pcl_json_writer_close
+ */
+PCL_PUBLIC pcl_json_writer_t *pcl_json_writer(bool format, pcl_json_write_t write, void *udata);
+
+/** Open an array. Until the matching ::pcl_json_writer_end, values are written as elements.
+ * @param w pointer to a json writer
+ * @return 0 on success and -1 on error
+ */
+PCL_PUBLIC int pcl_json_writer_beginarr(pcl_json_writer_t *w);
+
+/** Open an object. Until the matching ::pcl_json_writer_end, each member is written as a
+ * ::pcl_json_writer_key followed by a value, ::pcl_json_writer_beginarr or
+ * ::pcl_json_writer_beginobj.
+ * @param w pointer to a json writer
+ * @return 0 on success and -1 on error
+ */
+PCL_PUBLIC int pcl_json_writer_beginobj(pcl_json_writer_t *w);
+
+/** Write the key of the next object member.
+ * @param w pointer to a json writer
+ * @param key UTF-8 member name
+ * @return 0 on success and -1 on error
+ */
+PCL_PUBLIC int pcl_json_writer_key(pcl_json_writer_t *w, const char *key);
+
+/** Write a value. This is the root value, an array element or an object member value
+ * depending on the writer's position.
+ * @param w pointer to a json writer
+ * @param value pointer to a json value, which remains owned by the caller
+ * @return 0 on success and -1 on error
+ */
+PCL_PUBLIC int pcl_json_writer_value(pcl_json_writer_t *w, pcl_json_t *value);
+
+/** Close the innermost open array or object.
+ * @param w pointer to a json writer
+ * @return 0 on success and -1 on error
+ */
+PCL_PUBLIC int pcl_json_writer_end(pcl_json_writer_t *w);
+
+/** Write any buffered output and free a json writer.
+ * @param w pointer to a json writer
+ * @return 0 on success and -1 if the document is incomplete or the final write failed. The
+ * writer is freed either way.
+ */
+PCL_PUBLIC int pcl_json_writer_close(pcl_json_writer_t *w);
+
+/** Encode a json value as CBOR (RFC 8949) and append it to a binary buffer.
+ * Integers use the shortest encoding, reals are written as single precision floats when that is
+ * lossless and double precision otherwise.
+ * @param value pointer to a json value
+ * @param b pointer to a buffer in ::PclBufBinary mode
+ * @return number of bytes appended to \a b or -1 on error
+ */
+PCL_PUBLIC int pcl_json_encode_cbor(pcl_json_t *value, pcl_buf_t *b);
+
+/** Decode a CBOR data item into a json value.
+ * Map keys must be text strings. Byte strings and simple values without a json equivalent are
+ * errors, tags are ignored and undefined, NaN and Infinity decode as null. Integers outside the
+ * range of a long long decode as reals.
+ * @param data pointer to CBOR data
+ * @param len number of bytes within \a data
+ * @param end pointer to the first byte not decoded. This can be \c NULL.
+ * @return pointer to a json value or \c NULL on error
+ */
+PCL_PUBLIC pcl_json_t *pcl_json_decode_cbor(const void *data, size_t len, const void **end);
+
+/** Encode a json value as MessagePack and append it to a binary buffer.
+ * @param value pointer to a json value
+ * @param b pointer to a buffer in ::PclBufBinary mode
+ * @return number of bytes appended to \a b or -1 on error
+ * @see pcl_json_encode_cbor
+ */
+PCL_PUBLIC int pcl_json_encode_msgpack(pcl_json_t *value, pcl_buf_t *b);
+
+/** Decode a MessagePack object into a json value.
+ * Map keys must be strings. The bin and ext families are errors and unsigned integers greater
+ * than \c LLONG_MAX decode as reals.
+ * @param data pointer to MessagePack data
+ * @param len number of bytes within \a data
+ * @param end pointer to the first byte not decoded. This can be \c NULL.
+ * @return pointer to a json value or \c NULL on error
+ */
+PCL_PUBLIC pcl_json_t *pcl_json_decode_msgpack(const void *data, size_t len, const void **end);
+
+/** Callback that receives each document decoded by ::pcl_json_decode_lines and
+ * ::pcl_json_readlines. It is always invoked on the thread that started the decode.
+ * @param doc pointer to a decoded json value, which the handler must release with ::pcl_json_free
+ * @param udata user data pointer passed to the decode function
+ * @return true to continue decoding or false to stop
+ */
+typedef bool (*pcl_json_line_handler_t)(pcl_json_t *doc, void *udata);
+
+/** Decode newline-delimited JSON (NDJSON / JSON Lines) using a pool of threads.
+ * The input is split into chunks at newline boundaries, which are decoded concurrently. Each
+ * non-blank line must contain exactly one JSON value. Documents are handed to \a handler in
+ * input order unless ::PCL_JSON_UNORDERED is set, in which case each chunk of documents is
+ * delivered as soon as it has been decoded. The number of chunks in flight is bounded, so memory
+ * use does not grow with the size of the input.
+ * @param data pointer to json lines, which does not need to be NUL-terminated
+ * @param len number of bytes within \a data
+ * @param nthreads number of decoding threads, must be at least 1
+ * @param flags ::PCL_JSON_UNORDERED or 0
+ * @param handler callback invoked for each document
+ * @param udata user data passed to \a handler
+ * @return number of documents delivered or -1 on error. The error includes the byte offset of
+ * the offending line. Documents preceding an error may have already been delivered.
+ */
+PCL_PUBLIC int pcl_json_decode_lines(const char *data, size_t len, int nthreads, uint32_t flags,
+	pcl_json_line_handler_t handler, void *udata);
+
+/** Decode newline-delimited JSON from a file. Regular files are memory mapped from the current
+ * file position and decoded with ::pcl_json_decode_lines. Pipes, sockets and other streams
+ * are read with ::pcl_file_read, one chunk at a time, until end of file.
+ * @param file pointer to a file opened for reading
+ * @param nthreads number of decoding threads, must be at least 1
+ * @param flags ::PCL_JSON_UNORDERED or 0
+ * @param handler callback invoked for each document
+ * @param udata user data passed to \a handler
+ * @return number of documents delivered or -1 on error
+ */
+PCL_PUBLIC int pcl_json_readlines(pcl_file_t *file, int nthreads, uint32_t flags,
+	pcl_json_line_handler_t handler, void *udata);
+
 /** Compile a json path.
- * @param path A JSONPath string. This doesn't support filters.
+ * Filter expressions are supported in the form \c [?(@.rel.path op value)], where \a op is one
+ * of \c ==, \c !=, \c <, \c <=, \c > or \c >= and \a value is a number, a single or double
+ * quoted string, \c true, \c false or \c null. Omitting the operator and value, as in
+ * \c [?(@.isbn)], tests for existence. A filter selects the elements of an array, or the values
+ * of an object, for which any value matched by the relative path satisfies the predicate.
+ * @code
+ * pcl_json_path_t *path = pcl_json_compile("$.store.book[?(@.price < 10)].title");
+ * @endcode
+ * @param path A JSONPath string.
  * @return pointer to a compiled json path object which must be freed with ::pcl_json_freepath.
  */
 PCL_PUBLIC pcl_json_path_t *pcl_json_compile(const char *path);
@@ -259,6 +461,27 @@ PCL_PUBLIC void pcl_json_freepath(pcl_json_path_t *path);
  */
 PCL_PUBLIC pcl_array_t *pcl_json_match(pcl_json_t *j, const pcl_json_path_t *path);
 
+/** Callback invoked by ::pcl_json_visit for each matched value.
+ * @param value pointer to a matched json value. Its reference count is not modified, so it is
+ * only valid while the document being visited is valid.
+ * @param udata user data pointer passed to ::pcl_json_visit
+ * @return true to continue visiting or false to stop
+ */
+typedef bool (*pcl_json_visitor_t)(pcl_json_t *value, void *udata);
+
+/** Visit each JSON value matching a compiled JSON Path.
+ * This is the engine behind ::pcl_json_match, but it does not allocate a result array or modify
+ * reference counts. It is useful when results are consumed immediately or only the first few
+ * matches are needed.
+ * @param j pointer to a json value
+ * @param path a compiled JSON Path
+ * @param visitor callback invoked for each matched value
+ * @param udata user data passed to \a visitor
+ * @return number of values visited or -1 on error
+ */
+PCL_PUBLIC int pcl_json_visit(pcl_json_t *j, const pcl_json_path_t *path,
+	pcl_json_visitor_t visitor, void *udata);
+
 /** Query a json object with a path.
  * Internally, this performs a ::pcl_json_compile followed by ::pcl_json_match. Although this
  * is convenient, if a compiled path is to be used across many documents, it is better to
@@ -56,4 +56,9 @@
 
 #define PCL_MAXNAME 255
 
+/** Maximum number of ::pcl_iovec_t elements transferred per scatter or gather call, IOV_MAX on
+ * linux and darwin.
+ */
+#define PCL_MAXIOV 1024
+
 #endif // LIBPCL_LIMITS_H
@@ -0,0 +1,130 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL_MEMPROF_H
+#define LIBPCL_MEMPROF_H
+
+/** @defgroup memprof Allocation Profiler
+ * Counts allocations by call site, using the location every ::pcl_malloc, ::pcl_zalloc,
+ * ::pcl_realloc and ::pcl_free already carries. Each site records its allocations, frees,
+ * bytes allocated, live bytes and peak live bytes. Allocations at or above a size threshold
+ * also have their call stack sampled.
+ *
+ * The profiler is opt-in and must be enabled before ::pcl_init or any allocation, because
+ * it prefixes every block with a 16 byte header recording its site and size. Counters are
+ * kept per thread and merged into the site every 256 operations or 64K of live bytes, and
+ * when the thread exits. Reports therefore lag other running threads by up to that much. A thread's
+ * high-water mark between merges is carried into the peaks, which are exact for a single
+ * thread and approximate across threads.
+ * #### Basic Usage
+ * @code
+ * int pcl_main(int argc, pchar_t **argv)
+ * {
+ *   // sample stacks of allocations of 1M or more, print leaks when the process exits
+ *   pcl_memprof_enable(1024 * 1024, PCL_MEMPROF_ATEXIT);
+ *   pcl_init();
+ *
+ *   // kill -USR2 <pid> writes the profile
+ *   pcl_memprof_signal(SIGUSR2, _P("/tmp/memprof.json"));
+ *
+ *   return app_start();
+ * }
+ * @endcode
+ * @{
+ */
+
+#include <pcl/types.h>
+#include <stdio.h>
+
+/** Print a leak report to \c stderr when the process exits, see ::pcl_memprof_leaks. */
+#define PCL_MEMPROF_ATEXIT 0x01
+
+/** Maximum number of frames in a sampled stack. */
+#define PCL_MEMPROF_DEPTH 16
+
+/** Number of stacks kept per call site, the most recent replace the oldest. */
+#define PCL_MEMPROF_SAMPLES 4
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Enable the allocation profiler. This must be called before ::pcl_init.
+ * @param stack_threshold allocations of at least this many bytes have their call stack
+ * sampled, 0 disables sampling
+ * @param flags bit mask of \c PCL_MEMPROF_xxx flags
+ * @return 0 on success or -1 on error. Once ::pcl_init has been called this always fails
+ * with \c PCL_EBUSY.
+ */
+PCL_PUBLIC int pcl_memprof_enable(size_t stack_threshold, int flags);
+
+/** Indicates if the allocation profiler is enabled.
+ * @return true if enabled
+ */
+PCL_PUBLIC bool pcl_memprof_enabled(void);
+
+/** Export the profile as JSON. The result is an object with process totals \c allocs,
+ * \c bytes, \c live and \c peak, plus a \c sites array sorted by bytes allocated. Each site
+ * has \c file, \c func, \c line, \c allocs, \c frees, \c bytes, \c live, \c peak and, when
+ * sampled, \c stacks: an array of arrays of frame descriptions.
+ * @return pointer to a json object that must be freed via ::pcl_json_free or \c NULL on
+ * error. Fails with \c PCL_ENOTREADY when the profiler is not enabled.
+ */
+PCL_PUBLIC pcl_json_t *pcl_memprof_json(void);
+
+/** Write the JSON profile to a file.
+ * @param path file path, which is replaced
+ * @return 0 on success or -1 on error
+ * @see pcl_memprof_json
+ */
+PCL_PUBLIC int pcl_memprof_save(const pchar_t *path);
+
+/** Print the call sites that still have live allocations, largest first.
+ * @param stream output stream
+ * @return number of sites with live allocations or -1 on error
+ */
+PCL_PUBLIC int pcl_memprof_leaks(FILE *stream);
+
+/** Write the JSON profile to a file whenever a signal is received. A background thread
+ * does the writing, so the signal handler only wakes it.
+ * @param signum signal number, such as \c SIGUSR2
+ * @param path file path, which is replaced on every signal
+ * @return 0 on success or -1 on error. Fails with \c PCL_ENOTSUP on Windows.
+ */
+PCL_PUBLIC int pcl_memprof_signal(int signum, const pchar_t *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif // LIBPCL_MEMPROF_H
@@ -0,0 +1,189 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL_MEMTAG_H
+#define LIBPCL_MEMTAG_H
+
+/** @defgroup memtag Memory Accounting
+ * Charges memory allocated through ::pcl_malloc, ::pcl_zalloc and ::pcl_realloc to a tag,
+ * and tracks each tag's live and peak bytes. The json, htable, buf, error and ssl modules
+ * tag their own allocations, and applications can register tags of their own.
+ *
+ * A thread's current tag is set with ::pcl_memtag_set. Modules only apply their tag when the
+ * thread has none, so the outermost tag wins: a JSON document decoded while a tenant's tag
+ * is set is charged to the tenant. A block stays charged to the tag it was allocated with,
+ * even when it is resized or freed under another. Untagged memory is not counted. Objects
+ * from a ::pcl_pool are charged when handed out and credited when put back, the slabs they
+ * are carved from are not counted.
+ *
+ * Each tag can have a soft limit. The allocation that takes a tag over its limit still
+ * succeeds, since many callers cannot handle a failed allocation. Instead, ::pcl_memory_error
+ * is called with a type of ::PCL_MEMORY_LIMIT, which the default handler ignores rather
+ * than exiting. Operations that can fail cleanly then refuse to continue: JSON decoding and
+ * buffer growth fail with \c PCL_ENOMEM while the thread's tag is over its limit.
+ *
+ * Accounting is opt-in and must be enabled before ::pcl_init or any allocation, because it
+ * prefixes every block with a 16 byte header recording its tag and size.
+ * #### Basic Usage
+ * @code
+ * static int tenant_tag;
+ *
+ * pcl_json_t *
+ * decode_request(const char *body, size_t len)
+ * {
+ *   int prev = pcl_memtag_set(tenant_tag);
+ *   pcl_json_t *doc = pcl_json_decode(body, len, NULL);
+ *
+ *   pcl_memtag_set(prev);
+ *   return doc; // NULL with PCL_ENOMEM when over the limit
+ * }
+ *
+ * int pcl_main(int argc, pchar_t **argv)
+ * {
+ *   pcl_memtag_enable();
+ *   pcl_init();
+ *
+ *   tenant_tag = pcl_memtag_register("tenant");
+ *   pcl_memtag_limit(tenant_tag, 64 * 1024 * 1024);
+ *   return app_start();
+ * }
+ * @endcode
+ * @{
+ */
+
+#include <pcl/types.h>
+
+/** Untagged memory, which is not counted. */
+#define PCL_MEMTAG_NONE 0
+/** JSON values, decoding and encoding */
+#define PCL_MEMTAG_JSON 1
+/** hash tables and their entries */
+#define PCL_MEMTAG_HTABLE 2
+/** buffers and their data */
+#define PCL_MEMTAG_BUF 3
+/** error contexts and traces */
+#define PCL_MEMTAG_ERROR 4
+/** SSL objects, not including allocations made by OpenSSL itself */
+#define PCL_MEMTAG_SSL 5
+/** First tag returned by ::pcl_memtag_register */
+#define PCL_MEMTAG_USER 6
+/** Maximum number of tags, including the built-in tags */
+#define PCL_MEMTAG_MAX 64
+
+/** Maximum length of a tag name, including the \c NUL */
+#define PCL_MEMTAG_NAMESIZE 32
+
+/** ::pcl_memory_error type used when an allocation takes a tag over its limit. Memory
+ * handlers should compare it with \c strcmp.
+ */
+#define PCL_MEMORY_LIMIT "memory limit"
+
+/** Usage of a tag, see ::pcl_memtag_usage */
+typedef struct
+{
+	/** name of the tag */
+	const char *name;
+
+	/** bytes currently allocated */
+	int64_t live;
+
+	/** highest value of \a live */
+	int64_t peak;
+
+	/** soft limit in bytes, 0 for none */
+	int64_t limit;
+
+	/** number of times an allocation has taken the tag over its limit */
+	int64_t exceeded;
+} pcl_memtag_usage_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Enable memory accounting. This must be called before ::pcl_init.
+ * @return 0 on success or -1 on error. Once ::pcl_init has been called this always fails
+ * with \c PCL_EBUSY.
+ */
+PCL_PUBLIC int pcl_memtag_enable(void);
+
+/** Indicates if memory accounting is enabled.
+ * @return true if enabled
+ */
+PCL_PUBLIC bool pcl_memtag_enabled(void);
+
+/** Register an application tag.
+ * @param name name of the tag, shorter than ::PCL_MEMTAG_NAMESIZE
+ * @return new tag or -1 on error. Fails with \c PCL_ENOSPC once ::PCL_MEMTAG_MAX tags exist.
+ */
+PCL_PUBLIC int pcl_memtag_register(const char *name);
+
+/** Set the calling thread's current tag. Memory allocated by the thread is charged to it.
+ * @param tag tag to set, \c PCL_MEMTAG_NONE to stop charging
+ * @return the previous tag, which can be passed back to restore it, or -1 on error
+ */
+PCL_PUBLIC int pcl_memtag_set(int tag);
+
+/** Get the calling thread's current tag.
+ * @return current tag, \c PCL_MEMTAG_NONE when none is set
+ */
+PCL_PUBLIC int pcl_memtag_get(void);
+
+/** Set the soft limit of a tag. The memory handler is called when an allocation crosses
+ * the limit, so lowering it below the tag's live bytes puts the tag over its limit without
+ * calling the handler.
+ * @param tag tag to limit, which cannot be \c PCL_MEMTAG_NONE
+ * @param limit soft limit in bytes, 0 removes the limit
+ * @return 0 on success or -1 on error. Fails with \c PCL_ENOTREADY when accounting is not
+ * enabled.
+ */
+PCL_PUBLIC int pcl_memtag_limit(int tag, int64_t limit);
+
+/** Get the usage of a tag.
+ * @param tag tag to query
+ * @param usage pointer to a usage object to fill in
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_memtag_usage(int tag, pcl_memtag_usage_t *usage);
+
+/** Indicates if a tag is over its soft limit.
+ * @param tag tag to check
+ * @return true if the tag has a limit and its live bytes exceed it
+ */
+PCL_PUBLIC bool pcl_memtag_exceeded(int tag);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif // LIBPCL_MEMTAG_H
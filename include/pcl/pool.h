@@ -0,0 +1,124 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL_POOL_H
+#define LIBPCL_POOL_H
+
+/** @defgroup pool Object Pool
+ * A slab allocator for fixed-size objects. Objects are carved from 64K slabs and recycled
+ * through a per-thread magazine, so a get or put normally touches no lock and no shared
+ * cache line. Magazines exchange objects with the pool's shared depot in half-magazine
+ * batches, and a thread's magazines return to the depot when it exits. Slabs are only
+ * released by ::pcl_pool_free.
+ *
+ * Objects put by one thread may be got by another; a pool is safe to share between
+ * threads. Magazines require ::pcl_init, before which every call goes to the depot.
+ * #### Basic Usage
+ * @code
+ * static void conn_init(void *obj, void *udata)
+ * {
+ *   conn_t *c = obj;
+ *   c->fd = -1;
+ * }
+ *
+ * pcl_pool_t *conns = pcl_pool_typed(conn_t, PCL_POOL_ZERO, conn_init, NULL);
+ *
+ * conn_t *c = pcl_pool_get(conns); // zeroed, then fd set to -1
+ * // ...
+ * pcl_pool_put(conns, c);
+ * @endcode
+ * @{
+ */
+
+#include <pcl/types.h>
+
+/** Zero objects before they are handed out by ::pcl_pool_get. */
+#define PCL_POOL_ZERO 0x01
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Prototype for a pool object constructor.
+ * @param obj pointer to the object being handed out
+ * @param udata user data given to ::pcl_pool
+ */
+typedef void (*pcl_pool_ctor_t)(void *obj, void *udata);
+
+#ifdef __doxygen__
+	/** Create a pool of objects of a given type.
+	 * @param type object type
+	 * @param flags bit mask of \c PCL_POOL_xxx flags
+	 * @param ctor optional constructor
+	 * @param udata user data passed to \a ctor
+	 * @return pointer to a new pool
+	 * @note implemented as a macro
+	 */
+	pcl_pool_t *pcl_pool_typed(type, int flags, pcl_pool_ctor_t ctor, void *udata);
+#else
+#	define pcl_pool_typed(type, flags, ctor, udata) pcl_pool(sizeof(type), flags, ctor, udata)
+#endif
+
+/** Create a pool.
+ * @param objsize size of each object in bytes, rounded up to a multiple of 16
+ * @param flags bit mask of \c PCL_POOL_xxx flags
+ * @param ctor optional constructor called on every object ::pcl_pool_get hands out, after
+ * it has been zeroed when ::PCL_POOL_ZERO is set
+ * @param udata user data passed to \a ctor
+ * @return pointer to a new pool that must be freed via ::pcl_pool_free or \c NULL on error
+ */
+PCL_PUBLIC pcl_pool_t *pcl_pool(size_t objsize, int flags, pcl_pool_ctor_t ctor, void *udata);
+
+/** Get an object from a pool.
+ * @param p pointer to a pool
+ * @return pointer to an object or \c NULL on error
+ */
+PCL_PUBLIC void *pcl_pool_get(pcl_pool_t *p);
+
+/** Return an object to a pool.
+ * @param p pointer to the pool \a obj was got from
+ * @param obj pointer to an object, can be \c NULL
+ */
+PCL_PUBLIC void pcl_pool_put(pcl_pool_t *p, void *obj);
+
+/** Release all resources used by a pool, including every object. No other thread may be
+ * using the pool.
+ * @param p pointer to a pool, can be \c NULL
+ */
+PCL_PUBLIC void pcl_pool_free(pcl_pool_t *p);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif // LIBPCL_POOL_H
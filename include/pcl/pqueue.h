@@ -0,0 +1,132 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL_PQUEUE_H
+#define LIBPCL_PQUEUE_H
+
+/** @defgroup pqueue Priority Queue
+ * A min-heap of items ordered by an integer key, the smallest key being the head. The heap is
+ * d-ary with keys stored inline next to their items, so sifting compares adjacent memory
+ * rather than chasing item pointers. Adding an item returns a handle that can be used to
+ * change its key (decrease-key) or remove it in O(log n).
+ *
+ * Items with equal keys are removed in an unspecified order.
+ * @{
+ */
+
+#include <pcl/types.h>
+
+/** Default number of children per heap node. */
+#define PCL_PQUEUE_ARITY 4
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Create a priority queue.
+ * @param arity number of children per heap node, between 2 and 16. Zero uses
+ * ::PCL_PQUEUE_ARITY.
+ * @param cleanup optional cleanup handler for queue items
+ * @return pointer to a new priority queue that must be freed via ::pcl_pqueue_free or \c NULL
+ * on error
+ */
+PCL_PUBLIC pcl_pqueue_t *pcl_pqueue(int arity, pcl_cleanup_t cleanup);
+
+/** Get the number of items in a priority queue.
+ * @param pq pointer to a priority queue
+ * @return number of items
+ */
+PCL_PUBLIC int pcl_pqueue_size(pcl_pqueue_t *pq);
+
+/** Indicates if a priority queue is empty.
+ * @param pq pointer to a priority queue
+ * @return true if empty and false otherwise
+ */
+PCL_PUBLIC bool pcl_pqueue_empty(pcl_pqueue_t *pq);
+
+/** Add an item.
+ * @param pq pointer to a priority queue
+ * @param key priority of the item, smaller keys are removed first
+ * @param item pointer to an item. To avoid ambiguity, do not add \c NULL items.
+ * @return handle for ::pcl_pqueue_update and ::pcl_pqueue_remove or -1 on error. A handle is
+ * valid until its item leaves the queue, after which it may be reused.
+ */
+PCL_PUBLIC int pcl_pqueue_push(pcl_pqueue_t *pq, int64_t key, void *item);
+
+/** Retrieve the item with the smallest key without removing it.
+ * @param pq pointer to a priority queue
+ * @param key optional pointer to receive the item's key
+ * @return pointer to an item or \c NULL if the queue is empty
+ */
+PCL_PUBLIC void *pcl_pqueue_peek(pcl_pqueue_t *pq, int64_t *key);
+
+/** Remove the item with the smallest key.
+ * @note caller repsonsible for releasing any resources used by returned item
+ * @param pq pointer to a priority queue
+ * @param key optional pointer to receive the item's key
+ * @return pointer to an item or \c NULL if the queue is empty
+ */
+PCL_PUBLIC void *pcl_pqueue_pop(pcl_pqueue_t *pq, int64_t *key);
+
+/** Change the key of an item. Decreasing a key moves the item towards the head and increasing
+ * it moves the item away.
+ * @param pq pointer to a priority queue
+ * @param handle item handle returned by ::pcl_pqueue_push
+ * @param key new key
+ * @return 0 for success and -1 on error
+ */
+PCL_PUBLIC int pcl_pqueue_update(pcl_pqueue_t *pq, int handle, int64_t key);
+
+/** Remove an item by handle.
+ * @note caller repsonsible for releasing any resources used by returned item
+ * @param pq pointer to a priority queue
+ * @param handle item handle returned by ::pcl_pqueue_push
+ * @return pointer to the removed item or \c NULL on error
+ */
+PCL_PUBLIC void *pcl_pqueue_remove(pcl_pqueue_t *pq, int handle);
+
+/** Remove all items, calling the cleanup handler for each. All handles are invalidated.
+ * @param pq pointer to a priority queue
+ */
+PCL_PUBLIC void pcl_pqueue_clear(pcl_pqueue_t *pq);
+
+/** Clear and free a priority queue.
+ * @param pq pointer to a priority queue
+ */
+PCL_PUBLIC void pcl_pqueue_free(pcl_pqueue_t *pq);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif // LIBPCL_PQUEUE_H
@@ -49,6 +49,15 @@ extern "C" {
  */
 PCL_PUBLIC pcl_queue_t *pcl_queue(pcl_cleanup_t cleanup);
 
+/** Create a queue object with room for \a capacity items. Items are stored in chunks of 64,
+ * the chunks for \a capacity items are allocated up front and kept for reuse as the queue
+ * drains. Without a capacity hint, only a couple of empty chunks are kept.
+ * @param capacity expected number of items, a hint rather than a limit
+ * @param cleanup optional cleanup handler for queue items
+ * @return pointer to a new queue object that must be freed via ::pcl_queue_free
+ */
+PCL_PUBLIC pcl_queue_t *pcl_queue_sized(int capacity, pcl_cleanup_t cleanup);
+
 /** Get the size (number of items) of a queue.
  * @param q pointer to a queue object
  * @return number of items in the queue
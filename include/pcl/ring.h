@@ -0,0 +1,136 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL_RING_H
+#define LIBPCL_RING_H
+
+/** @defgroup ring Ring Buffer
+ * Bounded lock-free queues of pointers. A ring is either single-producer/single-consumer,
+ * which is wait-free, or multi-producer/multi-consumer using Dmitry Vyukov's bounded queue.
+ * Head and tail indices live on separate cache lines and items can be moved in batches.
+ *
+ * By default all operations are non-blocking. Rings created with ::PCL_RING_BLOCKING also
+ * support ::pcl_ring_put and ::pcl_ring_take, which wait on a condition variable when the
+ * ring is full or empty. Waiting costs nothing when no thread is blocked.
+ * @{
+ */
+
+#include <pcl/types.h>
+
+/** Ring flag: one producer thread and one consumer thread. This is the default. */
+#define PCL_RING_SPSC 0x00
+
+/** Ring flag: any number of producer and consumer threads. */
+#define PCL_RING_MPMC 0x01
+
+/** Ring flag: enable ::pcl_ring_put, ::pcl_ring_take and ::pcl_ring_close. */
+#define PCL_RING_BLOCKING 0x02
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Create a ring.
+ * @param capacity number of items, rounded up to a power of 2
+ * @param flags bitmask of \c PCL_RING_xxx flags
+ * @return pointer to a new ring that must be freed via ::pcl_ring_free or \c NULL on error
+ */
+PCL_PUBLIC pcl_ring_t *pcl_ring(size_t capacity, int flags);
+
+/** Add an item without blocking.
+ * @param r pointer to a ring
+ * @param item pointer to an item, \c NULL is not allowed
+ * @return true if the item was added and false if the ring is full
+ */
+PCL_PUBLIC bool pcl_ring_push(pcl_ring_t *r, void *item);
+
+/** Remove an item without blocking.
+ * @param r pointer to a ring
+ * @return pointer to an item or \c NULL if the ring is empty
+ */
+PCL_PUBLIC void *pcl_ring_pop(pcl_ring_t *r);
+
+/** Add up to \a count items without blocking. Items are added in order and with a single
+ * publish for SPSC rings.
+ * @param r pointer to a ring
+ * @param items array of non-NULL items
+ * @param count number of items
+ * @return number of items added, which is less than \a count when the ring fills up, or -1
+ * on error
+ */
+PCL_PUBLIC int pcl_ring_pushv(pcl_ring_t *r, void *const *items, int count);
+
+/** Remove up to \a max items without blocking.
+ * @param r pointer to a ring
+ * @param items array that receives items
+ * @param max number of elements in \a items
+ * @return number of items removed or -1 on error
+ */
+PCL_PUBLIC int pcl_ring_popv(pcl_ring_t *r, void **items, int max);
+
+/** Add an item, waiting while the ring is full. Requires ::PCL_RING_BLOCKING.
+ * @param r pointer to a ring
+ * @param item pointer to an item, \c NULL is not allowed
+ * @return 0 on success or -1 on error. ::PCL_EPIPE when the ring is closed.
+ */
+PCL_PUBLIC int pcl_ring_put(pcl_ring_t *r, void *item);
+
+/** Remove an item, waiting while the ring is empty. Requires ::PCL_RING_BLOCKING.
+ * @param r pointer to a ring
+ * @return pointer to an item or \c NULL once the ring is closed and empty, or on error
+ */
+PCL_PUBLIC void *pcl_ring_take(pcl_ring_t *r);
+
+/** Close a blocking ring, waking all waiting threads. Items already in the ring can still be
+ * taken, further puts fail.
+ * @param r pointer to a ring
+ */
+PCL_PUBLIC void pcl_ring_close(pcl_ring_t *r);
+
+/** Get the number of items in a ring. With concurrent producers or consumers, this is only
+ * a snapshot.
+ * @param r pointer to a ring
+ * @return number of items
+ */
+PCL_PUBLIC size_t pcl_ring_size(pcl_ring_t *r);
+
+/** Release all resources used by a ring. Items still in the ring are not freed.
+ * @param r pointer to a ring, can be \c NULL
+ */
+PCL_PUBLIC void pcl_ring_free(pcl_ring_t *r);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif // LIBPCL_RING_H
@@ -0,0 +1,156 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL_ROPE_H
+#define LIBPCL_ROPE_H
+
+/** @defgroup rope Rope
+ * A segmented byte buffer. Unlike a ::pcl_buf_t, a rope never reallocates: copied data fills
+ * fixed-size segments and caller-owned memory is linked in without copying. A rope is written
+ * with one gather call via ::pcl_rope_send or ::pcl_rope_write.
+ * @{
+ */
+
+#include <pcl/types.h>
+
+/** Default size of the segments a rope allocates for copied data. */
+#define PCL_ROPE_SEGSIZE 4096
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Create a rope.
+ * @param segsize size of the segments used for copied data, 0 for ::PCL_ROPE_SEGSIZE
+ * @return pointer to a new rope that must be freed via ::pcl_rope_free
+ */
+PCL_PUBLIC pcl_rope_t *pcl_rope(size_t segsize);
+
+/** Get the number of bytes in a rope.
+ * @param r pointer to a rope
+ * @return number of bytes
+ */
+PCL_PUBLIC size_t pcl_rope_len(const pcl_rope_t *r);
+
+/** Copy data to the end of a rope. This fills the free space of the last segment before
+ * allocating new ones.
+ * @param r pointer to a rope
+ * @param data pointer to the data
+ * @param len number of bytes
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_rope_append(pcl_rope_t *r, const void *data, size_t len);
+
+/** Copy data to the beginning of a rope.
+ * @param r pointer to a rope
+ * @param data pointer to the data
+ * @param len number of bytes
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_rope_prepend(pcl_rope_t *r, const void *data, size_t len);
+
+/** Link caller-owned memory to the end of a rope without copying it.
+ * @param r pointer to a rope
+ * @param data pointer to the data, which must remain valid until it is consumed or the rope
+ * is cleared
+ * @param len number of bytes
+ * @param release optional handler called with \a data once the rope no longer references it
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_rope_appendref(pcl_rope_t *r, const void *data, size_t len,
+	pcl_cleanup_t release);
+
+/** Link caller-owned memory to the beginning of a rope without copying it.
+ * @param r pointer to a rope
+ * @param data pointer to the data, which must remain valid until it is consumed or the rope
+ * is cleared
+ * @param len number of bytes
+ * @param release optional handler called with \a data once the rope no longer references it
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_rope_prependref(pcl_rope_t *r, const void *data, size_t len,
+	pcl_cleanup_t release);
+
+/** Describe the leading segments of a rope as an I/O vector.
+ * @param r pointer to a rope
+ * @param iov array to receive the segments
+ * @param max number of elements in \a iov
+ * @return number of elements set
+ */
+PCL_PUBLIC int pcl_rope_iov(const pcl_rope_t *r, pcl_iovec_t *iov, int max);
+
+/** Remove bytes from the beginning of a rope, typically after a partial write.
+ * @param r pointer to a rope
+ * @param len number of bytes to remove, anything beyond the rope's length is ignored
+ */
+PCL_PUBLIC void pcl_rope_consume(pcl_rope_t *r, size_t len);
+
+/** Copy bytes from the beginning of a rope without removing them.
+ * @param r pointer to a rope
+ * @param buf destination buffer
+ * @param size size of \a buf in bytes
+ * @return number of bytes copied
+ */
+PCL_PUBLIC size_t pcl_rope_copy(const pcl_rope_t *r, void *buf, size_t size);
+
+/** Send a rope with gather sends via ::pcl_sendv, consuming what was sent. This returns when
+ * the rope is empty or a send fails, so a non-blocking socket returns with ::PCL_EAGAIN and
+ * the unsent remainder still in the rope.
+ * @param r pointer to a rope
+ * @param sock pointer to a socket
+ * @return 0 when the rope was sent in full or -1 on error
+ */
+PCL_PUBLIC int pcl_rope_send(pcl_rope_t *r, pcl_socket_t *sock);
+
+/** Write a rope with gather writes via ::pcl_file_writev, consuming what was written.
+ * @param r pointer to a rope
+ * @param file pointer to a file object
+ * @return 0 when the rope was written in full or -1 on error
+ */
+PCL_PUBLIC int pcl_rope_write(pcl_rope_t *r, pcl_file_t *file);
+
+/** Remove all data from a rope, calling the release handlers of borrowed segments.
+ * @param r pointer to a rope
+ */
+PCL_PUBLIC void pcl_rope_clear(pcl_rope_t *r);
+
+/** Release all resources used by a rope.
+ * @param r pointer to a rope, can be \c NULL
+ */
+PCL_PUBLIC void pcl_rope_free(pcl_rope_t *r);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif // LIBPCL_ROPE_H
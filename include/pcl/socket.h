@@ -118,6 +118,12 @@ pcl_send(pcl_socket_t *sock, const void *data, size_t count, int flags);
 PCL_PUBLIC bool
 pcl_sendall(pcl_socket_t *sock, const void *data, size_t count);
 
+/* Gather send: sendmsg on unix and WSASend on windows. Like pcl_send, this can send fewer
+ * bytes than requested. At most PCL_MAXIOV elements are sent per call.
+ */
+PCL_PUBLIC ssize_t
+pcl_sendv(pcl_socket_t *sock, const pcl_iovec_t *iov, int iovcnt, int flags);
+
 /* For AF_UNIX, this will automatically unlink the sun_path before attempting
  * to bind the address.
  */
@@ -45,6 +45,15 @@ extern "C" {
  */
 PCL_PUBLIC pcl_stack_t *pcl_stack(pcl_cleanup_t cleanup);
 
+/** Create a stack object with room for \a capacity items. Items are stored in chunks of 64,
+ * the chunks for \a capacity items are allocated up front and kept for reuse as the stack
+ * shrinks. Without a capacity hint, only a couple of empty chunks are kept.
+ * @param capacity expected number of items, a hint rather than a limit
+ * @param cleanup optional item cleanup handler
+ * @return pointer to a stack object or \c NULL on error
+ */
+PCL_PUBLIC pcl_stack_t *pcl_stack_sized(int capacity, pcl_cleanup_t cleanup);
+
 /** Get the size (number of items) of a stack object.
  * @param s pointer to a stack object
  * @return number of stack items
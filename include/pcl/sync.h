@@ -0,0 +1,250 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL_SYNC_H
+#define LIBPCL_SYNC_H
+
+/** @defgroup sync Synchronization
+ * Adaptive locks, reader-writer locks, condition variables and barriers. All of them are
+ * plain structures that can be embedded or statically initialized and need no destroy call.
+ *
+ * Contended operations spin for a short while before parking the thread in the kernel:
+ * a futex on Linux, \c WaitOnAddress on Windows and a hashed table of condition variables
+ * elsewhere. A lock learns how long it is typically held and adjusts its spin limit, and
+ * never spins on single processor machines.
+ *
+ * Every primitive takes an optional ::pcl_syncstats_t that receives contention counters.
+ * Several primitives may share one stats structure. Counting is skipped when it is \c NULL.
+ * @{
+ */
+
+#include <pcl/types.h>
+
+/** Reader-writer lock policy: new readers wait behind waiting writers. This is the default. */
+#define PCL_RWLOCK_PREFER_WRITER 0
+
+/** Reader-writer lock policy: readers enter whenever no writer holds the lock. Writers can
+ * starve under a steady stream of readers.
+ */
+#define PCL_RWLOCK_PREFER_READER 1
+
+/** Returned by ::pcl_barrier_wait to exactly one thread per barrier cycle. */
+#define PCL_BARRIER_SERIAL 1
+
+/** Static initializer for a ::pcl_lock_t without stats. */
+#define PCL_LOCK_INITIALIZER {0, 0, NULL}
+
+/** Static initializer for a writer preferring ::pcl_rwlock_t without stats. */
+#define PCL_RWLOCK_INITIALIZER {0, 0, 0, 0, PCL_RWLOCK_PREFER_WRITER, NULL}
+
+/** Static initializer for a ::pcl_cond_t without stats. */
+#define PCL_COND_INITIALIZER {0, 0, NULL}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Contention counters. All fields are updated with relaxed atomics. */
+typedef struct
+{
+	int64_t acquisitions; /**< locks acquired, condition waits or barrier arrivals */
+	int64_t contended;    /**< acquisitions that could not take the fast path */
+	int64_t spins;        /**< spin iterations spent before acquiring or parking */
+	int64_t parks;        /**< times a thread was parked in the kernel */
+	int64_t wait_time;    /**< nanoseconds spent in contended acquisitions and waits */
+} pcl_syncstats_t;
+
+/** Adaptive mutual exclusion lock. Not recursive. */
+struct tag_pcl_lock
+{
+	int32_t state;          /* 0 unlocked, 1 locked, 2 locked with parked waiters */
+	int32_t spin;           /* running average of spins needed to acquire */
+	pcl_syncstats_t *stats;
+};
+
+/** Reader-writer lock. */
+struct tag_pcl_rwlock
+{
+	int64_t state;          /* reader count, writer bit and waiting writer count */
+	int32_t rseq;           /* readers park on this */
+	int32_t wseq;           /* writers park on this */
+	int32_t rwaiters;       /* number of parked or parking readers */
+	int32_t policy;
+	pcl_syncstats_t *stats;
+};
+
+/** Condition variable used together with a ::pcl_lock_t. */
+struct tag_pcl_cond
+{
+	int32_t seq;
+	int32_t waiters;
+	pcl_syncstats_t *stats;
+};
+
+/** Barrier for a fixed number of threads. Reusable once all threads have passed. */
+struct tag_pcl_barrier
+{
+	int32_t count;
+	int32_t arrived;
+	int32_t gen;
+	pcl_syncstats_t *stats;
+};
+
+/** Initialize a lock.
+ * @param l pointer to a lock
+ * @param stats optional pointer to contention counters, can be \c NULL
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_lock_init(pcl_lock_t *l, pcl_syncstats_t *stats);
+
+/** Acquire a lock, spinning and then parking while it is held by another thread.
+ * @param l pointer to a lock
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_lock_acquire(pcl_lock_t *l);
+
+/** Acquire a lock without waiting.
+ * @param l pointer to a lock
+ * @return true if the lock was acquired and false if it is held or \a l is \c NULL
+ */
+PCL_PUBLIC bool pcl_lock_try(pcl_lock_t *l);
+
+/** Release a lock held by the calling thread.
+ * @param l pointer to a lock
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_lock_release(pcl_lock_t *l);
+
+/** Initialize a reader-writer lock.
+ * @param rw pointer to a reader-writer lock
+ * @param policy ::PCL_RWLOCK_PREFER_WRITER or ::PCL_RWLOCK_PREFER_READER
+ * @param stats optional pointer to contention counters, can be \c NULL
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_rwlock_init(pcl_rwlock_t *rw, int policy, pcl_syncstats_t *stats);
+
+/** Acquire shared access. Readers only touch the lock word, so they never block each
+ * other.
+ * @param rw pointer to a reader-writer lock
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_rwlock_rdlock(pcl_rwlock_t *rw);
+
+/** Acquire shared access without waiting.
+ * @param rw pointer to a reader-writer lock
+ * @return true if shared access was acquired
+ */
+PCL_PUBLIC bool pcl_rwlock_tryrdlock(pcl_rwlock_t *rw);
+
+/** Release shared access.
+ * @param rw pointer to a reader-writer lock
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_rwlock_rdunlock(pcl_rwlock_t *rw);
+
+/** Acquire exclusive access.
+ * @param rw pointer to a reader-writer lock
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_rwlock_wrlock(pcl_rwlock_t *rw);
+
+/** Acquire exclusive access without waiting.
+ * @param rw pointer to a reader-writer lock
+ * @return true if exclusive access was acquired
+ */
+PCL_PUBLIC bool pcl_rwlock_trywrlock(pcl_rwlock_t *rw);
+
+/** Release exclusive access.
+ * @param rw pointer to a reader-writer lock
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_rwlock_wrunlock(pcl_rwlock_t *rw);
+
+/** Initialize a condition variable.
+ * @param c pointer to a condition variable
+ * @param stats optional pointer to counters, can be \c NULL
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_cond_init(pcl_cond_t *c, pcl_syncstats_t *stats);
+
+/** Release a lock, wait for a signal and reacquire the lock. Like any condition variable,
+ * this can return without a signal so the caller must recheck its predicate.
+ * @param c pointer to a condition variable
+ * @param l pointer to a lock held by the calling thread
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_cond_wait(pcl_cond_t *c, pcl_lock_t *l);
+
+/** Same as ::pcl_cond_wait but gives up after a timeout measured with ::pcl_clock, so wall
+ * clock changes have no effect.
+ * @param c pointer to a condition variable
+ * @param l pointer to a lock held by the calling thread
+ * @param timeout relative timeout in nanoseconds
+ * @return 0 on success or -1 on error. ::PCL_ETIMEOUT when the timeout expired, in which
+ * case the lock is still reacquired.
+ */
+PCL_PUBLIC int pcl_cond_timedwait(pcl_cond_t *c, pcl_lock_t *l, pcl_clock_t timeout);
+
+/** Wake at least one thread waiting on a condition variable. Costs nothing when no thread
+ * is waiting.
+ * @param c pointer to a condition variable
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_cond_signal(pcl_cond_t *c);
+
+/** Wake all threads waiting on a condition variable.
+ * @param c pointer to a condition variable
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_cond_broadcast(pcl_cond_t *c);
+
+/** Initialize a barrier.
+ * @param b pointer to a barrier
+ * @param count number of threads that must call ::pcl_barrier_wait, at least 1
+ * @param stats optional pointer to counters, can be \c NULL
+ * @return 0 on success or -1 on error
+ */
+PCL_PUBLIC int pcl_barrier_init(pcl_barrier_t *b, int count, pcl_syncstats_t *stats);
+
+/** Wait until \a count threads have reached the barrier.
+ * @param b pointer to a barrier
+ * @return ::PCL_BARRIER_SERIAL for the last thread to arrive, 0 for the others and -1 on
+ * error
+ */
+PCL_PUBLIC int pcl_barrier_wait(pcl_barrier_t *b);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif // LIBPCL_SYNC_H
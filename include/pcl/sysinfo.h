@@ -36,6 +36,10 @@
 #include <pcl/limits.h>
 #include <pcl/types.h>
 
+#ifdef PCL_WINDOWS
+#	include <intrin.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -48,10 +52,37 @@ typedef enum
 	PclLanGrpDomain
 } pcl_langrp_t;
 
+/** Largest logical CPU number + 1 that a ::pcl_cpuset_t can hold. */
+#define PCL_CPUSET_SIZE 1024
+
+/** A set of logical CPUs, as used for thread affinity. */
+typedef struct
+{
+	uint64_t bits[PCL_CPUSET_SIZE / 64];
+} pcl_cpuset_t;
+
+/** Placement of one logical CPU, see ::pcl_sysinfo_cpus. */
+typedef struct
+{
+	int cpu;              /* logical CPU number, as used in a pcl_cpuset_t */
+	int socket;           /* physical package id */
+	int core;             /* core id, only unique within a socket */
+	int thread;           /* SMT sibling index within the core, 0 for the first */
+	int node;             /* NUMA node, 0 on uniform memory machines */
+} pcl_cpu_t;
+
 typedef struct
 {
 	int cpu_sockets;      /* number of physical processors (sockets) */
 	int cpu_cores;        /* number of logical processors (cores/threads) */
+	int cpu_physical;     /* number of physical cores across all sockets */
+	int cpu_smt;          /* maximum hardware threads per physical core, 1 without SMT */
+	int numa_nodes;       /* number of NUMA nodes, 1 on uniform memory machines */
+	int cache_line;       /* cache line size in bytes */
+	uint64_t cache_l1d;   /* L1 data cache size in bytes, per core */
+	uint64_t cache_l1i;   /* L1 instruction cache size in bytes, per core */
+	uint64_t cache_l2;    /* L2 cache size in bytes, per instance */
+	uint64_t cache_l3;    /* L3 cache size in bytes, per instance (usually per socket) */
 	char cpu_model[100];  /* Intel(R) Core(TM) i7-3720QM CPU @ 2.60GHz */
 	long gmtoff;
 	char tzabbr[80];
@@ -68,6 +99,68 @@ typedef struct
 
 PCL_PUBLIC void pcl_sysinfo(pcl_sysinfo_t *info);
 
+/** Get the placement of every online logical CPU, ordered by CPU number. On Linux this is
+ * read from /sys/devices/system.
+ * @param cpus output array, can be \c NULL when \a max is 0
+ * @param max number of elements in \a cpus
+ * @return number of online CPUs, which can be more than \a max, or -1 on error
+ */
+PCL_PUBLIC int pcl_sysinfo_cpus(pcl_cpu_t *cpus, int max);
+
+/** Get the logical CPUs of a NUMA node.
+ * @param node NUMA node number
+ * @param set output set of CPUs
+ * @return 0 on success or -1 on error. ::PCL_ENOTFOUND if the node does not exist.
+ */
+PCL_PUBLIC int pcl_sysinfo_nodecpus(int node, pcl_cpuset_t *set);
+
+/** Remove all CPUs from a set. */
+PCL_INLINE void
+pcl_cpuset_zero(pcl_cpuset_t *set)
+{
+	for(int i = 0; i < PCL_CPUSET_SIZE / 64; i++)
+		set->bits[i] = 0;
+}
+
+/** Add a CPU to a set, out of range CPUs are ignored. */
+PCL_INLINE void
+pcl_cpuset_add(pcl_cpuset_t *set, int cpu)
+{
+	if(cpu >= 0 && cpu < PCL_CPUSET_SIZE)
+		set->bits[cpu / 64] |= 1ULL << (cpu % 64);
+}
+
+/** Remove a CPU from a set. */
+PCL_INLINE void
+pcl_cpuset_remove(pcl_cpuset_t *set, int cpu)
+{
+	if(cpu >= 0 && cpu < PCL_CPUSET_SIZE)
+		set->bits[cpu / 64] &= ~(1ULL << (cpu % 64));
+}
+
+/** Check if a set contains a CPU. */
+PCL_INLINE bool
+pcl_cpuset_has(const pcl_cpuset_t *set, int cpu)
+{
+	return cpu >= 0 && cpu < PCL_CPUSET_SIZE && (set->bits[cpu / 64] >> (cpu % 64)) & 1;
+}
+
+/** Get the number of CPUs in a set. */
+PCL_INLINE int
+pcl_cpuset_count(const pcl_cpuset_t *set)
+{
+	int n = 0;
+
+	for(int i = 0; i < PCL_CPUSET_SIZE / 64; i++)
+#ifdef PCL_WINDOWS
+		n += (int) __popcnt64(set->bits[i]);
+#else
+		n += __builtin_popcountll(set->bits[i]);
+#endif
+
+	return n;
+}
+
 #ifdef __cplusplus
 }
 #endif
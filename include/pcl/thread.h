@@ -34,18 +34,52 @@
 #define LIBPCL_THREAD_H
 
 #include <pcl/types.h>
+#include <pcl/sysinfo.h>
 #define _TIMESPEC_DEFINED
 #include <pthread.h>
 
+/* scheduling policies for pcl_thread_attr_t.policy and pcl_thread_setpriority */
+#define PCL_THREAD_SCHED_DEFAULT -1 /* inherit from the creating thread, priority is ignored */
+#define PCL_THREAD_SCHED_OTHER 0    /* time sharing, priority is a nice value: -20 to 19 */
+#define PCL_THREAD_SCHED_FIFO 1     /* realtime first in, first out: priority 1 to 99 */
+#define PCL_THREAD_SCHED_RR 2       /* realtime round robin: priority 1 to 99 */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 typedef void (*pcl_thread_start_t)(void *);
 
+/* Extended thread attributes, initialize with pcl_thread_attr_init. Name, affinity, NUMA
+ * node and priority are applied by the new thread itself, before its routine is called.
+ */
+typedef struct
+{
+	size_t stack_size;            /* 0 for the system default */
+	const char *name;             /* NULL for none, Linux truncates it to 15 characters */
+	const pcl_cpuset_t *affinity; /* CPUs the thread may run on, NULL for any */
+	int numa_node;                /* -1 for none, else run on the node's CPUs and prefer its memory */
+	int policy;                   /* PCL_THREAD_SCHED_xxx */
+	int priority;                 /* meaning depends on policy */
+	bool joinable;                /* create a joinable thread rather than a detached one */
+} pcl_thread_attr_t;
+
 PCL_PUBLIC int pcl_thread(pthread_t *t, pcl_thread_start_t routine, void *a);
 PCL_PUBLIC uint64_t pcl_thread_id(void);
 
+/* extended thread creation: returns 0 or -1. When attributes cannot be applied, the new
+ * thread exits without running routine and the error is returned here.
+ */
+PCL_PUBLIC void pcl_thread_attr_init(pcl_thread_attr_t *attr);
+PCL_PUBLIC int pcl_thread_ex(pthread_t *t, const pcl_thread_attr_t *attr,
+	pcl_thread_start_t routine, void *a);
+
+/* calling thread settings: return 0 or -1, PCL_ENOTSUP where the platform lacks support */
+PCL_PUBLIC int pcl_thread_setname(const char *name);
+PCL_PUBLIC int pcl_thread_setaffinity(const pcl_cpuset_t *set);
+PCL_PUBLIC int pcl_thread_setnode(int node);
+PCL_PUBLIC int pcl_thread_setpriority(int policy, int priority);
+
 /* mutex support */
 PCL_PUBLIC int pcl_mutex_init(pthread_mutex_t *m);
 PCL_PUBLIC int pcl_mutex_lock(pthread_mutex_t *m);
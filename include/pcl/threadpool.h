@@ -0,0 +1,148 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL_THREADPOOL_H
+#define LIBPCL_THREADPOOL_H
+
+/** @defgroup threadpool Thread Pool
+ * A fixed set of worker threads running short tasks. Each worker owns a Chase-Lev deque: tasks
+ * submitted by a worker go to the bottom of its own deque and idle workers steal from the top
+ * of others. Tasks submitted by other threads go through a shared queue.
+ *
+ * Worker threads dispatch ::PCL_EVENT_THREADINIT when they start, just like ::pcl_thread.
+ *
+ * Waiting on a future or running ::pcl_threadpool_for from within a task is allowed. The
+ * waiting worker runs other tasks until the wait is over instead of blocking.
+ * @{
+ */
+
+#include <pcl/types.h>
+#include <pcl/thread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Task prototype for tasks with a result.
+ * @param arg user argument
+ * @return result made available through ::pcl_future_wait
+ */
+typedef void *(*pcl_task_t)(void *arg);
+
+/** Range body prototype for ::pcl_threadpool_for.
+ * @param begin first index of the chunk
+ * @param end index past the last one of the chunk
+ * @param arg user argument
+ */
+typedef void (*pcl_threadpool_range_t)(size_t begin, size_t end, void *arg);
+
+/** Create a thread pool and start its workers.
+ * @param nthreads number of worker threads, zero uses one per logical processor
+ * @return pointer to a thread pool that must be freed via ::pcl_threadpool_free or \c NULL on
+ * error
+ */
+PCL_PUBLIC pcl_threadpool_t *pcl_threadpool(int nthreads);
+
+/** Get the number of worker threads.
+ * @param tp pointer to a thread pool
+ * @return number of workers
+ */
+PCL_PUBLIC int pcl_threadpool_size(pcl_threadpool_t *tp);
+
+/** Run a task without a result.
+ * @param tp pointer to a thread pool
+ * @param routine task function
+ * @param arg argument passed to \a routine
+ * @return 0 for success and -1 on error
+ */
+PCL_PUBLIC int pcl_threadpool_submit(pcl_threadpool_t *tp, pcl_thread_start_t routine, void *arg);
+
+/** Run a task and get a future for its result.
+ * @param tp pointer to a thread pool
+ * @param task task function
+ * @param arg argument passed to \a task
+ * @return pointer to a future that must be freed via ::pcl_future_free or \c NULL on error
+ */
+PCL_PUBLIC pcl_future_t *pcl_threadpool_async(pcl_threadpool_t *tp, pcl_task_t task, void *arg);
+
+/** Call \a body over the range [\a begin, \a end) split into chunks, in parallel. The calling
+ * thread takes part and the function returns once every chunk is done.
+ * @param tp pointer to a thread pool
+ * @param begin first index
+ * @param end index past the last one
+ * @param grain indexes per chunk, zero picks about four chunks per worker
+ * @param body function called for each chunk
+ * @param arg argument passed to \a body
+ * @return 0 for success and -1 on error
+ */
+PCL_PUBLIC int pcl_threadpool_for(pcl_threadpool_t *tp, size_t begin, size_t end, size_t grain,
+	pcl_threadpool_range_t body, void *arg);
+
+/** Wait until every submitted task has completed. This cannot be called from a task.
+ * @param tp pointer to a thread pool
+ * @return 0 for success and -1 on error
+ */
+PCL_PUBLIC int pcl_threadpool_wait(pcl_threadpool_t *tp);
+
+/** Shut down a thread pool. Tasks already submitted are run, then the workers are joined.
+ * Submitting tasks from outside the pool during shutdown is not allowed. This cannot be called
+ * from a task.
+ * @param tp pointer to a thread pool, can be \c NULL
+ * @return 0 for success and -1 on error. ::PCL_EDEADLK when called from one of its tasks.
+ */
+PCL_PUBLIC int pcl_threadpool_free(pcl_threadpool_t *tp);
+
+/** Wait for a task to complete. Futures of tasks run during ::pcl_threadpool_free can still be
+ * waited on after the pool is freed, but a future must not outlive its pool while its task is
+ * pending.
+ * @param f pointer to a future
+ * @return the task's result
+ */
+PCL_PUBLIC void *pcl_future_wait(pcl_future_t *f);
+
+/** Indicates if a task has completed.
+ * @param f pointer to a future
+ * @return true if the task has completed and false otherwise
+ */
+PCL_PUBLIC bool pcl_future_done(pcl_future_t *f);
+
+/** Free a future. This does not wait for the task, which still runs to completion.
+ * @param f pointer to a future
+ */
+PCL_PUBLIC void pcl_future_free(pcl_future_t *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif // LIBPCL_THREADPOOL_H
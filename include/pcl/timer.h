@@ -0,0 +1,130 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL_TIMER_H
+#define LIBPCL_TIMER_H
+
+/** @defgroup timer Timer Wheel
+ * A hierarchical timing wheel for large numbers of timeouts, such as connection idle timeouts
+ * and retry schedules. Adding, resetting and cancelling a timer are O(1). Time is measured
+ * with ::pcl_clock and rounded up to the wheel's resolution, so a timer never fires early and
+ * at most one tick late, given ::pcl_timerwheel_run is called often enough.
+ *
+ * The wheel has four levels: 256 slots of one tick each, followed by three levels of 64
+ * slots covering 2^26 ticks (about 18 hours at the default resolution). Longer timeouts are
+ * parked in the last level and re-evaluated as the wheel turns.
+ *
+ * A timer wheel is not thread-safe, it is meant to be driven by a single event loop.
+ * @{
+ */
+
+#include <pcl/types.h>
+
+/** Default timer wheel resolution: 1 millisecond. */
+#define PCL_TIMER_RESOLUTION 1000000
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Timer expiry handler.
+ * @param timer pointer to the timer that expired. It is released when the handler returns
+ * unless the handler rearms it with ::pcl_timer_reset.
+ * @param udata user data pointer supplied to ::pcl_timer_add
+ */
+typedef void (*pcl_timer_handler_t)(pcl_timer_t *timer, void *udata);
+
+/** Create a timer wheel.
+ * @param resolution tick length in ::pcl_clock units (nanoseconds). Zero uses
+ * ::PCL_TIMER_RESOLUTION.
+ * @return pointer to a new timer wheel that must be freed via ::pcl_timerwheel_free
+ */
+PCL_PUBLIC pcl_timerwheel_t *pcl_timerwheel(pcl_clock_t resolution);
+
+/** Fire all timers that have expired.
+ * @param tw pointer to a timer wheel
+ * @param now current ::pcl_clock value or zero to read the clock
+ * @return number of handlers called
+ */
+PCL_PUBLIC int pcl_timerwheel_run(pcl_timerwheel_t *tw, pcl_clock_t now);
+
+/** Get how long until the next timer may expire, suitable as an event loop's poll timeout.
+ * The result can be earlier than the actual expiry, in which case ::pcl_timerwheel_run fires
+ * nothing and this function should be asked again.
+ * @param tw pointer to a timer wheel
+ * @return nanoseconds until the next expiry, zero if a timer is due, or -1 if no timers are
+ * pending
+ */
+PCL_PUBLIC pcl_clock_t pcl_timerwheel_next(pcl_timerwheel_t *tw);
+
+/** Get the number of pending timers.
+ * @param tw pointer to a timer wheel
+ * @return number of timers
+ */
+PCL_PUBLIC size_t pcl_timerwheel_size(pcl_timerwheel_t *tw);
+
+/** Free a timer wheel. Pending timers are dropped without calling their handlers.
+ * @param tw pointer to a timer wheel
+ */
+PCL_PUBLIC void pcl_timerwheel_free(pcl_timerwheel_t *tw);
+
+/** Add a timer.
+ * @param tw pointer to a timer wheel
+ * @param timeout nanoseconds from now until the timer expires
+ * @param handler function called when the timer expires
+ * @param udata user data pointer passed to \a handler
+ * @return pointer to a timer, valid until its handler returns or it is cancelled, or \c NULL
+ * on error
+ */
+PCL_PUBLIC pcl_timer_t *pcl_timer_add(pcl_timerwheel_t *tw, pcl_clock_t timeout,
+	pcl_timer_handler_t handler, void *udata);
+
+/** Restart a pending timer with a new timeout, for example on connection activity. This can
+ * also be called by a timer's handler to rearm it.
+ * @param timer pointer to a timer
+ * @param timeout nanoseconds from now until the timer expires
+ * @return 0 for success and -1 on error
+ */
+PCL_PUBLIC int pcl_timer_reset(pcl_timer_t *timer, pcl_clock_t timeout);
+
+/** Cancel a pending timer. The timer is released and must not be used afterwards.
+ * @param timer pointer to a timer
+ * @return 0 for success and -1 on error
+ */
+PCL_PUBLIC int pcl_timer_cancel(pcl_timer_t *timer);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif // LIBPCL_TIMER_H
@@ -73,6 +73,18 @@ typedef void (*pcl_cleanup_t)(void *item);
  */
 typedef int (*pcl_compare_t)(const void *a, const void *b);
 
+/** Scatter/gather I/O element, laid out like a POSIX \c struct iovec. Used by ::pcl_sendv,
+ * ::pcl_file_readv and ::pcl_file_writev.
+ */
+typedef struct
+{
+	/** pointer to the data */
+	void *iov_base;
+
+	/** number of bytes at \c iov_base */
+	size_t iov_len;
+} pcl_iovec_t;
+
 /* --------------------------------------------------------------------
  * forward declarations
  */
@@ -88,6 +100,7 @@ typedef struct tag_pcl_file pcl_file_t;
  */
 typedef struct tag_pcl_json pcl_json_t;
 typedef struct tag_pcl_json_path pcl_json_path_t;
+typedef struct tag_pcl_json_writer pcl_json_writer_t;
 /** Directory handle.
  * @ingroup dir
  */
@@ -98,6 +111,12 @@ typedef struct tag_pcl_ssl pcl_ssl_t;
 typedef struct tag_pcl_stat pcl_stat_t;
 /** @ingroup buf */
 typedef struct tag_pcl_buf pcl_buf_t;
+/** @ingroup rope */
+typedef struct tag_pcl_rope pcl_rope_t;
+/** @ingroup arena */
+typedef struct tag_pcl_arena pcl_arena_t;
+/** @ingroup pool */
+typedef struct tag_pcl_pool pcl_pool_t;
 
 /** @ingroup vector
  * @copydoc tag_pcl_vector
@@ -106,7 +125,27 @@ typedef struct tag_pcl_vector pcl_vector_t;
 typedef struct tag_pcl_array pcl_array_t;
 typedef struct tag_pcl_queue pcl_queue_t;
 typedef struct tag_pcl_stack pcl_stack_t;
+/** @ingroup pqueue */
+typedef struct tag_pcl_pqueue pcl_pqueue_t;
+/** @ingroup ring */
+typedef struct tag_pcl_ring pcl_ring_t;
 typedef struct tag_pcl_htable pcl_htable_t;
+/** @ingroup timer */
+typedef struct tag_pcl_timerwheel pcl_timerwheel_t;
+/** @ingroup timer */
+typedef struct tag_pcl_timer pcl_timer_t;
+/** @ingroup threadpool */
+typedef struct tag_pcl_threadpool pcl_threadpool_t;
+/** @ingroup threadpool */
+typedef struct tag_pcl_future pcl_future_t;
+/** @ingroup sync */
+typedef struct tag_pcl_lock pcl_lock_t;
+/** @ingroup sync */
+typedef struct tag_pcl_rwlock pcl_rwlock_t;
+/** @ingroup sync */
+typedef struct tag_pcl_cond pcl_cond_t;
+/** @ingroup sync */
+typedef struct tag_pcl_barrier pcl_barrier_t;
 
 typedef struct
 {
@@ -0,0 +1,226 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL__ALLOC_H
+#define LIBPCL__ALLOC_H
+
+#include <pcl/alloc.h>
+#include <pcl/memprof.h>
+#include <pcl/memtag.h>
+#include <pcl/sync.h>
+#include <pcl/error.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* installed allocator, read by the pcl_xxx_trace functions */
+PCL_PRIVATE const pcl_allocator_t *ipcl_allocator(void);
+
+/* called by pcl_init, after which the allocator can no longer be changed */
+PCL_PRIVATE void ipcl_allocator_seal(void);
+PCL_PRIVATE bool ipcl_allocator_sealed(void);
+
+#define MEMPROF_BUCKETS 1024
+
+/* a thread merges a site's counters after this many operations or live bytes */
+#define MEMPROF_FLUSHOPS 256
+#define MEMPROF_FLUSHBYTES (64 * 1024)
+
+typedef struct
+{
+	size_t size;
+	int depth;
+	void *frames[PCL_MEMPROF_DEPTH];
+} ipcl_memprof_sample_t;
+
+typedef struct tag_ipcl_memprof_site ipcl_memprof_site_t;
+
+/* Call site, never freed. Counters are merged from threads with atomics. */
+struct tag_ipcl_memprof_site
+{
+	ipcl_memprof_site_t *next;
+	const char *file;
+	const char *func;
+	int line;
+	int index;
+
+	int64_t allocs;
+	int64_t frees;
+	int64_t bytes;
+	int64_t live;
+	int64_t peak;
+
+	/* guards the samples, PCL_MEMPROF_SAMPLES allocated on first use */
+	pcl_lock_t lock;
+	ipcl_memprof_sample_t *samples;
+	int nsamples;
+};
+
+/* prefixes every block while profiling, 16 bytes to keep user memory aligned */
+typedef struct
+{
+	ipcl_memprof_site_t *site;
+	size_t size;
+} ipcl_memprof_hdr_t;
+
+/* a thread's unmerged counters for one site */
+typedef struct
+{
+	ipcl_memprof_site_t *site;
+	int64_t allocs;
+	int64_t frees;
+	int64_t bytes;
+	int64_t live;
+	int64_t maxlive; /* high-water mark of live since the last merge */
+	int ops;
+} ipcl_memprof_delta_t;
+
+/* snapshot of a site's counters */
+typedef struct
+{
+	ipcl_memprof_site_t *site;
+	int64_t allocs;
+	int64_t frees;
+	int64_t bytes;
+	int64_t live;
+	int64_t peak;
+} ipcl_memprof_stat_t;
+
+typedef struct
+{
+	bool enabled;
+	int flags;
+	size_t threshold;
+
+	/* guards site creation */
+	pcl_lock_t lock;
+	ipcl_memprof_site_t *buckets[MEMPROF_BUCKETS];
+	int nsites;
+
+	/* process totals of merged counters */
+	int64_t live;
+	int64_t peak;
+} ipcl_memprof_t;
+
+PCL_PRIVATE ipcl_memprof_t *ipcl_memprof(void);
+
+/* Profiled versions of the allocator functions, used by the pcl_xxx_trace functions. 'extra'
+ * bytes are allocated but not counted, making room for the accounting header.
+ */
+PCL_PRIVATE void *ipcl_memprof_alloc(const pcl_allocator_t *a, size_t n, size_t extra,
+	bool zero, PCL_LOCATION_PARAMS);
+PCL_PRIVATE void *ipcl_memprof_resize(const pcl_allocator_t *a, void *ptr, size_t n,
+	size_t extra, PCL_LOCATION_PARAMS);
+PCL_PRIVATE void ipcl_memprof_release(const pcl_allocator_t *a, void *ptr);
+
+/* find or create the site for a location, NULL if it could not be allocated */
+PCL_PRIVATE ipcl_memprof_site_t *ipcl_memprof_site(PCL_LOCATION_PARAMS);
+
+/* record the calling thread's stack against a site */
+PCL_PRIVATE void ipcl_memprof_sample(ipcl_memprof_site_t *site, size_t size);
+
+/* add to the calling thread's counters for a site, 'size' is negative for frees */
+PCL_PRIVATE void ipcl_memprof_count(ipcl_memprof_site_t *site, int64_t size);
+
+/* merge all of the calling thread's counters */
+PCL_PRIVATE void ipcl_memprof_flush(void);
+
+/* merged counters of every site after merging the calling thread's, largest first by
+ * bytes allocated or live bytes. Released with the installed allocator.
+ */
+PCL_PRIVATE ipcl_memprof_stat_t *ipcl_memprof_stats(int *count, bool bylive);
+
+/* platform stack capture and symbolization */
+PCL_PRIVATE int ipcl_memprof_backtrace(void **frames, int max);
+PCL_PRIVATE pcl_json_t *ipcl_memprof_symbols(void **frames, int depth);
+
+/* prefixes every block while accounting, outside of any profiler header */
+typedef struct
+{
+	int64_t tag;
+	int64_t size;
+} ipcl_memtag_hdr_t;
+
+typedef struct
+{
+	char name[PCL_MEMTAG_NAMESIZE];
+	int64_t live;
+	int64_t peak;
+	int64_t limit;
+	int64_t exceeded;
+} ipcl_memtag_t;
+
+typedef struct
+{
+	bool enabled;
+
+	/* guards registration */
+	pcl_lock_t lock;
+	int32_t count;
+	ipcl_memtag_t tags[PCL_MEMTAG_MAX];
+} ipcl_memtags_t;
+
+PCL_PRIVATE ipcl_memtags_t *ipcl_memtags(void);
+
+/* accounted versions of the allocator functions, used by the pcl_xxx_trace functions */
+PCL_PRIVATE void *ipcl_memtag_alloc(const pcl_allocator_t *a, size_t n, bool zero,
+	PCL_LOCATION_PARAMS);
+PCL_PRIVATE void *ipcl_memtag_resize(const pcl_allocator_t *a, void *ptr, size_t n,
+	PCL_LOCATION_PARAMS);
+PCL_PRIVATE void ipcl_memtag_release(const pcl_allocator_t *a, void *ptr);
+
+/* calling thread's current tag, PCL_MEMTAG_NONE when accounting is disabled */
+PCL_PRIVATE int ipcl_memtag_current(void);
+
+/* Used by modules to tag their allocations: sets 'tag' only if the thread has none. The
+ * result is passed to ipcl_memtag_leave, which restores the thread's tag.
+ */
+PCL_PRIVATE int ipcl_memtag_enter(int tag);
+PCL_PRIVATE void ipcl_memtag_leave(int prev);
+
+/* clears the thread's tag until ipcl_memtag_leave, for memory kept across tags */
+PCL_PRIVATE int ipcl_memtag_suspend(void);
+
+/* Used by allocators layered on untagged memory, like pools. Charges 'size' bytes to the
+ * thread's current tag and returns it, to be passed to ipcl_memtag_credit on release.
+ */
+PCL_PRIVATE int ipcl_memtag_charge(int64_t size, PCL_LOCATION_PARAMS);
+PCL_PRIVATE void ipcl_memtag_credit(int tag, int64_t size);
+
+/* true if the thread's current tag is over its limit, checked by operations that can fail */
+PCL_PRIVATE bool ipcl_memtag_exceeded(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPCL__ALLOC_H
@@ -0,0 +1,113 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_alloc.h"
+#include <pcl/atomic.h>
+#include <pcl/error.h>
+#include <stdlib.h>
+
+static void *
+libc_alloc(void *ctx, size_t size)
+{
+	UNUSED(ctx);
+	return malloc(size);
+}
+
+static void *
+libc_zalloc(void *ctx, size_t size)
+{
+	UNUSED(ctx);
+	return calloc(1, size);
+}
+
+static void *
+libc_resize(void *ctx, void *ptr, size_t size)
+{
+	UNUSED(ctx);
+	return realloc(ptr, size);
+}
+
+static void
+libc_release(void *ctx, void *ptr)
+{
+	UNUSED(ctx);
+	free(ptr);
+}
+
+static const pcl_allocator_t libc_allocator = {
+	"libc", NULL, libc_alloc, libc_zalloc, libc_resize, libc_release
+};
+
+static const pcl_allocator_t *allocator = &libc_allocator;
+static int32_t sealed;
+
+const pcl_allocator_t *
+ipcl_allocator(void)
+{
+	return allocator;
+}
+
+void
+ipcl_allocator_seal(void)
+{
+	pcl_atomic_store32(&sealed, 1, PCL_ATOMIC_RELEASE);
+}
+
+bool
+ipcl_allocator_sealed(void)
+{
+	return pcl_atomic_load32(&sealed, PCL_ATOMIC_ACQUIRE) != 0;
+}
+
+const pcl_allocator_t *
+pcl_set_allocator(const pcl_allocator_t *a)
+{
+	/* pcl_init has allocated thread contexts by now, errors can be set */
+	if(ipcl_allocator_sealed())
+		return R_SETERRMSG(NULL, PCL_EBUSY, "allocator must be set before pcl_init", 0);
+
+	const pcl_allocator_t *prev = allocator;
+
+	allocator = a ? a : &libc_allocator;
+	return prev;
+}
+
+const pcl_allocator_t *
+pcl_get_allocator(void)
+{
+	return allocator;
+}
+
+const pcl_allocator_t *
+pcl_allocator_libc(void)
+{
+	return &libc_allocator;
+}
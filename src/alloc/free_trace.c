@@ -29,16 +29,25 @@
   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
-#include <pcl/alloc.h>
-#include <stdlib.h>
+#include "_alloc.h"
 
 void *
 pcl_free_trace(void *ptr, PCL_LOCATION_PARAMS)
 {
 	if(!ptr)
+	{
 		pcl_memory_error("pcl_free", ptr, 0, PCL_LOCATION_VALS);
+		return NULL;
+	}
 
-	free(ptr);
+	const pcl_allocator_t *a = ipcl_allocator();
+
+	if(ipcl_memtags()->enabled)
+		ipcl_memtag_release(a, ptr);
+	else if(ipcl_memprof()->enabled)
+		ipcl_memprof_release(a, ptr);
+	else
+		a->release(a->ctx, ptr);
 
 	return NULL;
 }
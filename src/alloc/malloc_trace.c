@@ -29,13 +29,20 @@
   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
-#include <pcl/alloc.h>
-#include <stdlib.h>
+#include "_alloc.h"
 
 void *
 pcl_malloc_trace(size_t n, PCL_LOCATION_PARAMS)
 {
-	void *ptr = malloc(n);
+	const pcl_allocator_t *a = ipcl_allocator();
+	void *ptr;
+
+	if(ipcl_memtags()->enabled)
+		ptr = ipcl_memtag_alloc(a, n, false, PCL_LOCATION_VALS);
+	else if(ipcl_memprof()->enabled)
+		ptr = ipcl_memprof_alloc(a, n, 0, false, PCL_LOCATION_VALS);
+	else
+		ptr = a->alloc(a->ctx, n);
 
 	if(!ptr)
 		pcl_memory_error("pcl_malloc", NULL, n, PCL_LOCATION_VALS);
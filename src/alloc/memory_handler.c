@@ -31,12 +31,18 @@
 
 #include <pcl/alloc.h>
 #include <pcl/atomic.h>
+#include <pcl/memtag.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 static void
 default_memory_handler(const char *type, void *ptr, size_t size, PCL_LOCATION_PARAMS)
 {
+	/* soft limits are enforced by the operations that can fail, not by exiting */
+	if(strcmp(type, PCL_MEMORY_LIMIT) == 0)
+		return;
+
 	fprintf(stderr, "memory error: '%s' failed at %s:%s(%d) - ptr=%p, size=%zd\n",
 		type, PCL_LOCATION_VALS, ptr, size);
 
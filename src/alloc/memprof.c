@@ -0,0 +1,71 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_alloc.h"
+#include <pcl/error.h>
+#include <stdlib.h>
+
+static ipcl_memprof_t memprof = {.lock = PCL_LOCK_INITIALIZER};
+
+static void
+report_leaks(void)
+{
+	pcl_memprof_leaks(stderr);
+}
+
+ipcl_memprof_t *
+ipcl_memprof(void)
+{
+	return &memprof;
+}
+
+int
+pcl_memprof_enable(size_t stack_threshold, int flags)
+{
+	/* pcl_init has allocated thread contexts by now, errors can be set */
+	if(ipcl_allocator_sealed())
+		return SETERRMSG(PCL_EBUSY, "profiler must be enabled before pcl_init", 0);
+
+	memprof.threshold = stack_threshold;
+	memprof.flags = flags;
+
+	if(!memprof.enabled && (flags & PCL_MEMPROF_ATEXIT))
+		atexit(report_leaks);
+
+	memprof.enabled = true;
+	return 0;
+}
+
+bool
+pcl_memprof_enabled(void)
+{
+	return memprof.enabled;
+}
@@ -0,0 +1,190 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_alloc.h"
+#include <pcl/atomic.h>
+#include <pcl/thread.h>
+#include <string.h>
+
+typedef struct
+{
+	int size;
+	ipcl_memprof_delta_t *deltas;
+} memprof_tls_t;
+
+static pthread_key_t tlskey;
+static int32_t have_tlskey;
+static pcl_lock_t keylock = PCL_LOCK_INITIALIZER;
+
+static void
+peak_update(int64_t *peak, int64_t live)
+{
+	int64_t cur = pcl_atomic_load64(peak, PCL_ATOMIC_RELAXED);
+
+	while(live > cur && !pcl_atomic_cas64_weak(peak, &cur, live, PCL_ATOMIC_RELAXED))
+		;
+}
+
+static void
+delta_merge(ipcl_memprof_delta_t *d)
+{
+	ipcl_memprof_t *mp = ipcl_memprof();
+	ipcl_memprof_site_t *site = d->site;
+
+	pcl_atomic_fetch_add64(&site->allocs, d->allocs, PCL_ATOMIC_RELAXED);
+	pcl_atomic_fetch_add64(&site->frees, d->frees, PCL_ATOMIC_RELAXED);
+	pcl_atomic_fetch_add64(&site->bytes, d->bytes, PCL_ATOMIC_RELAXED);
+	peak_update(&site->peak,
+		pcl_atomic_fetch_add64(&site->live, d->live, PCL_ATOMIC_RELAXED) + d->maxlive);
+	peak_update(&mp->peak,
+		pcl_atomic_fetch_add64(&mp->live, d->live, PCL_ATOMIC_RELAXED) + d->maxlive);
+
+	d->allocs = d->frees = d->bytes = d->live = d->maxlive = 0;
+	d->ops = 0;
+}
+
+static void
+tls_merge(memprof_tls_t *tls)
+{
+	for(int i = 0; i < tls->size; i++)
+		if(tls->deltas[i].site && tls->deltas[i].ops > 0)
+			delta_merge(&tls->deltas[i]);
+}
+
+/* TLS callback: merges what the thread has not yet reported */
+static void
+tls_destroy(void *obj)
+{
+	const pcl_allocator_t *a = ipcl_allocator();
+	memprof_tls_t *tls = obj;
+
+	tls_merge(tls);
+
+	if(tls->deltas)
+		a->release(a->ctx, tls->deltas);
+
+	a->release(a->ctx, tls);
+}
+
+/* The profiler runs before pcl_init and allocates through the allocator directly, since
+ * pcl_malloc would recurse into it.
+ */
+static memprof_tls_t *
+tls_get(void)
+{
+	const pcl_allocator_t *a = ipcl_allocator();
+
+	if(!pcl_atomic_load32(&have_tlskey, PCL_ATOMIC_ACQUIRE))
+	{
+		pcl_lock_acquire(&keylock);
+
+		if(!have_tlskey && pthread_key_create(&tlskey, tls_destroy) == 0)
+			pcl_atomic_store32(&have_tlskey, 1, PCL_ATOMIC_RELEASE);
+
+		pcl_lock_release(&keylock);
+
+		if(!pcl_atomic_load32(&have_tlskey, PCL_ATOMIC_ACQUIRE))
+			return NULL;
+	}
+
+	memprof_tls_t *tls = pthread_getspecific(tlskey);
+
+	if(!tls && (tls = a->zalloc(a->ctx, sizeof(memprof_tls_t))))
+	{
+		if(pthread_setspecific(tlskey, tls))
+		{
+			a->release(a->ctx, tls);
+			tls = NULL;
+		}
+	}
+
+	return tls;
+}
+
+void
+ipcl_memprof_count(ipcl_memprof_site_t *site, int64_t size)
+{
+	memprof_tls_t *tls = tls_get();
+	ipcl_memprof_delta_t one = {.site = site}, *d = &one;
+
+	if(tls && site->index >= tls->size)
+	{
+		const pcl_allocator_t *a = ipcl_allocator();
+		int size = site->index + 64;
+		ipcl_memprof_delta_t *deltas = tls->deltas ?
+			a->resize(a->ctx, tls->deltas, size * sizeof(ipcl_memprof_delta_t)) :
+			a->alloc(a->ctx, size * sizeof(ipcl_memprof_delta_t));
+
+		if(deltas)
+		{
+			memset(deltas + tls->size, 0, (size - tls->size) * sizeof(ipcl_memprof_delta_t));
+			tls->deltas = deltas;
+			tls->size = size;
+		}
+	}
+
+	/* without thread counters, merge immediately */
+	if(tls && site->index < tls->size)
+	{
+		d = &tls->deltas[site->index];
+		d->site = site;
+	}
+
+	if(size >= 0)
+	{
+		d->allocs++;
+		d->bytes += size;
+	}
+	else
+	{
+		d->frees++;
+	}
+
+	d->live += size;
+
+	if(d->live > d->maxlive)
+		d->maxlive = d->live;
+
+	if(d == &one || ++d->ops >= MEMPROF_FLUSHOPS ||
+		d->live >= MEMPROF_FLUSHBYTES || d->live <= -MEMPROF_FLUSHBYTES)
+	{
+		delta_merge(d);
+	}
+}
+
+void
+ipcl_memprof_flush(void)
+{
+	memprof_tls_t *tls = tls_get();
+
+	if(tls)
+		tls_merge(tls);
+}
@@ -0,0 +1,104 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_alloc.h"
+#include <stdint.h>
+
+void *
+ipcl_memprof_alloc(const pcl_allocator_t *a, size_t n, size_t extra, bool zero,
+	PCL_LOCATION_PARAMS)
+{
+	if(n > SIZE_MAX - sizeof(ipcl_memprof_hdr_t) - extra)
+		return NULL;
+
+	size_t total = sizeof(ipcl_memprof_hdr_t) + extra + n;
+	ipcl_memprof_hdr_t *hdr = zero ? a->zalloc(a->ctx, total) : a->alloc(a->ctx, total);
+
+	if(!hdr)
+		return NULL;
+
+	/* a block without a site is simply not counted */
+	hdr->site = ipcl_memprof_site(PCL_LOCATION_VALS);
+	hdr->size = n;
+
+	if(hdr->site)
+	{
+		ipcl_memprof_count(hdr->site, (int64_t) n);
+
+		if(ipcl_memprof()->threshold && n >= ipcl_memprof()->threshold)
+			ipcl_memprof_sample(hdr->site, n);
+	}
+
+	return hdr + 1;
+}
+
+void *
+ipcl_memprof_resize(const pcl_allocator_t *a, void *ptr, size_t n, size_t extra,
+	PCL_LOCATION_PARAMS)
+{
+	if(n > SIZE_MAX - sizeof(ipcl_memprof_hdr_t) - extra)
+		return NULL;
+
+	ipcl_memprof_hdr_t *hdr = (ipcl_memprof_hdr_t *) ptr - 1;
+	ipcl_memprof_site_t *oldsite = hdr->site;
+	size_t oldsize = hdr->size;
+
+	if(!(hdr = a->resize(a->ctx, hdr, sizeof(ipcl_memprof_hdr_t) + extra + n)))
+		return NULL;
+
+	/* counted as a free of the old block and an allocation by the resizing site */
+	if(oldsite)
+		ipcl_memprof_count(oldsite, -(int64_t) oldsize);
+
+	hdr->site = ipcl_memprof_site(PCL_LOCATION_VALS);
+	hdr->size = n;
+
+	if(hdr->site)
+	{
+		ipcl_memprof_count(hdr->site, (int64_t) n);
+
+		if(ipcl_memprof()->threshold && n >= ipcl_memprof()->threshold)
+			ipcl_memprof_sample(hdr->site, n);
+	}
+
+	return hdr + 1;
+}
+
+void
+ipcl_memprof_release(const pcl_allocator_t *a, void *ptr)
+{
+	ipcl_memprof_hdr_t *hdr = (ipcl_memprof_hdr_t *) ptr - 1;
+
+	if(hdr->site)
+		ipcl_memprof_count(hdr->site, -(int64_t) hdr->size);
+
+	a->release(a->ctx, hdr);
+}
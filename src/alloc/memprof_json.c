@@ -0,0 +1,156 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_alloc.h"
+#include <pcl/atomic.h>
+#include <pcl/json.h>
+
+#define KEYFLAGS PCL_JSON_SKIPUTF8CHK
+
+#define FAILED do{ \
+	pcl_json_free(root); \
+	a->release(a->ctx, stats); \
+	return R_TRC(NULL); \
+}while(0)
+
+static pcl_json_t *
+site_stacks(ipcl_memprof_site_t *site)
+{
+	ipcl_memprof_sample_t samples[PCL_MEMPROF_SAMPLES];
+	int n;
+
+	/* copy out so symbolizing doesn't hold the lock */
+	pcl_lock_acquire(&site->lock);
+	n = site->nsamples < PCL_MEMPROF_SAMPLES ? site->nsamples : PCL_MEMPROF_SAMPLES;
+
+	for(int i = 0; i < n; i++)
+		samples[i] = site->samples[i];
+
+	pcl_lock_release(&site->lock);
+
+	if(n == 0)
+		return NULL;
+
+	pcl_json_t *stacks = pcl_json_arr();
+
+	for(int i = 0; i < n; i++)
+	{
+		pcl_json_t *frames = ipcl_memprof_symbols(samples[i].frames, samples[i].depth);
+
+		if(!frames || pcl_json_arradd(stacks, frames, PCL_JSON_FREEVALONERR) < 0)
+		{
+			pcl_json_free(stacks);
+			return R_TRC(NULL);
+		}
+	}
+
+	return stacks;
+}
+
+static pcl_json_t *
+site_json(const ipcl_memprof_stat_t *st)
+{
+	pcl_json_t *obj = pcl_json_obj();
+	ipcl_memprof_site_t *site = st->site;
+
+	if(pcl_json_objputstr(obj, "file", (char *) site->file, KEYFLAGS) < 0 ||
+		pcl_json_objputstr(obj, "func", (char *) site->func, KEYFLAGS) < 0 ||
+		pcl_json_objputint(obj, "line", site->line, KEYFLAGS) < 0 ||
+		pcl_json_objputint(obj, "allocs", st->allocs, KEYFLAGS) < 0 ||
+		pcl_json_objputint(obj, "frees", st->frees, KEYFLAGS) < 0 ||
+		pcl_json_objputint(obj, "bytes", st->bytes, KEYFLAGS) < 0 ||
+		pcl_json_objputint(obj, "live", st->live, KEYFLAGS) < 0 ||
+		pcl_json_objputint(obj, "peak", st->peak, KEYFLAGS) < 0)
+	{
+		pcl_json_free(obj);
+		return R_TRC(NULL);
+	}
+
+	pcl_json_t *stacks = site_stacks(site);
+
+	if(stacks && pcl_json_objput(obj, "stacks", stacks, KEYFLAGS | PCL_JSON_FREEVALONERR) < 0)
+	{
+		pcl_json_free(obj);
+		return R_TRC(NULL);
+	}
+
+	return obj;
+}
+
+pcl_json_t *
+pcl_memprof_json(void)
+{
+	ipcl_memprof_t *mp = ipcl_memprof();
+	const pcl_allocator_t *a = ipcl_allocator();
+
+	if(!mp->enabled)
+		return R_SETERRMSG(NULL, PCL_ENOTREADY, "allocation profiler is not enabled", 0);
+
+	int count;
+	ipcl_memprof_stat_t *stats = ipcl_memprof_stats(&count, false);
+
+	if(!stats)
+		return R_TRC(NULL);
+
+	pcl_json_t *root = pcl_json_obj();
+	pcl_json_t *sites = pcl_json_arr();
+	int64_t allocs = 0, bytes = 0;
+
+	for(int i = 0; i < count; i++)
+	{
+		allocs += stats[i].allocs;
+		bytes += stats[i].bytes;
+	}
+
+	if(pcl_json_objputint(root, "allocs", allocs, KEYFLAGS) < 0 ||
+		pcl_json_objputint(root, "bytes", bytes, KEYFLAGS) < 0 ||
+		pcl_json_objputint(root, "live", pcl_atomic_load64(&mp->live, PCL_ATOMIC_RELAXED), KEYFLAGS) < 0 ||
+		pcl_json_objputint(root, "peak", pcl_atomic_load64(&mp->peak, PCL_ATOMIC_RELAXED), KEYFLAGS) < 0 ||
+		pcl_json_objput(root, "sites", sites, KEYFLAGS | PCL_JSON_FREEVALONERR) < 0)
+	{
+		FAILED;
+	}
+
+	for(int i = 0; i < count; i++)
+	{
+		/* created by another thread that has yet to merge its counters */
+		if(stats[i].allocs == 0 && stats[i].frees == 0)
+			continue;
+
+		pcl_json_t *site = site_json(&stats[i]);
+
+		if(!site || pcl_json_arradd(sites, site, PCL_JSON_FREEVALONERR) < 0)
+			FAILED;
+	}
+
+	a->release(a->ctx, stats);
+	return root;
+}
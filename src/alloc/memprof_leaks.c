@@ -0,0 +1,68 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_alloc.h"
+
+int
+pcl_memprof_leaks(FILE *stream)
+{
+	const pcl_allocator_t *a = ipcl_allocator();
+
+	if(!stream)
+		return BADARG();
+
+	if(!ipcl_memprof()->enabled)
+		return SETERRMSG(PCL_ENOTREADY, "allocation profiler is not enabled", 0);
+
+	int count, leaks = 0;
+	int64_t live = 0;
+	ipcl_memprof_stat_t *stats = ipcl_memprof_stats(&count, true);
+
+	if(!stats)
+		return TRC();
+
+	for(; leaks < count && stats[leaks].live > 0; leaks++)
+		live += stats[leaks].live;
+
+	fprintf(stream, "memory leaks: %lld bytes live from %d sites\n", (long long) live, leaks);
+
+	for(int i = 0; i < leaks; i++)
+	{
+		ipcl_memprof_stat_t *st = &stats[i];
+
+		fprintf(stream, "  %s:%s(%d) - %lld bytes in %lld blocks\n", st->site->file,
+			st->site->func, st->site->line, (long long) st->live,
+			(long long) (st->allocs - st->frees));
+	}
+
+	a->release(a->ctx, stats);
+	return leaks;
+}
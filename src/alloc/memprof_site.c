@@ -0,0 +1,108 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_alloc.h"
+#include <pcl/atomic.h>
+#include <string.h>
+
+/* __FILE__ of a header differs in each translation unit that includes it, so files are
+ * compared by value once the line matches
+ */
+static bool
+site_match(ipcl_memprof_site_t *site, PCL_LOCATION_PARAMS)
+{
+	return site->line == line && (site->file == file || strcmp(site->file, file) == 0) &&
+		(site->func == func || strcmp(site->func, func) == 0);
+}
+
+ipcl_memprof_site_t *
+ipcl_memprof_site(PCL_LOCATION_PARAMS)
+{
+	ipcl_memprof_t *mp = ipcl_memprof();
+	ipcl_memprof_site_t **bucket = &mp->buckets[((uint32_t) line * 2654435761u) % MEMPROF_BUCKETS];
+	ipcl_memprof_site_t *site;
+
+	/* sites are pushed at the head and never removed, so readers need no lock */
+	for(site = pcl_atomic_loadptr((void **) bucket, PCL_ATOMIC_ACQUIRE); site; site = site->next)
+		if(site_match(site, PCL_LOCATION_VALS))
+			return site;
+
+	pcl_lock_acquire(&mp->lock);
+
+	for(site = *bucket; site; site = site->next)
+		if(site_match(site, PCL_LOCATION_VALS))
+			break;
+
+	if(!site)
+	{
+		const pcl_allocator_t *a = ipcl_allocator();
+
+		if((site = a->zalloc(a->ctx, sizeof(ipcl_memprof_site_t))))
+		{
+			site->file = file;
+			site->func = func;
+			site->line = line;
+			site->index = mp->nsites++;
+			pcl_lock_init(&site->lock, NULL);
+			site->next = *bucket;
+			pcl_atomic_storeptr((void **) bucket, site, PCL_ATOMIC_RELEASE);
+		}
+	}
+
+	pcl_lock_release(&mp->lock);
+	return site;
+}
+
+void
+ipcl_memprof_sample(ipcl_memprof_site_t *site, size_t size)
+{
+	ipcl_memprof_sample_t sample;
+
+	sample.size = size;
+	sample.depth = ipcl_memprof_backtrace(sample.frames, PCL_MEMPROF_DEPTH);
+
+	if(sample.depth <= 0)
+		return;
+
+	pcl_lock_acquire(&site->lock);
+
+	if(!site->samples)
+	{
+		const pcl_allocator_t *a = ipcl_allocator();
+		site->samples = a->alloc(a->ctx, PCL_MEMPROF_SAMPLES * sizeof(ipcl_memprof_sample_t));
+	}
+
+	/* the newest replaces the oldest once full */
+	if(site->samples)
+		site->samples[site->nsamples++ % PCL_MEMPROF_SAMPLES] = sample;
+
+	pcl_lock_release(&site->lock);
+}
@@ -0,0 +1,85 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_alloc.h"
+#include <pcl/atomic.h>
+#include <stdlib.h>
+
+static int
+compare_bytes(const void *a, const void *b)
+{
+	int64_t x = ((const ipcl_memprof_stat_t *) a)->bytes;
+	int64_t y = ((const ipcl_memprof_stat_t *) b)->bytes;
+	return x < y ? 1 : x > y ? -1 : 0;
+}
+
+static int
+compare_live(const void *a, const void *b)
+{
+	int64_t x = ((const ipcl_memprof_stat_t *) a)->live;
+	int64_t y = ((const ipcl_memprof_stat_t *) b)->live;
+	return x < y ? 1 : x > y ? -1 : 0;
+}
+
+ipcl_memprof_stat_t *
+ipcl_memprof_stats(int *count, bool bylive)
+{
+	ipcl_memprof_t *mp = ipcl_memprof();
+	const pcl_allocator_t *a = ipcl_allocator();
+
+	ipcl_memprof_flush();
+	pcl_lock_acquire(&mp->lock);
+
+	ipcl_memprof_stat_t *stats = a->alloc(a->ctx, (mp->nsites + 1) * sizeof(ipcl_memprof_stat_t));
+	int n = 0;
+
+	for(int i = 0; stats && i < MEMPROF_BUCKETS; i++)
+	{
+		for(ipcl_memprof_site_t *s = mp->buckets[i]; s; s = s->next, n++)
+		{
+			stats[n].site = s;
+			stats[n].allocs = pcl_atomic_load64(&s->allocs, PCL_ATOMIC_RELAXED);
+			stats[n].frees = pcl_atomic_load64(&s->frees, PCL_ATOMIC_RELAXED);
+			stats[n].bytes = pcl_atomic_load64(&s->bytes, PCL_ATOMIC_RELAXED);
+			stats[n].live = pcl_atomic_load64(&s->live, PCL_ATOMIC_RELAXED);
+			stats[n].peak = pcl_atomic_load64(&s->peak, PCL_ATOMIC_RELAXED);
+		}
+	}
+
+	pcl_lock_release(&mp->lock);
+
+	if(!stats)
+		return R_SETERR(NULL, PCL_ENOMEM);
+
+	qsort(stats, n, sizeof(ipcl_memprof_stat_t), bylive ? compare_live : compare_bytes);
+	*count = n;
+	return stats;
+}
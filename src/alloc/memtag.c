@@ -0,0 +1,144 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_alloc.h"
+#include <pcl/atomic.h>
+#include <pcl/string.h>
+#include <string.h>
+
+static ipcl_memtags_t memtags = {
+	.lock = PCL_LOCK_INITIALIZER,
+	.count = PCL_MEMTAG_USER,
+	.tags = {
+		[PCL_MEMTAG_NONE] = {"none"},
+		[PCL_MEMTAG_JSON] = {"json"},
+		[PCL_MEMTAG_HTABLE] = {"htable"},
+		[PCL_MEMTAG_BUF] = {"buf"},
+		[PCL_MEMTAG_ERROR] = {"error"},
+		[PCL_MEMTAG_SSL] = {"ssl"}
+	}
+};
+
+static bool
+valid_tag(int tag)
+{
+	return tag >= 0 && tag < pcl_atomic_load32(&memtags.count, PCL_ATOMIC_ACQUIRE);
+}
+
+ipcl_memtags_t *
+ipcl_memtags(void)
+{
+	return &memtags;
+}
+
+int
+pcl_memtag_enable(void)
+{
+	/* pcl_init has allocated thread contexts by now, errors can be set */
+	if(ipcl_allocator_sealed())
+		return SETERRMSG(PCL_EBUSY, "memory accounting must be enabled before pcl_init", 0);
+
+	memtags.enabled = true;
+	return 0;
+}
+
+bool
+pcl_memtag_enabled(void)
+{
+	return memtags.enabled;
+}
+
+int
+pcl_memtag_register(const char *name)
+{
+	if(strempty(name) || strlen(name) >= PCL_MEMTAG_NAMESIZE)
+		return BADARG();
+
+	pcl_lock_acquire(&memtags.lock);
+
+	int tag = memtags.count;
+
+	if(tag < PCL_MEMTAG_MAX)
+	{
+		pcl_strcpy(memtags.tags[tag].name, PCL_MEMTAG_NAMESIZE, name);
+
+		/* publishes the name along with the count */
+		pcl_atomic_store32(&memtags.count, tag + 1, PCL_ATOMIC_RELEASE);
+	}
+
+	pcl_lock_release(&memtags.lock);
+
+	if(tag == PCL_MEMTAG_MAX)
+		return SETERRMSG(PCL_ENOSPC, "all %d memory tags are in use", PCL_MEMTAG_MAX);
+
+	return tag;
+}
+
+int
+pcl_memtag_limit(int tag, int64_t limit)
+{
+	if(tag == PCL_MEMTAG_NONE || !valid_tag(tag) || limit < 0)
+		return BADARG();
+
+	if(!memtags.enabled)
+		return SETERRMSG(PCL_ENOTREADY, "memory accounting is not enabled", 0);
+
+	pcl_atomic_store64(&memtags.tags[tag].limit, limit, PCL_ATOMIC_RELAXED);
+	return 0;
+}
+
+int
+pcl_memtag_usage(int tag, pcl_memtag_usage_t *usage)
+{
+	if(!valid_tag(tag) || !usage)
+		return BADARG();
+
+	ipcl_memtag_t *t = &memtags.tags[tag];
+
+	usage->name = t->name;
+	usage->live = pcl_atomic_load64(&t->live, PCL_ATOMIC_RELAXED);
+	usage->peak = pcl_atomic_load64(&t->peak, PCL_ATOMIC_RELAXED);
+	usage->limit = pcl_atomic_load64(&t->limit, PCL_ATOMIC_RELAXED);
+	usage->exceeded = pcl_atomic_load64(&t->exceeded, PCL_ATOMIC_RELAXED);
+	return 0;
+}
+
+bool
+pcl_memtag_exceeded(int tag)
+{
+	if(!valid_tag(tag))
+		return false;
+
+	ipcl_memtag_t *t = &memtags.tags[tag];
+	int64_t limit = pcl_atomic_load64(&t->limit, PCL_ATOMIC_RELAXED);
+
+	return limit > 0 && pcl_atomic_load64(&t->live, PCL_ATOMIC_RELAXED) > limit;
+}
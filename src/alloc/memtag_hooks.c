@@ -0,0 +1,145 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_alloc.h"
+#include <pcl/atomic.h>
+#include <stdint.h>
+
+#define HDRSIZE sizeof(ipcl_memtag_hdr_t)
+
+/* the profiler, when enabled, sits beneath accounting and does not count its header */
+#define BLOCK_ALLOC(a, n, zero) (ipcl_memprof()->enabled ? \
+	ipcl_memprof_alloc(a, n, HDRSIZE, zero, PCL_LOCATION_VALS) : \
+	(zero) ? (a)->zalloc((a)->ctx, HDRSIZE + (n)) : (a)->alloc((a)->ctx, HDRSIZE + (n)))
+
+static void
+charge(int tag, int64_t size, void *ptr, PCL_LOCATION_PARAMS)
+{
+	ipcl_memtag_t *t = &ipcl_memtags()->tags[tag];
+	int64_t live = pcl_atomic_fetch_add64(&t->live, size, PCL_ATOMIC_RELAXED) + size;
+
+	if(size <= 0)
+		return;
+
+	int64_t peak = pcl_atomic_load64(&t->peak, PCL_ATOMIC_RELAXED);
+
+	while(live > peak && !pcl_atomic_cas64_weak(&t->peak, &peak, live, PCL_ATOMIC_RELAXED))
+		;
+
+	/* only the allocation that crosses the limit reports it */
+	int64_t limit = pcl_atomic_load64(&t->limit, PCL_ATOMIC_RELAXED);
+
+	if(limit > 0 && live > limit && live - size <= limit)
+	{
+		pcl_atomic_fetch_add64(&t->exceeded, 1, PCL_ATOMIC_RELAXED);
+		pcl_memory_error(PCL_MEMORY_LIMIT, ptr, (size_t) size, PCL_LOCATION_VALS);
+	}
+}
+
+void *
+ipcl_memtag_alloc(const pcl_allocator_t *a, size_t n, bool zero, PCL_LOCATION_PARAMS)
+{
+	if(n > INT64_MAX - HDRSIZE)
+		return NULL;
+
+	ipcl_memtag_hdr_t *hdr = BLOCK_ALLOC(a, n, zero);
+
+	if(!hdr)
+		return NULL;
+
+	hdr->tag = ipcl_memtag_current();
+	hdr->size = (int64_t) n;
+
+	if(hdr->tag != PCL_MEMTAG_NONE)
+		charge((int) hdr->tag, hdr->size, hdr + 1, PCL_LOCATION_VALS);
+
+	return hdr + 1;
+}
+
+void *
+ipcl_memtag_resize(const pcl_allocator_t *a, void *ptr, size_t n, PCL_LOCATION_PARAMS)
+{
+	if(n > INT64_MAX - HDRSIZE)
+		return NULL;
+
+	ipcl_memtag_hdr_t *hdr = (ipcl_memtag_hdr_t *) ptr - 1;
+
+	if(ipcl_memprof()->enabled)
+		hdr = ipcl_memprof_resize(a, hdr, n, HDRSIZE, PCL_LOCATION_VALS);
+	else
+		hdr = a->resize(a->ctx, hdr, HDRSIZE + n);
+
+	if(!hdr)
+		return NULL;
+
+	/* the block stays with the tag it was allocated under */
+	int64_t delta = (int64_t) n - hdr->size;
+
+	hdr->size = (int64_t) n;
+
+	if(hdr->tag != PCL_MEMTAG_NONE)
+		charge((int) hdr->tag, delta, hdr + 1, PCL_LOCATION_VALS);
+
+	return hdr + 1;
+}
+
+void
+ipcl_memtag_release(const pcl_allocator_t *a, void *ptr)
+{
+	ipcl_memtag_hdr_t *hdr = (ipcl_memtag_hdr_t *) ptr - 1;
+
+	if(hdr->tag != PCL_MEMTAG_NONE)
+		pcl_atomic_fetch_add64(&ipcl_memtags()->tags[hdr->tag].live, -hdr->size,
+			PCL_ATOMIC_RELAXED);
+
+	if(ipcl_memprof()->enabled)
+		ipcl_memprof_release(a, hdr);
+	else
+		a->release(a->ctx, hdr);
+}
+
+int
+ipcl_memtag_charge(int64_t size, PCL_LOCATION_PARAMS)
+{
+	int tag = ipcl_memtag_current();
+
+	if(tag != PCL_MEMTAG_NONE)
+		charge(tag, size, NULL, PCL_LOCATION_VALS);
+
+	return tag;
+}
+
+void
+ipcl_memtag_credit(int tag, int64_t size)
+{
+	if(tag != PCL_MEMTAG_NONE)
+		pcl_atomic_fetch_add64(&ipcl_memtags()->tags[tag].live, -size, PCL_ATOMIC_RELAXED);
+}
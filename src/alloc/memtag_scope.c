@@ -0,0 +1,130 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_alloc.h"
+#include <pcl/atomic.h>
+#include <pcl/thread.h>
+#include <stdint.h>
+
+/* Accounting runs before pcl_init, so the key is created on first use. The tag is stored
+ * as the key's value, leaving nothing to allocate or destroy.
+ */
+static pthread_key_t tlskey;
+static int32_t have_tlskey;
+static pcl_lock_t keylock = PCL_LOCK_INITIALIZER;
+
+static bool
+create_key(void)
+{
+	if(!pcl_atomic_load32(&have_tlskey, PCL_ATOMIC_ACQUIRE))
+	{
+		pcl_lock_acquire(&keylock);
+
+		if(!have_tlskey && pthread_key_create(&tlskey, NULL) == 0)
+			pcl_atomic_store32(&have_tlskey, 1, PCL_ATOMIC_RELEASE);
+
+		pcl_lock_release(&keylock);
+	}
+
+	return pcl_atomic_load32(&have_tlskey, PCL_ATOMIC_ACQUIRE) != 0;
+}
+
+int
+ipcl_memtag_current(void)
+{
+	if(!pcl_atomic_load32(&have_tlskey, PCL_ATOMIC_ACQUIRE))
+		return PCL_MEMTAG_NONE;
+
+	return (int) (intptr_t) pthread_getspecific(tlskey);
+}
+
+int
+pcl_memtag_set(int tag)
+{
+	if(tag < 0 || tag >= pcl_atomic_load32(&ipcl_memtags()->count, PCL_ATOMIC_ACQUIRE))
+		return BADARG();
+
+	if(!create_key())
+		return SETERRMSG(PCL_ENOMEM, "cannot create thread key", 0);
+
+	int prev = ipcl_memtag_current();
+
+	if(pthread_setspecific(tlskey, (void *) (intptr_t) tag))
+		return SETERRMSG(PCL_ENOMEM, "cannot set thread key", 0);
+
+	return prev;
+}
+
+int
+pcl_memtag_get(void)
+{
+	return ipcl_memtag_current();
+}
+
+int
+ipcl_memtag_enter(int tag)
+{
+	if(!ipcl_memtags()->enabled || ipcl_memtag_current() != PCL_MEMTAG_NONE || !create_key())
+		return -1;
+
+	pthread_setspecific(tlskey, (void *) (intptr_t) tag);
+	return PCL_MEMTAG_NONE;
+}
+
+int
+ipcl_memtag_suspend(void)
+{
+	int prev = ipcl_memtag_current();
+
+	if(prev == PCL_MEMTAG_NONE)
+		return -1;
+
+	pthread_setspecific(tlskey, (void *) (intptr_t) PCL_MEMTAG_NONE);
+	return prev;
+}
+
+void
+ipcl_memtag_leave(int prev)
+{
+	if(prev >= 0)
+		pthread_setspecific(tlskey, (void *) (intptr_t) prev);
+}
+
+bool
+ipcl_memtag_exceeded(void)
+{
+	if(!ipcl_memtags()->enabled)
+		return false;
+
+	int tag = ipcl_memtag_current();
+
+	return tag != PCL_MEMTAG_NONE && pcl_memtag_exceeded(tag);
+}
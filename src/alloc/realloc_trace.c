@@ -29,13 +29,22 @@
   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
-#include <pcl/alloc.h>
-#include <stdlib.h>
+#include "_alloc.h"
 
 void *
 pcl_realloc_trace(void *ptr, size_t n, PCL_LOCATION_PARAMS)
 {
-	void *p = ptr ? realloc(ptr, n) : malloc(n);
+	const pcl_allocator_t *a = ipcl_allocator();
+	void *p;
+
+	if(ipcl_memtags()->enabled)
+		p = ptr ? ipcl_memtag_resize(a, ptr, n, PCL_LOCATION_VALS) :
+			ipcl_memtag_alloc(a, n, false, PCL_LOCATION_VALS);
+	else if(ipcl_memprof()->enabled)
+		p = ptr ? ipcl_memprof_resize(a, ptr, n, 0, PCL_LOCATION_VALS) :
+			ipcl_memprof_alloc(a, n, 0, false, PCL_LOCATION_VALS);
+	else
+		p = ptr ? a->resize(a->ctx, ptr, n) : a->alloc(a->ctx, n);
 
 	if(!p)
 		pcl_memory_error("pcl_realloc", ptr, n, PCL_LOCATION_VALS);
@@ -0,0 +1,396 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_alloc.h"
+#include <pcl/sync.h>
+#include <pcl/atomic.h>
+#include <pcl/thread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define TC_CLASSES 20
+#define TC_MAXSIZE 1024
+#define TC_CHUNK (64 * 1024)
+
+/* header class value of a block that came from the C library */
+#define TC_LARGE ((size_t) -1)
+
+/* Precedes every block. Its 16 byte size keeps user memory aligned like malloc. */
+typedef struct
+{
+	size_t cls;
+	size_t size;   /* requested size, large blocks only */
+} tc_header_t;
+
+/* free blocks are linked through their user memory */
+typedef struct tag_tc_block
+{
+	struct tag_tc_block *next;
+} tc_block_t;
+
+typedef struct
+{
+	tc_block_t *head;
+	uint32_t count;
+} tc_list_t;
+
+typedef struct
+{
+	pcl_lock_t lock;
+	tc_list_t list;
+} tc_central_t;
+
+/* 16 byte steps to 128, then four classes per power of two */
+static const uint32_t class_size[TC_CLASSES] = {
+	16, 32, 48, 64, 80, 96, 112, 128, 160, 192,
+	224, 256, 320, 384, 448, 512, 640, 768, 896, 1024
+};
+
+/* class of a request, indexed by (size + 15) / 16 */
+static const uint8_t class_index[TC_MAXSIZE / 16 + 1] = {
+	0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 12, 12, 13,
+	13, 13, 13, 14, 14, 14, 14, 15, 15, 15, 15, 16, 16, 16, 16, 16, 16, 16, 16,
+	17, 17, 17, 17, 17, 17, 17, 17, 18, 18, 18, 18, 18, 18, 18, 18, 19, 19, 19,
+	19, 19, 19, 19, 19
+};
+
+static tc_central_t central[TC_CLASSES];
+
+static pthread_key_t tlskey;
+static int32_t have_tlskey;
+static pcl_lock_t keylock = PCL_LOCK_INITIALIZER;
+
+/* blocks moved between a thread and the central list at once, roughly 8K worth */
+static inline uint32_t
+tc_batch(size_t cls)
+{
+	uint32_t n = 8192 / class_size[cls];
+	return n < 8 ? 8 : n > 64 ? 64 : n;
+}
+
+static void
+tc_push(tc_list_t *list, tc_block_t *head, tc_block_t *tail, uint32_t count)
+{
+	tail->next = list->head;
+	list->head = head;
+	list->count += count;
+}
+
+/* move up to 'count' blocks from 'src' to 'dst' */
+static uint32_t
+tc_move(tc_list_t *dst, tc_list_t *src, uint32_t count)
+{
+	tc_block_t *head = src->head, *tail = NULL;
+	uint32_t n = 0;
+
+	for(tc_block_t *b = head; b && n < count; b = b->next, n++)
+		tail = b;
+
+	if(n > 0)
+	{
+		src->head = tail->next;
+		src->count -= n;
+		tc_push(dst, head, tail, n);
+	}
+
+	return n;
+}
+
+/* TLS callback: returns the thread's blocks to the central lists */
+static void
+tc_destroy(void *obj)
+{
+	tc_list_t *lists = obj;
+
+	for(size_t cls = 0; cls < TC_CLASSES; cls++)
+	{
+		if(lists[cls].count == 0)
+			continue;
+
+		pcl_lock_acquire(&central[cls].lock);
+		tc_move(&central[cls].list, &lists[cls], lists[cls].count);
+		pcl_lock_release(&central[cls].lock);
+	}
+
+	free(lists);
+}
+
+/* The allocator can be installed before pcl_init, so the key is created on first use
+ * with the C library directly rather than through the error-reporting tls functions.
+ */
+static tc_list_t *
+tc_cache(bool create)
+{
+	if(!pcl_atomic_load32(&have_tlskey, PCL_ATOMIC_ACQUIRE))
+	{
+		if(!create)
+			return NULL;
+
+		pcl_lock_acquire(&keylock);
+
+		if(!have_tlskey && pthread_key_create(&tlskey, tc_destroy) == 0)
+			pcl_atomic_store32(&have_tlskey, 1, PCL_ATOMIC_RELEASE);
+
+		pcl_lock_release(&keylock);
+
+		if(!pcl_atomic_load32(&have_tlskey, PCL_ATOMIC_ACQUIRE))
+			return NULL;
+	}
+
+	tc_list_t *lists = pthread_getspecific(tlskey);
+
+	if(!lists && create)
+	{
+		lists = calloc(TC_CLASSES, sizeof(tc_list_t));
+
+		if(lists && pthread_setspecific(tlskey, lists))
+		{
+			free(lists);
+			lists = NULL;
+		}
+	}
+
+	return lists;
+}
+
+/* Refill 'list' from the central list, carving a new chunk when that is empty. Surplus
+ * blocks from the chunk go to the central list.
+ */
+static bool
+tc_refill(tc_list_t *list, size_t cls)
+{
+	tc_central_t *c = &central[cls];
+	uint32_t batch = tc_batch(cls);
+
+	pcl_lock_acquire(&c->lock);
+	uint32_t n = tc_move(list, &c->list, batch);
+	pcl_lock_release(&c->lock);
+
+	if(n > 0)
+		return true;
+
+	char *chunk = malloc(TC_CHUNK);
+
+	if(!chunk)
+		return false;
+
+	size_t stride = sizeof(tc_header_t) + class_size[cls];
+	uint32_t total = TC_CHUNK / stride;
+	tc_list_t carved = {NULL, 0};
+
+	for(uint32_t i = total; i-- > 0; )
+	{
+		tc_header_t *hdr = (tc_header_t *) (chunk + i * stride);
+		tc_block_t *b = (tc_block_t *) (hdr + 1);
+
+		hdr->cls = cls;
+		hdr->size = 0;
+		b->next = carved.head;
+		carved.head = b;
+		carved.count++;
+	}
+
+	tc_move(list, &carved, batch);
+
+	if(carved.count > 0)
+	{
+		pcl_lock_acquire(&c->lock);
+		tc_move(&c->list, &carved, carved.count);
+		pcl_lock_release(&c->lock);
+	}
+
+	return true;
+}
+
+static void *
+tc_large(size_t size, bool zero)
+{
+	if(size > SIZE_MAX - sizeof(tc_header_t))
+		return NULL;
+
+	size_t n = sizeof(tc_header_t) + size;
+	tc_header_t *hdr = zero ? calloc(1, n) : malloc(n);
+
+	if(!hdr)
+		return NULL;
+
+	hdr->cls = TC_LARGE;
+	hdr->size = size;
+	return hdr + 1;
+}
+
+static void *
+tc_alloc(void *ctx, size_t size)
+{
+	UNUSED(ctx);
+
+	if(size > TC_MAXSIZE)
+		return tc_large(size, false);
+
+	size_t cls = class_index[(size + 15) >> 4];
+	tc_list_t *lists = tc_cache(true);
+	tc_block_t *b;
+
+	/* no cache during thread teardown or when TLS is unavailable */
+	if(!lists)
+	{
+		tc_list_t one = {NULL, 0};
+
+		if(!tc_refill(&one, cls))
+			return NULL;
+
+		b = one.head;
+		one.head = b->next;
+		one.count--;
+
+		if(one.count > 0)
+		{
+			pcl_lock_acquire(&central[cls].lock);
+			tc_move(&central[cls].list, &one, one.count);
+			pcl_lock_release(&central[cls].lock);
+		}
+
+		return b;
+	}
+
+	tc_list_t *list = &lists[cls];
+
+	if(!list->head && !tc_refill(list, cls))
+		return NULL;
+
+	b = list->head;
+	list->head = b->next;
+	list->count--;
+	return b;
+}
+
+static void *
+tc_zalloc(void *ctx, size_t size)
+{
+	if(size > TC_MAXSIZE)
+		return tc_large(size, true);
+
+	void *p = tc_alloc(ctx, size);
+
+	if(p)
+		memset(p, 0, size);
+
+	return p;
+}
+
+static void
+tc_release(void *ctx, void *ptr)
+{
+	UNUSED(ctx);
+
+	tc_header_t *hdr = (tc_header_t *) ptr - 1;
+
+	if(hdr->cls == TC_LARGE)
+	{
+		free(hdr);
+		return;
+	}
+
+	size_t cls = hdr->cls;
+	tc_block_t *b = ptr;
+	tc_list_t *lists = tc_cache(false);
+
+	if(!lists)
+	{
+		pcl_lock_acquire(&central[cls].lock);
+		tc_push(&central[cls].list, b, b, 1);
+		pcl_lock_release(&central[cls].lock);
+		return;
+	}
+
+	tc_list_t *list = &lists[cls];
+	uint32_t batch = tc_batch(cls);
+
+	tc_push(list, b, b, 1);
+
+	/* keep between one and two batches cached */
+	if(list->count > 2 * batch)
+	{
+		pcl_lock_acquire(&central[cls].lock);
+		tc_move(&central[cls].list, list, batch);
+		pcl_lock_release(&central[cls].lock);
+	}
+}
+
+static void *
+tc_resize(void *ctx, void *ptr, size_t size)
+{
+	tc_header_t *hdr = (tc_header_t *) ptr - 1;
+
+	if(hdr->cls == TC_LARGE)
+	{
+		if(size > TC_MAXSIZE)
+		{
+			if(size > SIZE_MAX - sizeof(tc_header_t))
+				return NULL;
+
+			hdr = realloc(hdr, sizeof(tc_header_t) + size);
+
+			if(!hdr)
+				return NULL;
+
+			hdr->size = size;
+			return hdr + 1;
+		}
+	}
+	/* still fits its class and would not drop to a much smaller one */
+	else if(size <= class_size[hdr->cls] && size > class_size[hdr->cls] / 2)
+	{
+		return ptr;
+	}
+
+	size_t oldsize = hdr->cls == TC_LARGE ? hdr->size : class_size[hdr->cls];
+	void *p = tc_alloc(ctx, size);
+
+	if(p)
+	{
+		memcpy(p, ptr, oldsize < size ? oldsize : size);
+		tc_release(ctx, ptr);
+	}
+
+	return p;
+}
+
+static const pcl_allocator_t tcache_allocator = {
+	"tcache", NULL, tc_alloc, tc_zalloc, tc_resize, tc_release
+};
+
+const pcl_allocator_t *
+pcl_allocator_tcache(void)
+{
+	return &tcache_allocator;
+}
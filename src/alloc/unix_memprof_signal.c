@@ -0,0 +1,152 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_alloc.h"
+#include <pcl/thread.h>
+#include <pcl/string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+/* The handler only writes a byte to a pipe. Building and saving the JSON allocates, so it
+ * runs on a writer thread that reads the other end.
+ */
+static int sigpipe[2] = {-1, -1};
+static pcl_lock_t siglock = PCL_LOCK_INITIALIZER;
+static pchar_t *sigpath;
+
+static void
+signal_handler(int signum)
+{
+	int e = errno;
+	char c = 1;
+
+	UNUSED(signum);
+
+	if(write(sigpipe[1], &c, 1) < 0)
+	{
+		/* pipe full, a save is already pending */
+	}
+
+	errno = e;
+}
+
+static void
+writer_main(void *arg)
+{
+	char c;
+
+	UNUSED(arg);
+
+	for(;;)
+	{
+		ssize_t n = read(sigpipe[0], &c, 1);
+
+		if(n < 0 && errno == EINTR)
+			continue;
+
+		if(n <= 0)
+			break;
+
+		pcl_lock_acquire(&siglock);
+		pchar_t *path = pcl_pcsdup(sigpath);
+		pcl_lock_release(&siglock);
+
+		if(path)
+		{
+			pcl_memprof_save(path);
+			pcl_free(path);
+		}
+	}
+}
+
+int
+pcl_memprof_signal(int signum, const pchar_t *path)
+{
+	if(signum <= 0 || strempty(path))
+		return BADARG();
+
+	if(!ipcl_memprof()->enabled)
+		return SETERRMSG(PCL_ENOTREADY, "allocation profiler is not enabled", 0);
+
+	pchar_t *dup = pcl_pcsdup(path);
+
+	if(!dup)
+		return TRC();
+
+	pcl_lock_acquire(&siglock);
+
+	pchar_t *old = sigpath;
+	sigpath = dup;
+
+	if(sigpipe[0] == -1)
+	{
+		pthread_t t;
+
+		if(pipe(sigpipe))
+		{
+			int r = SETLASTERR();
+			sigpipe[0] = sigpipe[1] = -1;
+			pcl_lock_release(&siglock);
+			return r;
+		}
+
+		fcntl(sigpipe[0], F_SETFD, FD_CLOEXEC);
+		fcntl(sigpipe[1], F_SETFD, FD_CLOEXEC);
+		fcntl(sigpipe[1], F_SETFL, O_NONBLOCK);
+
+		if(pcl_thread(&t, writer_main, NULL))
+		{
+			close(sigpipe[0]);
+			close(sigpipe[1]);
+			sigpipe[0] = sigpipe[1] = -1;
+			pcl_lock_release(&siglock);
+			return TRC();
+		}
+	}
+
+	pcl_lock_release(&siglock);
+
+	if(old)
+		pcl_free(old);
+
+	struct sigaction sa = {0};
+
+	sa.sa_handler = signal_handler;
+	sa.sa_flags = SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+
+	if(sigaction(signum, &sa, NULL))
+		return SETLASTERR();
+
+	return 0;
+}
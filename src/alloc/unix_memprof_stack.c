@@ -0,0 +1,75 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_alloc.h"
+#include <pcl/json.h>
+#include <execinfo.h>
+#include <stdlib.h>
+#include <string.h>
+
+int
+ipcl_memprof_backtrace(void **frames, int max)
+{
+	/* skip this function and the profiler hooks */
+	void *buf[PCL_MEMPROF_DEPTH + 3];
+	int n = backtrace(buf, max + 3) - 3;
+
+	if(n <= 0)
+		return 0;
+
+	memcpy(frames, buf + 3, n * sizeof(void *));
+	return n;
+}
+
+pcl_json_t *
+ipcl_memprof_symbols(void **frames, int depth)
+{
+	char **symbols = backtrace_symbols(frames, depth);
+
+	if(!symbols)
+		return R_SETERR(NULL, PCL_ENOMEM);
+
+	pcl_json_t *arr = pcl_json_arr();
+
+	for(int i = 0; i < depth; i++)
+	{
+		if(pcl_json_arraddstr(arr, symbols[i], 0) < 0)
+		{
+			pcl_json_free(arr);
+			arr = R_TRC(NULL);
+			break;
+		}
+	}
+
+	/* allocated by libc */
+	free(symbols);
+	return arr;
+}
@@ -29,13 +29,20 @@
   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
-#include <pcl/alloc.h>
-#include <stdlib.h>
+#include "_alloc.h"
 
 void *
 pcl_zalloc_trace(size_t n, PCL_LOCATION_PARAMS)
 {
-	void *ptr = calloc(n, 1);
+	const pcl_allocator_t *a = ipcl_allocator();
+	void *ptr;
+
+	if(ipcl_memtags()->enabled)
+		ptr = ipcl_memtag_alloc(a, n, true, PCL_LOCATION_VALS);
+	else if(ipcl_memprof()->enabled)
+		ptr = ipcl_memprof_alloc(a, n, 0, true, PCL_LOCATION_VALS);
+	else
+		ptr = a->zalloc(a->ctx, n);
 
 	if(!ptr)
 		pcl_memory_error("pcl_zalloc", NULL, n, PCL_LOCATION_VALS);
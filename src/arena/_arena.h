@@ -0,0 +1,82 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL__ARENA_H
+#define LIBPCL__ARENA_H
+
+#include <pcl/arena.h>
+#include <pcl/alloc.h>
+#include <pcl/error.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* round 'p' up to 'align', a power of two */
+#define ARENA_ALIGNUP(p, align) (((p) + ((align) - 1)) & ~((uintptr_t) (align) - 1))
+
+typedef struct tag_ipcl_arena_chunk ipcl_arena_chunk_t;
+
+struct tag_ipcl_arena_chunk
+{
+	/* chunk filled before this one, or the next spare chunk */
+	ipcl_arena_chunk_t *prev;
+
+	/* capacity of data, equal to the arena's chunksize unless oversized */
+	size_t size;
+	size_t used;
+
+	char data[];
+};
+
+struct tag_pcl_arena
+{
+	/* chunk being bumped, most recent first */
+	ipcl_arena_chunk_t *head;
+
+	/* standard chunks released by reset or rewind */
+	ipcl_arena_chunk_t *spare;
+
+	size_t chunksize;
+};
+
+/* push a chunk with room for 'need' bytes */
+PCL_PRIVATE ipcl_arena_chunk_t *ipcl_arena_grow(pcl_arena_t *a, size_t need);
+
+/* pop the head chunk, keeping it as a spare unless oversized */
+PCL_PRIVATE void ipcl_arena_pop(pcl_arena_t *a);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPCL__ARENA_H
@@ -0,0 +1,78 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_arena.h"
+
+ipcl_arena_chunk_t *
+ipcl_arena_grow(pcl_arena_t *a, size_t need)
+{
+	ipcl_arena_chunk_t *c;
+
+	if(need <= a->chunksize && a->spare)
+	{
+		c = a->spare;
+		a->spare = c->prev;
+	}
+	else
+	{
+		/* oversized requests get a chunk of their own, freed rather than kept as a spare */
+		size_t size = need > a->chunksize ? need : a->chunksize;
+
+		if(size > SIZE_MAX - sizeof(ipcl_arena_chunk_t))
+			return R_SETERRMSG(NULL, PCL_EINVAL, "arena allocation too large: %zu", need);
+
+		c = pcl_malloc(sizeof(ipcl_arena_chunk_t) + size);
+		c->size = size;
+	}
+
+	c->used = 0;
+	c->prev = a->head;
+	a->head = c;
+	return c;
+}
+
+void
+ipcl_arena_pop(pcl_arena_t *a)
+{
+	ipcl_arena_chunk_t *c = a->head;
+
+	a->head = c->prev;
+
+	if(c->size == a->chunksize)
+	{
+		c->prev = a->spare;
+		a->spare = c;
+	}
+	else
+	{
+		pcl_free(c);
+	}
+}
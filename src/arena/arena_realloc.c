@@ -0,0 +1,65 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_arena.h"
+#include <string.h>
+
+void *
+pcl_arena_realloc(pcl_arena_t *a, void *ptr, size_t oldsize, size_t size)
+{
+	if(!ptr)
+		return pcl_arena_alloc(a, size);
+
+	if(!a)
+		return R_SETERR(NULL, PCL_EINVAL);
+
+	ipcl_arena_chunk_t *c = a->head;
+	uintptr_t p = (uintptr_t) ptr;
+
+	/* the most recent allocation ends at the chunk's used mark */
+	if(c && p >= (uintptr_t) c->data && p + oldsize == (uintptr_t) c->data + c->used &&
+		size <= (uintptr_t) c->data + c->size - p)
+	{
+		c->used = p + size - (uintptr_t) c->data;
+		return ptr;
+	}
+
+	if(size <= oldsize)
+		return ptr;
+
+	void *newptr = pcl_arena_alloc(a, size);
+
+	if(!newptr)
+		return R_TRC(NULL);
+
+	memcpy(newptr, ptr, oldsize);
+	return newptr;
+}
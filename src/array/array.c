@@ -40,6 +40,7 @@ pcl_array(int initial_capacity, pcl_cleanup_t cleanup)
 	arr->count = 0;
 	arr->capacity = max(0, initial_capacity);
 	arr->cleanup = cleanup;
+	arr->arena = NULL;
 	arr->elements = arr->capacity ? pcl_zalloc(arr->capacity * sizeof(void*)) : NULL;
 
 	return arr;
@@ -43,7 +43,11 @@ pcl_array_free(pcl_array_t *arr)
 				arr->cleanup(arr->elements[i]);
 		}
 
-		pcl_free_safe(arr->elements);
-		pcl_free(arr);
+		/* arena memory is reclaimed with the arena */
+		if(!arr->arena)
+		{
+			pcl_free_safe(arr->elements);
+			pcl_free(arr);
+		}
 	}
 }
@@ -32,6 +32,7 @@
 #include <pcl/array.h>
 #include <pcl/error.h>
 #include <pcl/alloc.h>
+#include <pcl/arena.h>
 #include <string.h>
 
 int
@@ -42,8 +43,17 @@ pcl_array_insert(pcl_array_t *arr, void *elem, int index)
 
 	if(arr->count == arr->capacity)
 	{
-		arr->capacity = arr->capacity > 0 ? arr->capacity * 2 : 8;
-		arr->elements = pcl_realloc(arr->elements, arr->capacity * sizeof(void*));
+		int capacity = arr->capacity > 0 ? arr->capacity * 2 : 8;
+		void **elements = arr->arena ?
+			pcl_arena_realloc(arr->arena, arr->elements, arr->capacity * sizeof(void*),
+				capacity * sizeof(void*)) :
+			pcl_realloc(arr->elements, capacity * sizeof(void*));
+
+		if(!elements)
+			return TRC();
+
+		arr->elements = elements;
+		arr->capacity = capacity;
 
 		/* this satisfies array_set by ensuring all unused elements are NULL */
 		memset(arr->elements + arr->count, 0, (arr->capacity - arr->count) * sizeof(void*));
@@ -31,16 +31,8 @@
 
 #include <pcl/atomic.h>
 
-#ifdef PCL_WINDOWS
-	#include <windows.h>
-#endif
-
 pcl_atomic_t
 pcl_atomic_add_fetch(pcl_atomic_t *dest, pcl_atomic_t add)
 {
-#ifdef _WIN32
-	return (pcl_atomic_t)InterlockedAdd64((LONGLONG volatile *)dest, add);
-#else
-	return (pcl_atomic_t)__atomic_add_fetch((long long *)dest, add, __ATOMIC_SEQ_CST);
-#endif
+	return pcl_atomic_fetch_add64(dest, add, PCL_ATOMIC_SEQ_CST) + add;
 }
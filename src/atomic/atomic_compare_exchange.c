@@ -31,18 +31,10 @@
 
 #include <pcl/atomic.h>
 
-#ifdef PCL_WINDOWS
-	#include <windows.h>
-#endif
-
 pcl_atomic_t
 pcl_atomic_compare_exchange(pcl_atomic_t *dest, pcl_atomic_t expected, pcl_atomic_t desired)
 {
-#ifdef PCL_WINDOWS
-	return (pcl_atomic_t)InterlockedCompareExchange64((LONGLONG volatile *)dest, desired, expected);
-#else
-	pcl_atomic_t orig = *dest;
-	(void)__atomic_compare_exchange_n(dest, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
-	return orig;
-#endif
+	/* expected receives the initial value on failure and already holds it on success */
+	(void) pcl_atomic_cas64(dest, &expected, desired, PCL_ATOMIC_SEQ_CST);
+	return expected;
 }
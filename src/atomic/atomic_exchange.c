@@ -31,16 +31,8 @@
 
 #include <pcl/atomic.h>
 
-#ifdef PCL_WINDOWS
-	#include <windows.h>
-#endif
-
 pcl_atomic_t
 pcl_atomic_exchange(pcl_atomic_t *dest, pcl_atomic_t val)
 {
-#ifdef PCL_WINDOWS
-	return (pcl_atomic_t)InterlockedExchange64((LONGLONG *)dest, (LONGLONG)val);
-#else
-	return (pcl_atomic_t)__atomic_exchange_n(dest, val, __ATOMIC_SEQ_CST);
-#endif
+	return pcl_atomic_exchange64(dest, val, PCL_ATOMIC_SEQ_CST);
 }
@@ -31,16 +31,8 @@
 
 #include <pcl/atomic.h>
 
-#ifdef PCL_WINDOWS
-	#include <windows.h>
-#endif
-
 pcl_atomic_t
 pcl_atomic_fetch(pcl_atomic_t *dest)
 {
-#ifdef PCL_WINDOWS
-	return (pcl_atomic_t)InterlockedAdd64((LONGLONG volatile *)dest, 0);
-#else
-	return (pcl_atomic_t)__atomic_load_n(dest, __ATOMIC_SEQ_CST);
-#endif
+	return pcl_atomic_load64(dest, PCL_ATOMIC_SEQ_CST);
 }
@@ -31,18 +31,8 @@
 
 #include <pcl/atomic.h>
 
-#ifdef PCL_WINDOWS
-	#include <windows.h>
-#endif
-
 pcl_atomic_t
 pcl_atomic_fetch_add(pcl_atomic_t *dest, pcl_atomic_t add)
 {
-#ifdef _WIN32
-	pcl_atomic_t orig = *dest;
-	(void)InterlockedAdd64((LONGLONG volatile *)dest, add);
-	return orig;
-#else
-	return (pcl_atomic_t)__atomic_fetch_add((long long *)dest, add, __ATOMIC_SEQ_CST);
-#endif
+	return pcl_atomic_fetch_add64(dest, add, PCL_ATOMIC_SEQ_CST);
 }
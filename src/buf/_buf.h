@@ -34,5 +34,15 @@
 
 #include <pcl/buf.h>
 #include <pcl/error.h>
+#include <pcl/arena.h>
+#include <pcl/alloc.h>
+
+/* smallest page size of supported platforms, larger pages are a multiple of it */
+#define BUF_PAGESIZE 4096
+
+/* resize a buffer's data to 'bytes', from its arena when it has one */
+#define BUF_REALLOC(b, bytes) ((b)->arena ? \
+	pcl_arena_realloc((b)->arena, (b)->data, (b)->size * (b)->chrsize, bytes) : \
+	pcl_realloc((b)->data, bytes))
 
 #endif // LIBPCL__BUF_H
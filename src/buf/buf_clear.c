@@ -38,8 +38,12 @@ pcl_buf_clear(pcl_buf_t *b)
 	if(!b)
 		return R_SETERR(NULL, PCL_EINVAL);
 
+	/* arena memory is reclaimed with the arena */
+	if(!b->arena)
+		pcl_free_safe(b->data);
+
 	b->size = b->len = b->pos = 0;
-	b->data = pcl_free_safe(b->data);
+	b->data = NULL;
 
 	return b;
 }
@@ -30,6 +30,7 @@
 */
 
 #include "_buf.h"
+#include "../alloc/_alloc.h" // ipcl_memtag_enter
 #include <pcl/alloc.h>
 #include <string.h>
 
@@ -45,11 +46,25 @@ pcl_buf_copy(pcl_buf_t *dest, const pcl_buf_t *src)
 	}
 	else
 	{
-		dest->data = pcl_realloc(dest->data, src->size * src->chrsize);
+		int tag = ipcl_memtag_enter(PCL_MEMTAG_BUF);
+		char *data = BUF_REALLOC(dest, src->size * src->chrsize);
+
+		ipcl_memtag_leave(tag);
+
+		if(!data)
+			return R_TRC(NULL);
+
+		dest->data = data;
 		dest->mode = src->mode;
+		dest->chrsize = src->chrsize;
 		dest->size = src->size;
 	}
 
+	dest->growth = src->growth;
+	dest->factor = src->factor;
+	dest->maxsize = src->maxsize;
+	dest->lazynul = src->lazynul;
+
 	dest->len = src->len;
 	dest->pos = src->pos;
 	memcpy(dest->data, src->data, (src->len + 1) * dest->chrsize);
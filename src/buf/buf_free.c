@@ -35,6 +35,9 @@
 pcl_buf_t *
 pcl_buf_free(pcl_buf_t *b)
 {
+	if(b && b->arena)
+		return NULL;
+
 	if(b)
 		b = pcl_free(pcl_buf_clear(b));
 	return b;
@@ -30,21 +30,64 @@
 */
 
 #include "_buf.h"
+#include "../alloc/_alloc.h" // ipcl_memtag_enter
 #include <pcl/alloc.h>
 
 pcl_buf_t *
 pcl_buf_grow(pcl_buf_t *b, int len)
 {
-	if(!b)
+	if(!b || len < 0)
 		return R_SETERR(NULL, PCL_EINVAL);
 
-	int avail = (int) b->size - b->pos;
+	/* characters needed, not counting the NUL */
+	size_t need = (size_t) b->pos + len;
 
-	if(len >= (int) avail)
+	if(need < b->size)
+		return b;
+
+	size_t size = need * (b->factor ? b->factor : 200) / 100;
+
+	if(size <= need)
+		size = need + 1;
+
+	switch(b->growth)
 	{
-		b->size = (b->size + (len - avail)) * 2;
-		b->data = pcl_realloc(b->data, b->size * b->chrsize);
+		case PclBufGrowPage:
+		{
+			size_t bytes = size * b->chrsize;
+
+			bytes = (bytes + BUF_PAGESIZE - 1) & ~((size_t) BUF_PAGESIZE - 1);
+			size = bytes / b->chrsize;
+			break;
+		}
+
+		case PclBufGrowCapped:
+			if(need >= b->maxsize)
+				return R_SETERRMSG(NULL, PCL_EBUF, "buffer is capped at %llu characters",
+					(unsigned long long) b->maxsize);
+
+			if(size > b->maxsize)
+				size = b->maxsize;
+			break;
+
+		default:
+			break;
 	}
 
+	/* growth is where a buffer can fail cleanly, unlike most allocations */
+	if(ipcl_memtag_exceeded())
+		return R_SETERRMSG(NULL, PCL_ENOMEM, "memory limit exceeded", 0);
+
+	int tag = ipcl_memtag_enter(PCL_MEMTAG_BUF);
+	char *data = BUF_REALLOC(b, size * b->chrsize);
+
+	ipcl_memtag_leave(tag);
+
+	if(!data)
+		return R_TRC(NULL);
+
+	b->data = data;
+	b->size = size;
+
 	return b;
 }
@@ -30,6 +30,7 @@
 */
 
 #include "_buf.h"
+#include "../alloc/_alloc.h" // ipcl_memtag_enter
 #include <pcl/alloc.h>
 #include <string.h>
 
@@ -53,6 +54,8 @@ pcl_buf_init(pcl_buf_t *b, size_t size, enum pcl_buf_mode mode)
 			return R_SETERRMSG(NULL, PCL_EINVAL, "No such mode: %d", mode);
 	}
 
+	int tag = ipcl_memtag_enter(PCL_MEMTAG_BUF);
+
 	if(!b)
 		b = pcl_malloc(sizeof(pcl_buf_t));
 
@@ -60,6 +63,12 @@ pcl_buf_init(pcl_buf_t *b, size_t size, enum pcl_buf_mode mode)
 	b->chrsize = chrsize;
 	b->len = b->pos = 0;
 	b->size = size;
+	b->data = NULL;
+	b->growth = PclBufGrowGeometric;
+	b->factor = 0;
+	b->maxsize = 0;
+	b->lazynul = false;
+	b->arena = NULL;
 
 	if(b->size)
 	{
@@ -67,5 +76,6 @@ pcl_buf_init(pcl_buf_t *b, size_t size, enum pcl_buf_mode mode)
 		memset(b->data, 0, b->chrsize);
 	}
 
+	ipcl_memtag_leave(tag);
 	return b;
 }
@@ -38,7 +38,9 @@ pcl_buf_put(pcl_buf_t *b, const void *data, int len)
 	if(!b || len == 0)
 		return BADARG();
 
-	(void) pcl_buf_grow(b, len + 1);
+	/* grow always leaves room for the NUL */
+	if(!pcl_buf_grow(b, len))
+		return TRC();
 
 	memcpy(b->data + b->pos * b->chrsize, data, len * b->chrsize);
 	b->pos += len;
@@ -46,8 +48,9 @@ pcl_buf_put(pcl_buf_t *b, const void *data, int len)
 	if(b->len < b->pos)
 		b->len = b->pos;
 
-	/* ALWAYS NUL terminate, just not added to len */
-	memset(b->data + b->pos * b->chrsize, 0, b->chrsize);
+	/* NUL terminate unless lazy, just not added to len */
+	if(!b->lazynul)
+		memset(b->data + b->pos * b->chrsize, 0, b->chrsize);
 
 	return len;
 }
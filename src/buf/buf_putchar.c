@@ -34,7 +34,31 @@
 int
 pcl_buf_putchar(pcl_buf_t *b, uint32_t c)
 {
-	if(b)
-		return pcl_buf_put(b, (const void *)&c, 1);
-	return BADARG();
+	if(!b)
+		return BADARG();
+
+	if((size_t) b->pos + 1 >= b->size && !pcl_buf_grow(b, 1))
+		return TRC();
+
+	if(b->chrsize == 1)
+	{
+		b->data[b->pos++] = (char) c;
+
+		if(!b->lazynul)
+			b->data[b->pos] = 0;
+	}
+	else
+	{
+		wchar_t *w = (wchar_t *) b->data;
+
+		w[b->pos++] = (wchar_t) c;
+
+		if(!b->lazynul)
+			w[b->pos] = 0;
+	}
+
+	if(b->len < b->pos)
+		b->len = b->pos;
+
+	return 1;
 }
@@ -0,0 +1,65 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_buf.h"
+
+int
+pcl_buf_setgrowth(pcl_buf_t *b, enum pcl_buf_growth growth, size_t param)
+{
+	if(!b)
+		return BADARG();
+
+	switch(growth)
+	{
+		case PclBufGrowGeometric:
+		case PclBufGrowPage:
+			if(param != 0 && (param <= 100 || param > 10000))
+				return SETERRMSG(PCL_EINVAL, "growth factor must be 101-10000 percent: %d", (int) param);
+
+			b->factor = (int) param;
+			b->maxsize = 0;
+			break;
+
+		case PclBufGrowCapped:
+			if(param == 0)
+				return SETERRMSG(PCL_EINVAL, "capped growth requires a maximum size", 0);
+
+			b->factor = 0;
+			b->maxsize = param;
+			break;
+
+		default:
+			return SETERRMSG(PCL_EINVAL, "No such growth strategy: %d", growth);
+	}
+
+	b->growth = growth;
+	return 0;
+}
@@ -30,31 +30,62 @@
 */
 
 #include "_buf.h"
+#include "../string/_string.h" // pcl_strvformat
 #include <pcl/io.h>
 #include <string.h>
 
+static int
+putf(pcl_buf_t *b, size_t size, const void *format, va_list ap)
+{
+	if(b->chrsize == 1)
+		return pcl_strvformat(b->data + b->pos, size, format, ap);
+	return pcl_vswprintf(((wchar_t *) b->data) + b->pos, size, format, ap);
+}
+
 int
 pcl_buf_vputf(pcl_buf_t *b, const void *format, va_list ap)
 {
 	int len;
-
-	/* query for formatted length */
 	va_list ap2;
+
+	if(!b || !format)
+		return BADARG();
+
+	/* binary adds a NUL to every string */
+	int extra = b->mode == PclBufBinary ? 1 : 0;
+
+	/* make sure there is some spare capacity to format into */
+	if(pcl_buf_reserve(b, extra))
+		return TRC();
+
+	/* format optimistically into the spare capacity, which usually fits */
+	size_t avail = b->size - b->pos;
+
 	va_copy(ap2, ap);
-	len = b->chrsize == 1 ? pcl_vsprintf(NULL, 0, format, ap2) : pcl_vswprintf(NULL, 0, format, ap2);
+	len = putf(b, avail, format, ap2);
 	va_end(ap2);
 
-	if(len < 0)
-		return SETERR(-len);
+	if(len < 0 || (size_t) len + extra >= avail)
+	{
+		/* wide strings do not report their length when truncated */
+		if(len == -PCL_EBUF)
+		{
+			va_copy(ap2, ap);
+			len = b->chrsize == 1 ? pcl_vsprintf(NULL, 0, format, ap2) : pcl_vswprintf(NULL, 0, format, ap2);
+			va_end(ap2);
+		}
 
-	/* binary adds a NUL to every string */
-	pcl_buf_grow(b, b->mode == PclBufBinary ? len + 1 : len);
+		if(len < 0)
+			return SETERR(-len);
 
-	/* do a vsprintf buffer put */
-	if(b->chrsize == 1)
-		len = pcl_vsprintf(b->data + b->pos, b->size - b->pos, format, ap);
-	else
-		len = pcl_vswprintf(((wchar_t *) b->data) + b->pos, b->size - b->pos, format, ap);
+		if(pcl_buf_reserve(b, len + extra))
+			return TRC();
+
+		len = putf(b, b->size - b->pos, format, ap);
+
+		if(len < 0)
+			return SETERR(-len);
+	}
 
 	/* no NUL included yet */
 	b->pos += len;
@@ -66,8 +97,9 @@ pcl_buf_vputf(pcl_buf_t *b, const void *format, va_list ap)
 		len++;
 	}
 
-	/* add always present NUL: binary buffers "Abc\0\0", text buffers "Abc\0" */
-	memset(b->data + b->pos * b->chrsize, 0, b->chrsize);
+	/* add NUL unless lazy: binary buffers "Abc\0\0", text buffers "Abc\0" */
+	if(!b->lazynul)
+		memset(b->data + b->pos * b->chrsize, 0, b->chrsize);
 
 	if(b->len < b->pos)
 		b->len = b->pos;
@@ -0,0 +1,128 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL__EPOCH_H
+#define LIBPCL__EPOCH_H
+
+#include <pcl/epoch.h>
+#include <pcl/sync.h>
+#include <pcl/atomic.h>
+#include <pcl/alloc.h>
+#include <pcl/error.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EPOCH_CACHELINE 64
+
+/* items freed per pass of ipcl_epoch_collect */
+#define EPOCH_COLLECT 64
+
+/* a thread's announced state: (epoch << 1) | 1 inside a critical section, 0 outside */
+#define EPOCH_ACTIVE(e) (((e) << 1) | 1)
+#define EPOCH_OF(s) ((s) >> 1)
+
+typedef struct
+{
+	void *item;
+	pcl_cleanup_t cleanup;
+	int64_t epoch;
+} ipcl_epoch_item_t;
+
+/* Retired items in epoch order, oldest first */
+typedef struct
+{
+	ipcl_epoch_item_t *items;
+	int count;
+	int size;
+} ipcl_epoch_list_t;
+
+/* Per-thread registration. Records are linked once and never freed, a record released
+ * by an exiting thread is reused by the next thread that registers.
+ */
+typedef struct tag_ipcl_epoch_thread
+{
+	int64_t state;     /* read by reclaiming threads, alone on its cache line */
+	char pad[EPOCH_CACHELINE - sizeof(int64_t)];
+	struct tag_ipcl_epoch_thread *next;
+	int32_t inuse;
+	int nesting;
+	ipcl_epoch_list_t retired;
+	int threshold;     /* retired count that triggers the next reclaim */
+} ipcl_epoch_thread_t;
+
+typedef struct
+{
+	int64_t epoch;
+	char pad[EPOCH_CACHELINE - sizeof(int64_t)];
+	ipcl_epoch_thread_t *threads;
+
+	/* items left behind by exited threads */
+	pcl_lock_t orphanlock;
+	ipcl_epoch_list_t orphans;
+} ipcl_epoch_domain_t;
+
+/** Get the process wide epoch domain. */
+PCL_PRIVATE ipcl_epoch_domain_t *ipcl_epoch_domain(void);
+
+/* event handler: creates the epoch TLS key and registers new threads */
+PCL_PRIVATE void ipcl_epoch_handler(uint32_t which, void *data);
+
+/* true once PCL_EVENT_INIT created the TLS key, the epoch functions fail before that */
+PCL_PRIVATE bool ipcl_epoch_ready(void);
+
+/** Get the calling thread's record.
+ * @param create register the calling thread if it has no record
+ * @return pointer to a record or NULL if the thread is not registered or on error
+ */
+PCL_PRIVATE ipcl_epoch_thread_t *ipcl_epoch_thread(bool create);
+
+/** Advance the global epoch if every active thread has observed it.
+ * @return true if the epoch is now newer than when called
+ */
+PCL_PRIVATE bool ipcl_epoch_advance(void);
+
+/** Free the items of a list retired at least two epochs before epoch. Cleanup functions
+ * run after the list has been compacted, so they may retire more items.
+ * @return number of items freed
+ */
+PCL_PRIVATE int ipcl_epoch_collect(ipcl_epoch_list_t *list, int64_t epoch);
+
+/** Append items to a list, growing it as needed. */
+PCL_PRIVATE int ipcl_epoch_append(ipcl_epoch_list_t *list, const ipcl_epoch_item_t *items,
+	int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPCL__EPOCH_H
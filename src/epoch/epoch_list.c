@@ -0,0 +1,111 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_epoch.h"
+#include <string.h>
+
+int
+ipcl_epoch_append(ipcl_epoch_list_t *list, const ipcl_epoch_item_t *items, int count)
+{
+	if(list->count + count > list->size)
+	{
+		int size = list->size ? list->size : PCL_EPOCH_BATCH;
+
+		while(size < list->count + count)
+			size *= 2;
+
+		ipcl_epoch_item_t *p = pcl_realloc(list->items, size * sizeof(ipcl_epoch_item_t));
+
+		if(!p)
+			return TRC();
+
+		list->items = p;
+		list->size = size;
+	}
+
+	memcpy(list->items + list->count, items, count * sizeof(ipcl_epoch_item_t));
+	list->count += count;
+	return 0;
+}
+
+int
+ipcl_epoch_collect(ipcl_epoch_list_t *list, int64_t epoch)
+{
+	int total = 0;
+	ipcl_epoch_item_t batch[EPOCH_COLLECT];
+
+	for(;;)
+	{
+		int n = 0, kept = 0;
+
+		for(int i = 0; i < list->count; i++)
+		{
+			ipcl_epoch_item_t *item = &list->items[i];
+
+			if(n < EPOCH_COLLECT && item->epoch + 2 <= epoch)
+				batch[n++] = *item;
+			else
+				list->items[kept++] = *item;
+		}
+
+		list->count = kept;
+
+		for(int i = 0; i < n; i++)
+			batch[i].cleanup(batch[i].item);
+
+		total += n;
+
+		if(n < EPOCH_COLLECT)
+			return total;
+	}
+}
+
+bool
+ipcl_epoch_advance(void)
+{
+	ipcl_epoch_domain_t *d = ipcl_epoch_domain();
+	int64_t e = pcl_atomic_load64(&d->epoch, PCL_ATOMIC_SEQ_CST);
+
+	/* every thread inside a critical section must have seen the current epoch */
+	ipcl_epoch_thread_t *t = pcl_atomic_loadptr((void **) &d->threads, PCL_ATOMIC_ACQUIRE);
+
+	for(; t; t = t->next)
+	{
+		int64_t s = pcl_atomic_load64(&t->state, PCL_ATOMIC_SEQ_CST);
+
+		if((s & 1) && EPOCH_OF(s) != e)
+			return false;
+	}
+
+	/* failure means another thread advanced it */
+	(void) pcl_atomic_cas64(&d->epoch, &e, e + 1, PCL_ATOMIC_SEQ_CST);
+	return true;
+}
@@ -0,0 +1,57 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_epoch.h"
+#include <pcl/time.h>
+
+int
+pcl_epoch_synchronize(void)
+{
+	ipcl_epoch_domain_t *d = ipcl_epoch_domain();
+	ipcl_epoch_thread_t *t = ipcl_epoch_thread(true);
+
+	if(!t)
+		return TRC();
+
+	if(t->nesting > 0)
+		return SETERRMSG(PCL_EDEADLK, "cannot synchronize inside an epoch critical section", 0);
+
+	/* everything retired so far is tagged with at most the current epoch */
+	int64_t target = pcl_atomic_load64(&d->epoch, PCL_ATOMIC_SEQ_CST) + 2;
+
+	while(pcl_atomic_load64(&d->epoch, PCL_ATOMIC_SEQ_CST) < target)
+	{
+		if(!ipcl_epoch_advance())
+			pcl_sleep(100000, NULL, 0);
+	}
+
+	return pcl_epoch_reclaim() < 0 ? TRC() : 0;
+}
@@ -0,0 +1,126 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_epoch.h"
+#include <pcl/thread.h>
+#include <pcl/event.h>
+
+static ipcl_epoch_domain_t domain = {.orphanlock = PCL_LOCK_INITIALIZER};
+static pthread_key_t tlskey;
+static bool have_tlskey;
+
+/* TLS callback: hands pending items to the domain and releases the record for reuse */
+static void
+thread_release(void *obj)
+{
+	ipcl_epoch_thread_t *t = obj;
+
+	t->nesting = 0;
+	pcl_atomic_store64(&t->state, 0, PCL_ATOMIC_RELEASE);
+
+	if(t->retired.count > 0)
+	{
+		pcl_lock_acquire(&domain.orphanlock);
+
+		/* on failure the items leak, which is still safe */
+		(void) ipcl_epoch_append(&domain.orphans, t->retired.items, t->retired.count);
+		pcl_lock_release(&domain.orphanlock);
+		t->retired.count = 0;
+	}
+
+	t->threshold = PCL_EPOCH_BATCH;
+	pcl_atomic_store32(&t->inuse, 0, PCL_ATOMIC_RELEASE);
+}
+
+bool
+ipcl_epoch_ready(void)
+{
+	return have_tlskey;
+}
+
+ipcl_epoch_domain_t *
+ipcl_epoch_domain(void)
+{
+	return &domain;
+}
+
+ipcl_epoch_thread_t *
+ipcl_epoch_thread(bool create)
+{
+	if(!have_tlskey)
+		return create ? R_SETERRMSG(NULL, PCL_EINVAL, "epoch reclamation requires pcl_init", 0) : NULL;
+
+	ipcl_epoch_thread_t *t = pcl_tls_get(tlskey);
+
+	if(t || !create)
+		return t;
+
+	/* reuse a record released by an exited thread */
+	for(t = pcl_atomic_loadptr((void **) &domain.threads, PCL_ATOMIC_ACQUIRE); t; t = t->next)
+	{
+		int32_t unused = 0;
+
+		if(pcl_atomic_cas32(&t->inuse, &unused, 1, PCL_ATOMIC_ACQUIRE))
+			break;
+	}
+
+	if(!t)
+	{
+		t = pcl_zalloc(sizeof(ipcl_epoch_thread_t));
+		t->inuse = 1;
+		t->threshold = PCL_EPOCH_BATCH;
+		t->next = pcl_atomic_loadptr((void **) &domain.threads, PCL_ATOMIC_RELAXED);
+
+		while(!pcl_atomic_casptr_weak((void **) &domain.threads, (void **) &t->next, t,
+			PCL_ATOMIC_RELEASE))
+			;
+	}
+
+	if(pcl_tls_set(tlskey, t))
+	{
+		pcl_atomic_store32(&t->inuse, 0, PCL_ATOMIC_RELEASE);
+		return R_TRC(NULL);
+	}
+
+	return t;
+}
+
+void
+ipcl_epoch_handler(uint32_t which, void *data)
+{
+	UNUSED(data);
+
+	if(which == PCL_EVENT_INIT)
+		have_tlskey = pcl_tls_alloc(&tlskey, thread_release) == 0;
+
+	if(which == PCL_EVENT_THREADINIT)
+		(void) ipcl_epoch_thread(true);
+}
@@ -35,6 +35,7 @@
  */
 
 #include "_error.h"
+#include "../alloc/_alloc.h" // ipcl_memtag_enter
 #include <pcl/thread.h>
 #include <pcl/event.h>
 #include <pcl/alloc.h>
@@ -68,5 +69,10 @@ ipcl_err_handler(uint32_t which, void *data)
 		pcl_tls_alloc(&ctxkey, ctx_destroy);
 
 	if(which == PCL_EVENT_INIT || which == PCL_EVENT_THREADINIT)
+	{
+		int tag = ipcl_memtag_enter(PCL_MEMTAG_ERROR);
+
 		pcl_tls_set(ctxkey, pcl_zalloc(sizeof(pcl_err_t)));
+		ipcl_memtag_leave(tag);
+	}
 }
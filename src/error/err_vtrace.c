@@ -30,6 +30,8 @@
 */
 
 #include "_error.h"
+#include "../alloc/_alloc.h" // ipcl_memtag_enter
+#include "../string/_string.h" // pcl_strvformat
 #include <pcl/alloc.h>
 #include <pcl/io.h>
 #include <pcl/string.h>
@@ -49,6 +51,8 @@ pcl_err_vtrace(PCL_LOCATION_PARAMS, const char *format, va_list ap)
 	 */
 
 	size_t file_len = 0, func_len = 0, msg_len = 0;
+	char msgbuf[512];
+	bool msg_fits = false;
 
 	if(file)
 		file_len = strlen(file) + 1;
@@ -58,16 +62,26 @@ pcl_err_vtrace(PCL_LOCATION_PARAMS, const char *format, va_list ap)
 
 	if(!strempty(format))
 	{
+		/* format into a stack buffer, only format again when it did not fit */
 		va_list ap2;
 		va_copy(ap2, ap);
-		msg_len = pcl_vsprintf(NULL, 0, format, ap2) + 1; // query for size
+		int r = pcl_strvformat(msgbuf, sizeof(msgbuf), format, ap2);
 		va_end(ap2);
+
+		if(r >= 0)
+		{
+			msg_len = (size_t) r + 1;
+			msg_fits = msg_len <= sizeof(msgbuf);
+		}
 	}
 
 	size_t trc_len = sizeof(pcl_err_trace_t) + file_len + func_len + msg_len;
+	int tag = ipcl_memtag_enter(PCL_MEMTAG_ERROR);
 	pcl_err_trace_t *trc = pcl_zalloc(trc_len);
 	char *tail = (char *) (trc + 1);
 
+	ipcl_memtag_leave(tag);
+
 	trc->line = line;
 	trc->size = trc_len;
 	trc->file = file_len ? tail : NULL;
@@ -90,7 +104,9 @@ pcl_err_vtrace(PCL_LOCATION_PARAMS, const char *format, va_list ap)
 #endif
 	}
 
-	if(trc->msg)
+	if(msg_fits)
+		memcpy(trc->msg, msgbuf, msg_len);
+	else if(trc->msg)
 		pcl_vsprintf(trc->msg, msg_len, format, ap);
 
 	/* add to stack (push) */
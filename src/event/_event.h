@@ -33,15 +33,54 @@
 #define LIBPCL__EVENT_H__
 
 #include <pcl/event.h>
-#include <pcl/array.h>
+#include <pcl/atomic.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* atomic publication of the handler snapshot */
+#define EVENT_LOAD_ACQ(p) pcl_atomic_loadptr((void **) (p), PCL_ATOMIC_ACQUIRE)
+#define EVENT_STORE_REL(p, v) pcl_atomic_storeptr((void **) (p), (v), PCL_ATOMIC_RELEASE)
+
+/* one registration, event is PCL_EVENT_ALL for handlers receiving every event */
+typedef struct
+{
+	uint32_t event;
+	pcl_event_handler_t handler;
+} ipcl_event_entry_t;
+
+/* handlers[first] through handlers[first + count - 1] subscribe to event */
+typedef struct
+{
+	uint32_t event;
+	int first;
+	int count;
+} ipcl_event_list_t;
+
+/* Immutable view of the registrations, replaced as a whole whenever they change so that
+ * dispatch can read it without locking. The first nall handlers receive every event, lists
+ * is sorted by event.
+ *
+ * refs counts dispatching threads plus one while the snapshot is current. Readers only take
+ * a reference inside an epoch critical section, so the snapshot is handed to
+ * pcl_epoch_retire once refs drops to zero and handlers run outside of the section.
+ */
 typedef struct
 {
-	pcl_array_t *handlers;
+	int32_t refs;
+	int nall;
+	int nlists;
+	ipcl_event_list_t *lists;
+	pcl_event_handler_t handlers[];
+} ipcl_event_snapshot_t;
+
+typedef struct
+{
+	/* registrations in order, only accessed with the context locked */
+	ipcl_event_entry_t *entries;
+	int count;
+	int size;
 } ipcl_event_context_t;
 
 /* only called once from pcl_init. This is not a PCL_EVENT_INIT func */
@@ -51,6 +90,19 @@ PCL_PRIVATE ipcl_event_context_t *ipcl_event_context(void);
 
 PCL_PRIVATE void ipcl_event_context_release(void);
 
+/* reference the current snapshot, NULL when no handlers were ever registered. No lock
+ * required, release with ipcl_event_release.
+ */
+PCL_PRIVATE ipcl_event_snapshot_t *ipcl_event_acquire(void);
+PCL_PRIVATE void ipcl_event_release(ipcl_event_snapshot_t *snap);
+
+/* build and publish a snapshot of ctx's registrations, the context must be locked */
+PCL_PRIVATE void ipcl_event_publish(ipcl_event_context_t *ctx);
+
+/* add or remove a registration and publish, returns false if nothing was removed */
+PCL_PRIVATE void ipcl_event_add(uint32_t event, pcl_event_handler_t handler);
+PCL_PRIVATE bool ipcl_event_remove(uint32_t event, pcl_event_handler_t handler);
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,16 +30,20 @@
 */
 
 #include "_event.h"
+#include "../epoch/_epoch.h" // ipcl_epoch_ready
+#include <pcl/alloc.h>
 #include <pcl/thread.h>
+#include <stdlib.h>
+#include <string.h>
 
 static pthread_mutex_t event_context_lock;
 static ipcl_event_context_t event_context;
+static ipcl_event_snapshot_t *event_snapshot;
 
 void
 ipcl_event_init(void)
 {
 	pcl_mutex_init(&event_context_lock);
-	event_context.handlers = pcl_array(4, NULL);
 }
 
 ipcl_event_context_t *
@@ -54,3 +58,163 @@ ipcl_event_context_release(void)
 {
 	pcl_mutex_unlock(&event_context_lock);
 }
+
+/* fails for a snapshot whose count already reached zero, it is being retired */
+static bool
+snapshot_ref(ipcl_event_snapshot_t *snap)
+{
+	int32_t refs = pcl_atomic_load32(&snap->refs, PCL_ATOMIC_RELAXED);
+
+	while(refs > 0)
+		if(pcl_atomic_cas32(&snap->refs, &refs, refs + 1, PCL_ATOMIC_ACQUIRE))
+			return true;
+
+	return false;
+}
+
+ipcl_event_snapshot_t *
+ipcl_event_acquire(void)
+{
+	ipcl_event_snapshot_t *snap;
+
+	/* until pcl_init sets up epochs nothing is retired, see ipcl_event_release */
+	bool epoch = ipcl_epoch_ready() && pcl_epoch_enter() == 0;
+
+	/* a replaced snapshot can drop to zero before it is referenced, the new one is current */
+	do
+		snap = (ipcl_event_snapshot_t *) EVENT_LOAD_ACQ(&event_snapshot);
+	while(snap && !snapshot_ref(snap));
+
+	if(epoch)
+		pcl_epoch_exit();
+
+	return snap;
+}
+
+void
+ipcl_event_release(ipcl_event_snapshot_t *snap)
+{
+	if(pcl_atomic_fetch_add32(&snap->refs, -1, PCL_ATOMIC_ACQ_REL) != 1)
+		return;
+
+	/* epochs are ready once pcl_init dispatched PCL_EVENT_INIT. Before that there is only the
+	 * initializing thread, which cannot be about to reference a snapshot at zero.
+	 */
+	if(!ipcl_epoch_ready())
+		pcl_free(snap);
+	else
+		(void) pcl_epoch_retire(snap, NULL);
+}
+
+/* order subscriptions by event, then by registration */
+static int
+compare_entries(const void *a, const void *b)
+{
+	const ipcl_event_entry_t *x = *(const ipcl_event_entry_t **) a;
+	const ipcl_event_entry_t *y = *(const ipcl_event_entry_t **) b;
+
+	if(x->event != y->event)
+		return x->event < y->event ? -1 : 1;
+
+	return x < y ? -1 : x > y;
+}
+
+void
+ipcl_event_publish(ipcl_event_context_t *ctx)
+{
+	int nall = 0;
+	int nlists = 0;
+	int nsubs = 0;
+	ipcl_event_entry_t **subs = pcl_malloc((ctx->count + 1) * sizeof(ipcl_event_entry_t *));
+
+	for(int i = 0; i < ctx->count; i++)
+	{
+		if(ctx->entries[i].event == PCL_EVENT_ALL)
+			nall++;
+		else
+			subs[nsubs++] = &ctx->entries[i];
+	}
+
+	qsort(subs, nsubs, sizeof(ipcl_event_entry_t *), compare_entries);
+
+	for(int i = 0; i < nsubs; i++)
+		if(i == 0 || subs[i]->event != subs[i - 1]->event)
+			nlists++;
+
+	/* handlers first, they have the strictest alignment */
+	size_t size = sizeof(ipcl_event_snapshot_t) + ctx->count * sizeof(pcl_event_handler_t);
+	ipcl_event_snapshot_t *snap = pcl_malloc(size + nlists * sizeof(ipcl_event_list_t));
+
+	snap->refs = 1;
+	snap->nall = nall;
+	snap->nlists = nlists;
+	snap->lists = (ipcl_event_list_t *) ((char *) snap + size);
+
+	for(int i = 0, n = 0; i < ctx->count; i++)
+		if(ctx->entries[i].event == PCL_EVENT_ALL)
+			snap->handlers[n++] = ctx->entries[i].handler;
+
+	for(int i = 0, list = -1; i < nsubs; i++)
+	{
+		if(i == 0 || subs[i]->event != subs[i - 1]->event)
+		{
+			snap->lists[++list].event = subs[i]->event;
+			snap->lists[list].first = nall + i;
+			snap->lists[list].count = 0;
+		}
+
+		snap->handlers[nall + i] = subs[i]->handler;
+		snap->lists[list].count++;
+	}
+
+	pcl_free(subs);
+
+	ipcl_event_snapshot_t *old = event_snapshot;
+
+	EVENT_STORE_REL(&event_snapshot, snap);
+
+	/* drop the reference held while it was current */
+	if(old)
+		ipcl_event_release(old);
+}
+
+void
+ipcl_event_add(uint32_t event, pcl_event_handler_t handler)
+{
+	ipcl_event_context_t *ctx = ipcl_event_context();
+
+	if(ctx->count == ctx->size)
+	{
+		ctx->size = ctx->size ? ctx->size * 2 : 8;
+		ctx->entries = pcl_realloc(ctx->entries, ctx->size * sizeof(ipcl_event_entry_t));
+	}
+
+	ctx->entries[ctx->count].event = event;
+	ctx->entries[ctx->count++].handler = handler;
+	ipcl_event_publish(ctx);
+
+	ipcl_event_context_release();
+}
+
+bool
+ipcl_event_remove(uint32_t event, pcl_event_handler_t handler)
+{
+	bool found = false;
+	ipcl_event_context_t *ctx = ipcl_event_context();
+
+	for(int i = 0; i < ctx->count; i++)
+	{
+		if(ctx->entries[i].event == event && ctx->entries[i].handler == handler)
+		{
+			memmove(&ctx->entries[i], &ctx->entries[i + 1],
+				(ctx->count - i - 1) * sizeof(ipcl_event_entry_t));
+			ctx->count--;
+			ipcl_event_publish(ctx);
+			found = true;
+			break;
+		}
+	}
+
+	ipcl_event_context_release();
+	return found;
+}
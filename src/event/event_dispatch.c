@@ -34,13 +34,38 @@
 void
 pcl_event_dispatch(uint32_t which, void *data)
 {
-	ipcl_event_context_t *ctx = ipcl_event_context();
+	ipcl_event_snapshot_t *snap = ipcl_event_acquire();
 
-	for(int i = 0; i < ctx->handlers->count; i++)
+	if(!snap)
+		return;
+
+	for(int i = 0; i < snap->nall; i++)
+		snap->handlers[i](which, data);
+
+	/* binary search for which's subscribers */
+	int lo = 0;
+	int hi = snap->nlists - 1;
+
+	while(lo <= hi)
 	{
-		pcl_event_handler_t handler = (pcl_event_handler_t)(uintptr_t) ctx->handlers->elements[i];
-		handler(which, data);
+		int mid = (lo + hi) / 2;
+		ipcl_event_list_t *list = &snap->lists[mid];
+
+		if(list->event < which)
+		{
+			lo = mid + 1;
+		}
+		else if(list->event > which)
+		{
+			hi = mid - 1;
+		}
+		else
+		{
+			for(int i = list->first; i < list->first + list->count; i++)
+				snap->handlers[i](which, data);
+			break;
+		}
 	}
 
-	ipcl_event_context_release();
+	ipcl_event_release(snap);
 }
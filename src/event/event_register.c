@@ -30,15 +30,10 @@
 */
 
 #include "_event.h"
-#include <pcl/alloc.h>
 
 void
 pcl_event_register(pcl_event_handler_t handler)
 {
-	if(!handler)
-		return;
-
-	ipcl_event_context_t *ctx = ipcl_event_context();
-	pcl_array_append(ctx->handlers, (void *)(uintptr_t) handler);
-	ipcl_event_context_release();
+	if(handler)
+		ipcl_event_add(PCL_EVENT_ALL, handler);
 }
@@ -30,19 +30,10 @@
 */
 
 #include "_event.h"
-#include <string.h>
 
 void
 pcl_event_unregister(pcl_event_handler_t handler)
 {
-	if(!handler)
-		return;
-
-	ipcl_event_context_t *ctx = ipcl_event_context();
-	int index = pcl_array_indexof(ctx->handlers, (void *)(uintptr_t) handler, NULL);
-
-	if(index != -1)
-		pcl_array_remove(ctx->handlers, index);
-
-	ipcl_event_context_release();
+	if(handler)
+		ipcl_event_remove(PCL_EVENT_ALL, handler);
 }
@@ -0,0 +1,65 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_file.h"
+#include <pcl/error.h>
+#include <pcl/limits.h>
+
+int
+pcl_file_readv(pcl_file_t *file, const pcl_iovec_t *iov, int iovcnt)
+{
+	int total = 0;
+
+	if(!file || !iov || iovcnt < 0)
+		return BADARG();
+
+	if(iovcnt > PCL_MAXIOV)
+		iovcnt = PCL_MAXIOV;
+
+	/* no scatter read for ordinary handles, stop at the first short read */
+	for(int i = 0; i < iovcnt; i++)
+	{
+		if(iov[i].iov_len == 0)
+			continue;
+
+		int r = pcl_file_read(file, iov[i].iov_base, iov[i].iov_len);
+
+		if(r == -1)
+			return total > 0 ? total : TRC();
+
+		total += r;
+
+		if((size_t) r < iov[i].iov_len)
+			break;
+	}
+
+	return total;
+}
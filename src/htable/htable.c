@@ -30,6 +30,7 @@
 */
 
 #include "_htable.h"
+#include "../alloc/_alloc.h" // ipcl_memtag_enter
 #include <pcl/error.h>
 #include <pcl/alloc.h>
 #include <pcl/farmhash.h>
@@ -63,6 +64,7 @@ pcl_htable(int capacity)
 	if(capacity < 0)
 		return R_TRC(NULL);
 
+	int tag = ipcl_memtag_enter(PCL_MEMTAG_HTABLE);
 	pcl_htable_t *ht = pcl_malloc(sizeof(pcl_htable_t));
 
 	ht->key_len = 0;
@@ -77,6 +79,7 @@ pcl_htable(int capacity)
 	ht->remove_entry = NULL;
 
 	ipcl_htable_init(ht->capacity, &ht->entries, &ht->entry_lookup);
+	ipcl_memtag_leave(tag);
 
 	return ht;
 }
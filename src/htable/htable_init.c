@@ -30,6 +30,7 @@
 */
 
 #include "_htable.h"
+#include "../alloc/_alloc.h" // ipcl_memtag_enter
 #include <pcl/alloc.h>
 #include <string.h>
 
@@ -37,8 +38,11 @@ void
 ipcl_htable_init(int capacity, pcl_htable_entry_t **entries, int **entry_lookup)
 {
 	size_t size = capacity * (sizeof(pcl_htable_entry_t) + sizeof(int));
+	int tag = ipcl_memtag_enter(PCL_MEMTAG_HTABLE);
 	pcl_htable_entry_t *new_entries = pcl_malloc(size);
 
+	ipcl_memtag_leave(tag);
+
 	memset(new_entries, 0, capacity * sizeof(pcl_htable_entry_t));
 
 	int *new_entry_lookup = (int *) (new_entries + capacity);
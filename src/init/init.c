@@ -30,9 +30,13 @@
 	OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include "../alloc/_alloc.h"   // ipcl_allocator_seal
 #include "../time/_time.h"     // time_handler
 #include "../event/_event.h"   // ipcl_event_init
+#include "../epoch/_epoch.h"   // epoch_handler
 #include "../error/_error.h" // err_handler
+#include "../io/_io.h"       // io_handler
+#include "../pool/_pool.h"   // pool_handler
 #include <pcl/init.h>
 #include <pcl/atomic.h>
 
@@ -52,6 +56,9 @@
 static pcl_event_handler_t builtin_handlers[] = {
 	ipcl_err_handler,
 	ipcl_time_handler,
+	ipcl_io_handler,
+	ipcl_epoch_handler,
+	ipcl_pool_handler,
 #ifdef PCL_WINDOWS
 	ipcl_win32_socket_handler,
 	ipcl_win32_stat_handler
@@ -66,6 +73,9 @@ pcl_init(void)
 	if(pcl_atomic_compare_exchange(&pcl_initialized, 0, 1)) /* if(library_initialized == 1) */
 		return;
 
+	/* blocks allocated from here on belong to the installed allocator */
+	ipcl_allocator_seal();
+
 #ifdef PCL_WINDOWS
 	_set_fmode(_O_BINARY);
 	_setmode(STDIN_FILENO, _O_BINARY);
@@ -0,0 +1,107 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL__IO_H
+#define LIBPCL__IO_H
+
+#include <pcl/defs.h>
+#include <pcl/types.h>
+#include <stdio.h>
+#include <wchar.h>
+#include <stdarg.h>
+
+/* number of translated formats cached per thread, must be a power of 2 */
+#define IO_FMTCACHE_SIZE 64
+
+/* largest buffer, in characters, a counting stream keeps between calls */
+#define IO_COUNTSTREAM_MAX 65536
+
+typedef struct
+{
+	const void *key;  /* format pointer */
+	size_t size;      /* byte size of the format copy */
+	char *format;     /* copy of the format, verifies a hit */
+	void *fmt;        /* translated format */
+} ipcl_fmtcache_entry_t;
+
+/* per-thread io state */
+typedef struct
+{
+	ipcl_fmtcache_entry_t fmtcache[IO_FMTCACHE_SIZE];
+
+#ifndef PCL_WINDOWS
+	/* wide stream for measuring formatted length, created on first use */
+	FILE *countfp;
+	wchar_t *countbuf;
+	size_t countsize;
+#endif
+} ipcl_io_tls_t;
+
+/* Get this thread's io state. Threads not created by pcl_thread have none until asked to create
+ * it. Returns NULL before pcl_init or when create is false and there is no state yet.
+ */
+PCL_PRIVATE ipcl_io_tls_t *ipcl_io_tls(bool create);
+
+/* Measure wide formatted output, like vfwprintf to /dev/null without the syscalls. This writes
+ * to a per-thread memory stream that is rewound for every call. Its memory is released when a
+ * measurement exceeds IO_COUNTSTREAM_MAX characters. Returns the number of wide characters or
+ * -1 with errno set.
+ * @param format OS wide format, already translated
+ * @param ap variable arguments
+ */
+#ifndef PCL_WINDOWS
+PCL_PRIVATE int ipcl_io_vwcount(const wchar_t *format, va_list ap);
+#endif
+
+/* Find the translation of a PCL format in this thread's cache. Entries are keyed by the format
+ * pointer, since formats are almost always string literals, and verified against a copy of the
+ * format so reused buffers never return a stale translation. Returns NULL on a miss.
+ * @param format PCL format
+ * @param size byte size of format, including the NUL
+ */
+PCL_PRIVATE const void *ipcl_fmtcache_get(const void *format, size_t size);
+
+/* Add a translated format to this thread's cache, evicting whatever shared its slot. Returns
+ * the cached translation or NULL if there is no cache for this thread. On success, the cache
+ * takes ownership of fmt when take is true.
+ * @param format PCL format
+ * @param size byte size of format, including the NUL
+ * @param fmt translated format
+ * @param fmtsize byte size of fmt, including the NUL
+ * @param take true to take ownership of an allocated fmt rather than copying it
+ */
+PCL_PRIVATE const void *ipcl_fmtcache_put(const void *format, size_t size, void *fmt,
+	size_t fmtsize, bool take);
+
+/* event handler: creates the io TLS key */
+PCL_PRIVATE void ipcl_io_handler(uint32_t which, void *data);
+
+#endif // LIBPCL__IO_H
@@ -31,6 +31,7 @@
 
 #include "../string/_string.h"
 #include <pcl/alloc.h>
+#include <string.h>
 
 #undef vaxprintf
 #undef axprintf
@@ -50,14 +51,34 @@ vaxprintf(xchar **out, const xchar *format, va_list ap)
 	if(!format)
 		return -PCL_EINVAL;
 
-	if(out)
-		*out = NULL;
+	if(!out)
+		return vxprintf(NULL, 0, format, ap);
+
+	*out = NULL;
+
+	/* format optimistically into a stack buffer, most strings fit */
+	xchar buf[512];
 
 	va_copy(ap2, ap);
-	int r = vxprintf(NULL, 0, format, ap2);
+	int r = xvformat(buf, countof(buf), format, ap2);
 	va_end(ap2);
 
-	if(!out || r < 0)
+	if(r >= 0 && r < (int) countof(buf))
+	{
+		*out = (xchar *) pcl_malloc((r + 1) * sizeof(xchar));
+		memcpy(*out, buf, (r + 1) * sizeof(xchar));
+		return r;
+	}
+
+	/* wide strings do not report their length when truncated */
+	if(r == -PCL_EBUF)
+	{
+		va_copy(ap2, ap);
+		r = vxprintf(NULL, 0, format, ap2);
+		va_end(ap2);
+	}
+
+	if(r < 0)
 		return r;
 
 	*out = (xchar *) pcl_malloc((++r) * sizeof(xchar));
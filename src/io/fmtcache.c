@@ -0,0 +1,81 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_io.h"
+#include <pcl/alloc.h>
+#include <string.h>
+
+static ipcl_fmtcache_entry_t *
+cache_slot(const void *format, bool create)
+{
+	ipcl_io_tls_t *tls = ipcl_io_tls(create);
+
+	if(!tls)
+		return NULL;
+
+	uintptr_t h = (uintptr_t) format;
+
+	h ^= h >> 12;
+	return &tls->fmtcache[(h >> 3) & (IO_FMTCACHE_SIZE - 1)];
+}
+
+const void *
+ipcl_fmtcache_get(const void *format, size_t size)
+{
+	ipcl_fmtcache_entry_t *e = cache_slot(format, false);
+
+	if(e && e->key == format && e->size == size && memcmp(e->format, format, size) == 0)
+		return e->fmt;
+
+	return NULL;
+}
+
+const void *
+ipcl_fmtcache_put(const void *format, size_t size, void *fmt, size_t fmtsize, bool take)
+{
+	ipcl_fmtcache_entry_t *e = cache_slot(format, true);
+
+	if(!e)
+		return NULL;
+
+	pcl_free_safe(e->format);
+	pcl_free_safe(e->fmt);
+
+	if(!take)
+		fmt = memcpy(pcl_malloc(fmtsize), fmt, fmtsize);
+
+	e->key = format;
+	e->size = size;
+	e->format = memcpy(pcl_malloc(size), format, size);
+	e->fmt = fmt;
+
+	return fmt;
+}
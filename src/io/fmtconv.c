@@ -36,19 +36,22 @@
  * changing format type specs based on printf or wprintf...OMG!
  *
  * Anyway, this creates a platform-specific format string given an PCL format
- * string. The returned string might be a pointer to 'buf' (which is most likely
- * stack) or this function might allocate a new buffer if more room is needed.
- * The callee must check if the provided 'buf' argument address matches the
- * returned address when this function returns. If it doesn't match, the callee
- * must free() the returned pointer.
+ * string. Formats without PCL extensions are returned as-is. Translations are
+ * cached per thread, keyed by the format pointer. Without a cache, the returned
+ * string might be a pointer to 'buf' (which is most likely stack) or this function
+ * might allocate a new buffer if more room is needed, which is returned in 'alloc'
+ * and must be freed by the callee.
  */
 
 #include "../string/_string.h"
+#include "_io.h"
 #include <pcl/alloc.h>
 #include <ctype.h>
 
 #undef XPATHSEPCHAR
 #undef toxupper
+#undef passthru
+#undef translate
 
 #ifdef XWIDE
 #define XPATHSEPCHAR PCL_WPATHSEPCHR
@@ -58,8 +61,51 @@
 #define toxupper toupper
 #endif
 
-xchar *
-XFUNC(fmtconv)(xchar *buf, size_t bufsz, const xchar *pcl_format)
+#define passthru XFUNC(fmtpassthru)
+#define translate XFUNC(fmttranslate)
+
+/* true when a format has nothing to translate and can be handed to the OS as-is */
+static bool
+passthru(const xchar *format)
+{
+	while((format = xstrchr(format, X('%'))))
+	{
+		format++;
+
+		if(*format == X('%'))
+		{
+			format++;
+			continue;
+		}
+
+		/* "%/" path sep */
+		if(*format == X('/'))
+			return false;
+
+		/* scan to the conversion specifier */
+		for(; *format; format++)
+		{
+			xchar c = *format;
+
+			if(c == X('P'))
+				return false;
+
+#ifdef PCL_WINDOWS
+			/* windows swaps the meaning of s and c between printf and wprintf */
+			if(c == X('s') || c == X('c'))
+				return false;
+#endif
+
+			if(!xstrchr(X("0123456789-+ #'*.hlLqjzt"), c))
+				break;
+		}
+	}
+
+	return true;
+}
+
+static xchar *
+translate(xchar *buf, size_t bufsz, const xchar *pcl_format)
 {
 	xchar *os_format = buf;
 	xchar *out = os_format;
@@ -101,7 +147,7 @@ XFUNC(fmtconv)(xchar *buf, size_t bufsz, const xchar *pcl_format)
 		 */
 		if(*pcl_format == X('%'))
 		{
-			pcl_format++; /* no copy, already have 1st '%', just move past 2nd one */
+			*out++ = *pcl_format++; /* copy the 2nd '%', 1st is already copied */
 			continue;
 		}
 
@@ -216,6 +262,7 @@ XFUNC(fmtconv)(xchar *buf, size_t bufsz, const xchar *pcl_format)
 				case X('0'):
 				case X('1'):
 				case X('2'):
+				case X('3'):
 				case X('4'):
 				case X('5'):
 				case X('6'):
@@ -225,6 +272,7 @@ XFUNC(fmtconv)(xchar *buf, size_t bufsz, const xchar *pcl_format)
 				case X('-'):
 				case X(' '):
 				case X('+'):
+				case X('#'):
 				case X('\''):
 				case X('*'):
 				case X('.'):
@@ -232,6 +280,7 @@ XFUNC(fmtconv)(xchar *buf, size_t bufsz, const xchar *pcl_format)
 				case X('q'):
 				case X('j'):
 				case X('z'):
+				case X('t'):
 					*out++ = *pcl_format++;
 					break;
 
@@ -251,6 +300,34 @@ XFUNC(fmtconv)(xchar *buf, size_t bufsz, const xchar *pcl_format)
 	return os_format;
 }
 
+const xchar *
+XFUNC(fmtconv)(xchar *buf, size_t bufsz, const xchar *pcl_format, xchar **alloc)
+{
+	*alloc = NULL;
+
+	if(passthru(pcl_format))
+		return pcl_format;
+
+	size_t size = (xstrlen(pcl_format) + 1) * sizeof(xchar);
+	const xchar *fmt = ipcl_fmtcache_get(pcl_format, size);
+
+	if(fmt)
+		return fmt;
+
+	xchar *os_format = translate(buf, bufsz, pcl_format);
+	size_t os_size = (xstrlen(os_format) + 1) * sizeof(xchar);
+	bool take = os_format != buf;
+
+	if((fmt = ipcl_fmtcache_put(pcl_format, size, os_format, os_size, take)))
+		return fmt;
+
+	/* no cache for this thread */
+	if(take)
+		*alloc = os_format;
+
+	return os_format;
+}
+
 #ifndef XWIDE
 #define XWIDE
 #include "fmtconv.c"
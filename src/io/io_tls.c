@@ -0,0 +1,89 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_io.h"
+#include <pcl/thread.h>
+#include <pcl/event.h>
+#include <pcl/alloc.h>
+#include <stdlib.h>
+
+static pthread_key_t tlskey;
+static bool have_tlskey;
+
+static void
+tls_destroy(void *obj)
+{
+	ipcl_io_tls_t *tls = obj;
+
+	for(int i = 0; i < IO_FMTCACHE_SIZE; i++)
+	{
+		pcl_free_safe(tls->fmtcache[i].format);
+		pcl_free_safe(tls->fmtcache[i].fmt);
+	}
+
+#ifndef PCL_WINDOWS
+	if(tls->countfp)
+		fclose(tls->countfp);
+
+	/* allocated by the C library, not pcl_malloc */
+	free(tls->countbuf);
+#endif
+
+	pcl_free(tls);
+}
+
+ipcl_io_tls_t *
+ipcl_io_tls(bool create)
+{
+	if(!have_tlskey)
+		return NULL;
+
+	ipcl_io_tls_t *tls = pcl_tls_get(tlskey);
+
+	if(!tls && create)
+	{
+		tls = pcl_zalloc(sizeof(ipcl_io_tls_t));
+
+		if(pcl_tls_set(tlskey, tls))
+			tls = pcl_free(tls);
+	}
+
+	return tls;
+}
+
+void
+ipcl_io_handler(uint32_t which, void *data)
+{
+	UNUSED(data);
+
+	if(which == PCL_EVENT_INIT)
+		have_tlskey = pcl_tls_alloc(&tlskey, tls_destroy) == 0;
+}
@@ -0,0 +1,73 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_io.h"
+#include <stdlib.h>
+
+static void
+countstream_close(ipcl_io_tls_t *tls)
+{
+	fclose(tls->countfp);
+	free(tls->countbuf);
+	tls->countfp = NULL;
+	tls->countbuf = NULL;
+	tls->countsize = 0;
+}
+
+int
+ipcl_io_vwcount(const wchar_t *format, va_list ap)
+{
+	ipcl_io_tls_t *tls = ipcl_io_tls(true);
+
+	/* before pcl_init or out of memory */
+	if(!tls || (!tls->countfp && !(tls->countfp = open_wmemstream(&tls->countbuf, &tls->countsize))))
+	{
+		FILE *fp = fopen("/dev/null", "wb");
+
+		if(!fp)
+			return -1;
+
+		int r = vfwprintf(fp, format, ap);
+		fclose(fp);
+		return r;
+	}
+
+	rewind(tls->countfp);
+	clearerr(tls->countfp);
+
+	int r = vfwprintf(tls->countfp, format, ap);
+
+	/* don't hold on to the memory of an unusually large measurement */
+	if(r > IO_COUNTSTREAM_MAX)
+		countstream_close(tls);
+
+	return r;
+}
@@ -50,11 +50,11 @@ vxprintf(const xchar *format, va_list ap)
 		return -PCL_EINVAL;
 
 	xchar buf[4096];
-	xchar *fmt = xfmtconv(buf, countof(buf), format);
+	xchar *alloc;
+	const xchar *fmt = xfmtconv(buf, countof(buf), format, &alloc);
 	int r = sys_vprintf(fmt, ap);
 
-	if(fmt != buf)
-		pcl_free(fmt);
+	pcl_free_safe(alloc);
 
 	return r;
 }
@@ -30,16 +30,18 @@
 */
 
 #include "../string/_string.h"
+#include "_io.h"
 #include <pcl/alloc.h>
 
 int
-vxprintf(xchar *buf, size_t size, const xchar *format, va_list ap)
+xvformat(xchar *buf, size_t size, const xchar *format, va_list ap)
 {
 	if(!format)
 		return -PCL_EINVAL;
 
 	xchar fmtbuf[4096];
-	xchar *fmt = xfmtconv(fmtbuf, countof(fmtbuf), format);
+	xchar *alloc;
+	const xchar *fmt = xfmtconv(fmtbuf, countof(fmtbuf), format, &alloc);
 	int r = 0, err = 0;
 
 	errno = 0;
@@ -58,10 +60,8 @@ vxprintf(xchar *buf, size_t size, const xchar *format, va_list ap)
 #elif defined(XWIDE)
 	if(!buf)
 	{
-		/* vswprintf always returns -1, write to /dev/null to get length */
-		FILE *fp = fopen("/dev/null", "wb");
-		r = vfwprintf(fp, fmt, ap);
-		fclose(fp);
+		/* vswprintf always returns -1, write to an in-memory stream to get length */
+		r = ipcl_io_vwcount(fmt, ap);
 	}
 	else
 	{
@@ -71,18 +71,9 @@ vxprintf(xchar *buf, size_t size, const xchar *format, va_list ap)
 			err = PCL_EBUF; /* best guess */
 	}
 
-	/* Unix non-wide */
+	/* Unix non-wide: C99 returns the full length when truncated */
 #else
-	if(!buf)
-	{
-		r = vsnprintf(NULL, 0, fmt, ap);
-	}
-	else
-	{
-		r = vsnprintf(buf, size, fmt, ap);
-		if(r >= (int) size) /* buffer to small */
-			err = PCL_EBUF;
-	}
+	r = vsnprintf(buf, buf ? size : 0, fmt, ap);
 #endif
 
 	/* set pcl error if not already set, returned as -(err) */
@@ -93,12 +84,22 @@ vxprintf(xchar *buf, size_t size, const xchar *format, va_list ap)
 			err = PCL_EINVAL;
 	}
 
-	if(fmt != fmtbuf)
-		pcl_free(fmt);
+	pcl_free_safe(alloc);
 
 	return err ? -err : r;
 }
 
+int
+vxprintf(xchar *buf, size_t size, const xchar *format, va_list ap)
+{
+	int r = xvformat(buf, size, format, ap);
+
+	if(buf && r >= (int) size) /* buffer to small */
+		return -PCL_EBUF;
+
+	return r;
+}
+
 #ifndef XWIDE
 	#define XWIDE
 	#include "vsprintf.c"
@@ -35,13 +35,35 @@
 #include <pcl/json.h>
 #include <pcl/error.h>
 #include <pcl/buf.h>
+#include "../alloc/_alloc.h" // ipcl_memtag_exceeded
 
 #define JSON_THROW(message, ...) \
 	return R_SETERRMSG(NULL, PCL_ESYNTAX, message, __VA_ARGS__)
 
+/* decoders stop once the thread's memory tag is over its soft limit */
+#define JSON_CHKLIMIT() do{ \
+	if(ipcl_memtag_exceeded()) \
+		return R_SETERRMSG(NULL, PCL_ENOMEM, "memory limit exceeded", 0); \
+}while(0)
+
+/* target size of the chunks handed to json lines worker threads */
+#define JSON_LINES_CHUNK (1024 * 1024)
+
+/* buffer size of the streaming encoders. The buffer is flushed once it is within
+ * JSON_STREAM_SLACK bytes of being full, so it only grows for deeply nested documents.
+ */
+#define JSON_STREAM_BUFSIZE (64 * 1024)
+#define JSON_STREAM_SLACK 4096
+
+/* arrays and objects with fewer members are always encoded serially */
+#define JSON_PARALLEL_MIN 1024
+
+/* nesting limit for the binary decoders, whose input usually comes off the network */
+#define JSON_BINARY_MAXDEPTH 512
+
 #define PRINT_TABS(_enc) \
-	for(int __i = 0; __i < (enc)->tabs; __i++) \
-		pcl_buf_putchar((enc)->b, '\t')
+	for(int __i = 0; __i < (_enc)->tabs; __i++) \
+		pcl_buf_putchar((_enc)->b, '\t')
 
 #ifdef __cplusplus
 extern "C" {
@@ -55,13 +77,35 @@ typedef struct
 	int line;
 } ipcl_json_state_t;
 
+typedef struct tag_ipcl_json_pool ipcl_json_pool_t;
+
 typedef struct
 {
 	int tabs;
 	bool format;
 	pcl_buf_t *b;
+	pcl_json_write_t write; // NULL unless streaming
+	void *udata;
+	ipcl_json_pool_t *pool; // NULL unless encoding in parallel
 } ipcl_json_encode_t;
 
+typedef struct
+{
+	char type; // 'a' or 'o'
+	int count;
+} ipcl_json_level_t;
+
+struct tag_pcl_json_writer
+{
+	pcl_buf_t buf;
+	ipcl_json_encode_t enc;
+	ipcl_json_level_t *levels;
+	int depth;
+	int size;
+	bool haskey; // object key written, value pending
+	bool done; // root value complete
+};
+
 typedef enum
 {
 	PclPathRoot,
@@ -71,9 +115,21 @@ typedef enum
 	PclPathElement,
 	PclPathWildcardElement,
 	PclPathElementList,
-	PclPathElementSlice
+	PclPathElementSlice,
+	PclPathFilter
 } path_type_t;
 
+typedef enum
+{
+	PclFilterExists,
+	PclFilterEQ,
+	PclFilterNE,
+	PclFilterLT,
+	PclFilterLE,
+	PclFilterGT,
+	PclFilterGE
+} filter_op_t;
+
 struct tag_pcl_json_path
 {
 	pcl_json_path_t *next;
@@ -90,9 +146,18 @@ struct tag_pcl_json_path
 			int end;
 			int step;
 		} idx_slice; // ChildElementSlice
+		struct {
+			pcl_json_path_t *path; // relative to '@', NULL when '@' itself
+			filter_op_t op;
+			pcl_json_t *value; // literal operand, NULL for PclFilterExists
+		} filter; // Filter
 	};
 };
 
+typedef struct tag_ipcl_json_lines ipcl_json_lines_t;
+
+/* pool of every pcl_json_t node */
+PCL_PRIVATE pcl_pool_t *ipcl_json_nodes(void);
 
 PCL_PRIVATE pcl_json_t *ipcl_json_parse_value(ipcl_json_state_t *s);
 PCL_PRIVATE char *ipcl_json_parse_string(ipcl_json_state_t *s);
@@ -106,6 +171,81 @@ PCL_PRIVATE pcl_buf_t *ipcl_json_encode_string(ipcl_json_encode_t *enc, const ch
 PCL_PRIVATE pcl_buf_t *ipcl_json_encode_array(ipcl_json_encode_t *enc, pcl_array_t *array);
 PCL_PRIVATE pcl_buf_t *ipcl_json_encode_object(ipcl_json_encode_t *enc, pcl_htable_t *obj);
 
+/** Hand the buffered output of a streaming encoder to its write callback.
+ * @param enc pointer to an encoder, which is ignored when not streaming
+ * @param force when false, the buffer is only flushed if it is nearly full
+ * @return pointer to the encoder's buffer or \c NULL if the write callback failed
+ */
+PCL_PRIVATE pcl_buf_t *ipcl_json_encode_flush(ipcl_json_encode_t *enc, bool force);
+
+/** Start the worker threads of a parallel encoder.
+ * @param nthreads number of worker threads. The encoding thread also encodes, so this is one less
+ * than the desired parallelism.
+ * @return pointer to a pool or \c NULL on error
+ */
+PCL_PRIVATE ipcl_json_pool_t *ipcl_json_pool(int nthreads);
+
+/** Stop the worker threads and free a pool.
+ * @param pool pointer to a pool
+ */
+PCL_PRIVATE void ipcl_json_pool_free(ipcl_json_pool_t *pool);
+
+/** Encode the members of an array or object using the encoder's pool. Ranges of members are
+ * encoded into separate buffers concurrently and then appended in order, producing the exact
+ * output of the serial encoder. Only the opening and closing brackets, and the indentation
+ * that surrounds them, are left to the caller.
+ * @param enc pointer to an encoder with a pool
+ * @param values array of \a count values
+ * @param keys array of \a count object keys or \c NULL for an array
+ * @param count number of members
+ * @return pointer to the encoder's buffer or \c NULL on error
+ */
+PCL_PRIVATE pcl_buf_t *ipcl_json_encode_members(ipcl_json_encode_t *enc, pcl_json_t **values,
+	char **keys, int count);
+
+/** Validate the position of the next writer item and write the separator and indentation that
+ * precede it. An object value has no separator, it was written along with its key.
+ * @param w pointer to a json writer
+ * @param key true if the item is an object key
+ * @return 0 on success and -1 if the item is not allowed at the current position
+ */
+PCL_PRIVATE int ipcl_json_writer_item(pcl_json_writer_t *w, bool key);
+
+/** Open an array or object within a json writer.
+ * @param w pointer to a json writer
+ * @param type \c 'a' or \c 'o'
+ * @return 0 on success and -1 on error
+ */
+PCL_PRIVATE int ipcl_json_writer_begin(pcl_json_writer_t *w, char type);
+
+/** Start a json lines decoder with a pool of worker threads.
+ * @param nthreads number of worker threads
+ * @param flags ::PCL_JSON_UNORDERED or 0
+ * @param handler callback that receives each decoded document on the calling thread
+ * @param udata user data passed to \a handler
+ * @return pointer to a decoder or \c NULL on error
+ */
+PCL_PRIVATE ipcl_json_lines_t *ipcl_json_lines(int nthreads, uint32_t flags,
+	pcl_json_line_handler_t handler, void *udata);
+
+/** Queue a chunk of complete lines for decoding. Blocks while too many chunks are in flight,
+ * delivering finished documents in the meantime. If \a data does not end with a newline, the
+ * trailing partial line is copied so the parser is always bounded by a newline.
+ * @param jl pointer to a decoder
+ * @param data pointer to the chunk
+ * @param len number of bytes in \a data
+ * @param owned allocation backing \a data that is freed once decoded, or \c NULL if borrowed
+ * @return 0 to keep submitting or -1 if decoding has stopped due to an error or the handler
+ */
+PCL_PRIVATE int ipcl_json_lines_submit(ipcl_json_lines_t *jl, const char *data, size_t len,
+	char *owned);
+
+/** Deliver all outstanding documents, stop the worker threads and free the decoder.
+ * @param jl pointer to a decoder
+ * @return number of documents delivered or -1 on error
+ */
+PCL_PRIVATE int ipcl_json_lines_end(ipcl_json_lines_t *jl);
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,8 +30,8 @@
 */
 
 #include "_json.h"
+#include <pcl/pool.h>
 #include <pcl/array.h>
-#include <pcl/alloc.h>
 
 static void
 array_cleanup(void *elem)
@@ -42,7 +42,7 @@ array_cleanup(void *elem)
 pcl_json_t *
 pcl_json_arr(void)
 {
-	pcl_json_t *val = pcl_malloc(sizeof(pcl_json_t));
+	pcl_json_t *val = pcl_pool_get(ipcl_json_nodes());
 
 	val->type = 'a';
 	val->nrefs = 1;
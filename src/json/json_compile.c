@@ -34,6 +34,124 @@
 #include <pcl/vector.h>
 #include <pcl/alloc.h>
 #include <pcl/strint.h>
+#include <string.h>
+
+/** Compile a filter expression: [?(@.price < 10)], [?(@.isbn)], [?(@ == 'x')]. The left operand
+ * is a path relative to the current node '@', which is compiled as if it were rooted at '$'.
+ * The right operand is a scalar literal: number, quoted string, true, false or null.
+ * @param node path node to populate, must already be typed as a filter with zeroed members
+ * @param pp pointer to the '[' beginning the filter, updated to point past the closing ']'
+ * @return 0 on success and -1 on error
+ */
+static int
+compile_filter(pcl_json_path_t *node, const char **pp)
+{
+	const char *p = *pp + 2; // skip "[?"
+
+	if(*p != '(')
+		return SETERRMSG(PCL_ESYNTAX, "invalid filter expression: expected '('", 0);
+
+	p = pcl_strskipws(p + 1);
+
+	if(*p != '@')
+		return SETERRMSG(PCL_ESYNTAX, "invalid filter expression: expected '@'", 0);
+
+	/* find the end of the relative path, quoted member names can contain anything */
+	const char *end = p + 1;
+
+	while(*end && !strchr(" \t\r\n=!<>)", *end))
+	{
+		if(end[0] == '[' && end[1] == '\'')
+		{
+			const char *quote = strstr(end + 2, "']");
+
+			if(!quote)
+				return SETERRMSG(PCL_ESYNTAX, "unterminated single quote", 0);
+
+			end = quote + 2;
+		}
+		else
+		{
+			end++;
+		}
+	}
+
+	/* "@" alone refers to the current node, no relative path required */
+	if(end - p > 1)
+	{
+		char *relpath = pcl_strndup(p, end - p);
+
+		*relpath = '$';
+		node->filter.path = pcl_json_compile(relpath);
+		pcl_free(relpath);
+
+		if(!node->filter.path)
+			return TRCMSG("invalid filter expression: bad relative path", 0);
+	}
+
+	p = pcl_strskipws(end);
+
+	if(*p != ')')
+	{
+		int oplen = 2;
+
+		if(p[0] == '=' && p[1] == '=')
+			node->filter.op = PclFilterEQ;
+		else if(p[0] == '!' && p[1] == '=')
+			node->filter.op = PclFilterNE;
+		else if(p[0] == '<' && p[1] == '=')
+			node->filter.op = PclFilterLE;
+		else if(p[0] == '>' && p[1] == '=')
+			node->filter.op = PclFilterGE;
+		else if(p[0] == '<')
+		{
+			node->filter.op = PclFilterLT;
+			oplen = 1;
+		}
+		else if(p[0] == '>')
+		{
+			node->filter.op = PclFilterGT;
+			oplen = 1;
+		}
+		else
+			return SETERRMSG(PCL_ESYNTAX, "invalid filter operator '%c'", *p);
+
+		p = pcl_strskipws(p + oplen);
+
+		/* JSONPath allows single quoted strings, which pcl_json_decode does not */
+		if(*p == '\'')
+		{
+			const char *quote = strchr(p + 1, '\'');
+
+			if(!quote)
+				return SETERRMSG(PCL_ESYNTAX, "unterminated single quote", 0);
+
+			if(!(node->filter.value = pcl_json_strn(p + 1, quote - p - 1, 0)))
+				return TRC();
+
+			p = quote + 1;
+		}
+		else
+		{
+			if(!(node->filter.value = pcl_json_decode(p, 0, &p)))
+				return TRCMSG("invalid filter expression: bad operand", 0);
+
+			if(pcl_json_isobj(node->filter.value) || pcl_json_isarr(node->filter.value))
+				return SETERRMSG(PCL_ESYNTAX, "invalid filter expression: operand must be a scalar", 0);
+		}
+
+		p = pcl_strskipws(p);
+
+		if(*p != ')')
+			return SETERRMSG(PCL_ESYNTAX, "invalid filter expression: expected ')'", 0);
+	}
+
+	if(p[1] != ']')
+		return SETERRMSG(PCL_ESYNTAX, "invalid filter expression: no closing ']'", 0);
+
+	*pp = p + 2;
+	return 0;
+}
 
 pcl_json_path_t *
 pcl_json_compile(const char *path)
@@ -99,8 +217,24 @@ pcl_json_compile(const char *path)
 				char *end;
 				pcl_json_path_t *node = pcl_malloc(sizeof(pcl_json_path_t));
 
+				/* $.book[?(@.price < 10)] */
+				if(p[1] == '?')
+				{
+					node->next = NULL;
+					node->type = PclPathFilter;
+					node->filter.path = NULL;
+					node->filter.op = PclFilterExists;
+					node->filter.value = NULL;
+
+					if(compile_filter(node, &p) < 0)
+					{
+						pcl_json_freepath(node);
+						pcl_json_freepath(root);
+						return R_TRC(NULL);
+					}
+				}
 				/* $.book[*] */
-				if(p[1] == '*' && p[2] == ']')
+				else if(p[1] == '*' && p[2] == ']')
 				{
 					node->type = PclPathWildcardElement;
 					p += 3;
@@ -63,8 +63,11 @@ pcl_json_decode(const char *json, size_t len, const char **end)
 	};
 
 	/* implemented as a recursive descent parser, this kicks off the recursion */
+	int tag = ipcl_memtag_enter(PCL_MEMTAG_JSON);
 	pcl_json_t *val = ipcl_json_parse_value(&state);
 
+	ipcl_memtag_leave(tag);
+
 	if(val)
 	{
 		if(end)
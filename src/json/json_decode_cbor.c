@@ -0,0 +1,419 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_json.h"
+#include <pcl/alloc.h>
+#include <pcl/string.h>
+#include <math.h>
+#include <string.h>
+
+#define CBOR_INDEFINITE 31
+#define CBOR_BREAK 0xff
+
+typedef struct
+{
+	const uint8_t *next;
+	const uint8_t *end;
+	int depth;
+} cbor_state_t;
+
+static pcl_json_t *decode_value(cbor_state_t *s);
+
+static cbor_state_t *
+read_uint(cbor_state_t *s, uint8_t info, uint64_t *n)
+{
+	int size;
+
+	if(info < 24)
+	{
+		*n = info;
+		return s;
+	}
+
+	switch(info)
+	{
+		case 24: size = 1; break;
+		case 25: size = 2; break;
+		case 26: size = 4; break;
+		case 27: size = 8; break;
+		default:
+			JSON_THROW("invalid cbor additional info %d", info);
+	}
+
+	if(s->end - s->next < size)
+		JSON_THROW("unexpected end of input", 0);
+
+	/* network byte order */
+	for(*n = 0; size > 0; size--)
+		*n = (*n << 8) | *s->next++;
+
+	return s;
+}
+
+static double
+half_to_double(uint16_t half)
+{
+	int exp = (half >> 10) & 0x1f;
+	int mant = half & 0x3ff;
+	double val;
+
+	if(exp == 0)
+		val = ldexp(mant, -24);
+	else if(exp != 31)
+		val = ldexp(mant + 1024, exp - 25);
+	else
+		val = mant == 0 ? INFINITY : NAN;
+
+	return (half & 0x8000) ? -val : val;
+}
+
+/* json has no NaN or Infinity, treat them as null like the text encoder */
+static pcl_json_t *
+make_real(double real)
+{
+	if(isnan(real) || isinf(real))
+		return pcl_json_null();
+
+	return pcl_json_real(real);
+}
+
+/* decodes a text string (major type 3) whose initial byte has been consumed */
+static char *
+decode_text(cbor_state_t *s, uint8_t info)
+{
+	uint64_t len;
+
+	/* indefinite length: a series of definite length chunks terminated by a break */
+	if(info == CBOR_INDEFINITE)
+	{
+		pcl_buf_t buf;
+		pcl_buf_t *b = pcl_buf_init(&buf, 32, PclBufText);
+
+		for(;;)
+		{
+			if(s->next == s->end || *s->next == CBOR_BREAK || (*s->next >> 5) != 3)
+				break;
+
+			info = *s->next++ & 31;
+
+			if(info == CBOR_INDEFINITE || !read_uint(s, info, &len) ||
+				len > (uint64_t) (s->end - s->next))
+			{
+				pcl_buf_clear(b);
+				JSON_THROW("invalid cbor text string chunk", 0);
+			}
+
+			if(len > 0)
+				pcl_buf_put(b, s->next, (int) len);
+
+			s->next += len;
+		}
+
+		if(s->next == s->end || *s->next++ != CBOR_BREAK)
+		{
+			pcl_buf_clear(b);
+			JSON_THROW("invalid cbor indefinite text string", 0);
+		}
+
+		if(b->len > 0 && pcl_utf8_check(b->data, b->len) < 0)
+		{
+			pcl_buf_clear(b);
+			return R_TRC(NULL);
+		}
+
+		return b->data;
+	}
+
+	if(!read_uint(s, info, &len))
+		return NULL;
+
+	if(len > (uint64_t) (s->end - s->next))
+		JSON_THROW("unexpected end of input: string length %llu", (unsigned long long) len);
+
+	if(len > 0 && pcl_utf8_check((const char *) s->next, (size_t) len) < 0)
+		return R_TRC(NULL);
+
+	/* pcl_strndup treats a zero len as NUL-terminated */
+	char *str = len > 0 ? pcl_strndup((const char *) s->next, (size_t) len) : pcl_strdup("");
+
+	s->next += len;
+	return str;
+}
+
+static pcl_json_t *
+decode_array(cbor_state_t *s, uint8_t info)
+{
+	uint64_t count = 0;
+
+	if(info != CBOR_INDEFINITE && !read_uint(s, info, &count))
+		return NULL;
+
+	pcl_json_t *arr = pcl_json_arr();
+
+	for(uint64_t i = 0; info == CBOR_INDEFINITE || i < count; i++)
+	{
+		if(info == CBOR_INDEFINITE && s->next < s->end && *s->next == CBOR_BREAK)
+		{
+			s->next++;
+			break;
+		}
+
+		pcl_json_t *elem = decode_value(s);
+
+		if(!elem || pcl_json_arradd(arr, elem, PCL_JSON_FREEVALONERR) < 0)
+		{
+			pcl_json_free(arr);
+			return R_TRC(NULL);
+		}
+	}
+
+	return arr;
+}
+
+static pcl_json_t *
+decode_map(cbor_state_t *s, uint8_t info)
+{
+	uint64_t count = 0;
+
+	if(info != CBOR_INDEFINITE && !read_uint(s, info, &count))
+		return NULL;
+
+	pcl_json_t *obj = pcl_json_obj();
+
+	for(uint64_t i = 0; info == CBOR_INDEFINITE || i < count; i++)
+	{
+		if(s->next == s->end)
+		{
+			pcl_json_free(obj);
+			JSON_THROW("unexpected end of input", 0);
+		}
+
+		if(info == CBOR_INDEFINITE && *s->next == CBOR_BREAK)
+		{
+			s->next++;
+			break;
+		}
+
+		/* json keys must be strings */
+		if((*s->next >> 5) != 3)
+		{
+			pcl_json_free(obj);
+			JSON_THROW("cbor map key must be a text string", 0);
+		}
+
+		char *key = decode_text(s, *s->next++ & 31);
+
+		if(!key)
+		{
+			pcl_json_free(obj);
+			return NULL;
+		}
+
+		pcl_json_t *val = decode_value(s);
+
+		if(!val)
+		{
+			pcl_free(key);
+			pcl_json_free(obj);
+			return NULL;
+		}
+
+		uint32_t flags = PCL_JSON_SKIPUTF8CHK | PCL_JSON_SHALLOW | PCL_JSON_FREEVALONERR;
+
+		if(pcl_json_objput(obj, key, val, flags) < 0)
+		{
+			pcl_free(key);
+			pcl_json_free(obj);
+			return R_TRC(NULL);
+		}
+	}
+
+	return obj;
+}
+
+static pcl_json_t *
+decode_simple(cbor_state_t *s, uint8_t info)
+{
+	uint64_t n;
+
+	switch(info)
+	{
+		case 20:
+			return pcl_json_false();
+
+		case 21:
+			return pcl_json_true();
+
+		case 22: /* null */
+		case 23: /* undefined */
+			return pcl_json_null();
+
+		case 25:
+			if(!read_uint(s, info, &n))
+				return NULL;
+			return make_real(half_to_double((uint16_t) n));
+
+		case 26:
+		{
+			float f;
+			uint32_t bits;
+
+			if(!read_uint(s, info, &n))
+				return NULL;
+
+			bits = (uint32_t) n;
+			memcpy(&f, &bits, sizeof(f));
+			return make_real(f);
+		}
+
+		case 27:
+		{
+			double d;
+
+			if(!read_uint(s, info, &n))
+				return NULL;
+
+			memcpy(&d, &n, sizeof(d));
+			return make_real(d);
+		}
+
+		case CBOR_INDEFINITE:
+			JSON_THROW("unexpected cbor break", 0);
+
+		default:
+			JSON_THROW("unsupported cbor simple value %d", info);
+	}
+}
+
+static pcl_json_t *
+decode_value(cbor_state_t *s)
+{
+	uint64_t n;
+	pcl_json_t *val;
+
+	if(s->next == s->end)
+		JSON_THROW("unexpected end of input", 0);
+
+	JSON_CHKLIMIT();
+
+	if(++s->depth > JSON_BINARY_MAXDEPTH)
+		JSON_THROW("maximum nesting depth of %d exceeded", JSON_BINARY_MAXDEPTH);
+
+	uint8_t major = *s->next >> 5;
+	uint8_t info = *s->next++ & 31;
+
+	switch(major)
+	{
+		/* unsigned integer */
+		case 0:
+			if(!read_uint(s, info, &n))
+				return NULL;
+
+			val = n > LLONG_MAX ? pcl_json_real((double) n) : pcl_json_int((long long) n);
+			break;
+
+		/* negative integer: -1 - n */
+		case 1:
+			if(!read_uint(s, info, &n))
+				return NULL;
+
+			/* -1 - LLONG_MAX is PCL_JSON_INVINT */
+			if(n >= LLONG_MAX)
+				val = pcl_json_real(-1.0 - (double) n);
+			else
+				val = pcl_json_int(-1 - (long long) n);
+			break;
+
+		case 2:
+			JSON_THROW("cbor byte strings are not supported", 0);
+
+		case 3:
+		{
+			char *str = decode_text(s, info);
+
+			if(!str)
+				return NULL;
+
+			/* decode_text already did UTF-8 check */
+			val = pcl_json_str(str, PCL_JSON_SKIPUTF8CHK | PCL_JSON_SHALLOW);
+			break;
+		}
+
+		case 4:
+			val = decode_array(s, info);
+			break;
+
+		case 5:
+			val = decode_map(s, info);
+			break;
+
+		/* tags carry no meaning for json, decode the tagged item */
+		case 6:
+			if(!read_uint(s, info, &n))
+				return NULL;
+
+			val = decode_value(s);
+			break;
+
+		default:
+			val = decode_simple(s, info);
+			break;
+	}
+
+	s->depth--;
+	return val;
+}
+
+pcl_json_t *
+pcl_json_decode_cbor(const void *data, size_t len, const void **end)
+{
+	if(!data || len == 0)
+		return R_SETERR(NULL, PCL_EINVAL);
+
+	cbor_state_t state = {
+		.next = data,
+		.end = (const uint8_t *) data + len,
+		.depth = 0
+	};
+
+	int tag = ipcl_memtag_enter(PCL_MEMTAG_JSON);
+	pcl_json_t *val = decode_value(&state);
+
+	ipcl_memtag_leave(tag);
+
+	if(!val)
+		return R_TRCMSG(NULL, "offset=%ld", (long) (state.next - (const uint8_t *) data));
+
+	if(end)
+		*end = state.next;
+
+	return val;
+}
@@ -0,0 +1,69 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_json.h"
+#include <string.h>
+
+int
+pcl_json_decode_lines(const char *data, size_t len, int nthreads, uint32_t flags,
+	pcl_json_line_handler_t handler, void *udata)
+{
+	if(!data)
+		return BADARG();
+
+	ipcl_json_lines_t *jl = ipcl_json_lines(nthreads, flags, handler, udata);
+
+	if(!jl)
+		return TRC();
+
+	const char *end = data + len;
+
+	while(data < end)
+	{
+		/* extend each chunk to the end of the line it stops within */
+		const char *next = data + min((size_t) (end - data), JSON_LINES_CHUNK);
+
+		if(next < end)
+		{
+			const char *nl = memchr(next, '\n', end - next);
+			next = nl ? nl + 1 : end;
+		}
+
+		if(ipcl_json_lines_submit(jl, data, next - data, NULL) < 0)
+			break;
+
+		data = next;
+	}
+
+	int count = ipcl_json_lines_end(jl);
+
+	return count < 0 ? TRC() : count;
+}
@@ -0,0 +1,331 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_json.h"
+#include <pcl/alloc.h>
+#include <pcl/string.h>
+#include <math.h>
+#include <string.h>
+
+typedef struct
+{
+	const uint8_t *next;
+	const uint8_t *end;
+	int depth;
+} msgpack_state_t;
+
+static pcl_json_t *decode_value(msgpack_state_t *s);
+
+/* reads a big-endian unsigned integer of size bytes */
+static msgpack_state_t *
+read_uint(msgpack_state_t *s, int size, uint64_t *n)
+{
+	if(s->end - s->next < size)
+		JSON_THROW("unexpected end of input", 0);
+
+	for(*n = 0; size > 0; size--)
+		*n = (*n << 8) | *s->next++;
+
+	return s;
+}
+
+/* json has no NaN or Infinity, treat them as null like the text encoder */
+static pcl_json_t *
+make_real(double real)
+{
+	if(isnan(real) || isinf(real))
+		return pcl_json_null();
+
+	return pcl_json_real(real);
+}
+
+/* reads the string body, byte has already been consumed */
+static char *
+decode_string(msgpack_state_t *s, uint8_t byte)
+{
+	uint64_t len;
+
+	if((byte & 0xe0) == 0xa0)
+		len = byte & 0x1f;
+	else if(byte < 0xd9 || byte > 0xdb || !read_uint(s, 1 << (byte - 0xd9), &len))
+		JSON_THROW("expected msgpack str, found 0x%02x", byte);
+
+	if(len > (uint64_t) (s->end - s->next))
+		JSON_THROW("unexpected end of input: string length %llu", (unsigned long long) len);
+
+	if(len > 0 && pcl_utf8_check((const char *) s->next, (size_t) len) < 0)
+		return R_TRC(NULL);
+
+	/* pcl_strndup treats a zero len as NUL-terminated */
+	char *str = len > 0 ? pcl_strndup((const char *) s->next, (size_t) len) : pcl_strdup("");
+
+	s->next += len;
+	return str;
+}
+
+static pcl_json_t *
+decode_array(msgpack_state_t *s, uint64_t count)
+{
+	pcl_json_t *arr = pcl_json_arr();
+
+	for(uint64_t i = 0; i < count; i++)
+	{
+		pcl_json_t *elem = decode_value(s);
+
+		if(!elem || pcl_json_arradd(arr, elem, PCL_JSON_FREEVALONERR) < 0)
+		{
+			pcl_json_free(arr);
+			return R_TRC(NULL);
+		}
+	}
+
+	return arr;
+}
+
+static pcl_json_t *
+decode_map(msgpack_state_t *s, uint64_t count)
+{
+	pcl_json_t *obj = pcl_json_obj();
+
+	for(uint64_t i = 0; i < count; i++)
+	{
+		if(s->next == s->end)
+		{
+			pcl_json_free(obj);
+			JSON_THROW("unexpected end of input", 0);
+		}
+
+		/* json keys must be strings */
+		char *key = decode_string(s, *s->next++);
+
+		if(!key)
+		{
+			pcl_json_free(obj);
+			return NULL;
+		}
+
+		pcl_json_t *val = decode_value(s);
+
+		if(!val)
+		{
+			pcl_free(key);
+			pcl_json_free(obj);
+			return NULL;
+		}
+
+		uint32_t flags = PCL_JSON_SKIPUTF8CHK | PCL_JSON_SHALLOW | PCL_JSON_FREEVALONERR;
+
+		if(pcl_json_objput(obj, key, val, flags) < 0)
+		{
+			pcl_free(key);
+			pcl_json_free(obj);
+			return R_TRC(NULL);
+		}
+	}
+
+	return obj;
+}
+
+static pcl_json_t *
+decode_value(msgpack_state_t *s)
+{
+	uint64_t n;
+	pcl_json_t *val;
+
+	if(s->next == s->end)
+		JSON_THROW("unexpected end of input", 0);
+
+	JSON_CHKLIMIT();
+
+	if(++s->depth > JSON_BINARY_MAXDEPTH)
+		JSON_THROW("maximum nesting depth of %d exceeded", JSON_BINARY_MAXDEPTH);
+
+	uint8_t byte = *s->next++;
+
+	/* positive fixint */
+	if(byte <= 0x7f)
+	{
+		val = pcl_json_int(byte);
+	}
+	/* fixmap */
+	else if(byte <= 0x8f)
+	{
+		val = decode_map(s, byte & 0x0f);
+	}
+	/* fixarray */
+	else if(byte <= 0x9f)
+	{
+		val = decode_array(s, byte & 0x0f);
+	}
+	/* fixstr, str 8, str 16 and str 32 */
+	else if(byte <= 0xbf || (byte >= 0xd9 && byte <= 0xdb))
+	{
+		char *str = decode_string(s, byte);
+
+		if(!str)
+			return NULL;
+
+		/* decode_string already did UTF-8 check */
+		val = pcl_json_str(str, PCL_JSON_SKIPUTF8CHK | PCL_JSON_SHALLOW);
+	}
+	/* negative fixint */
+	else if(byte >= 0xe0)
+	{
+		val = pcl_json_int((int8_t) byte);
+	}
+	else
+	{
+		switch(byte)
+		{
+			case 0xc0:
+				val = pcl_json_null();
+				break;
+
+			case 0xc2:
+				val = pcl_json_false();
+				break;
+
+			case 0xc3:
+				val = pcl_json_true();
+				break;
+
+			case 0xca:
+			{
+				float f;
+				uint32_t bits;
+
+				if(!read_uint(s, 4, &n))
+					return NULL;
+
+				bits = (uint32_t) n;
+				memcpy(&f, &bits, sizeof(f));
+				val = make_real(f);
+				break;
+			}
+
+			case 0xcb:
+			{
+				double d;
+
+				if(!read_uint(s, 8, &n))
+					return NULL;
+
+				memcpy(&d, &n, sizeof(d));
+				val = make_real(d);
+				break;
+			}
+
+			/* uint 8, 16, 32 and 64 */
+			case 0xcc:
+			case 0xcd:
+			case 0xce:
+			case 0xcf:
+				if(!read_uint(s, 1 << (byte - 0xcc), &n))
+					return NULL;
+
+				val = n > LLONG_MAX ? pcl_json_real((double) n) : pcl_json_int((long long) n);
+				break;
+
+			/* int 8, 16, 32 and 64 */
+			case 0xd0:
+			case 0xd1:
+			case 0xd2:
+			case 0xd3:
+			{
+				int size = 1 << (byte - 0xd0);
+				long long i;
+
+				if(!read_uint(s, size, &n))
+					return NULL;
+
+				/* sign extend */
+				if(size < 8 && (n & (1ULL << (size * 8 - 1))))
+					n |= ~0ULL << (size * 8);
+
+				i = (long long) n;
+
+				/* PCL_JSON_INVINT */
+				val = i == LLONG_MIN ? pcl_json_real((double) i) : pcl_json_int(i);
+				break;
+			}
+
+			/* array 16 and 32 */
+			case 0xdc:
+			case 0xdd:
+				if(!read_uint(s, byte == 0xdc ? 2 : 4, &n))
+					return NULL;
+
+				val = decode_array(s, n);
+				break;
+
+			/* map 16 and 32 */
+			case 0xde:
+			case 0xdf:
+				if(!read_uint(s, byte == 0xde ? 2 : 4, &n))
+					return NULL;
+
+				val = decode_map(s, n);
+				break;
+
+			default:
+				JSON_THROW("unsupported msgpack type 0x%02x", byte);
+		}
+	}
+
+	s->depth--;
+	return val;
+}
+
+pcl_json_t *
+pcl_json_decode_msgpack(const void *data, size_t len, const void **end)
+{
+	if(!data || len == 0)
+		return R_SETERR(NULL, PCL_EINVAL);
+
+	msgpack_state_t state = {
+		.next = data,
+		.end = (const uint8_t *) data + len,
+		.depth = 0
+	};
+
+	int tag = ipcl_memtag_enter(PCL_MEMTAG_JSON);
+	pcl_json_t *val = decode_value(&state);
+
+	ipcl_memtag_leave(tag);
+
+	if(!val)
+		return R_TRCMSG(NULL, "offset=%ld", (long) (state.next - (const uint8_t *) data));
+
+	if(end)
+		*end = state.next;
+
+	return val;
+}
@@ -38,16 +38,25 @@ pcl_json_encode(pcl_json_t *value, bool format)
 {
 	pcl_buf_t buf;
 	ipcl_json_encode_t enc;
+	int tag = ipcl_memtag_enter(PCL_MEMTAG_JSON);
 
 	enc.tabs = 0;
 	enc.format = format;
-	enc.b = pcl_buf_init(&buf, 256, PclBufText);
+	enc.b = pcl_buf_lazynul(pcl_buf_init(&buf, 256, PclBufText), true);
+	enc.write = NULL;
+	enc.udata = NULL;
+	enc.pool = NULL;
 
-	if(!ipcl_json_encode_value(&enc, value))
+	bool ok = ipcl_json_encode_value(&enc, value) != NULL;
+
+	ipcl_memtag_leave(tag);
+
+	if(!ok)
 	{
 		pcl_buf_clear(&buf);
 		return NULL;
 	}
 
+	pcl_buf_terminate(&buf);
 	return buf.data;
 }
@@ -44,19 +44,29 @@ ipcl_json_encode_array(ipcl_json_encode_t *enc, pcl_array_t *arr)
 	if(enc->format && arr->count)
 		pcl_buf_putchar(b, '\n');
 
-	for(int i = 0; i < arr->count; i++)
+	/* large arrays are encoded in parallel when the encoder has a pool */
+	if(enc->pool && arr->count >= JSON_PARALLEL_MIN)
 	{
-		if(enc->format)
-			PRINT_TABS(enc);
-
-		if(!ipcl_json_encode_value(enc, arr->elements[i]))
+		if(!ipcl_json_encode_members(enc, (pcl_json_t **) arr->elements, NULL, arr->count))
 			return NULL;
+	}
+	else
+	{
+		for(int i = 0; i < arr->count; i++)
+		{
+			if(enc->format)
+				PRINT_TABS(enc);
+
+			if(!ipcl_json_encode_value(enc, arr->elements[i]) ||
+				!ipcl_json_encode_flush(enc, false))
+				return NULL;
 
-		if(i + 1 < arr->count)
-			pcl_buf_putchar(b, ',');
+			if(i + 1 < arr->count)
+				pcl_buf_putchar(b, ',');
 
-		if(enc->format)
-			pcl_buf_putchar(b, '\n');
+			if(enc->format)
+				pcl_buf_putchar(b, '\n');
+		}
 	}
 
 	enc->tabs--;
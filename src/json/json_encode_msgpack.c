@@ -0,0 +1,236 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_json.h"
+#include <pcl/array.h>
+#include <pcl/htable.h>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+/* writes the header of a str, array or map using the smallest format that fits n */
+static void
+put_head(pcl_buf_t *b, uint8_t fix, int fixmax, uint8_t fmt8, uint8_t fmt16, size_t n)
+{
+	if(n <= (size_t) fixmax)
+	{
+		pcl_buf_putint8(b, fix | (uint8_t) n);
+	}
+	else if(fmt8 && n <= UINT8_MAX)
+	{
+		pcl_buf_putint8(b, fmt8);
+		pcl_buf_putint8(b, (uint8_t) n);
+	}
+	else if(n <= UINT16_MAX)
+	{
+		pcl_buf_putint8(b, fmt16);
+		pcl_buf_putint16(b, (uint16_t) n);
+	}
+	else
+	{
+		/* 32-bit format always follows the 16-bit one */
+		pcl_buf_putint8(b, fmt16 + 1);
+		pcl_buf_putint32(b, (uint32_t) n);
+	}
+}
+
+static void
+put_string(pcl_buf_t *b, const char *s)
+{
+	size_t len = strlen(s);
+
+	put_head(b, 0xa0, 31, 0xd9, 0xda, len);
+
+	if(len > 0)
+		pcl_buf_put(b, s, (int) len);
+}
+
+static void
+put_integer(pcl_buf_t *b, long long i)
+{
+	if(i >= 0)
+	{
+		if(i <= 127)
+		{
+			pcl_buf_putint8(b, (uint8_t) i);
+		}
+		else if(i <= UINT8_MAX)
+		{
+			pcl_buf_putint8(b, 0xcc);
+			pcl_buf_putint8(b, (uint8_t) i);
+		}
+		else if(i <= UINT16_MAX)
+		{
+			pcl_buf_putint8(b, 0xcd);
+			pcl_buf_putint16(b, (uint16_t) i);
+		}
+		else if(i <= UINT32_MAX)
+		{
+			pcl_buf_putint8(b, 0xce);
+			pcl_buf_putint32(b, (uint32_t) i);
+		}
+		else
+		{
+			pcl_buf_putint8(b, 0xcf);
+			pcl_buf_putint64(b, (uint64_t) i);
+		}
+	}
+	else if(i >= -32)
+	{
+		pcl_buf_putint8(b, (uint8_t) (int8_t) i);
+	}
+	else if(i >= INT8_MIN)
+	{
+		pcl_buf_putint8(b, 0xd0);
+		pcl_buf_putint8(b, (uint8_t) (int8_t) i);
+	}
+	else if(i >= INT16_MIN)
+	{
+		pcl_buf_putint8(b, 0xd1);
+		pcl_buf_putint16(b, (uint16_t) (int16_t) i);
+	}
+	else if(i >= INT32_MIN)
+	{
+		pcl_buf_putint8(b, 0xd2);
+		pcl_buf_putint32(b, (uint32_t) (int32_t) i);
+	}
+	else
+	{
+		pcl_buf_putint8(b, 0xd3);
+		pcl_buf_putint64(b, (uint64_t) i);
+	}
+}
+
+static void
+put_real(pcl_buf_t *b, double real)
+{
+	/* same as the text encoder */
+	if(isnan(real) || isinf(real))
+	{
+		pcl_buf_putint8(b, 0xc0);
+		return;
+	}
+
+	/* use float 32 when it is lossless */
+	if(fabs(real) <= FLT_MAX && (double) (float) real == real)
+	{
+		float f = (float) real;
+		uint32_t bits;
+
+		memcpy(&bits, &f, sizeof(bits));
+		pcl_buf_putint8(b, 0xca);
+		pcl_buf_putint32(b, bits);
+	}
+	else
+	{
+		uint64_t bits;
+
+		memcpy(&bits, &real, sizeof(bits));
+		pcl_buf_putint8(b, 0xcb);
+		pcl_buf_putint64(b, bits);
+	}
+}
+
+static pcl_buf_t *
+encode_value(pcl_buf_t *b, pcl_json_t *value)
+{
+	switch(value->type)
+	{
+		case 0:
+			pcl_buf_putint8(b, 0xc0);
+			break;
+
+		case 'b':
+			pcl_buf_putint8(b, value->boolean ? 0xc3 : 0xc2);
+			break;
+
+		case 'i':
+			put_integer(b, value->integer);
+			break;
+
+		case 'r':
+			put_real(b, value->real);
+			break;
+
+		case 's':
+			put_string(b, value->string);
+			break;
+
+		case 'a':
+		{
+			/* array has no 8-bit format */
+			put_head(b, 0x90, 15, 0, 0xdc, (size_t) value->array->count);
+
+			for(int i = 0; i < value->array->count; i++)
+				if(!encode_value(b, value->array->elements[i]))
+					return NULL;
+
+			break;
+		}
+
+		case 'o':
+		{
+			int index = 0;
+			pcl_htable_entry_t *ent;
+
+			put_head(b, 0x80, 15, 0, 0xde, (size_t) value->object->count);
+
+			while((ent = pcl_htable_iter(value->object, &index)))
+			{
+				put_string(b, ent->key);
+
+				if(!encode_value(b, ent->value))
+					return NULL;
+			}
+
+			break;
+		}
+
+		default:
+			return R_SETERRMSG(NULL, PCL_ETYPE, "invalid json type '%c'", value->type);
+	}
+
+	return b;
+}
+
+int
+pcl_json_encode_msgpack(pcl_json_t *value, pcl_buf_t *b)
+{
+	if(!value || !b || b->mode != PclBufBinary)
+		return BADARG();
+
+	int pos = b->pos;
+
+	if(!encode_value(b, value))
+		return TRC();
+
+	return b->pos - pos;
+}
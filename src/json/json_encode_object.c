@@ -31,6 +31,7 @@
 
 #include "_json.h"
 #include <pcl/htable.h>
+#include <pcl/alloc.h>
 
 pcl_buf_t *
 ipcl_json_encode_object(ipcl_json_encode_t *enc, pcl_htable_t *obj)
@@ -48,27 +49,51 @@ ipcl_json_encode_object(ipcl_json_encode_t *enc, pcl_htable_t *obj)
 	pcl_htable_entry_t *ent;
 	int count = obj->count;
 
-	while((ent = pcl_htable_iter(obj, &index)))
+	/* large objects are encoded in parallel when the encoder has a pool */
+	if(enc->pool && count >= JSON_PARALLEL_MIN)
 	{
-		if(enc->format)
-			PRINT_TABS(enc);
+		char **keys = pcl_malloc(count * sizeof(char *));
+		pcl_json_t **values = pcl_malloc(count * sizeof(pcl_json_t *));
 
-		if(!ipcl_json_encode_string(enc, ent->key))
-			return NULL;
+		for(int i = 0; (ent = pcl_htable_iter(obj, &index)); i++)
+		{
+			keys[i] = (char *) ent->key;
+			values[i] = ent->value;
+		}
 
-		pcl_buf_putchar(b, ':');
+		pcl_buf_t *r = ipcl_json_encode_members(enc, values, keys, count);
 
-		if(enc->format)
-			pcl_buf_putchar(b, ' ');
+		pcl_free(keys);
+		pcl_free(values);
 
-		if(!ipcl_json_encode_value(enc, ent->value))
+		if(!r)
 			return NULL;
+	}
+	else
+	{
+		while((ent = pcl_htable_iter(obj, &index)))
+		{
+			if(enc->format)
+				PRINT_TABS(enc);
+
+			if(!ipcl_json_encode_string(enc, ent->key))
+				return NULL;
+
+			pcl_buf_putchar(b, ':');
+
+			if(enc->format)
+				pcl_buf_putchar(b, ' ');
+
+			if(!ipcl_json_encode_value(enc, ent->value) ||
+				!ipcl_json_encode_flush(enc, false))
+				return NULL;
 
-		if(--count > 0)
-			pcl_buf_putchar(b, ',');
+			if(--count > 0)
+				pcl_buf_putchar(b, ',');
 
-		if(enc->format)
-			pcl_buf_putchar(b, '\n');
+			if(enc->format)
+				pcl_buf_putchar(b, '\n');
+		}
 	}
 
 	enc->tabs--;
@@ -0,0 +1,72 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_json.h"
+#include <pcl/buf.h>
+
+char *
+pcl_json_encode_parallel(pcl_json_t *value, bool format, int nthreads)
+{
+	if(!value || nthreads < 1)
+		return R_SETERR(NULL, PCL_EINVAL);
+
+	if(nthreads == 1)
+		return pcl_json_encode(value, format);
+
+	pcl_buf_t buf;
+	ipcl_json_encode_t enc;
+
+	enc.tabs = 0;
+	enc.format = format;
+	enc.b = pcl_buf_lazynul(pcl_buf_init(&buf, 256, PclBufText), true);
+	enc.write = NULL;
+	enc.udata = NULL;
+
+	/* the encoding thread is one of the nthreads */
+	if(!(enc.pool = ipcl_json_pool(nthreads - 1)))
+	{
+		pcl_buf_clear(&buf);
+		return R_TRC(NULL);
+	}
+
+	pcl_buf_t *b = ipcl_json_encode_value(&enc, value);
+
+	ipcl_json_pool_free(enc.pool);
+
+	if(!b)
+	{
+		pcl_buf_clear(&buf);
+		return R_TRC(NULL);
+	}
+
+	pcl_buf_terminate(&buf);
+	return buf.data;
+}
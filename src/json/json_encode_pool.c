@@ -0,0 +1,279 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_json.h"
+#include <pcl/alloc.h>
+#include <pcl/thread.h>
+#include <stdio.h>
+
+/* members per range are clamped to this, so batches stay bounded for huge containers */
+#define RANGE_MIN 64
+#define RANGE_MAX 4096
+
+typedef struct
+{
+	int start;
+	int end;
+	pcl_buf_t buf; /* reused across batches */
+	int err;
+	char errmsg[256];
+} json_range_t;
+
+struct tag_ipcl_json_pool
+{
+	pthread_mutex_t lock;
+	pthread_cond_t work_cond;  /* signaled when a batch is posted or on shutdown */
+	pthread_cond_t done_cond;  /* signaled when a batch completes or a worker exits */
+	int workers;
+	bool shutdown;
+
+	/* the current batch, which is shared by every range */
+	pcl_json_t **values;
+	char **keys;
+	int count;
+	int tabs;
+	bool format;
+
+	json_range_t *ranges;
+	int max_ranges;
+	int nranges;
+	int next;      /* next range to be claimed */
+	int pending;   /* ranges not yet encoded */
+};
+
+/* encode members [start, end) exactly like ipcl_json_encode_array and ipcl_json_encode_object */
+static void
+encode_range(ipcl_json_pool_t *pool, json_range_t *r)
+{
+	ipcl_json_encode_t enc = {
+		.tabs = pool->tabs,
+		.format = pool->format,
+		.b = pcl_buf_reset(&r->buf),
+		.write = NULL,
+		.udata = NULL,
+		.pool = NULL
+	};
+
+	r->err = 0;
+
+	for(int i = r->start; i < r->end; i++)
+	{
+		if(enc.format)
+			PRINT_TABS(&enc);
+
+		if(pool->keys)
+		{
+			if(!ipcl_json_encode_string(&enc, pool->keys[i]))
+				goto error;
+
+			pcl_buf_putchar(enc.b, ':');
+
+			if(enc.format)
+				pcl_buf_putchar(enc.b, ' ');
+		}
+
+		if(!ipcl_json_encode_value(&enc, pool->values[i]))
+			goto error;
+
+		if(i + 1 < pool->count)
+			pcl_buf_putchar(enc.b, ',');
+
+		if(enc.format)
+			pcl_buf_putchar(enc.b, '\n');
+	}
+
+	return;
+
+error:
+	r->err = pcl_errno;
+	snprintf(r->errmsg, sizeof(r->errmsg), "%s", pcl_err_lastmsg());
+	pcl_err_clear();
+}
+
+/* claim and encode ranges of the current batch until none are left, lock must be held */
+static void
+drain(ipcl_json_pool_t *pool)
+{
+	while(pool->next < pool->nranges)
+	{
+		json_range_t *r = &pool->ranges[pool->next++];
+
+		pthread_mutex_unlock(&pool->lock);
+		encode_range(pool, r);
+		pthread_mutex_lock(&pool->lock);
+
+		if(--pool->pending == 0)
+			pthread_cond_broadcast(&pool->done_cond);
+	}
+}
+
+static void
+worker(void *arg)
+{
+	ipcl_json_pool_t *pool = arg;
+
+	pthread_mutex_lock(&pool->lock);
+
+	for(;;)
+	{
+		while(pool->next == pool->nranges && !pool->shutdown)
+			pthread_cond_wait(&pool->work_cond, &pool->lock);
+
+		if(pool->shutdown)
+			break;
+
+		drain(pool);
+	}
+
+	pool->workers--;
+	pthread_cond_broadcast(&pool->done_cond);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+ipcl_json_pool_t *
+ipcl_json_pool(int nthreads)
+{
+	if(nthreads < 1)
+		return R_SETERR(NULL, PCL_EINVAL);
+
+	ipcl_json_pool_t *pool = pcl_zalloc(sizeof(ipcl_json_pool_t));
+
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->work_cond, NULL);
+	pthread_cond_init(&pool->done_cond, NULL);
+
+	/* two ranges per thread, including the encoding thread, evens out uneven members */
+	pool->max_ranges = (nthreads + 1) * 2;
+	pool->ranges = pcl_zalloc(pool->max_ranges * sizeof(json_range_t));
+
+	for(int i = 0; i < pool->max_ranges; i++)
+		pcl_buf_init(&pool->ranges[i].buf, 4096, PclBufText);
+
+	for(int i = 0; i < nthreads; i++)
+	{
+		pool->workers++;
+
+		if(pcl_thread(NULL, worker, pool) < 0)
+		{
+			pool->workers--;
+
+			/* the encoding thread always helps, so any number of workers will do */
+			pcl_err_clear();
+			break;
+		}
+	}
+
+	return pool;
+}
+
+void
+ipcl_json_pool_free(ipcl_json_pool_t *pool)
+{
+	pthread_mutex_lock(&pool->lock);
+
+	pool->shutdown = true;
+	pthread_cond_broadcast(&pool->work_cond);
+
+	while(pool->workers > 0)
+		pthread_cond_wait(&pool->done_cond, &pool->lock);
+
+	pthread_mutex_unlock(&pool->lock);
+
+	for(int i = 0; i < pool->max_ranges; i++)
+		pcl_buf_clear(&pool->ranges[i].buf);
+
+	pcl_free(pool->ranges);
+	pthread_cond_destroy(&pool->work_cond);
+	pthread_cond_destroy(&pool->done_cond);
+	pthread_mutex_destroy(&pool->lock);
+	pcl_free(pool);
+}
+
+pcl_buf_t *
+ipcl_json_encode_members(ipcl_json_encode_t *enc, pcl_json_t **values, char **keys, int count)
+{
+	ipcl_json_pool_t *pool = enc->pool;
+	int size = count / (pool->max_ranges * 2);
+
+	if(size < RANGE_MIN)
+		size = RANGE_MIN;
+	else if(size > RANGE_MAX)
+		size = RANGE_MAX;
+
+	for(int start = 0; start < count; )
+	{
+		pthread_mutex_lock(&pool->lock);
+
+		pool->values = values;
+		pool->keys = keys;
+		pool->count = count;
+		pool->tabs = enc->tabs;
+		pool->format = enc->format;
+
+		for(pool->nranges = 0; pool->nranges < pool->max_ranges && start < count; pool->nranges++)
+		{
+			json_range_t *r = &pool->ranges[pool->nranges];
+
+			r->start = start;
+			r->end = count - start > size ? start + size : count;
+			start = r->end;
+		}
+
+		pool->next = 0;
+		pool->pending = pool->nranges;
+		pthread_cond_broadcast(&pool->work_cond);
+
+		drain(pool);
+
+		while(pool->pending > 0)
+			pthread_cond_wait(&pool->done_cond, &pool->lock);
+
+		/* idle workers wait for next < nranges, keep them waiting */
+		int nranges = pool->nranges;
+		pool->nranges = 0;
+		pool->next = 0;
+
+		pthread_mutex_unlock(&pool->lock);
+
+		for(int i = 0; i < nranges; i++)
+		{
+			json_range_t *r = &pool->ranges[i];
+
+			if(r->err)
+				return R_SETERRMSG(NULL, r->err, "%s", r->errmsg);
+
+			if(r->buf.len > 0)
+				pcl_buf_put(enc->b, r->buf.data, r->buf.len);
+		}
+	}
+
+	return enc->b;
+}
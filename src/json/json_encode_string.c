@@ -30,6 +30,7 @@
 */
 
 #include "_json.h"
+#include <limits.h>
 
 pcl_buf_t *
 ipcl_json_encode_string(ipcl_json_encode_t *enc, const char *s)
@@ -38,8 +39,33 @@ ipcl_json_encode_string(ipcl_json_encode_t *enc, const char *s)
 
 	pcl_buf_putchar(b, '"');
 
-	for(; *s; s++)
+	/* streaming bounds runs so a single large string cannot outgrow the buffer */
+	int limit = enc->write ? JSON_STREAM_SLACK : INT_MAX;
+
+	for(;; s++)
 	{
+		int n = 0;
+
+		/* copy runs of characters that need no escaping with one append */
+		while(n < limit && (unsigned char) s[n] >= 0x20 && s[n] != '\\' && s[n] != '/' && s[n] != '"')
+			n++;
+
+		if(n > 0)
+		{
+			if(pcl_buf_reserve(b, n))
+				return NULL;
+
+			pcl_buf_append(b, s, n);
+			s += n;
+		}
+
+		if(enc->write && b->len >= JSON_STREAM_BUFSIZE - JSON_STREAM_SLACK &&
+			!ipcl_json_encode_flush(enc, false))
+			return NULL;
+
+		if(!*s)
+			break;
+
 		switch(*s)
 		{
 			case '\\':
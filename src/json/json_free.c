@@ -31,6 +31,7 @@
 
 #include "_json.h"
 #include <pcl/alloc.h>
+#include <pcl/pool.h>
 #include <pcl/array.h>
 #include <pcl/htable.h>
 
@@ -61,5 +62,5 @@ pcl_json_free(pcl_json_t *j)
 			break;
 	}
 
-	pcl_free(j);
+	pcl_pool_put(ipcl_json_nodes(), j);
 }
@@ -42,6 +42,11 @@ pcl_json_freepath(pcl_json_path_t *path)
 			pcl_free_safe(cur->member);
 		else if(cur->type == PclPathElementList)
 			pcl_vector_free(cur->idx_list);
+		else if(cur->type == PclPathFilter)
+		{
+			pcl_json_freepath(cur->filter.path);
+			pcl_json_free(cur->filter.value);
+		}
 
 		pcl_json_path_t *next = cur->next;
 		pcl_free(cur);
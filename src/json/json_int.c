@@ -30,7 +30,7 @@
 */
 
 #include "_json.h"
-#include <pcl/alloc.h>
+#include <pcl/pool.h>
 
 pcl_json_t *
 pcl_json_int(long long integer)
@@ -38,7 +38,7 @@ pcl_json_int(long long integer)
 	if(integer == PCL_JSON_INVINT)
 		return R_SETERR(NULL, PCL_EINVAL);
 
-	pcl_json_t *val = pcl_malloc(sizeof(pcl_json_t));
+	pcl_json_t *val = pcl_pool_get(ipcl_json_nodes());
 
 	val->type = 'i';
 	val->nrefs = 1;
@@ -0,0 +1,401 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_json.h"
+#include <pcl/alloc.h>
+#include <pcl/array.h>
+#include <pcl/queue.h>
+#include <pcl/thread.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef struct
+{
+	const char *data;
+	size_t len;
+
+	/* allocation backing data, NULL when borrowed from the caller */
+	char *owned;
+
+	/* submission order and byte offset of data within the whole input */
+	uint64_t seq;
+	uint64_t offset;
+
+	pcl_array_t *docs;
+
+	/* first decode error within the chunk, docs holds everything before it */
+	int err;
+	uint64_t erroffset;
+	char errmsg[256];
+} json_chunk_t;
+
+struct tag_ipcl_json_lines
+{
+	pthread_mutex_t lock;
+	pthread_cond_t work_cond;  /* signaled when work is queued or on shutdown */
+	pthread_cond_t done_cond;  /* signaled when a chunk is decoded or a worker exits */
+	pcl_queue_t *work;         /* chunks waiting to be decoded */
+	pcl_array_t *done;         /* decoded chunks waiting to be delivered */
+	int inflight;              /* chunks submitted but not yet delivered */
+	int max_inflight;
+	int workers;
+	bool shutdown;
+	bool ordered;
+	bool stopped;              /* error or handler returned false, remaining chunks are dropped */
+	uint64_t next_seq;
+	uint64_t deliver_seq;
+	uint64_t offset;
+	int count;
+	int err;
+	char errmsg[300];
+	pcl_json_line_handler_t handler;
+	void *udata;
+};
+
+static void
+doc_cleanup(void *doc)
+{
+	pcl_json_free(doc);
+}
+
+static void
+chunk_free(json_chunk_t *c)
+{
+	pcl_array_free(c->docs);
+	pcl_free_safe(c->owned);
+	pcl_free(c);
+}
+
+static void
+decode_chunk(json_chunk_t *c)
+{
+	const char *p = c->data;
+	const char *end = c->data + c->len;
+
+	c->docs = pcl_array(64, doc_cleanup);
+
+	while(p < end)
+	{
+		const char *nl = memchr(p, '\n', end - p);
+		const char *eol = nl ? nl : end;
+
+		while(p < eol && isspace((unsigned char) *p))
+			p++;
+
+		/* blank lines are skipped. The decode includes the newline, which bounds the parser. */
+		if(p < eol)
+		{
+			const char *docend;
+			pcl_json_t *doc = pcl_json_decode(p, (nl ? nl + 1 : end) - p, &docend);
+
+			if(!doc)
+			{
+				c->err = pcl_errno;
+				snprintf(c->errmsg, sizeof(c->errmsg), "%s", pcl_err_lastmsg());
+				c->erroffset = p - c->data;
+				pcl_err_clear();
+				return;
+			}
+
+			pcl_array_append(c->docs, doc);
+
+			while(docend < eol && isspace((unsigned char) *docend))
+				docend++;
+
+			if(docend < eol)
+			{
+				c->err = PCL_ESYNTAX;
+				strcpy(c->errmsg, "unexpected data after json value");
+				c->erroffset = docend - c->data;
+				return;
+			}
+		}
+
+		p = eol + 1;
+	}
+}
+
+static void
+worker(void *arg)
+{
+	ipcl_json_lines_t *jl = arg;
+
+	pthread_mutex_lock(&jl->lock);
+
+	for(;;)
+	{
+		json_chunk_t *c;
+
+		while(!(c = pcl_queue_remove(jl->work)) && !jl->shutdown)
+			pthread_cond_wait(&jl->work_cond, &jl->lock);
+
+		if(!c)
+			break;
+
+		/* once stopped, chunks are passed through undecoded so they can be released in order */
+		if(!jl->stopped)
+		{
+			pthread_mutex_unlock(&jl->lock);
+			decode_chunk(c);
+			pthread_mutex_lock(&jl->lock);
+		}
+
+		pcl_array_append(jl->done, c);
+		pthread_cond_broadcast(&jl->done_cond);
+	}
+
+	jl->workers--;
+	pthread_cond_broadcast(&jl->done_cond);
+	pthread_mutex_unlock(&jl->lock);
+}
+
+/* remove the next deliverable chunk from the done list, lock must be held */
+static json_chunk_t *
+next_ready(ipcl_json_lines_t *jl)
+{
+	for(int i = 0; i < jl->done->count; i++)
+	{
+		json_chunk_t *c = jl->done->elements[i];
+
+		if(!jl->ordered || c->seq == jl->deliver_seq)
+		{
+			pcl_array_remove(jl->done, i);
+			jl->deliver_seq++;
+			return c;
+		}
+	}
+
+	return NULL;
+}
+
+/* hand a chunk's documents to the handler. Called with the lock held, which is released while
+ * the handler runs.
+ */
+static void
+deliver(ipcl_json_lines_t *jl, json_chunk_t *c)
+{
+	bool stopped = jl->stopped;
+
+	pthread_mutex_unlock(&jl->lock);
+
+	for(int i = 0; !stopped && c->docs && i < c->docs->count; i++)
+	{
+		pcl_json_t *doc = c->docs->elements[i];
+
+		/* ownership moves to the handler */
+		c->docs->elements[i] = NULL;
+		jl->count++;
+
+		if(!jl->handler(doc, jl->udata))
+			stopped = true;
+	}
+
+	if(!stopped && c->err)
+	{
+		jl->err = c->err;
+		snprintf(jl->errmsg, sizeof(jl->errmsg), "offset %llu: %s",
+			(unsigned long long) (c->offset + c->erroffset), c->errmsg);
+		stopped = true;
+	}
+
+	chunk_free(c);
+
+	pthread_mutex_lock(&jl->lock);
+
+	jl->inflight--;
+
+	if(stopped)
+		jl->stopped = true;
+}
+
+static int
+queue_chunk(ipcl_json_lines_t *jl, const char *data, size_t len, char *owned)
+{
+	json_chunk_t *c = pcl_zalloc(sizeof(json_chunk_t));
+
+	c->data = data;
+	c->len = len;
+	c->owned = owned;
+	c->seq = jl->next_seq++;
+	c->offset = jl->offset;
+	jl->offset += len;
+
+	pthread_mutex_lock(&jl->lock);
+
+	while(!jl->stopped && jl->inflight >= jl->max_inflight)
+	{
+		json_chunk_t *ready = next_ready(jl);
+
+		if(ready)
+			deliver(jl, ready);
+		else
+			pthread_cond_wait(&jl->done_cond, &jl->lock);
+	}
+
+	if(jl->stopped)
+	{
+		pthread_mutex_unlock(&jl->lock);
+		chunk_free(c);
+		return -1;
+	}
+
+	jl->inflight++;
+	pcl_queue_add(jl->work, c);
+	pthread_cond_signal(&jl->work_cond);
+	pthread_mutex_unlock(&jl->lock);
+
+	return 0;
+}
+
+ipcl_json_lines_t *
+ipcl_json_lines(int nthreads, uint32_t flags, pcl_json_line_handler_t handler, void *udata)
+{
+	if(nthreads < 1 || !handler)
+		return R_SETERR(NULL, PCL_EINVAL);
+
+	ipcl_json_lines_t *jl = pcl_zalloc(sizeof(ipcl_json_lines_t));
+
+	pthread_mutex_init(&jl->lock, NULL);
+	pthread_cond_init(&jl->work_cond, NULL);
+	pthread_cond_init(&jl->done_cond, NULL);
+	jl->work = pcl_queue(NULL);
+	jl->done = pcl_array(nthreads * 2, NULL);
+	jl->max_inflight = nthreads * 2;
+	jl->ordered = !(flags & PCL_JSON_UNORDERED);
+	jl->handler = handler;
+	jl->udata = udata;
+
+	/* workers only touch 'workers' when exiting, which cannot happen before shutdown */
+	for(int i = 0; i < nthreads; i++)
+	{
+		jl->workers++;
+
+		if(pcl_thread(NULL, worker, jl) < 0)
+		{
+			jl->workers--;
+
+			/* run with fewer threads, as long as there is at least one */
+			if(jl->workers > 0)
+			{
+				pcl_err_clear();
+				break;
+			}
+
+			jl->stopped = true;
+			ipcl_json_lines_end(jl);
+			return R_TRCMSG(NULL, "cannot start json lines worker", 0);
+		}
+	}
+
+	return jl;
+}
+
+int
+ipcl_json_lines_submit(ipcl_json_lines_t *jl, const char *data, size_t len, char *owned)
+{
+	if(len == 0 || data[len - 1] == '\n')
+		return queue_chunk(jl, data, len, owned);
+
+	/* copy the trailing partial line so the parser is bounded by a newline */
+	size_t headlen = len;
+
+	while(headlen > 0 && data[headlen - 1] != '\n')
+		headlen--;
+
+	size_t taillen = len - headlen;
+	char *tail = pcl_malloc(taillen + 2);
+
+	memcpy(tail, data + headlen, taillen);
+	tail[taillen] = '\n';
+	tail[taillen + 1] = 0;
+
+	if(headlen > 0)
+	{
+		if(queue_chunk(jl, data, headlen, owned) < 0)
+		{
+			pcl_free(tail);
+			return -1;
+		}
+	}
+	else
+	{
+		pcl_free_safe(owned);
+	}
+
+	/* the appended newline is not part of the input */
+	int r = queue_chunk(jl, tail, taillen + 1, tail);
+
+	jl->offset--;
+	return r;
+}
+
+int
+ipcl_json_lines_end(ipcl_json_lines_t *jl)
+{
+	pthread_mutex_lock(&jl->lock);
+
+	while(jl->inflight > 0)
+	{
+		json_chunk_t *ready = next_ready(jl);
+
+		if(ready)
+			deliver(jl, ready);
+		else
+			pthread_cond_wait(&jl->done_cond, &jl->lock);
+	}
+
+	jl->shutdown = true;
+	pthread_cond_broadcast(&jl->work_cond);
+
+	while(jl->workers > 0)
+		pthread_cond_wait(&jl->done_cond, &jl->lock);
+
+	pthread_mutex_unlock(&jl->lock);
+
+	int err = jl->err;
+	int count = jl->count;
+	char errmsg[sizeof(jl->errmsg)];
+
+	strcpy(errmsg, jl->errmsg);
+
+	pcl_queue_free(jl->work);
+	pcl_array_free(jl->done);
+	pthread_cond_destroy(&jl->work_cond);
+	pthread_cond_destroy(&jl->done_cond);
+	pthread_mutex_destroy(&jl->lock);
+	pcl_free(jl);
+
+	if(err)
+		return SETERRMSG(err, "%s", errmsg);
+
+	return count;
+}
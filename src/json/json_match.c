@@ -31,197 +31,12 @@
 
 #include "_json.h"
 #include <pcl/array.h>
-#include <pcl/vector.h>
-#include <pcl/htable.h>
-#include <string.h>
 
-static void
-walk_path(pcl_json_t *node, const pcl_json_path_t *path, pcl_array_t *results)
+static bool
+append_result(pcl_json_t *value, void *udata)
 {
-	switch(path->type)
-	{
-		case PclPathRoot:
-		{
-			if(path->next == NULL)
-				pcl_array_append(results, pcl_json_ref(node, 1));
-			else
-				walk_path(node, path->next, results);
-
-			break;
-		}
-
-		case PclPathMember:
-		{
-			if(pcl_json_isobj(node))
-			{
-				pcl_json_t *mbr = pcl_json_objget(node, path->member);
-
-				if(mbr)
-				{
-					if(path->next == NULL)
-						pcl_array_append(results, pcl_json_ref(mbr, 1));
-					else
-						walk_path(mbr, path->next, results);
-				}
-			}
-
-			break;
-		}
-
-		case PclPathRecursiveDescent:
-		{
-			if(pcl_json_isobj(node))
-			{
-				int index = 0;
-				pcl_htable_entry_t *ent;
-
-				while((ent = pcl_htable_iter(node->object, &index)))
-				{
-					if(path->next->type == PclPathMember && !strcmp(path->next->member, ent->key))
-						walk_path(node, path->next, results);
-					else
-						walk_path(ent->value, path, results);
-				}
-			}
-			else if(pcl_json_isarr(node))
-			{
-				for(int i = 0; i < node->array->count; i++)
-				{
-					pcl_json_t *elem = node->array->elements[i];
-
-					if(path->next->type == PclPathElement && path->next->index == i)
-						walk_path(node, path->next, results);
-					else
-						walk_path(elem, path, results);
-				}
-			}
-
-			break;
-		}
-
-		case PclPathWildcardMember:
-		{
-			if(!pcl_json_isobj(node))
-			{
-				pcl_array_append(results, pcl_json_ref(node, 1));
-				break;
-			}
-
-			int index = 0;
-			pcl_htable_entry_t *ent;
-
-			while((ent = pcl_htable_iter(node->object, &index)))
-			{
-				if(path->next)
-					walk_path(ent->value, path->next, results);
-				else
-					pcl_array_append(results, pcl_json_ref(ent->value, 1));
-			}
-
-			break;
-		}
-
-		case PclPathElement:
-		{
-			if(pcl_json_isarr(node))
-			{
-				pcl_err_freeze(true);
-				pcl_json_t *elem = pcl_array_get(node->array, path->index);
-				pcl_err_freeze(false);
-
-				if(elem)
-				{
-					if(path->next == NULL)
-						pcl_array_append(results, pcl_json_ref(elem, 1));
-					else
-						walk_path(elem, path->next, results);
-				}
-			}
-
-			break;
-		}
-
-		case PclPathElementList:
-		{
-			if(!pcl_json_isarr(node))
-				break;
-
-			for(int i = 0; i < path->idx_list->count; i++)
-			{
-				int *index = pcl_vector_get(path->idx_list, i);
-
-				pcl_err_freeze(true);
-				pcl_json_t *elem = pcl_array_get(node->array, *index);
-				pcl_err_freeze(false);
-
-				if(elem)
-				{
-					if(path->next == NULL)
-						pcl_array_append(results, pcl_json_ref(elem, 1));
-					else
-						walk_path(elem, path->next, results);
-				}
-			}
-
-			break;
-		}
-
-		case PclPathWildcardElement:
-		{
-			if(!pcl_json_isarr(node))
-			{
-				pcl_array_append(results, pcl_json_ref(node, 1));
-				break;
-			}
-
-			for(int i = 0; i < node->array->count; i++)
-			{
-				pcl_json_t *elem = node->array->elements[i];
-
-				if(path->next == NULL)
-					pcl_array_append(results, pcl_json_ref(elem, 1));
-				else
-					walk_path(elem, path->next, results);
-			}
-
-			break;
-		}
-
-		case PclPathElementSlice:
-		{
-			if(!pcl_json_isarr(node))
-				break;
-
-			int start = path->idx_slice.start;
-			int end = path->idx_slice.end ? path->idx_slice.end : node->array->count;
-
-			if(start < 0)
-				start = node->array->count + path->idx_slice.start;
-
-			if(end < 0)
-				end = node->array->count + path->idx_slice.end;
-
-			for(int i = start; i < end; i += path->idx_slice.step)
-			{
-				pcl_err_freeze(true);
-				pcl_json_t *elem = pcl_array_get(node->array, i);
-				pcl_err_freeze(false);
-
-				if(elem)
-				{
-					if(path->next == NULL)
-						pcl_array_append(results, pcl_json_ref(elem, 1));
-					else
-						walk_path(elem, path->next, results);
-				}
-			}
-
-			break;
-		}
-
-		default:
-			break;
-	}
+	pcl_array_append(udata, pcl_json_ref(value, 1));
+	return true;
 }
 
 pcl_array_t *
@@ -233,6 +48,11 @@ pcl_json_match(pcl_json_t *root, const pcl_json_path_t *path)
 	j->array = NULL;
 	pcl_json_free(j);
 
-	walk_path(root, path, results);
+	if(pcl_json_visit(root, path, append_result, results) < 0)
+	{
+		pcl_array_free(results);
+		return R_TRC(NULL);
+	}
+
 	return results;
 }
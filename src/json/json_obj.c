@@ -30,6 +30,7 @@
 */
 
 #include "_json.h"
+#include <pcl/pool.h>
 #include <pcl/htable.h>
 #include <pcl/alloc.h>
 
@@ -43,7 +44,7 @@ remove_entry(const void *key, void *value)
 pcl_json_t *
 pcl_json_obj(void)
 {
-	pcl_json_t *val = pcl_malloc(sizeof(pcl_json_t));
+	pcl_json_t *val = pcl_pool_get(ipcl_json_nodes());
 
 	val->type = 'o';
 	val->nrefs = 1;
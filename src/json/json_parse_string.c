@@ -98,13 +98,15 @@ utf16_to_utf8(ipcl_json_state_t *s, pcl_buf_t *b)
 		code = pair[0];
 	}
 
-	int n = pcl_utf8_encode(code, pcl_buf_grow(b, 4)->data + b->pos);
+	/* room for the NUL, which pcl_buf_put would normally write */
+	int n = pcl_utf8_encode(code, pcl_buf_grow(b, 5)->data + b->pos);
 
 	if(n == -1)
 		return R_TRC(NULL);
 
 	b->pos += n;
 	b->len += n;
+	b->data[b->pos] = 0;
 
 	return s;
 }
@@ -121,7 +123,7 @@ ipcl_json_parse_string(ipcl_json_state_t *s)
 	s->ctx = s->next++;
 
 	/* first encode any escapes */
-	for(; *s->next; s->next++)
+	for(; s->next < s->end && *s->next; s->next++)
 	{
 		if(*s->next != '\\')
 		{
@@ -132,8 +134,11 @@ ipcl_json_parse_string(ipcl_json_state_t *s)
 			continue;
 		}
 
+		if(++s->next == s->end)
+			break;
+
 		/* we have an escape sequence */
-		switch(*++s->next)
+		switch(*s->next)
 		{
 			case '\\':
 			case '/':
@@ -181,7 +186,7 @@ ipcl_json_parse_string(ipcl_json_state_t *s)
 		}
 	}
 
-	if(*s->next != '"')
+	if(s->next == s->end || *s->next != '"')
 	{
 		pcl_buf_clear(b);
 		JSON_THROW("expected closing double quote", 0);
@@ -38,6 +38,7 @@ ipcl_json_parse_value(ipcl_json_state_t *s)
 {
 	pcl_json_t *val;
 
+	JSON_CHKLIMIT();
 	s->ctx = s->next;
 
 	if(!ipcl_json_skipws(s))
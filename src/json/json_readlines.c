@@ -0,0 +1,167 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_json.h"
+#include "../file/_file.h"
+#include <pcl/alloc.h>
+#include <string.h>
+
+#ifdef PCL_UNIX
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+
+/* Returns the number of documents, -1 on error or -2 if the file cannot be mapped */
+static int
+map_lines(pcl_file_t *file, int nthreads, uint32_t flags, pcl_json_line_handler_t handler,
+	void *udata)
+{
+	struct stat st;
+
+	if(fstat(file->fd, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size == 0)
+		return -2;
+
+	off_t pos = lseek(file->fd, 0, SEEK_CUR);
+
+	if(pos < 0 || pos > st.st_size)
+		return -2;
+
+	char *map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, file->fd, 0);
+
+	if(map == MAP_FAILED)
+		return -2;
+
+	(void) madvise(map, (size_t) st.st_size, MADV_SEQUENTIAL);
+
+	int count = pcl_json_decode_lines(map + pos, (size_t) (st.st_size - pos), nthreads, flags,
+		handler, udata);
+
+	munmap(map, (size_t) st.st_size);
+
+	if(count < 0)
+		return TRC();
+
+	/* behave like the file was read */
+	lseek(file->fd, 0, SEEK_END);
+	return count;
+}
+#endif
+
+int
+pcl_json_readlines(pcl_file_t *file, int nthreads, uint32_t flags,
+	pcl_json_line_handler_t handler, void *udata)
+{
+	if(!file)
+		return BADARG();
+
+#ifdef PCL_UNIX
+	int r = map_lines(file, nthreads, flags, handler, udata);
+
+	if(r != -2)
+		return r;
+#endif
+
+	ipcl_json_lines_t *jl = ipcl_json_lines(nthreads, flags, handler, udata);
+
+	if(!jl)
+		return TRC();
+
+	/* Stream: fill a chunk buffer, submit up to its last newline and carry the partial line
+	 * into the next buffer. A line larger than the buffer grows it.
+	 */
+	int n = 0;
+	size_t len = 0;
+	size_t size = JSON_LINES_CHUNK;
+	char *buf = pcl_malloc(size);
+
+	for(;;)
+	{
+		while(len < size && (n = pcl_file_read(file, buf + len, size - len)) > 0)
+			len += n;
+
+		if(n < 0)
+			break;
+
+		size_t headlen = len;
+
+		while(headlen > 0 && buf[headlen - 1] != '\n')
+			headlen--;
+
+		/* end of file, submit whatever is left */
+		if(n == 0)
+		{
+			if(len > 0 && ipcl_json_lines_submit(jl, buf, len, buf) < 0)
+				n = -2;
+
+			buf = NULL;
+			break;
+		}
+
+		/* no newline within the buffer */
+		if(headlen == 0)
+		{
+			size *= 2;
+			buf = pcl_realloc(buf, size);
+			continue;
+		}
+
+		size = len - headlen + JSON_LINES_CHUNK;
+
+		char *next = pcl_malloc(size);
+
+		memcpy(next, buf + headlen, len - headlen);
+		len -= headlen;
+
+		if(ipcl_json_lines_submit(jl, buf, headlen, buf) < 0)
+		{
+			pcl_free(next);
+			buf = NULL;
+			n = -2;
+			break;
+		}
+
+		buf = next;
+	}
+
+	pcl_free_safe(buf);
+
+	/* read error: stop decoding but keep the read error, not the decoder's */
+	if(n == -1)
+	{
+		pcl_err_freeze(true);
+		ipcl_json_lines_end(jl);
+		pcl_err_freeze(false);
+		return TRCMSG("cannot read json lines", 0);
+	}
+
+	int count = ipcl_json_lines_end(jl);
+
+	return count < 0 ? TRC() : count;
+}
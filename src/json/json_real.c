@@ -30,7 +30,7 @@
 */
 
 #include "_json.h"
-#include <pcl/alloc.h>
+#include <pcl/pool.h>
 #include <math.h>
 
 pcl_json_t *
@@ -45,7 +45,7 @@ pcl_json_real(double real)
 	if(isinf(real))
 		return R_SETERRMSG(NULL, PCL_EINVAL, "Infinity not supported", 0);
 
-	pcl_json_t *val = pcl_malloc(sizeof(pcl_json_t));
+	pcl_json_t *val = pcl_pool_get(ipcl_json_nodes());
 
 	val->type = 'r';
 	val->nrefs = 1;
@@ -30,8 +30,8 @@
 */
 
 #include "_json.h"
+#include <pcl/pool.h>
 #include <pcl/string.h>
-#include <pcl/alloc.h>
 
 pcl_json_t *
 pcl_json_str(char *str, uint32_t flags)
@@ -52,7 +52,7 @@ pcl_json_str(char *str, uint32_t flags)
 	if((flags & PCL_JSON_EMPTYASNULL) && len == 0)
 		return pcl_json_null();
 
-	pcl_json_t *val = pcl_malloc(sizeof(pcl_json_t));
+	pcl_json_t *val = pcl_pool_get(ipcl_json_nodes());
 
 	val->type = 's';
 	val->nrefs = 1;
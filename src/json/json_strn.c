@@ -30,7 +30,7 @@
 */
 
 #include "_json.h"
-#include <pcl/alloc.h>
+#include <pcl/pool.h>
 #include <pcl/string.h>
 
 pcl_json_t *
@@ -50,7 +50,7 @@ pcl_json_strn(const char *str, size_t len, uint32_t flags)
 	if((flags & PCL_JSON_EMPTYASNULL) && len == 0)
 		return pcl_json_null();
 
-	pcl_json_t *val = pcl_malloc(sizeof(pcl_json_t));
+	pcl_json_t *val = pcl_pool_get(ipcl_json_nodes());
 
 	val->type = 's';
 	val->nrefs = 1;
@@ -0,0 +1,362 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_json.h"
+#include <pcl/array.h>
+#include <pcl/vector.h>
+#include <pcl/htable.h>
+#include <string.h>
+
+typedef struct
+{
+	pcl_json_visitor_t visitor;
+	void *udata;
+	int count;
+	bool stop;
+} visit_t;
+
+typedef struct
+{
+	const pcl_json_path_t *filter;
+	bool matched;
+} filter_test_t;
+
+static void walk_path(pcl_json_t *node, const pcl_json_path_t *path, visit_t *v);
+
+static void
+emit(pcl_json_t *node, visit_t *v)
+{
+	if(v->stop)
+		return;
+
+	v->count++;
+
+	if(!v->visitor(node, v->udata))
+		v->stop = true;
+}
+
+/* either node is a result or it continues down the path */
+static void
+step(pcl_json_t *node, const pcl_json_path_t *path, visit_t *v)
+{
+	if(path->next == NULL)
+		emit(node, v);
+	else
+		walk_path(node, path->next, v);
+}
+
+static bool
+filter_compare(const pcl_json_t *a, filter_op_t op, const pcl_json_t *b)
+{
+	int cmp;
+
+	if(op == PclFilterExists)
+		return true;
+
+	if(pcl_json_isnum(a) && pcl_json_isnum(b))
+	{
+		if(pcl_json_isint(a) && pcl_json_isint(b))
+		{
+			cmp = (a->integer > b->integer) - (a->integer < b->integer);
+		}
+		else
+		{
+			double x = pcl_json_isint(a) ? (double) a->integer : a->real;
+			double y = pcl_json_isint(b) ? (double) b->integer : b->real;
+
+			cmp = (x > y) - (x < y);
+		}
+	}
+	else if(pcl_json_isstr(a) && pcl_json_isstr(b))
+	{
+		cmp = strcmp(a->string, b->string);
+	}
+	else if(a->type == b->type && (pcl_json_isbool(a) || pcl_json_isnull(a)))
+	{
+		/* booleans and nulls only support equality */
+		bool equal = pcl_json_isnull(a) || a->boolean == b->boolean;
+
+		if(op == PclFilterEQ)
+			return equal;
+
+		return op == PclFilterNE ? !equal : false;
+	}
+	else
+	{
+		/* different types are never equal and have no ordering */
+		return op == PclFilterNE;
+	}
+
+	switch(op)
+	{
+		case PclFilterEQ:
+			return cmp == 0;
+
+		case PclFilterNE:
+			return cmp != 0;
+
+		case PclFilterLT:
+			return cmp < 0;
+
+		case PclFilterLE:
+			return cmp <= 0;
+
+		case PclFilterGT:
+			return cmp > 0;
+
+		case PclFilterGE:
+			return cmp >= 0;
+
+		default:
+			return false;
+	}
+}
+
+static bool
+filter_visitor(pcl_json_t *value, void *udata)
+{
+	filter_test_t *test = udata;
+
+	test->matched = filter_compare(value, test->filter->filter.op, test->filter->filter.value);
+
+	/* stop at the first value satisfying the predicate */
+	return !test->matched;
+}
+
+/* a filter passes when any value selected by its relative path satisfies the predicate */
+static bool
+filter_test(pcl_json_t *node, const pcl_json_path_t *filter)
+{
+	if(!filter->filter.path)
+		return filter_compare(node, filter->filter.op, filter->filter.value);
+
+	filter_test_t test = {.filter = filter, .matched = false};
+	visit_t v = {.visitor = filter_visitor, .udata = &test, .count = 0, .stop = false};
+
+	walk_path(node, filter->filter.path, &v);
+
+	return test.matched;
+}
+
+static void
+walk_path(pcl_json_t *node, const pcl_json_path_t *path, visit_t *v)
+{
+	if(v->stop)
+		return;
+
+	switch(path->type)
+	{
+		case PclPathRoot:
+		{
+			step(node, path, v);
+			break;
+		}
+
+		case PclPathMember:
+		{
+			if(pcl_json_isobj(node))
+			{
+				pcl_json_t *mbr = pcl_json_objget(node, path->member);
+
+				if(mbr)
+					step(mbr, path, v);
+			}
+
+			break;
+		}
+
+		case PclPathRecursiveDescent:
+		{
+			if(pcl_json_isobj(node))
+			{
+				int index = 0;
+				pcl_htable_entry_t *ent;
+
+				while(!v->stop && (ent = pcl_htable_iter(node->object, &index)))
+				{
+					if(path->next->type == PclPathMember && !strcmp(path->next->member, ent->key))
+						walk_path(node, path->next, v);
+					else
+						walk_path(ent->value, path, v);
+				}
+			}
+			else if(pcl_json_isarr(node))
+			{
+				for(int i = 0; i < node->array->count && !v->stop; i++)
+				{
+					pcl_json_t *elem = node->array->elements[i];
+
+					if(path->next->type == PclPathElement && path->next->index == i)
+						walk_path(node, path->next, v);
+					else
+						walk_path(elem, path, v);
+				}
+			}
+
+			break;
+		}
+
+		case PclPathWildcardMember:
+		{
+			if(!pcl_json_isobj(node))
+			{
+				emit(node, v);
+				break;
+			}
+
+			int index = 0;
+			pcl_htable_entry_t *ent;
+
+			while(!v->stop && (ent = pcl_htable_iter(node->object, &index)))
+				step(ent->value, path, v);
+
+			break;
+		}
+
+		case PclPathElement:
+		{
+			if(pcl_json_isarr(node))
+			{
+				pcl_err_freeze(true);
+				pcl_json_t *elem = pcl_array_get(node->array, path->index);
+				pcl_err_freeze(false);
+
+				if(elem)
+					step(elem, path, v);
+			}
+
+			break;
+		}
+
+		case PclPathElementList:
+		{
+			if(!pcl_json_isarr(node))
+				break;
+
+			for(int i = 0; i < path->idx_list->count && !v->stop; i++)
+			{
+				int *index = pcl_vector_get(path->idx_list, i);
+
+				pcl_err_freeze(true);
+				pcl_json_t *elem = pcl_array_get(node->array, *index);
+				pcl_err_freeze(false);
+
+				if(elem)
+					step(elem, path, v);
+			}
+
+			break;
+		}
+
+		case PclPathWildcardElement:
+		{
+			if(!pcl_json_isarr(node))
+			{
+				emit(node, v);
+				break;
+			}
+
+			for(int i = 0; i < node->array->count && !v->stop; i++)
+				step(node->array->elements[i], path, v);
+
+			break;
+		}
+
+		case PclPathElementSlice:
+		{
+			if(!pcl_json_isarr(node))
+				break;
+
+			int start = path->idx_slice.start;
+			int end = path->idx_slice.end ? path->idx_slice.end : node->array->count;
+
+			if(start < 0)
+				start = node->array->count + path->idx_slice.start;
+
+			if(end < 0)
+				end = node->array->count + path->idx_slice.end;
+
+			for(int i = start; i < end && !v->stop; i += path->idx_slice.step)
+			{
+				pcl_err_freeze(true);
+				pcl_json_t *elem = pcl_array_get(node->array, i);
+				pcl_err_freeze(false);
+
+				if(elem)
+					step(elem, path, v);
+			}
+
+			break;
+		}
+
+		case PclPathFilter:
+		{
+			if(pcl_json_isobj(node))
+			{
+				int index = 0;
+				pcl_htable_entry_t *ent;
+
+				while(!v->stop && (ent = pcl_htable_iter(node->object, &index)))
+					if(filter_test(ent->value, path))
+						step(ent->value, path, v);
+			}
+			else if(pcl_json_isarr(node))
+			{
+				for(int i = 0; i < node->array->count && !v->stop; i++)
+				{
+					pcl_json_t *elem = node->array->elements[i];
+
+					if(filter_test(elem, path))
+						step(elem, path, v);
+				}
+			}
+
+			break;
+		}
+
+		default:
+			break;
+	}
+}
+
+int
+pcl_json_visit(pcl_json_t *root, const pcl_json_path_t *path, pcl_json_visitor_t visitor,
+	void *udata)
+{
+	if(!root || !path || !visitor)
+		return BADARG();
+
+	visit_t v = {.visitor = visitor, .udata = udata, .count = 0, .stop = false};
+
+	walk_path(root, path, &v);
+
+	return v.count;
+}
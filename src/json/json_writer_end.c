@@ -0,0 +1,63 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_json.h"
+
+int
+pcl_json_writer_end(pcl_json_writer_t *w)
+{
+	if(!w)
+		return BADARG();
+
+	if(w->depth == 0)
+		return SETERRMSG(PCL_EINVAL, "no open array or object", 0);
+
+	if(w->haskey)
+		return SETERRMSG(PCL_EINVAL, "expected an object value", 0);
+
+	ipcl_json_level_t *level = &w->levels[--w->depth];
+
+	w->enc.tabs--;
+
+	/* identical to ipcl_json_encode_array and ipcl_json_encode_object */
+	if(w->enc.format && level->count)
+	{
+		pcl_buf_putchar(w->enc.b, '\n');
+		PRINT_TABS(&w->enc);
+	}
+
+	pcl_buf_putchar(w->enc.b, level->type == 'a' ? ']' : '}');
+
+	if(w->depth == 0)
+		w->done = true;
+
+	return ipcl_json_encode_flush(&w->enc, false) ? 0 : TRC();
+}
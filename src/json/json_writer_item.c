@@ -0,0 +1,77 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_json.h"
+
+int
+ipcl_json_writer_item(pcl_json_writer_t *w, bool key)
+{
+	if(w->done)
+		return SETERRMSG(PCL_EINVAL, "json writer root value already written", 0);
+
+	if(w->depth == 0)
+	{
+		if(key)
+			return SETERRMSG(PCL_EINVAL, "object key written outside of an object", 0);
+
+		return 0;
+	}
+
+	ipcl_json_level_t *level = &w->levels[w->depth - 1];
+
+	if(level->type == 'o')
+	{
+		if(key == w->haskey)
+			return SETERRMSG(PCL_EINVAL, "expected an object %s", key ? "value" : "key");
+
+		/* pcl_json_writer_key already wrote the separator */
+		if(!key)
+		{
+			w->haskey = false;
+			return 0;
+		}
+	}
+	else if(key)
+	{
+		return SETERRMSG(PCL_EINVAL, "object key written within an array", 0);
+	}
+
+	if(level->count++ > 0)
+		pcl_buf_putchar(w->enc.b, ',');
+
+	if(w->enc.format)
+	{
+		pcl_buf_putchar(w->enc.b, '\n');
+		PRINT_TABS(&w->enc);
+	}
+
+	return 0;
+}
@@ -0,0 +1,119 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL__POOL_H
+#define LIBPCL__POOL_H
+
+#include <pcl/pool.h>
+#include <pcl/sync.h>
+#include <pcl/alloc.h>
+#include <pcl/error.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* objects per magazine, half of it moves to or from the depot at once */
+#define POOL_MAGSIZE 32
+#define POOL_SLABSIZE (64 * 1024)
+#define POOL_ALIGN 16
+
+/* A thread's cache for one pool, indexed by the pool's slot. The serial identifies the
+ * pool it belongs to, since a slot is reused once its pool is freed.
+ */
+typedef struct
+{
+	uint64_t serial;
+	int count;
+	void *objs[POOL_MAGSIZE];
+} ipcl_pool_mag_t;
+
+typedef struct
+{
+	int size;
+	ipcl_pool_mag_t **mags;
+} ipcl_pool_tls_t;
+
+/* depot objects are linked through their first word */
+typedef struct tag_ipcl_pool_obj
+{
+	struct tag_ipcl_pool_obj *next;
+} ipcl_pool_obj_t;
+
+/* With accounting enabled, each object is preceded by the tag it was charged to. Slabs
+ * are untagged, objects are charged when handed out and credited when put back.
+ */
+#define POOL_TAGSIZE POOL_ALIGN
+
+struct tag_pcl_pool
+{
+	size_t objsize;
+	size_t stride;     /* objsize plus POOL_TAGSIZE when tagged */
+	bool tagged;
+	int flags;
+	pcl_pool_ctor_t ctor;
+	void *udata;
+	int slot;
+	uint64_t serial;
+
+	/* guards the depot and slabs */
+	pcl_lock_t lock;
+	ipcl_pool_obj_t *depot;
+
+	/* slabs are linked through their first word, objects are carved from cursor to end */
+	void *slabs;
+	char *cursor;
+	char *end;
+	size_t slabsize;
+};
+
+/* calling thread's magazine for 'p', NULL when there is no TLS */
+PCL_PRIVATE ipcl_pool_mag_t *ipcl_pool_mag(pcl_pool_t *p);
+
+/* take up to 'count' objects from the depot, carving a new slab when it is empty */
+PCL_PRIVATE int ipcl_pool_take(pcl_pool_t *p, void **objs, int count);
+
+/* return objects to the depot */
+PCL_PRIVATE void ipcl_pool_give(pcl_pool_t *p, void **objs, int count);
+
+/* return a magazine's objects to the pool in 'slot' if it is still the magazine's owner */
+PCL_PRIVATE void ipcl_pool_reclaim(int slot, ipcl_pool_mag_t *m);
+
+/* release a pool's slot */
+PCL_PRIVATE void ipcl_pool_unregister(pcl_pool_t *p);
+
+PCL_PRIVATE void ipcl_pool_handler(uint32_t which, void *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPCL__POOL_H
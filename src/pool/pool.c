@@ -0,0 +1,101 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_pool.h"
+#include <pcl/memtag.h>
+#include <string.h>
+
+/* live pools by slot, so exiting threads can tell whether a magazine's pool still exists */
+static pcl_lock_t reglock = PCL_LOCK_INITIALIZER;
+static pcl_pool_t **registry;
+static int regsize;
+static uint64_t serials;
+
+pcl_pool_t *
+pcl_pool(size_t objsize, int flags, pcl_pool_ctor_t ctor, void *udata)
+{
+	if(objsize == 0 || objsize > POOL_SLABSIZE)
+		return R_SETERRMSG(NULL, PCL_EINVAL, "invalid pool object size: %zu", objsize);
+
+	pcl_pool_t *p = pcl_zalloc(sizeof(pcl_pool_t));
+
+	p->objsize = (objsize + POOL_ALIGN - 1) & ~((size_t) POOL_ALIGN - 1);
+	p->tagged = pcl_memtag_enabled();
+	p->stride = p->objsize + (p->tagged ? POOL_TAGSIZE : 0);
+	p->flags = flags;
+	p->ctor = ctor;
+	p->udata = udata;
+	p->slabsize = POOL_SLABSIZE + POOL_ALIGN + (p->tagged ? POOL_TAGSIZE : 0);
+	pcl_lock_init(&p->lock, NULL);
+
+	pcl_lock_acquire(&reglock);
+
+	for(p->slot = 0; p->slot < regsize && registry[p->slot]; p->slot++)
+		;
+
+	if(p->slot == regsize)
+	{
+		int size = regsize ? regsize * 2 : 16;
+
+		registry = pcl_realloc(registry, size * sizeof(pcl_pool_t *));
+		memset(registry + regsize, 0, (size - regsize) * sizeof(pcl_pool_t *));
+		regsize = size;
+	}
+
+	p->serial = ++serials;
+	registry[p->slot] = p;
+	pcl_lock_release(&reglock);
+
+	return p;
+}
+
+void
+ipcl_pool_unregister(pcl_pool_t *p)
+{
+	pcl_lock_acquire(&reglock);
+	registry[p->slot] = NULL;
+	pcl_lock_release(&reglock);
+}
+
+void
+ipcl_pool_reclaim(int slot, ipcl_pool_mag_t *m)
+{
+	/* held across the give so the pool can't be freed underneath it */
+	pcl_lock_acquire(&reglock);
+
+	pcl_pool_t *p = slot < regsize ? registry[slot] : NULL;
+
+	if(p && p->serial == m->serial)
+		ipcl_pool_give(p, m->objs, m->count);
+
+	pcl_lock_release(&reglock);
+	m->count = 0;
+}
@@ -0,0 +1,89 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_pool.h"
+#include "../alloc/_alloc.h" // ipcl_memtag_suspend
+
+int
+ipcl_pool_take(pcl_pool_t *p, void **objs, int count)
+{
+	int n = 0;
+
+	pcl_lock_acquire(&p->lock);
+
+	for(; n < count && p->depot; n++)
+	{
+		objs[n] = p->depot;
+		p->depot = p->depot->next;
+	}
+
+	if(n == 0 && p->cursor == p->end)
+	{
+		/* outlives every tag, objects are charged one at a time */
+		int tag = ipcl_memtag_suspend();
+		char *slab = pcl_malloc(p->slabsize);
+
+		ipcl_memtag_leave(tag);
+
+		if(slab)
+		{
+			*(void **) slab = p->slabs;
+			p->slabs = slab;
+			p->cursor = slab + POOL_ALIGN;
+			p->end = p->cursor + ((p->slabsize - POOL_ALIGN) / p->stride) * p->stride;
+		}
+	}
+
+	for(; n < count && p->cursor < p->end; n++)
+	{
+		objs[n] = p->cursor;
+		p->cursor += p->stride;
+	}
+
+	pcl_lock_release(&p->lock);
+	return n;
+}
+
+void
+ipcl_pool_give(pcl_pool_t *p, void **objs, int count)
+{
+	pcl_lock_acquire(&p->lock);
+
+	for(int i = 0; i < count; i++)
+	{
+		ipcl_pool_obj_t *o = objs[i];
+
+		o->next = p->depot;
+		p->depot = o;
+	}
+
+	pcl_lock_release(&p->lock);
+}
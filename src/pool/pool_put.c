@@ -0,0 +1,65 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_pool.h"
+#include "../alloc/_alloc.h" // ipcl_memtag_credit
+#include <string.h>
+
+void
+pcl_pool_put(pcl_pool_t *p, void *obj)
+{
+	if(!p || !obj)
+		return;
+
+	if(p->tagged)
+	{
+		obj = (char *) obj - POOL_TAGSIZE;
+		ipcl_memtag_credit((int) *(int64_t *) obj, (int64_t) p->objsize);
+	}
+
+	ipcl_pool_mag_t *m = ipcl_pool_mag(p);
+
+	if(!m)
+	{
+		ipcl_pool_give(p, &obj, 1);
+		return;
+	}
+
+	/* keep the most recently used half, it is the warmest */
+	if(m->count == POOL_MAGSIZE)
+	{
+		ipcl_pool_give(p, m->objs, POOL_MAGSIZE / 2);
+		memmove(m->objs, m->objs + POOL_MAGSIZE / 2, (POOL_MAGSIZE / 2) * sizeof(void *));
+		m->count = POOL_MAGSIZE / 2;
+	}
+
+	m->objs[m->count++] = obj;
+}
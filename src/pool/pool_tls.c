@@ -0,0 +1,113 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_pool.h"
+#include <pcl/thread.h>
+#include <pcl/event.h>
+#include <string.h>
+
+static pthread_key_t tlskey;
+static bool have_tlskey;
+
+/* TLS callback: hands cached objects back to pools that still exist */
+static void
+tls_destroy(void *obj)
+{
+	ipcl_pool_tls_t *tls = obj;
+
+	for(int slot = 0; slot < tls->size; slot++)
+	{
+		ipcl_pool_mag_t *m = tls->mags[slot];
+
+		if(!m)
+			continue;
+
+		if(m->count > 0)
+			ipcl_pool_reclaim(slot, m);
+
+		pcl_free(m);
+	}
+
+	pcl_free_safe(tls->mags);
+	pcl_free(tls);
+}
+
+ipcl_pool_mag_t *
+ipcl_pool_mag(pcl_pool_t *p)
+{
+	if(!have_tlskey)
+		return NULL;
+
+	ipcl_pool_tls_t *tls = pcl_tls_get(tlskey);
+
+	if(!tls)
+	{
+		tls = pcl_zalloc(sizeof(ipcl_pool_tls_t));
+
+		if(pcl_tls_set(tlskey, tls))
+			return pcl_free(tls);
+	}
+
+	if(p->slot >= tls->size)
+	{
+		int size = max(p->slot + 1, tls->size * 2);
+
+		tls->mags = pcl_realloc(tls->mags, size * sizeof(ipcl_pool_mag_t *));
+		memset(tls->mags + tls->size, 0, (size - tls->size) * sizeof(ipcl_pool_mag_t *));
+		tls->size = size;
+	}
+
+	ipcl_pool_mag_t *m = tls->mags[p->slot];
+
+	if(!m)
+	{
+		m = tls->mags[p->slot] = pcl_malloc(sizeof(ipcl_pool_mag_t));
+		m->count = 0;
+		m->serial = p->serial;
+	}
+	else if(m->serial != p->serial)
+	{
+		/* left behind by a freed pool, whose slabs took the objects with them */
+		m->count = 0;
+		m->serial = p->serial;
+	}
+
+	return m;
+}
+
+void
+ipcl_pool_handler(uint32_t which, void *data)
+{
+	UNUSED(data);
+
+	if(which == PCL_EVENT_INIT)
+		have_tlskey = pcl_tls_alloc(&tlskey, tls_destroy) == 0;
+}
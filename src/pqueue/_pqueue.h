@@ -0,0 +1,84 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL__PQUEUE_H
+#define LIBPCL__PQUEUE_H
+
+#include <pcl/pqueue.h>
+#include <pcl/error.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PQUEUE_MAXARITY 16
+
+typedef struct
+{
+	int64_t key;
+	void *item;
+	int handle;
+} ipcl_pqueue_entry_t;
+
+/* Children of heap[i] are heap[i * arity + 1] through heap[i * arity + arity]. Handles index
+ * the pos array, which holds the heap index of each queued item. Released handles form a
+ * free list through pos, encoded as -(next + 2) so that -1 terminates the list.
+ */
+struct tag_pcl_pqueue
+{
+	ipcl_pqueue_entry_t *heap;
+	int count;
+	int capacity;
+	int arity;
+
+	int *pos;
+	int npos;
+	int freehandle;
+
+	pcl_cleanup_t cleanup;
+};
+
+#define PQUEUE_VALID(pq, h) ((pq) && (h) >= 0 && (h) < (pq)->npos && (pq)->pos[h] >= 0)
+
+/* restore heap order by moving heap[i] towards the root */
+PCL_PRIVATE void ipcl_pqueue_siftup(pcl_pqueue_t *pq, int i);
+
+/* restore heap order by moving heap[i] towards the leaves */
+PCL_PRIVATE void ipcl_pqueue_siftdown(pcl_pqueue_t *pq, int i);
+
+/* remove heap[i], releasing its handle, and return its item */
+PCL_PRIVATE void *ipcl_pqueue_detach(pcl_pqueue_t *pq, int i, int64_t *key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPCL__PQUEUE_H
@@ -0,0 +1,69 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_pqueue.h"
+#include <pcl/alloc.h>
+
+int
+pcl_pqueue_push(pcl_pqueue_t *pq, int64_t key, void *item)
+{
+	if(!pq)
+		return BADARG();
+
+	if(pq->count == pq->capacity)
+	{
+		pq->capacity = pq->capacity ? pq->capacity * 2 : 16;
+		pq->heap = pcl_realloc(pq->heap, pq->capacity * sizeof(ipcl_pqueue_entry_t));
+
+		/* never more handles than items, so pos grows with the heap */
+		pq->pos = pcl_realloc(pq->pos, pq->capacity * sizeof(int));
+	}
+
+	int handle = pq->freehandle;
+
+	if(handle >= 0)
+	{
+		pq->freehandle = -pq->pos[handle] - 2;
+	}
+	else
+	{
+		handle = pq->npos++;
+	}
+
+	int i = pq->count++;
+
+	pq->heap[i].key = key;
+	pq->heap[i].item = item;
+	pq->heap[i].handle = handle;
+	ipcl_pqueue_siftup(pq, i);
+
+	return handle;
+}
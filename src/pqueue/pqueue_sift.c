@@ -0,0 +1,116 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_pqueue.h"
+
+void
+ipcl_pqueue_siftup(pcl_pqueue_t *pq, int i)
+{
+	ipcl_pqueue_entry_t *heap = pq->heap;
+	ipcl_pqueue_entry_t e = heap[i];
+
+	while(i > 0)
+	{
+		int parent = (i - 1) / pq->arity;
+
+		if(heap[parent].key <= e.key)
+			break;
+
+		heap[i] = heap[parent];
+		pq->pos[heap[i].handle] = i;
+		i = parent;
+	}
+
+	heap[i] = e;
+	pq->pos[e.handle] = i;
+}
+
+void
+ipcl_pqueue_siftdown(pcl_pqueue_t *pq, int i)
+{
+	ipcl_pqueue_entry_t *heap = pq->heap;
+	ipcl_pqueue_entry_t e = heap[i];
+
+	while(true)
+	{
+		int first = i * pq->arity + 1;
+
+		if(first >= pq->count)
+			break;
+
+		int last = first + pq->arity;
+		int min = first;
+
+		if(last > pq->count)
+			last = pq->count;
+
+		/* siblings are contiguous, usually within one or two cache lines */
+		for(int c = first + 1; c < last; c++)
+			if(heap[c].key < heap[min].key)
+				min = c;
+
+		if(heap[min].key >= e.key)
+			break;
+
+		heap[i] = heap[min];
+		pq->pos[heap[i].handle] = i;
+		i = min;
+	}
+
+	heap[i] = e;
+	pq->pos[e.handle] = i;
+}
+
+void *
+ipcl_pqueue_detach(pcl_pqueue_t *pq, int i, int64_t *key)
+{
+	ipcl_pqueue_entry_t *e = &pq->heap[i];
+	void *item = e->item;
+	int handle = e->handle;
+
+	if(key)
+		*key = e->key;
+
+	pq->pos[handle] = -(pq->freehandle + 2);
+	pq->freehandle = handle;
+
+	if(i < --pq->count)
+	{
+		*e = pq->heap[pq->count];
+
+		if(i > 0 && e->key < pq->heap[(i - 1) / pq->arity].key)
+			ipcl_pqueue_siftup(pq, i);
+		else
+			ipcl_pqueue_siftdown(pq, i);
+	}
+
+	return item;
+}
@@ -131,7 +131,7 @@ pcl_proc_pipe(pcl_file_t *pipes[2], int rd_oflags, int wr_oflags)
 
 	wr_oflags &= ~(PCL_O_RDONLY | PCL_O_RDWR);
 	pipes[1] = ipcl_file_alloc(fds[1], 0);
-	ipcl_file_init(pipes[0], wr_oflags | PCL_O_WRONLY);
+	ipcl_file_init(pipes[1], wr_oflags | PCL_O_WRONLY);
 
 	return 0;
 }
@@ -38,20 +38,43 @@
 extern "C" {
 #endif
 
-struct queue_item
+/* items per chunk */
+#define QUEUE_CHUNKSIZE 64
+
+/* empty chunks kept for reuse, unless a larger capacity was requested */
+#define QUEUE_FREECHUNKS 2
+
+/* Items are stored in an unrolled list of fixed-size chunks: added at tail->items[tailpos]
+ * and removed from head->items[headpos].
+ */
+struct queue_chunk
 {
-	struct queue_item *next;
-	void *value;
+	struct queue_chunk *next;
+	void *items[QUEUE_CHUNKSIZE];
 };
 
 struct tag_pcl_queue
 {
 	int size;
-	struct queue_item *head;
-	struct queue_item *tail;
+	struct queue_chunk *head;
+	struct queue_chunk *tail;
+	int headpos;
+	int tailpos;
+
+	/* cache of empty chunks */
+	struct queue_chunk *free;
+	int nfree;
+	int maxfree;
+
 	pcl_cleanup_t cleanup;
 };
 
+/* get a chunk from the free cache or allocate one */
+PCL_PRIVATE struct queue_chunk *ipcl_queue_chunk(pcl_queue_t *q);
+
+/* return a chunk to the free cache or free it when the cache is full */
+PCL_PRIVATE void ipcl_queue_release(pcl_queue_t *q, struct queue_chunk *chunk);
+
 #ifdef __cplusplus
 }
 #endif
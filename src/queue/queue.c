@@ -30,14 +30,9 @@
 */
 
 #include "_queue.h"
-#include <pcl/alloc.h>
 
 pcl_queue_t *
 pcl_queue(pcl_cleanup_t cleanup)
 {
-	pcl_queue_t *q = pcl_malloc(sizeof(pcl_queue_t));
-	q->size = 0;
-	q->head = q->tail = NULL;
-	q->cleanup = cleanup;
-	return q;
+	return pcl_queue_sized(0, cleanup);
 }
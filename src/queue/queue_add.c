@@ -30,7 +30,6 @@
 */
 
 #include "_queue.h"
-#include <pcl/alloc.h>
 
 void
 pcl_queue_add(pcl_queue_t *q, void *item)
@@ -38,14 +37,17 @@ pcl_queue_add(pcl_queue_t *q, void *item)
 	if(!q)
 		return;
 
-	struct queue_item *qitem = pcl_malloc(sizeof(struct queue_item));
-
-	qitem->next = NULL;
-	qitem->value = item;
-	q->size++;
-
 	if(!q->tail)
-		q->head = q->tail = qitem;
-	else
-		q->tail = q->tail->next = qitem;
+	{
+		q->head = q->tail = ipcl_queue_chunk(q);
+		q->headpos = q->tailpos = 0;
+	}
+	else if(q->tailpos == QUEUE_CHUNKSIZE)
+	{
+		q->tail = q->tail->next = ipcl_queue_chunk(q);
+		q->tailpos = 0;
+	}
+
+	q->tail->items[q->tailpos++] = item;
+	q->size++;
 }
@@ -38,19 +38,26 @@ pcl_queue_clear(pcl_queue_t *q)
 	if(!q)
 		return;
 
-	struct queue_item *node = q->head;
+	struct queue_chunk *chunk = q->head;
+	int pos = q->headpos;
 
-	while(node)
+	while(chunk)
 	{
-		struct queue_item *next = node->next;
+		struct queue_chunk *next = chunk->next;
+		int end = next ? QUEUE_CHUNKSIZE : q->tailpos;
 
 		if(q->cleanup)
-			q->cleanup(node->value);
-
-		pcl_free(node);
-		node = next;
+		{
+			for(; pos < end; pos++)
+				q->cleanup(chunk->items[pos]);
+		}
+
+		ipcl_queue_release(q, chunk);
+		chunk = next;
+		pos = 0;
 	}
 
 	q->size = 0;
 	q->head = q->tail = NULL;
+	q->headpos = q->tailpos = 0;
 }
@@ -38,6 +38,14 @@ pcl_queue_free(pcl_queue_t *q)
 	if(q)
 	{
 		pcl_queue_clear(q);
+
+		while(q->free)
+		{
+			struct queue_chunk *next = q->free->next;
+			pcl_free(q->free);
+			q->free = next;
+		}
+
 		pcl_free(q);
 	}
 }
@@ -34,5 +34,5 @@
 void *
 pcl_queue_peek(pcl_queue_t *q)
 {
-	return pcl_queue_empty(q) ? NULL : q->head->value;
+	return pcl_queue_empty(q) ? NULL : q->head->items[q->headpos];
 }
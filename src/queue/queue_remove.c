@@ -30,7 +30,6 @@
 */
 
 #include "_queue.h"
-#include <pcl/alloc.h>
 
 void *
 pcl_queue_remove(pcl_queue_t *q)
@@ -38,17 +37,21 @@ pcl_queue_remove(pcl_queue_t *q)
 	if(pcl_queue_empty(q))
 		return NULL;
 
-	struct queue_item *qitem = q->head;
-
-	q->head = qitem->next;
-
-	if(!q->head)
-		q->tail = NULL;
-
-	q->size--;
-
-	void *item = qitem->value;
-	pcl_free(qitem);
+	void *item = q->head->items[q->headpos++];
+
+	if(--q->size == 0)
+	{
+		/* keep the last chunk, rewound */
+		q->headpos = q->tailpos = 0;
+	}
+	else if(q->headpos == QUEUE_CHUNKSIZE)
+	{
+		struct queue_chunk *chunk = q->head;
+
+		q->head = chunk->next;
+		q->headpos = 0;
+		ipcl_queue_release(q, chunk);
+	}
 
 	return item;
 }
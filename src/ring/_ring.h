@@ -0,0 +1,109 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL__RING_H
+#define LIBPCL__RING_H
+
+#include <pcl/ring.h>
+#include <pcl/thread.h>
+#include <pcl/error.h>
+#include <pcl/atomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RING_CACHELINE 64
+
+/* memory-ordered operations on ring indices */
+#define RING_LOAD(p) ((uint64_t) pcl_atomic_load64((int64_t *) (p), PCL_ATOMIC_RELAXED))
+#define RING_LOAD_ACQ(p) ((uint64_t) pcl_atomic_load64((int64_t *) (p), PCL_ATOMIC_ACQUIRE))
+#define RING_STORE_REL(p, v) pcl_atomic_store64((int64_t *) (p), (int64_t) (v), PCL_ATOMIC_RELEASE)
+#define RING_CAS(p, expected, desired) pcl_atomic_cas64_weak((int64_t *) (p), \
+	&(int64_t){(int64_t) (expected)}, (int64_t) (desired), PCL_ATOMIC_RELAXED)
+#define RING_FENCE() pcl_atomic_fence(PCL_ATOMIC_SEQ_CST)
+
+/* An index owned by one side of the ring, alone on its cache line. For SPSC rings, cache is
+ * the owner's last seen value of the other side's index, which avoids touching the other
+ * side's cache line until the ring looks full or empty.
+ */
+typedef struct
+{
+	uint64_t pos;
+	uint64_t cache;
+	char pad[RING_CACHELINE - 2 * sizeof(uint64_t)];
+} ipcl_ring_index_t;
+
+/* MPMC cell: seq == pos when free for the producer of pos, pos + 1 when full */
+typedef struct
+{
+	uint64_t seq;
+	void *item;
+} ipcl_ring_cell_t;
+
+struct tag_pcl_ring
+{
+	/* read-only after creation */
+	uint64_t mask;
+	int flags;
+	void **slots;             /* SPSC */
+	ipcl_ring_cell_t *cells;  /* MPMC */
+
+	/* blocking support, only used with PCL_RING_BLOCKING */
+	pthread_mutex_t lock;
+	pthread_cond_t notempty;
+	pthread_cond_t notfull;
+	uint64_t putwaiters;
+	uint64_t takewaiters;
+	uint64_t closed;
+
+	char pad[RING_CACHELINE];
+	ipcl_ring_index_t head;   /* consumer */
+	ipcl_ring_index_t tail;   /* producer */
+};
+
+/* push or pop without waking blocked threads */
+PCL_PRIVATE int ipcl_ring_pushv(pcl_ring_t *r, void *const *items, int count);
+PCL_PRIVATE int ipcl_ring_popv(pcl_ring_t *r, void **items, int max);
+
+PCL_PRIVATE int ipcl_ring_spsc_push(pcl_ring_t *r, void *const *items, int count);
+PCL_PRIVATE int ipcl_ring_spsc_pop(pcl_ring_t *r, void **items, int max);
+PCL_PRIVATE int ipcl_ring_mpmc_push(pcl_ring_t *r, void *const *items, int count);
+PCL_PRIVATE int ipcl_ring_mpmc_pop(pcl_ring_t *r, void **items, int max);
+
+/* wake threads blocked in pcl_ring_put or pcl_ring_take, if there are any */
+PCL_PRIVATE void ipcl_ring_wake(pcl_ring_t *r, pthread_cond_t *cond, uint64_t *waiters);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPCL__RING_H
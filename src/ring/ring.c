@@ -0,0 +1,72 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_ring.h"
+#include <pcl/alloc.h>
+
+pcl_ring_t *
+pcl_ring(size_t capacity, int flags)
+{
+	if(capacity == 0 || capacity > ((size_t) 1 << 40))
+		return R_SETERRMSG(NULL, PCL_EINVAL, "invalid ring capacity: %llu",
+			(unsigned long long) capacity);
+
+	size_t size = 1;
+
+	while(size < capacity)
+		size <<= 1;
+
+	pcl_ring_t *r = pcl_zalloc(sizeof(pcl_ring_t));
+
+	r->mask = size - 1;
+	r->flags = flags;
+
+	if(flags & PCL_RING_MPMC)
+	{
+		r->cells = pcl_malloc(size * sizeof(ipcl_ring_cell_t));
+
+		for(size_t i = 0; i < size; i++)
+			r->cells[i].seq = i;
+	}
+	else
+	{
+		r->slots = pcl_malloc(size * sizeof(void *));
+	}
+
+	if(flags & PCL_RING_BLOCKING)
+	{
+		pthread_mutex_init(&r->lock, NULL);
+		pthread_cond_init(&r->notempty, NULL);
+		pthread_cond_init(&r->notfull, NULL);
+	}
+
+	return r;
+}
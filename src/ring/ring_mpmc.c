@@ -0,0 +1,129 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_ring.h"
+
+/* Dmitry Vyukov's bounded MPMC queue. Each cell's sequence tells which lap of the ring it is
+ * ready for: a producer at pos waits for seq == pos and a consumer for seq == pos + 1. Batches
+ * claim the longest run of ready cells with one CAS on the index.
+ */
+
+int
+ipcl_ring_mpmc_push(pcl_ring_t *r, void *const *items, int count)
+{
+	uint64_t pos = RING_LOAD(&r->tail.pos);
+	int n;
+
+	for(;;)
+	{
+		int64_t dif = 0;
+
+		for(n = 0; n < count; n++)
+		{
+			ipcl_ring_cell_t *cell = &r->cells[(pos + n) & r->mask];
+
+			if((dif = (int64_t) (RING_LOAD_ACQ(&cell->seq) - (pos + n))) != 0)
+				break;
+		}
+
+		if(n == 0)
+		{
+			/* full: the consumer of the previous lap hasn't released the cell */
+			if(dif < 0)
+				return 0;
+
+			/* another producer claimed pos */
+			pos = RING_LOAD(&r->tail.pos);
+			continue;
+		}
+
+		if(RING_CAS(&r->tail.pos, pos, pos + n))
+			break;
+
+		pos = RING_LOAD(&r->tail.pos);
+	}
+
+	for(int i = 0; i < n; i++)
+	{
+		ipcl_ring_cell_t *cell = &r->cells[(pos + i) & r->mask];
+
+		cell->item = items[i];
+		RING_STORE_REL(&cell->seq, pos + i + 1);
+	}
+
+	return n;
+}
+
+int
+ipcl_ring_mpmc_pop(pcl_ring_t *r, void **items, int max)
+{
+	uint64_t pos = RING_LOAD(&r->head.pos);
+	int n;
+
+	for(;;)
+	{
+		int64_t dif = 0;
+
+		for(n = 0; n < max; n++)
+		{
+			ipcl_ring_cell_t *cell = &r->cells[(pos + n) & r->mask];
+
+			if((dif = (int64_t) (RING_LOAD_ACQ(&cell->seq) - (pos + n + 1))) != 0)
+				break;
+		}
+
+		if(n == 0)
+		{
+			/* empty: the producer of pos hasn't published */
+			if(dif < 0)
+				return 0;
+
+			/* another consumer claimed pos */
+			pos = RING_LOAD(&r->head.pos);
+			continue;
+		}
+
+		if(RING_CAS(&r->head.pos, pos, pos + n))
+			break;
+
+		pos = RING_LOAD(&r->head.pos);
+	}
+
+	for(int i = 0; i < n; i++)
+	{
+		ipcl_ring_cell_t *cell = &r->cells[(pos + i) & r->mask];
+
+		items[i] = cell->item;
+		RING_STORE_REL(&cell->seq, pos + i + r->mask + 1);
+	}
+
+	return n;
+}
@@ -0,0 +1,85 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_ring.h"
+
+/* Only the producer writes tail and only the consumer writes head, so each side reads its
+ * own index without synchronization and publishes it with a release store.
+ */
+
+int
+ipcl_ring_spsc_push(pcl_ring_t *r, void *const *items, int count)
+{
+	uint64_t tail = r->tail.pos;
+	uint64_t size = r->mask + 1;
+	uint64_t avail = size - (tail - r->tail.cache);
+
+	if(avail < (uint64_t) count)
+	{
+		r->tail.cache = RING_LOAD_ACQ(&r->head.pos);
+		avail = size - (tail - r->tail.cache);
+	}
+
+	if((uint64_t) count > avail)
+		count = (int) avail;
+
+	for(int i = 0; i < count; i++)
+		r->slots[(tail + i) & r->mask] = items[i];
+
+	if(count > 0)
+		RING_STORE_REL(&r->tail.pos, tail + count);
+
+	return count;
+}
+
+int
+ipcl_ring_spsc_pop(pcl_ring_t *r, void **items, int max)
+{
+	uint64_t head = r->head.pos;
+	uint64_t avail = r->head.cache - head;
+
+	if(avail < (uint64_t) max)
+	{
+		r->head.cache = RING_LOAD_ACQ(&r->tail.pos);
+		avail = r->head.cache - head;
+	}
+
+	if((uint64_t) max > avail)
+		max = (int) avail;
+
+	for(int i = 0; i < max; i++)
+		items[i] = r->slots[(head + i) & r->mask];
+
+	if(max > 0)
+		RING_STORE_REL(&r->head.pos, head + max);
+
+	return max;
+}
@@ -0,0 +1,67 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_ring.h"
+
+void *
+pcl_ring_take(pcl_ring_t *r)
+{
+	void *item = NULL;
+
+	if(!r || !(r->flags & PCL_RING_BLOCKING))
+		return R_SETERR(NULL, PCL_EINVAL);
+
+	if(ipcl_ring_popv(r, &item, 1) == 0)
+	{
+		pthread_mutex_lock(&r->lock);
+		RING_STORE_REL(&r->takewaiters, RING_LOAD(&r->takewaiters) + 1);
+		RING_FENCE();
+
+		while(ipcl_ring_popv(r, &item, 1) == 0)
+		{
+			if(r->closed)
+			{
+				item = NULL;
+				break;
+			}
+
+			pthread_cond_wait(&r->notempty, &r->lock);
+		}
+
+		RING_STORE_REL(&r->takewaiters, RING_LOAD(&r->takewaiters) - 1);
+		pthread_mutex_unlock(&r->lock);
+	}
+
+	if(item)
+		ipcl_ring_wake(r, &r->notfull, &r->putwaiters);
+
+	return item;
+}
@@ -0,0 +1,86 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL__ROPE_H
+#define LIBPCL__ROPE_H
+
+#include <pcl/rope.h>
+#include <pcl/error.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* batch of segments handed to each gather call */
+#define ROPE_IOVBATCH 64
+
+typedef struct tag_ipcl_rope_seg ipcl_rope_seg_t;
+
+struct tag_ipcl_rope_seg
+{
+	ipcl_rope_seg_t *next;
+
+	/* unconsumed bytes */
+	char *data;
+	size_t len;
+
+	/* capacity of an owned segment's buf, 0 for borrowed segments */
+	size_t size;
+
+	/* borrowed segments: called with base once unreferenced */
+	pcl_cleanup_t release;
+	void *base;
+
+	char buf[];
+};
+
+struct tag_pcl_rope
+{
+	ipcl_rope_seg_t *head;
+	ipcl_rope_seg_t *tail;
+	size_t len;
+	size_t segsize;
+};
+
+/* link a segment at the head or tail of a rope */
+PCL_PRIVATE void ipcl_rope_link(pcl_rope_t *r, ipcl_rope_seg_t *seg, bool head);
+
+/* unlink and free the head segment */
+PCL_PRIVATE void ipcl_rope_unlink(pcl_rope_t *r);
+
+/* create a borrowed segment */
+PCL_PRIVATE ipcl_rope_seg_t *ipcl_rope_ref(const void *data, size_t len, pcl_cleanup_t release);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPCL__ROPE_H
@@ -0,0 +1,80 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_rope.h"
+#include <pcl/alloc.h>
+#include <string.h>
+
+int
+pcl_rope_append(pcl_rope_t *r, const void *data, size_t len)
+{
+	if(!r || (!data && len))
+		return BADARG();
+
+	const char *src = data;
+	ipcl_rope_seg_t *tail = r->tail;
+
+	/* fill what is left of an owned tail segment */
+	if(tail && tail->size)
+	{
+		char *end = tail->data + tail->len;
+		size_t n = (size_t) (tail->buf + tail->size - end);
+
+		if(n > len)
+			n = len;
+
+		memcpy(end, src, n);
+		tail->len += n;
+		r->len += n;
+		src += n;
+		len -= n;
+	}
+
+	while(len > 0)
+	{
+		size_t size = r->segsize;
+		ipcl_rope_seg_t *seg = pcl_malloc(sizeof(ipcl_rope_seg_t) + size);
+		size_t n = len < size ? len : size;
+
+		seg->data = seg->buf;
+		seg->len = n;
+		seg->size = size;
+		seg->release = NULL;
+		seg->base = NULL;
+		memcpy(seg->data, src, n);
+
+		ipcl_rope_link(r, seg, false);
+		src += n;
+		len -= n;
+	}
+
+	return 0;
+}
@@ -0,0 +1,86 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_rope.h"
+#include <pcl/alloc.h>
+
+void
+ipcl_rope_link(pcl_rope_t *r, ipcl_rope_seg_t *seg, bool head)
+{
+	if(!r->head)
+	{
+		seg->next = NULL;
+		r->head = r->tail = seg;
+	}
+	else if(head)
+	{
+		seg->next = r->head;
+		r->head = seg;
+	}
+	else
+	{
+		seg->next = NULL;
+		r->tail->next = seg;
+		r->tail = seg;
+	}
+
+	r->len += seg->len;
+}
+
+void
+ipcl_rope_unlink(pcl_rope_t *r)
+{
+	ipcl_rope_seg_t *seg = r->head;
+
+	if(!(r->head = seg->next))
+		r->tail = NULL;
+
+	r->len -= seg->len;
+
+	if(seg->release)
+		seg->release(seg->base);
+
+	pcl_free(seg);
+}
+
+ipcl_rope_seg_t *
+ipcl_rope_ref(const void *data, size_t len, pcl_cleanup_t release)
+{
+	ipcl_rope_seg_t *seg = pcl_malloc(sizeof(ipcl_rope_seg_t));
+
+	seg->data = (char *) data;
+	seg->len = len;
+	seg->size = 0;
+	seg->release = release;
+	seg->base = (void *) data;
+
+	return seg;
+}
@@ -73,6 +73,9 @@ struct tag_pcl_socket
 
 PCL_PRIVATE pcl_socket_t *ipcl_socket_alloc(void);
 
+/* pool of every pcl_socket_t and its address buffer */
+PCL_PRIVATE pcl_pool_t *ipcl_socket_pool(void);
+
 #ifdef PCL_WINDOWS
 PCL_PRIVATE void ipcl_win32_socket_handler(uint32_t which, void *data);
 #endif
@@ -30,14 +30,47 @@
 */
 
 #include "_socket.h"
-#include <pcl/alloc.h>
+#include <pcl/pool.h>
+#include <pcl/sync.h>
+#include <pcl/atomic.h>
 
-pcl_socket_t *
-ipcl_socket_alloc(void)
+static pcl_pool_t *sockets;
+static pcl_lock_t lock = PCL_LOCK_INITIALIZER;
+
+static void
+socket_init(void *obj, void *udata)
 {
-	pcl_socket_t *s = pcl_zalloc(sizeof(pcl_socket_t) + SOCK_ADDRBUFSIZE);
+	pcl_socket_t *s = obj;
+
+	UNUSED(udata);
 	s->fd = INVALID_SOCKET;
 	s->sa_len = SOCK_ADDRBUFSIZE;
 	s->addr = (struct sockaddr *) (s + 1);
-	return s;
+}
+
+pcl_pool_t *
+ipcl_socket_pool(void)
+{
+	pcl_pool_t *p = pcl_atomic_loadptr((void **) &sockets, PCL_ATOMIC_ACQUIRE);
+
+	if(!p)
+	{
+		pcl_lock_acquire(&lock);
+
+		if(!(p = sockets))
+		{
+			p = pcl_pool(sizeof(pcl_socket_t) + SOCK_ADDRBUFSIZE, PCL_POOL_ZERO, socket_init, NULL);
+			pcl_atomic_storeptr((void **) &sockets, p, PCL_ATOMIC_RELEASE);
+		}
+
+		pcl_lock_release(&lock);
+	}
+
+	return p;
+}
+
+pcl_socket_t *
+ipcl_socket_alloc(void)
+{
+	return pcl_pool_get(ipcl_socket_pool());
 }
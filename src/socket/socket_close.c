@@ -31,6 +31,7 @@
 
 #include "_socket.h"
 #include <pcl/alloc.h>
+#include <pcl/pool.h>
 
 #ifdef PCL_UNIX
 #	include <unistd.h>
@@ -52,5 +53,5 @@ pcl_socket_close(pcl_socket_t *sock)
 	}
 
 	pcl_free_safe(sock->ipaddr);
-	pcl_free(sock);
+	pcl_pool_put(ipcl_socket_pool(), sock);
 }
@@ -58,6 +58,11 @@ struct tag_pcl_ssl
 
 PCL_PRIVATE int ipcl_ssl_configure_socket(pcl_ssl_t *ssl, const char *host, int port);
 
+PCL_PRIVATE pcl_ssl_t *ipcl_ssl_alloc(void);
+
+/* pool of every pcl_ssl_t, zeroed on get */
+PCL_PRIVATE pcl_pool_t *ipcl_ssl_pool(void);
+
 #ifdef __cplusplus
 }
 #endif
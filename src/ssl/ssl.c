@@ -72,7 +72,7 @@ create_sslctx(pcl_ssl_t *ssl)
 pcl_ssl_t *
 pcl_ssl(int flags, ...)
 {
-	pcl_ssl_t *ssl = pcl_zalloc(sizeof(pcl_ssl_t));
+	pcl_ssl_t *ssl = ipcl_ssl_alloc();
 
 	ssl->flags = flags & (PCL_SSL_PASSIVE | PCL_SOCK_NONBLOCK);
 
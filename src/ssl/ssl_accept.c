@@ -45,7 +45,7 @@ pcl_ssl_accept(pcl_ssl_t *server)
 	if(!(sock = pcl_accept(server->sock)))
 		return R_TRC(NULL);
 
-	client = pcl_zalloc(sizeof(pcl_ssl_t));
+	client = ipcl_ssl_alloc();
 	client->flags = PCL_SSL_SERVER | (server->flags & PCL_SOCK_NONBLOCK);
 	client->sock = sock;
 	ipcl_ssl_configure_socket(client, NULL, 0);
@@ -0,0 +1,71 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_ssl.h"
+#include "../alloc/_alloc.h" // ipcl_memtag_enter
+#include <pcl/pool.h>
+#include <pcl/sync.h>
+#include <pcl/atomic.h>
+
+static pcl_pool_t *ssls;
+static pcl_lock_t lock = PCL_LOCK_INITIALIZER;
+
+pcl_pool_t *
+ipcl_ssl_pool(void)
+{
+	pcl_pool_t *p = pcl_atomic_loadptr((void **) &ssls, PCL_ATOMIC_ACQUIRE);
+
+	if(!p)
+	{
+		pcl_lock_acquire(&lock);
+
+		if(!(p = ssls))
+		{
+			p = pcl_pool_typed(pcl_ssl_t, PCL_POOL_ZERO, NULL, NULL);
+			pcl_atomic_storeptr((void **) &ssls, p, PCL_ATOMIC_RELEASE);
+		}
+
+		pcl_lock_release(&lock);
+	}
+
+	return p;
+}
+
+pcl_ssl_t *
+ipcl_ssl_alloc(void)
+{
+	/* slabs grown here are charged to ssl, like the objects carved from them */
+	int tag = ipcl_memtag_enter(PCL_MEMTAG_SSL);
+	pcl_ssl_t *ssl = pcl_pool_get(ipcl_ssl_pool());
+
+	ipcl_memtag_leave(tag);
+	return ssl;
+}
@@ -31,6 +31,7 @@
 
 #include "_ssl.h"
 #include <pcl/alloc.h>
+#include <pcl/pool.h>
 
 void
 pcl_ssl_free(pcl_ssl_t *ssl)
@@ -41,5 +42,5 @@ pcl_ssl_free(pcl_ssl_t *ssl)
 	pcl_ssl_close(ssl);
 	SSL_CTX_free(ssl->ctx);
 	pcl_free_safe(ssl->err.msg);
-	pcl_free(ssl);
+	pcl_pool_put(ipcl_ssl_pool(), ssl);
 }
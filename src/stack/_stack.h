@@ -38,19 +38,41 @@
 extern "C" {
 #endif
 
-struct stack_item
+/* items per chunk */
+#define STACK_CHUNKSIZE 64
+
+/* empty chunks kept for reuse, unless a larger capacity was requested */
+#define STACK_FREECHUNKS 2
+
+/* Items are stored in an unrolled list of fixed-size chunks. The top of the stack is
+ * head->items[pos - 1], chunks below the head are always full.
+ */
+struct stack_chunk
 {
-	struct stack_item *next;
-	void *value;
+	struct stack_chunk *next;
+	void *items[STACK_CHUNKSIZE];
 };
 
 struct tag_pcl_stack
 {
-	struct stack_item *head;
+	struct stack_chunk *head;
+	int pos;
 	int size;
+
+	/* cache of empty chunks */
+	struct stack_chunk *free;
+	int nfree;
+	int maxfree;
+
 	pcl_cleanup_t cleanup;
 };
 
+/* get a chunk from the free cache or allocate one */
+PCL_PRIVATE struct stack_chunk *ipcl_stack_chunk(pcl_stack_t *s);
+
+/* return a chunk to the free cache or free it when the cache is full */
+PCL_PRIVATE void ipcl_stack_release(pcl_stack_t *s, struct stack_chunk *chunk);
+
 #ifdef __cplusplus
 }
 #endif
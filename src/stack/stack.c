@@ -30,14 +30,9 @@
 */
 
 #include "_stack.h"
-#include <pcl/alloc.h>
 
 pcl_stack_t *
 pcl_stack(pcl_cleanup_t cleanup)
 {
-	pcl_stack_t *s = pcl_malloc(sizeof(pcl_stack_t));
-	s->size = 0;
-	s->head = NULL;
-	s->cleanup = cleanup;
-	return s;
+	return pcl_stack_sized(0, cleanup);
 }
@@ -30,7 +30,6 @@
 */
 
 #include "_stack.h"
-#include <pcl/alloc.h>
 
 void
 pcl_stack_clear(pcl_stack_t *s)
@@ -38,18 +37,25 @@ pcl_stack_clear(pcl_stack_t *s)
 	if(!s)
 		return;
 
-	struct stack_item *node = s->head;
+	struct stack_chunk *chunk = s->head;
+	int pos = s->pos;
 
-	while(node)
+	while(chunk)
 	{
-		if(s->cleanup)
-			s->cleanup(node->value);
+		struct stack_chunk *next = chunk->next;
 
-		struct stack_item *next = node->next;
-		pcl_free(node);
-		node = next;
+		if(s->cleanup)
+		{
+			while(pos > 0)
+				s->cleanup(chunk->items[--pos]);
+		}
+
+		ipcl_stack_release(s, chunk);
+		chunk = next;
+		pos = STACK_CHUNKSIZE;
 	}
 
 	s->size = 0;
+	s->pos = 0;
 	s->head = NULL;
 }
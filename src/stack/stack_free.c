@@ -38,6 +38,14 @@ pcl_stack_free(pcl_stack_t *s)
 	if(s)
 	{
 		pcl_stack_clear(s);
+
+		while(s->free)
+		{
+			struct stack_chunk *next = s->free->next;
+			pcl_free(s->free);
+			s->free = next;
+		}
+
 		pcl_free(s);
 	}
 }
@@ -34,6 +34,5 @@
 void *
 pcl_stack_peek(pcl_stack_t *s)
 {
-	return pcl_stack_empty(s) ? NULL : s->head->value;
+	return pcl_stack_empty(s) ? NULL : s->head->items[s->pos - 1];
 }
-
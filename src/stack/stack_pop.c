@@ -30,7 +30,6 @@
 */
 
 #include "_stack.h"
-#include <pcl/alloc.h>
 
 void *
 pcl_stack_pop(pcl_stack_t *s)
@@ -38,14 +37,18 @@ pcl_stack_pop(pcl_stack_t *s)
 	if(pcl_stack_empty(s))
 		return NULL;
 
-	struct stack_item *sitem = s->head;
-	void *value = sitem->value;
+	void *item = s->head->items[--s->pos];
 
-	s->head = sitem->next;
-	s->size--;
+	/* drop an emptied chunk unless it is the last one */
+	if(s->pos == 0 && s->head->next)
+	{
+		struct stack_chunk *chunk = s->head;
 
-	pcl_free(sitem);
+		s->head = chunk->next;
+		s->pos = STACK_CHUNKSIZE;
+		ipcl_stack_release(s, chunk);
+	}
 
-	return value;
+	s->size--;
+	return item;
 }
-
@@ -30,7 +30,6 @@
 */
 
 #include "_stack.h"
-#include <pcl/alloc.h>
 
 void
 pcl_stack_push(pcl_stack_t *s, void *item)
@@ -38,11 +37,15 @@ pcl_stack_push(pcl_stack_t *s, void *item)
 	if(!s)
 		return;
 
-	struct stack_item *sitem = pcl_malloc(sizeof(struct stack_item));
-	struct stack_item *head = s->head;
+	if(!s->head || s->pos == STACK_CHUNKSIZE)
+	{
+		struct stack_chunk *chunk = ipcl_stack_chunk(s);
 
+		chunk->next = s->head;
+		s->head = chunk;
+		s->pos = 0;
+	}
+
+	s->head->items[s->pos++] = item;
 	s->size++;
-	s->head = sitem;
-	sitem->next = head;
-	sitem->value = item;
 }
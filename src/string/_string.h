@@ -45,6 +45,7 @@
 #undef xstrchr
 #undef xstrncpy
 #undef vxprintf
+#undef xvformat
 #undef xfmtconv
 #undef vfxprintf
 #undef xint
@@ -61,6 +62,7 @@
 #	define xstrchr wcschr
 #	define xstrncpy pcl_wcsncpy
 #	define vxprintf pcl_vswprintf
+#	define xvformat pcl_wcsvformat
 #	define xfmtconv pcl_wcsfmtconv
 #	define vfxprintf pcl_vfwprintf
 #	define xint wint_t
@@ -76,6 +78,7 @@
 #	define xstrchr strchr
 #	define xstrncpy pcl_strncpy
 #	define vxprintf pcl_vsprintf
+#	define xvformat pcl_strvformat
 #	define xfmtconv pcl_strfmtconv
 #	define vfxprintf pcl_vfprintf
 #	define xint int
@@ -87,4 +90,25 @@
 #	endif
 #endif
 
-PCL_PRIVATE xchar *XFUNC(fmtconv)(xchar *buf, size_t bufsz, const xchar *pcl_format);
+/* Translate a PCL format into a platform format, see fmtconv.c. The result must not be freed,
+ * except for *alloc which is set when a translation was allocated and could not be cached.
+ */
+PCL_PRIVATE const xchar *XFUNC(fmtconv)(xchar *buf, size_t bufsz, const xchar *pcl_format,
+	xchar **alloc);
+
+/* Like vxprintf, except a truncated non-wide result returns the full formatted length rather
+ * than -PCL_EBUF, like C99 vsnprintf. This lets callers format optimistically into the space
+ * they have and only format again, into an exact buffer, when it did not fit. Wide strings
+ * cannot report their length on truncation and return -PCL_EBUF.
+ */
+PCL_PRIVATE int XFUNC(vformat)(xchar *buf, size_t size, const xchar *format, va_list ap);
+
+#ifndef XWIDE
+/** Check that a string is valid UTF-8 without setting an error. This selects a vectorized
+ * implementation at runtime when the CPU supports one.
+ * @param s pointer to a string
+ * @param len number of bytes to check
+ * @return true if valid and false if not
+ */
+PCL_PRIVATE bool ipcl_utf8_valid(const char *s, size_t len);
+#endif
@@ -29,8 +29,8 @@
   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
-#include <pcl/string.h>
-#include <pcl/error.h>
+#include "_string.h"
+#include <string.h>
 
 /* Table found here:
  * https://lemire.me/blog/2018/05/09/how-quickly-can-you-check-that-a-string-is-valid-unicode-utf-8/
@@ -47,12 +47,12 @@
  * U+100000..U+10FFFF F4       80..8F   80..BF   80..BF
  */
 
-int
-pcl_utf8_check(const char *s, size_t len)
+/* Locates the first invalid sequence and reports it. This only runs after ipcl_utf8_valid
+ * has failed, so it favors detail over speed.
+ */
+static int
+utf8_error(const char *s, size_t len)
 {
-	if(len == 0)
-		len = strlen(s);
-
 	const char *end = s + len;
 
 	while(s < end)
@@ -123,7 +123,13 @@ pcl_utf8_check(const char *s, size_t len)
 					return SETERRMSG(PCL_EILSEQ, "4-byte sequence has invalid 2nd byte: "
 																			 "first=%02hhx, second=%02hhx", c, c2);
 			}
-			else if(c2 < 0x80 || c > 0xBF)
+			else if(c == 0xF4)
+			{
+				if(c2 < 0x80 || c2 > 0x8F)
+					return SETERRMSG(PCL_EILSEQ, "4-byte sequence has invalid 2nd byte: "
+																			 "first=%02hhx, second=%02hhx", c, c2);
+			}
+			else if(c2 < 0x80 || c2 > 0xBF)
 			{
 				return SETERRMSG(PCL_EILSEQ, "4-byte sequence has invalid 2nd byte: "
 																		 "first=%02hhx, second=%02hhx", c, c2);
@@ -144,9 +150,21 @@ pcl_utf8_check(const char *s, size_t len)
 		}
 		else
 		{
-			return SETERRMSG(PCL_EILSEQ, "invalid first byte: %02hxx", c);
+			return SETERRMSG(PCL_EILSEQ, "invalid first byte: %02hhx", c);
 		}
 	}
 
 	return 0;
 }
+
+int
+pcl_utf8_check(const char *s, size_t len)
+{
+	if(len == 0)
+		len = strlen(s);
+
+	if(ipcl_utf8_valid(s, len))
+		return 0;
+
+	return utf8_error(s, len);
+}
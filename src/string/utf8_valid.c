@@ -0,0 +1,308 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_string.h"
+#include <stdint.h>
+#include <string.h>
+
+/* The vectorized validator is the "lookup" algorithm from Keiser and Lemire, "Validating UTF-8
+ * In Less Than One Instruction Per Byte" (2021). Every byte is classified by its high nibble,
+ * the previous byte's high and low nibbles are looked up in 16-entry tables, and ANDing the
+ * three lookups leaves a bit set only for an error. Sequences spanning 3 or 4 bytes are
+ * validated separately by checking that every continuation byte is expected.
+ */
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#	define HAVE_AVX2_DISPATCH
+#	include <immintrin.h>
+#endif
+
+/* Validates everything the error reporting in utf8_check.c does, without reporting. Runs of
+ * ASCII are skipped 8 bytes at a time.
+ */
+static bool
+utf8_valid_scalar(const unsigned char *s, const unsigned char *end)
+{
+	while(s < end)
+	{
+		if(end - s >= 8)
+		{
+			uint64_t word;
+
+			memcpy(&word, s, sizeof(word));
+
+			if(!(word & 0x8080808080808080ULL))
+			{
+				s += 8;
+				continue;
+			}
+		}
+
+		unsigned char c = *s;
+
+		if(c < 0x80)
+		{
+			s++;
+			continue;
+		}
+
+		int n;
+		unsigned char lo = 0x80;
+		unsigned char hi = 0xBF;
+
+		if(c >= 0xC2 && c <= 0xDF)
+		{
+			n = 1;
+		}
+		else if(c >= 0xE0 && c <= 0xEF)
+		{
+			n = 2;
+
+			if(c == 0xE0)
+				lo = 0xA0;
+			else if(c == 0xED)
+				hi = 0x9F;
+		}
+		else if(c >= 0xF0 && c <= 0xF4)
+		{
+			n = 3;
+
+			if(c == 0xF0)
+				lo = 0x90;
+			else if(c == 0xF4)
+				hi = 0x8F;
+		}
+		else
+		{
+			return false;
+		}
+
+		if(end - s <= n || s[1] < lo || s[1] > hi)
+			return false;
+
+		for(int i = 2; i <= n; i++)
+			if((s[i] & 0xC0) != 0x80)
+				return false;
+
+		s += n + 1;
+	}
+
+	return true;
+}
+
+#ifdef HAVE_AVX2_DISPATCH
+
+#define TOO_SHORT   (1 << 0)  /* lead byte or ASCII followed by a lead byte */
+#define TOO_LONG    (1 << 1)  /* ASCII followed by a continuation byte */
+#define OVERLONG_3  (1 << 2)
+#define TOO_LARGE   (1 << 3)  /* greater than U+10FFFF */
+#define SURROGATE   (1 << 4)
+#define OVERLONG_2  (1 << 5)
+#define TOO_LARGE_1000 (1 << 6)
+#define OVERLONG_4  (1 << 6)
+#define TWO_CONTS   ((char) (1 << 7))  /* two continuations, valid only in 3 and 4-byte sequences */
+#define CARRY       (TOO_SHORT | TOO_LONG | TWO_CONTS)
+
+/* a 16-entry table duplicated into both 128-bit lanes, as _mm256_shuffle_epi8 works per lane */
+#define TABLE(...) _mm256_setr_epi8(__VA_ARGS__, __VA_ARGS__)
+
+/* input shifted right by n bytes, with the last n bytes of prev shifted in */
+#define PREV(input, prev, n) \
+	_mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - (n))
+
+typedef struct
+{
+	__m256i error;
+	__m256i prev;
+	__m256i prev_incomplete;
+} avx2_state_t;
+
+__attribute__((target("avx2")))
+static inline __m256i
+high_nibbles(__m256i v)
+{
+	return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i
+check_block(__m256i input, __m256i prev_input)
+{
+	__m256i prev1 = PREV(input, prev_input, 1);
+
+	__m256i byte_1_high = _mm256_shuffle_epi8(TABLE(
+		/* 0_______ ________ ASCII */
+		TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+		TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+		/* 10______ ________ continuation */
+		TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+		/* 1100____ ________ 2-byte lead */
+		TOO_SHORT | OVERLONG_2,
+		/* 1101____ ________ 2-byte lead */
+		TOO_SHORT,
+		/* 1110____ ________ 3-byte lead */
+		TOO_SHORT | OVERLONG_3 | SURROGATE,
+		/* 1111____ ________ 4-byte lead */
+		TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+	), high_nibbles(prev1));
+
+	__m256i byte_1_low = _mm256_shuffle_epi8(TABLE(
+		/* ____0000 ________ */
+		CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+		/* ____0001 ________ */
+		CARRY | OVERLONG_2,
+		/* ____001_ ________ */
+		CARRY,
+		CARRY,
+		/* ____0100 ________ */
+		CARRY | TOO_LARGE,
+		/* ____0101 ________ */
+		CARRY | TOO_LARGE | TOO_LARGE_1000,
+		/* ____011_ ________ */
+		CARRY | TOO_LARGE | TOO_LARGE_1000,
+		CARRY | TOO_LARGE | TOO_LARGE_1000,
+		/* ____1___ ________ */
+		CARRY | TOO_LARGE | TOO_LARGE_1000,
+		CARRY | TOO_LARGE | TOO_LARGE_1000,
+		CARRY | TOO_LARGE | TOO_LARGE_1000,
+		CARRY | TOO_LARGE | TOO_LARGE_1000,
+		CARRY | TOO_LARGE | TOO_LARGE_1000,
+		/* ____1101 ________ */
+		CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+		CARRY | TOO_LARGE | TOO_LARGE_1000,
+		CARRY | TOO_LARGE | TOO_LARGE_1000
+	), _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)));
+
+	__m256i byte_2_high = _mm256_shuffle_epi8(TABLE(
+		/* ________ 0_______ ASCII */
+		TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+		TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+		/* ________ 1000____ */
+		TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+		/* ________ 1001____ */
+		TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+		/* ________ 101_____ */
+		TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+		TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+		/* ________ 11______ lead */
+		TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+	), high_nibbles(input));
+
+	__m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+	/* the 3rd and 4th bytes of a sequence are continuations, which the tables flag as
+	 * TWO_CONTS. Bit 7 ends up set only where a lead byte 2 or 3 bytes back expects one.
+	 */
+	__m256i third = _mm256_subs_epu8(PREV(input, prev_input, 2), _mm256_set1_epi8(0xE0 - 0x80));
+	__m256i fourth = _mm256_subs_epu8(PREV(input, prev_input, 3), _mm256_set1_epi8(0xF0 - 0x80));
+	__m256i must23 = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8((char) 0x80));
+
+	return _mm256_xor_si256(must23, special);
+}
+
+/* non-zero where the last 3 bytes start a sequence that continues into the next block */
+__attribute__((target("avx2")))
+static inline __m256i
+is_incomplete(__m256i input)
+{
+	__m256i max = _mm256_setr_epi8(
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		(char) (0xF0 - 1), (char) (0xE0 - 1), (char) (0xC0 - 1));
+
+	return _mm256_subs_epu8(input, max);
+}
+
+/* validate 64 bytes, which are skipped after a single test when they are all ASCII */
+__attribute__((target("avx2")))
+static inline void
+check_step(avx2_state_t *st, const unsigned char *p)
+{
+	__m256i a = _mm256_loadu_si256((const __m256i *) p);
+	__m256i b = _mm256_loadu_si256((const __m256i *) (p + 32));
+
+	if(_mm256_movemask_epi8(_mm256_or_si256(a, b)) == 0)
+	{
+		st->error = _mm256_or_si256(st->error, st->prev_incomplete);
+		st->prev_incomplete = _mm256_setzero_si256();
+	}
+	else
+	{
+		st->error = _mm256_or_si256(st->error, check_block(a, st->prev));
+		st->error = _mm256_or_si256(st->error, check_block(b, a));
+		st->prev_incomplete = is_incomplete(b);
+	}
+
+	st->prev = b;
+}
+
+__attribute__((target("avx2")))
+static bool
+utf8_valid_avx2(const unsigned char *s, size_t len)
+{
+	avx2_state_t st;
+	size_t i = 0;
+
+	st.error = _mm256_setzero_si256();
+	st.prev = _mm256_setzero_si256();
+	st.prev_incomplete = _mm256_setzero_si256();
+
+	for(; i + 64 <= len; i += 64)
+		check_step(&st, s + i);
+
+	/* zero padding is ASCII, which catches a sequence truncated by the end of input */
+	if(i < len)
+	{
+		unsigned char tail[64] = {0};
+
+		memcpy(tail, s + i, len - i);
+		check_step(&st, tail);
+	}
+
+	st.error = _mm256_or_si256(st.error, st.prev_incomplete);
+
+	return _mm256_testz_si256(st.error, st.error);
+}
+
+#endif // HAVE_AVX2_DISPATCH
+
+bool
+ipcl_utf8_valid(const char *s, size_t len)
+{
+	const unsigned char *p = (const unsigned char *) s;
+
+#ifdef HAVE_AVX2_DISPATCH
+	/* the vector setup costs more than it saves on short strings */
+	if(len >= 64 && __builtin_cpu_supports("avx2"))
+		return utf8_valid_avx2(p, len);
+#endif
+
+	return utf8_valid_scalar(p, p + len);
+}
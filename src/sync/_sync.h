@@ -0,0 +1,94 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL__SYNC_H
+#define LIBPCL__SYNC_H
+
+#include <pcl/sync.h>
+#include <pcl/atomic.h>
+#include <pcl/error.h>
+#include <pcl/time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* upper bound for adaptive spinning, each iteration is one pause instruction */
+#define SYNC_SPIN_MAX 128
+
+#if defined(_M_X64) || defined(_M_IX86)
+#	define SYNC_PAUSE() _mm_pause()
+#elif defined(__x86_64__) || defined(__i386__)
+#	define SYNC_PAUSE() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#	define SYNC_PAUSE() __asm__ __volatile__("yield" ::: "memory")
+#else
+#	define SYNC_PAUSE() ((void) 0)
+#endif
+
+/* relaxed contention counting, a no-op without stats */
+#define SYNC_COUNT(stats, field, n) do{ \
+	if(stats) \
+		pcl_atomic_fetch_add64(&(stats)->field, (int64_t) (n), PCL_ATOMIC_RELAXED); \
+}while(0)
+
+/* rwlock state: readers in the low 32 bits, then the writer bit, then waiting writers */
+#define RW_READERS(s) ((s) & 0xFFFFFFFFLL)
+#define RW_WRITER (1LL << 32)
+#define RW_WWAIT (1LL << 33)
+#define RW_WAITING(s) ((s) >> 33)
+
+/* true when a reader may not enter, which depends on the policy */
+#define RW_RDBLOCKED(rw, s) (((s) & RW_WRITER) || \
+	((rw)->policy == PCL_RWLOCK_PREFER_WRITER && RW_WAITING(s) > 0))
+
+/** Park the calling thread while *addr equals expected.
+ * @param addr futex word
+ * @param expected value that keeps the thread parked
+ * @param deadline pcl_clock time to give up at, 0 for none
+ * @return 0 when woken, which can be spurious, or PCL_ETIMEOUT
+ */
+PCL_PRIVATE int ipcl_sync_park(int32_t *addr, int32_t expected, pcl_clock_t deadline);
+
+/** Wake one or all threads parked on addr. */
+PCL_PRIVATE void ipcl_sync_unpark(int32_t *addr, bool all);
+
+/** Spin limit for this machine: 0 on single processor machines and SYNC_SPIN_MAX otherwise. */
+PCL_PRIVATE int ipcl_sync_spinmax(void);
+
+/** Shared by pcl_cond_wait and pcl_cond_timedwait, deadline is 0 for none. */
+PCL_PRIVATE int ipcl_cond_wait(pcl_cond_t *c, pcl_lock_t *l, pcl_clock_t deadline);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPCL__SYNC_H
@@ -0,0 +1,84 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_sync.h"
+
+int
+pcl_barrier_wait(pcl_barrier_t *b)
+{
+	if(!b)
+		return BADARG();
+
+	pcl_syncstats_t *stats = b->stats;
+	int32_t gen = pcl_atomic_load32(&b->gen, PCL_ATOMIC_ACQUIRE);
+
+	SYNC_COUNT(stats, acquisitions, 1);
+
+	/* The last thread resets the count before opening the next generation, so threads
+	 * that race ahead into the next cycle always see a fresh count.
+	 */
+	if(pcl_atomic_fetch_add32(&b->arrived, 1, PCL_ATOMIC_ACQ_REL) + 1 == b->count)
+	{
+		pcl_atomic_store32(&b->arrived, 0, PCL_ATOMIC_RELAXED);
+		pcl_atomic_fetch_add32(&b->gen, 1, PCL_ATOMIC_RELEASE);
+		ipcl_sync_unpark(&b->gen, true);
+		return PCL_BARRIER_SERIAL;
+	}
+
+	int spins = 0;
+	int64_t parks = 0;
+	int max = ipcl_sync_spinmax();
+	pcl_clock_t start = stats ? pcl_clock() : 0;
+
+	while(pcl_atomic_load32(&b->gen, PCL_ATOMIC_ACQUIRE) == gen)
+	{
+		if(spins < max)
+		{
+			spins++;
+			SYNC_PAUSE();
+		}
+		else
+		{
+			parks++;
+			ipcl_sync_park(&b->gen, gen, 0);
+		}
+	}
+
+	if(stats)
+	{
+		SYNC_COUNT(stats, contended, 1);
+		SYNC_COUNT(stats, spins, spins);
+		SYNC_COUNT(stats, parks, parks);
+		SYNC_COUNT(stats, wait_time, pcl_clock() - start);
+	}
+
+	return 0;
+}
@@ -0,0 +1,69 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_sync.h"
+
+int
+ipcl_cond_wait(pcl_cond_t *c, pcl_lock_t *l, pcl_clock_t deadline)
+{
+	pcl_syncstats_t *stats = c->stats;
+	pcl_clock_t start = stats ? pcl_clock() : 0;
+
+	/* Both happen under the lock, so a signaller that changed the predicate under the same
+	 * lock sees this waiter. Any signal after this point changes seq and stops the park.
+	 */
+	int32_t seq = pcl_atomic_load32(&c->seq, PCL_ATOMIC_RELAXED);
+	pcl_atomic_fetch_add32(&c->waiters, 1, PCL_ATOMIC_RELAXED);
+
+	pcl_lock_release(l);
+	int ret = ipcl_sync_park(&c->seq, seq, deadline);
+
+	pcl_atomic_fetch_add32(&c->waiters, -1, PCL_ATOMIC_RELAXED);
+	pcl_lock_acquire(l);
+
+	if(stats)
+	{
+		SYNC_COUNT(stats, acquisitions, 1);
+		SYNC_COUNT(stats, parks, 1);
+		SYNC_COUNT(stats, wait_time, pcl_clock() - start);
+	}
+
+	return ret ? SETERR(ret) : 0;
+}
+
+int
+pcl_cond_wait(pcl_cond_t *c, pcl_lock_t *l)
+{
+	if(!c || !l)
+		return BADARG();
+
+	return ipcl_cond_wait(c, l, 0);
+}
@@ -0,0 +1,106 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_sync.h"
+#include <errno.h>
+#include <pthread.h>
+
+/* There is no public futex on Darwin. Parked threads wait on one of a fixed set of
+ * condition variables chosen by address. Waking broadcasts to the whole bucket, which
+ * may wake unrelated threads, but every caller treats wakeups as possibly spurious.
+ */
+#define PARK_BUCKETS 64
+
+typedef struct
+{
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+} park_bucket_t;
+
+static park_bucket_t buckets[PARK_BUCKETS] = {
+	[0 ... PARK_BUCKETS - 1] = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER}
+};
+
+static park_bucket_t *
+park_bucket(int32_t *addr)
+{
+	uintptr_t h = (uintptr_t) addr;
+	return &buckets[((h >> 2) ^ (h >> 9)) % PARK_BUCKETS];
+}
+
+int
+ipcl_sync_park(int32_t *addr, int32_t expected, pcl_clock_t deadline)
+{
+	int ret = 0;
+	park_bucket_t *b = park_bucket(addr);
+
+	pthread_mutex_lock(&b->lock);
+
+	if(pcl_atomic_load32(addr, PCL_ATOMIC_SEQ_CST) == expected)
+	{
+		if(deadline > 0)
+		{
+			struct timespec ts;
+			pcl_clock_t left = deadline - pcl_clock();
+
+			if(left <= 0)
+			{
+				ret = PCL_ETIMEOUT;
+			}
+			else
+			{
+				ts.tv_sec = (time_t) (left / PCL_CLOCK_SEC);
+				ts.tv_nsec = (long) (left - (pcl_clock_t) ts.tv_sec * PCL_CLOCK_SEC);
+
+				if(pthread_cond_timedwait_relative_np(&b->cond, &b->lock, &ts) == ETIMEDOUT)
+					ret = PCL_ETIMEOUT;
+			}
+		}
+		else
+		{
+			pthread_cond_wait(&b->cond, &b->lock);
+		}
+	}
+
+	pthread_mutex_unlock(&b->lock);
+	return ret;
+}
+
+void
+ipcl_sync_unpark(int32_t *addr, bool all)
+{
+	park_bucket_t *b = park_bucket(addr);
+
+	(void) all;
+	pthread_mutex_lock(&b->lock);
+	pthread_cond_broadcast(&b->cond);
+	pthread_mutex_unlock(&b->lock);
+}
@@ -0,0 +1,91 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_sync.h"
+
+static void
+lock_contended(pcl_lock_t *l)
+{
+	int32_t c;
+	int spins = 0;
+	int64_t parks = 0;
+	int max = ipcl_sync_spinmax();
+	pcl_syncstats_t *stats = l->stats;
+	pcl_clock_t start = stats ? pcl_clock() : 0;
+	int32_t avg = pcl_atomic_load32(&l->spin, PCL_ATOMIC_RELAXED);
+
+	/* spin up to twice the usual need, the holder is probably about to release */
+	if(max > avg * 2 + 16)
+		max = avg * 2 + 16;
+
+	for(; spins < max; spins++)
+	{
+		SYNC_PAUSE();
+		c = 0;
+
+		if(pcl_atomic_load32(&l->state, PCL_ATOMIC_RELAXED) == 0 &&
+			 pcl_atomic_cas32(&l->state, &c, 1, PCL_ATOMIC_ACQUIRE))
+			goto acquired;
+	}
+
+	/* 2 tells the releasing thread that someone may be parked */
+	while(pcl_atomic_exchange32(&l->state, 2, PCL_ATOMIC_ACQUIRE) != 0)
+	{
+		parks++;
+		ipcl_sync_park(&l->state, 2, 0);
+	}
+
+acquired:
+	pcl_atomic_store32(&l->spin, avg + (spins - avg) / 8, PCL_ATOMIC_RELAXED);
+
+	if(stats)
+	{
+		SYNC_COUNT(stats, contended, 1);
+		SYNC_COUNT(stats, spins, spins);
+		SYNC_COUNT(stats, parks, parks);
+		SYNC_COUNT(stats, wait_time, pcl_clock() - start);
+	}
+}
+
+int
+pcl_lock_acquire(pcl_lock_t *l)
+{
+	if(!l)
+		return BADARG();
+
+	int32_t c = 0;
+
+	if(!pcl_atomic_cas32(&l->state, &c, 1, PCL_ATOMIC_ACQUIRE))
+		lock_contended(l);
+
+	SYNC_COUNT(l->stats, acquisitions, 1);
+	return 0;
+}
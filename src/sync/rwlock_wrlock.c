@@ -0,0 +1,98 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_sync.h"
+
+static void
+wrlock_contended(pcl_rwlock_t *rw)
+{
+	int spins = 0;
+	int64_t parks = 0;
+	int max = ipcl_sync_spinmax();
+	pcl_syncstats_t *stats = rw->stats;
+	pcl_clock_t start = stats ? pcl_clock() : 0;
+	int64_t s;
+
+	for(; spins < max; spins++)
+	{
+		SYNC_PAUSE();
+		s = pcl_atomic_load64(&rw->state, PCL_ATOMIC_RELAXED);
+
+		if(!RW_READERS(s) && !(s & RW_WRITER) &&
+			 pcl_atomic_cas64(&rw->state, &s, s | RW_WRITER, PCL_ATOMIC_ACQUIRE))
+			goto acquired;
+	}
+
+	/* Register as a waiting writer, which also holds back new readers under the writer
+	 * preferring policy. Unlockers see this in the state word and bump wseq.
+	 */
+	pcl_atomic_fetch_add64(&rw->state, RW_WWAIT, PCL_ATOMIC_RELAXED);
+
+	for(;;)
+	{
+		int32_t seq = pcl_atomic_load32(&rw->wseq, PCL_ATOMIC_ACQUIRE);
+		s = pcl_atomic_load64(&rw->state, PCL_ATOMIC_RELAXED);
+
+		if(!RW_READERS(s) && !(s & RW_WRITER))
+		{
+			if(pcl_atomic_cas64(&rw->state, &s, s - RW_WWAIT + RW_WRITER, PCL_ATOMIC_ACQUIRE))
+				break;
+			continue;
+		}
+
+		parks++;
+		ipcl_sync_park(&rw->wseq, seq, 0);
+	}
+
+acquired:
+	if(stats)
+	{
+		SYNC_COUNT(stats, contended, 1);
+		SYNC_COUNT(stats, spins, spins);
+		SYNC_COUNT(stats, parks, parks);
+		SYNC_COUNT(stats, wait_time, pcl_clock() - start);
+	}
+}
+
+int
+pcl_rwlock_wrlock(pcl_rwlock_t *rw)
+{
+	if(!rw)
+		return BADARG();
+
+	int64_t s = 0;
+
+	if(!pcl_atomic_cas64(&rw->state, &s, RW_WRITER, PCL_ATOMIC_ACQUIRE))
+		wrlock_contended(rw);
+
+	SYNC_COUNT(rw->stats, acquisitions, 1);
+	return 0;
+}
@@ -0,0 +1,57 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_sync.h"
+
+int
+pcl_rwlock_wrunlock(pcl_rwlock_t *rw)
+{
+	if(!rw)
+		return BADARG();
+
+	int64_t s = pcl_atomic_fetch_add64(&rw->state, -RW_WRITER, PCL_ATOMIC_SEQ_CST) - RW_WRITER;
+
+	if(RW_WAITING(s) > 0)
+	{
+		pcl_atomic_fetch_add32(&rw->wseq, 1, PCL_ATOMIC_RELEASE);
+		ipcl_sync_unpark(&rw->wseq, false);
+	}
+
+	/* parked readers would only park again behind a waiting writer */
+	if(pcl_atomic_load32(&rw->rwaiters, PCL_ATOMIC_SEQ_CST) > 0 &&
+		 (rw->policy == PCL_RWLOCK_PREFER_READER || RW_WAITING(s) == 0))
+	{
+		pcl_atomic_fetch_add32(&rw->rseq, 1, PCL_ATOMIC_RELEASE);
+		ipcl_sync_unpark(&rw->rseq, true);
+	}
+
+	return 0;
+}
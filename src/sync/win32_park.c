@@ -0,0 +1,64 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_sync.h"
+#include <windows.h>
+
+int
+ipcl_sync_park(int32_t *addr, int32_t expected, pcl_clock_t deadline)
+{
+	DWORD msecs = INFINITE;
+
+	if(deadline > 0)
+	{
+		pcl_clock_t left = deadline - pcl_clock();
+
+		if(left <= 0)
+			return PCL_ETIMEOUT;
+
+		/* round up so a short timeout does not turn into a busy loop */
+		msecs = (DWORD) ((left + PCL_CLOCK_MSEC - 1) / PCL_CLOCK_MSEC);
+	}
+
+	if(!WaitOnAddress(addr, &expected, sizeof(int32_t), msecs) && GetLastError() == ERROR_TIMEOUT)
+		return PCL_ETIMEOUT;
+
+	return 0;
+}
+
+void
+ipcl_sync_unpark(int32_t *addr, bool all)
+{
+	if(all)
+		WakeByAddressAll(addr);
+	else
+		WakeByAddressSingle(addr);
+}
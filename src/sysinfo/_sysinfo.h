@@ -44,6 +44,12 @@ extern "C" {
  */
 PCL_PRIVATE void ipcl_sysinfo(pcl_sysinfo_t *info, void *uts);
 
+/** Fill in the CPU topology and cache fields. Implemented separately by darwin, linux and
+ * windows alongside pcl_sysinfo_cpus.
+ * @param info pointer to an output buffer, as passed to pcl_sysinfo().
+ */
+PCL_PRIVATE void ipcl_sysinfo_topology(pcl_sysinfo_t *info);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,113 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_sysinfo.h"
+#include <pcl/error.h>
+#include <sys/sysctl.h>
+
+/* Darwin has no NUMA and does not expose per-CPU placement. SMT siblings are numbered
+ * next to each other, so the layout is derived from the counts.
+ */
+static int
+sys_int(const char *name, int def)
+{
+	int value = 0;
+	size_t n = sizeof(value);
+
+	return sysctlbyname(name, &value, &n, NULL, 0) == 0 && value > 0 ? value : def;
+}
+
+static uint64_t
+sys_size(const char *name)
+{
+	int64_t value = 0;
+	size_t n = sizeof(value);
+
+	return sysctlbyname(name, &value, &n, NULL, 0) == 0 && value > 0 ? (uint64_t) value : 0;
+}
+
+int
+pcl_sysinfo_cpus(pcl_cpu_t *cpus, int max)
+{
+	if(max < 0 || (max > 0 && !cpus))
+		return BADARG();
+
+	int logical = sys_int("hw.logicalcpu", 1);
+	int physical = sys_int("hw.physicalcpu", logical);
+	int packages = sys_int("hw.packages", 1);
+	int smt = logical / physical > 0 ? logical / physical : 1;
+	int per_socket = physical / packages > 0 ? physical / packages : physical;
+
+	for(int i = 0; i < logical && i < max; i++)
+	{
+		cpus[i].cpu = i;
+		cpus[i].core = (i / smt) % per_socket;
+		cpus[i].socket = (i / smt) / per_socket;
+		cpus[i].thread = i % smt;
+		cpus[i].node = 0;
+	}
+
+	return logical;
+}
+
+int
+pcl_sysinfo_nodecpus(int node, pcl_cpuset_t *set)
+{
+	if(!set || node < 0)
+		return BADARG();
+
+	if(node > 0)
+		return SETERRMSG(PCL_ENOTFOUND, "NUMA node %d does not exist", node);
+
+	pcl_cpuset_zero(set);
+
+	for(int i = sys_int("hw.logicalcpu", 1) - 1; i >= 0; i--)
+		pcl_cpuset_add(set, i);
+
+	return 0;
+}
+
+void
+ipcl_sysinfo_topology(pcl_sysinfo_t *info)
+{
+	int logical = sys_int("hw.logicalcpu", 1);
+
+	info->cpu_physical = sys_int("hw.physicalcpu", logical);
+	/* rounded up, there is no per-core thread count to take the maximum from */
+	info->cpu_smt = logical > info->cpu_physical ?
+		(logical + info->cpu_physical - 1) / info->cpu_physical : 1;
+	info->numa_nodes = 1;
+	info->cache_line = (int) sys_size("hw.cachelinesize");
+	info->cache_l1d = sys_size("hw.l1dcachesize");
+	info->cache_l1i = sys_size("hw.l1icachesize");
+	info->cache_l2 = sys_size("hw.l2cachesize");
+	info->cache_l3 = sys_size("hw.l3cachesize");
+}
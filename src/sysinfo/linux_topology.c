@@ -0,0 +1,265 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_sysinfo.h"
+#include <pcl/error.h>
+#include <pcl/alloc.h>
+#include <pcl/string.h>
+#include <pcl/io.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#define SYSCPU "/sys/devices/system/cpu"
+#define SYSNODE "/sys/devices/system/node"
+
+/* read the first line of a sysfs file, returns false if it cannot be read */
+static bool
+sys_read(const char *path, char *buf, size_t len)
+{
+	FILE *fp = fopen(path, "r");
+
+	if(!fp)
+		return false;
+
+	bool ok = fgets(buf, (int) len, fp) != NULL;
+
+	fclose(fp);
+	return ok;
+}
+
+static int
+sys_int(const char *path, int def)
+{
+	char buf[32];
+	return sys_read(path, buf, sizeof(buf)) ? (int) strtol(buf, NULL, 10) : def;
+}
+
+/* cache sizes are written like "32K" or "36608K" */
+static uint64_t
+sys_size(const char *path)
+{
+	char buf[32], *unit;
+
+	if(!sys_read(path, buf, sizeof(buf)))
+		return 0;
+
+	uint64_t size = strtoull(buf, &unit, 10);
+
+	switch(*unit)
+	{
+		case 'K': return size * 1024;
+		case 'M': return size * 1048576;
+		case 'G': return size * 1073741824;
+	}
+
+	return size;
+}
+
+/* parse a cpu or node list like "0-3,8-11", returns -1 if the file cannot be read */
+static int
+sys_list(const char *path, pcl_cpuset_t *set)
+{
+	char buf[4096];
+
+	pcl_cpuset_zero(set);
+
+	if(!sys_read(path, buf, sizeof(buf)))
+		return -1;
+
+	for(char *p = buf; *p && *p != '\n'; )
+	{
+		int first = (int) strtol(p, &p, 10), last = first;
+
+		if(*p == '-')
+			last = (int) strtol(p + 1, &p, 10);
+
+		for(int i = first; i <= last; i++)
+			pcl_cpuset_add(set, i);
+
+		if(*p == ',')
+			p++;
+		else
+			break;
+	}
+
+	return 0;
+}
+
+int
+pcl_sysinfo_cpus(pcl_cpu_t *cpus, int max)
+{
+	char path[256];
+	pcl_cpuset_t online, nodes, nodecpus;
+	int count = 0, nodeof[PCL_CPUSET_SIZE] = {0};
+
+	if(max < 0 || (max > 0 && !cpus))
+		return BADARG();
+
+	if(sys_list(SYSCPU "/online", &online))
+		return SETERRMSG(PCL_ENOTSUP, "cannot read " SYSCPU "/online", 0);
+
+	/* machines without NUMA support have no node directory */
+	if(max > 0 && !sys_list(SYSNODE "/online", &nodes))
+	{
+		for(int node = 0; node < PCL_CPUSET_SIZE; node++)
+		{
+			pcl_sprintf(path, sizeof(path), SYSNODE "/node%d/cpulist", node);
+
+			if(!pcl_cpuset_has(&nodes, node) || sys_list(path, &nodecpus))
+				continue;
+
+			for(int cpu = 0; cpu < PCL_CPUSET_SIZE; cpu++)
+				if(pcl_cpuset_has(&nodecpus, cpu))
+					nodeof[cpu] = node;
+		}
+	}
+
+	for(int cpu = 0; cpu < PCL_CPUSET_SIZE; cpu++)
+	{
+		if(!pcl_cpuset_has(&online, cpu))
+			continue;
+
+		if(count < max)
+		{
+			pcl_cpu_t *c = &cpus[count];
+
+			c->cpu = cpu;
+			c->node = nodeof[cpu];
+
+			pcl_sprintf(path, sizeof(path), SYSCPU "/cpu%d/topology/physical_package_id", cpu);
+			c->socket = sys_int(path, 0);
+
+			pcl_sprintf(path, sizeof(path), SYSCPU "/cpu%d/topology/core_id", cpu);
+			c->core = sys_int(path, cpu);
+
+			/* siblings are numbered in CPU order */
+			c->thread = 0;
+			for(int i = 0; i < count; i++)
+				if(cpus[i].socket == c->socket && cpus[i].core == c->core)
+					c->thread++;
+		}
+
+		count++;
+	}
+
+	return count;
+}
+
+int
+pcl_sysinfo_nodecpus(int node, pcl_cpuset_t *set)
+{
+	char path[256];
+	pcl_cpuset_t nodes;
+
+	if(!set || node < 0)
+		return BADARG();
+
+	/* without NUMA support every CPU is on node 0 */
+	if(sys_list(SYSNODE "/online", &nodes))
+	{
+		if(node > 0)
+			return SETERRMSG(PCL_ENOTFOUND, "NUMA node %d does not exist", node);
+
+		return sys_list(SYSCPU "/online", set) ? SETERR(PCL_ENOTSUP) : 0;
+	}
+
+	pcl_sprintf(path, sizeof(path), SYSNODE "/node%d/cpulist", node);
+
+	if(!pcl_cpuset_has(&nodes, node) || sys_list(path, set))
+		return SETERRMSG(PCL_ENOTFOUND, "NUMA node %d does not exist", node);
+
+	return 0;
+}
+
+void
+ipcl_sysinfo_topology(pcl_sysinfo_t *info)
+{
+	char path[256], type[32];
+	pcl_cpuset_t nodes;
+
+	info->numa_nodes = sys_list(SYSNODE "/online", &nodes) ? 1 : pcl_cpuset_count(&nodes);
+
+	int count = pcl_sysinfo_cpus(NULL, 0);
+
+	if(count > 0)
+	{
+		pcl_cpu_t *cpus = pcl_malloc(count * sizeof(pcl_cpu_t));
+
+		count = pcl_sysinfo_cpus(cpus, count);
+
+		for(int i = 0; i < count; i++)
+		{
+			if(cpus[i].thread == 0)
+				info->cpu_physical++;
+
+			if(cpus[i].thread + 1 > info->cpu_smt)
+				info->cpu_smt = cpus[i].thread + 1;
+		}
+
+		pcl_free(cpus);
+	}
+
+	if(!info->cpu_physical)
+		info->cpu_physical = info->cpu_cores;
+
+	if(!info->cpu_smt)
+		info->cpu_smt = 1;
+
+	/* cpu0 is representative, mixed core types are not described */
+	for(int i = 0; i < 8; i++)
+	{
+		pcl_sprintf(path, sizeof(path), SYSCPU "/cpu0/cache/index%d/type", i);
+
+		if(!sys_read(path, type, sizeof(type)))
+			break;
+
+		pcl_sprintf(path, sizeof(path), SYSCPU "/cpu0/cache/index%d/level", i);
+		int level = sys_int(path, 0);
+
+		pcl_sprintf(path, sizeof(path), SYSCPU "/cpu0/cache/index%d/size", i);
+		uint64_t size = sys_size(path);
+
+		if(level == 1 && !strncmp(type, "Instruction", 11))
+			info->cache_l1i = size;
+		else if(level == 1)
+			info->cache_l1d = size;
+		else if(level == 2)
+			info->cache_l2 = size;
+		else if(level == 3)
+			info->cache_l3 = size;
+
+		if(!info->cache_line)
+		{
+			pcl_sprintf(path, sizeof(path), SYSCPU "/cpu0/cache/index%d/coherency_line_size", i);
+			info->cache_line = sys_int(path, 0);
+		}
+	}
+}
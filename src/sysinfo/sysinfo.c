@@ -88,6 +88,7 @@ pcl_sysinfo(pcl_sysinfo_t *info)
 	}
 
 	ipcl_sysinfo(info, &uts);
+	ipcl_sysinfo_topology(info);
 
 	/* remove any double spaces, this is common (straight from DMI) */
 	while((p = strstr(info->cpu_model, "  ")))
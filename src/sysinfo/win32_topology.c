@@ -0,0 +1,215 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_sysinfo.h"
+#include <pcl/error.h>
+#include <pcl/alloc.h>
+#include <windows.h>
+
+/* GetLogicalProcessorInformation only describes the calling thread's processor group,
+ * which is at most 64 logical CPUs.
+ */
+static SYSTEM_LOGICAL_PROCESSOR_INFORMATION *
+lpi_list(int *count)
+{
+	DWORD size = 0;
+	SYSTEM_LOGICAL_PROCESSOR_INFORMATION *list = NULL;
+
+	*count = 0;
+
+	if(GetLogicalProcessorInformation(NULL, &size) ||
+		 GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+		return NULL;
+
+	list = pcl_malloc(size);
+
+	if(!GetLogicalProcessorInformation(list, &size))
+		return pcl_free(list);
+
+	*count = (int) (size / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+	return list;
+}
+
+int
+pcl_sysinfo_cpus(pcl_cpu_t *cpus, int max)
+{
+	int count, ncpus = 0, core = 0, socket = 0;
+	pcl_cpu_t map[64] = {0};
+	ULONG_PTR online = 0;
+
+	if(max < 0 || (max > 0 && !cpus))
+		return BADARG();
+
+	SYSTEM_LOGICAL_PROCESSOR_INFORMATION *list = lpi_list(&count);
+
+	if(!list)
+		return SETLASTERR();
+
+	for(int i = 0; i < count; i++)
+	{
+		ULONG_PTR mask = list[i].ProcessorMask;
+		int thread = 0;
+
+		for(int cpu = 0; cpu < 64; cpu++)
+		{
+			if(!(mask & ((ULONG_PTR) 1 << cpu)))
+				continue;
+
+			switch(list[i].Relationship)
+			{
+				case RelationProcessorCore:
+					online |= (ULONG_PTR) 1 << cpu;
+					map[cpu].core = core;
+					map[cpu].thread = thread++;
+					break;
+
+				case RelationProcessorPackage:
+					map[cpu].socket = socket;
+					break;
+
+				case RelationNumaNode:
+					map[cpu].node = (int) list[i].NumaNode.NodeNumber;
+					break;
+
+				default:
+					break;
+			}
+		}
+
+		if(list[i].Relationship == RelationProcessorCore)
+			core++;
+		else if(list[i].Relationship == RelationProcessorPackage)
+			socket++;
+	}
+
+	pcl_free(list);
+
+	for(int cpu = 0; cpu < 64; cpu++)
+	{
+		if(!(online & ((ULONG_PTR) 1 << cpu)))
+			continue;
+
+		if(ncpus < max)
+		{
+			cpus[ncpus] = map[cpu];
+			cpus[ncpus].cpu = cpu;
+		}
+
+		ncpus++;
+	}
+
+	return ncpus;
+}
+
+int
+pcl_sysinfo_nodecpus(int node, pcl_cpuset_t *set)
+{
+	GROUP_AFFINITY affinity;
+
+	if(!set || node < 0)
+		return BADARG();
+
+	if(!GetNumaNodeProcessorMaskEx((USHORT) node, &affinity) || !affinity.Mask)
+		return SETERRMSG(PCL_ENOTFOUND, "NUMA node %d does not exist", node);
+
+	pcl_cpuset_zero(set);
+
+	for(int cpu = 0; cpu < 64; cpu++)
+		if(affinity.Mask & ((KAFFINITY) 1 << cpu))
+			pcl_cpuset_add(set, affinity.Group * 64 + cpu);
+
+	return 0;
+}
+
+void
+ipcl_sysinfo_topology(pcl_sysinfo_t *info)
+{
+	int count, logical = 0;
+	SYSTEM_LOGICAL_PROCESSOR_INFORMATION *list = lpi_list(&count);
+
+	info->numa_nodes = 0;
+
+	for(int i = 0; i < count; i++)
+	{
+		CACHE_DESCRIPTOR *cache = &list[i].Cache;
+
+		switch(list[i].Relationship)
+		{
+			case RelationProcessorCore:
+			{
+				int threads = (int) __popcnt64((uint64_t) list[i].ProcessorMask);
+
+				info->cpu_physical++;
+				logical += threads;
+
+				/* hybrid CPUs mix cores with and without SMT, report the widest */
+				if(threads > info->cpu_smt)
+					info->cpu_smt = threads;
+				break;
+			}
+
+			case RelationNumaNode:
+				info->numa_nodes++;
+				break;
+
+			case RelationCache:
+				if(cache->Level == 1 && cache->Type == CacheInstruction)
+					info->cache_l1i = cache->Size;
+				else if(cache->Level == 1)
+					info->cache_l1d = cache->Size;
+				else if(cache->Level == 2)
+					info->cache_l2 = cache->Size;
+				else if(cache->Level == 3)
+					info->cache_l3 = cache->Size;
+
+				info->cache_line = cache->LineSize;
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	pcl_free_safe(list);
+
+	/* windows_cpuinfo counts physical cores, cpu_cores is documented as logical */
+	if(logical > 0)
+		info->cpu_cores = logical;
+
+	if(!info->cpu_physical)
+		info->cpu_physical = info->cpu_cores;
+
+	if(!info->cpu_smt)
+		info->cpu_smt = 1;
+
+	if(!info->numa_nodes)
+		info->numa_nodes = 1;
+}
@@ -33,13 +33,60 @@
 #include <pcl/alloc.h>
 #include <pcl/error.h>
 #include <pcl/event.h>
+#include <pcl/sync.h>
+#include <pcl/atomic.h>
+#include <pcl/string.h>
 
 typedef struct
 {
 	void *arg;
 	pcl_thread_start_t routine;
+
+	/* attributes applied by the new thread */
+	char name[64];
+	bool has_affinity;
+	pcl_cpuset_t affinity;
+	int numa_node;
+	int policy;
+	int priority;
+
+	/* setup handshake, only used when there are attributes to apply */
+	bool wait;
+	pcl_lock_t lock;
+	pcl_cond_t cond;
+	int state;                /* 0 pending, 1 running, -1 failed */
+	int err;
+	const char *what;
+	int32_t refs;             /* creator and thread, the last one out frees */
 } thread_start_t;
 
+static void
+thread_start_release(thread_start_t *start)
+{
+	if(pcl_atomic_fetch_add32(&start->refs, -1, PCL_ATOMIC_ACQ_REL) == 1)
+		pcl_free(start);
+}
+
+static int
+thread_setup(thread_start_t *start)
+{
+	if(*start->name && pcl_thread_setname(start->name))
+		return start->what = "name", -1;
+
+	if(start->numa_node >= 0 && pcl_thread_setnode(start->numa_node))
+		return start->what = "NUMA node", -1;
+
+	/* an explicit affinity narrows the node's CPUs */
+	if(start->has_affinity && pcl_thread_setaffinity(&start->affinity))
+		return start->what = "affinity", -1;
+
+	if(start->policy != PCL_THREAD_SCHED_DEFAULT &&
+		 pcl_thread_setpriority(start->policy, start->priority))
+		return start->what = "priority", -1;
+
+	return 0;
+}
+
 static void *
 thread_start_wrapper(void *__arg)
 {
@@ -47,17 +94,49 @@ thread_start_wrapper(void *__arg)
 	void *arg = start->arg;
 	void (*routine)(void *) = start->routine;
 
-	pcl_free(start);
+	/* first, so setup failures have an error context to report into */
 	pcl_event_dispatch(PCL_EVENT_THREADINIT, NULL);
+
+	if(start->wait)
+	{
+		int r = thread_setup(start);
+
+		pcl_lock_acquire(&start->lock);
+		start->err = r ? pcl_errno : 0;
+		start->state = r ? -1 : 1;
+		pcl_cond_signal(&start->cond);
+		pcl_lock_release(&start->lock);
+		thread_start_release(start);
+
+		if(r)
+			return 0;
+	}
+	else
+	{
+		thread_start_release(start);
+	}
+
 	routine(arg);
 
 	return 0;
 }
 
+void
+pcl_thread_attr_init(pcl_thread_attr_t *attr)
+{
+	if(attr)
+	{
+		memset(attr, 0, sizeof(*attr));
+		attr->numa_node = -1;
+		attr->policy = PCL_THREAD_SCHED_DEFAULT;
+	}
+}
+
 int
-pcl_thread(pthread_t *t, pcl_thread_start_t routine, void *arg)
+pcl_thread_ex(pthread_t *t, const pcl_thread_attr_t *attr, pcl_thread_start_t routine, void *arg)
 {
 	pthread_t tbuf;
+	pcl_thread_attr_t defattr;
 
 	if(!routine)
 		return SETERR(EINVAL);
@@ -65,18 +144,55 @@ pcl_thread(pthread_t *t, pcl_thread_start_t routine, void *arg)
 	if(!t)
 		t = &tbuf;
 
-	pthread_attr_t attr;
-	pthread_attr_init(&attr);
-	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
-	pthread_attr_setscope(&attr, PTHREAD_SCOPE_SYSTEM);
+	if(!attr)
+	{
+		pcl_thread_attr_init(&defattr);
+		attr = &defattr;
+	}
 
-	/* create thread arg wrapper and start thread */
-	thread_start_t *start = pcl_malloc(sizeof(thread_start_t));
+	/* create thread arg wrapper */
+	thread_start_t *start = pcl_zalloc(sizeof(thread_start_t));
 	start->arg = arg;
 	start->routine = routine;
-	int err = pthread_create(t, &attr, thread_start_wrapper, start);
+	start->numa_node = attr->numa_node;
+	start->policy = attr->policy;
+	start->priority = attr->priority;
+	start->refs = 1;
+
+	if(attr->name)
+		pcl_strncpy(start->name, sizeof(start->name), attr->name,
+			strnlen(attr->name, sizeof(start->name) - 1));
+
+	if(attr->affinity)
+	{
+		start->has_affinity = true;
+		start->affinity = *attr->affinity;
+	}
+
+	/* without a handshake start belongs to the new thread once it is created */
+	bool wait = *start->name || start->has_affinity || start->numa_node >= 0 ||
+		start->policy != PCL_THREAD_SCHED_DEFAULT;
+
+	if(wait)
+	{
+		start->wait = true;
+		start->refs = 2;
+		pcl_lock_init(&start->lock, NULL);
+		pcl_cond_init(&start->cond, NULL);
+	}
+
+	pthread_attr_t pattr;
+	pthread_attr_init(&pattr);
+	pthread_attr_setdetachstate(&pattr, attr->joinable ? PTHREAD_CREATE_JOINABLE :
+		PTHREAD_CREATE_DETACHED);
+	pthread_attr_setscope(&pattr, PTHREAD_SCOPE_SYSTEM);
+
+	int err = attr->stack_size ? pthread_attr_setstacksize(&pattr, attr->stack_size) : 0;
 
-	pthread_attr_destroy(&attr);
+	if(!err)
+		err = pthread_create(t, &pattr, thread_start_wrapper, start);
+
+	pthread_attr_destroy(&pattr);
 
 	if(err)
 	{
@@ -84,5 +200,36 @@ pcl_thread(pthread_t *t, pcl_thread_start_t routine, void *arg)
 		return SETOSERR(err);
 	}
 
+	if(!wait)
+		return 0;
+
+	/* wait for the thread to apply its attributes */
+	pcl_lock_acquire(&start->lock);
+
+	while(start->state == 0)
+		pcl_cond_wait(&start->cond, &start->lock);
+
+	pcl_lock_release(&start->lock);
+
+	int state = start->state;
+	int failure = start->err;
+	const char *what = start->what;
+
+	thread_start_release(start);
+
+	if(state < 0)
+	{
+		if(attr->joinable)
+			pthread_join(*t, NULL);
+
+		return SETERRMSG(failure ? failure : PCL_EINVAL, "cannot set thread %s", what);
+	}
+
 	return 0;
 }
+
+int
+pcl_thread(pthread_t *t, pcl_thread_start_t routine, void *arg)
+{
+	return pcl_thread_ex(t, NULL, routine, arg);
+}
@@ -0,0 +1,76 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <pcl/thread.h>
+#include <pcl/error.h>
+
+#ifdef PCL_LINUX
+#	include <sched.h>
+#elif defined(PCL_WINDOWS)
+#	include <windows.h>
+#endif
+
+int
+pcl_thread_setaffinity(const pcl_cpuset_t *set)
+{
+	if(!set || !pcl_cpuset_count(set))
+		return BADARG();
+
+#ifdef PCL_LINUX
+	cpu_set_t cpus;
+
+	CPU_ZERO(&cpus);
+
+	for(int cpu = 0; cpu < PCL_CPUSET_SIZE && cpu < CPU_SETSIZE; cpu++)
+		if(pcl_cpuset_has(set, cpu))
+			CPU_SET(cpu, &cpus);
+
+	int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+	return err ? SETOSERR(err) : 0;
+
+#elif defined(PCL_WINDOWS)
+	/* only the first processor group, matching pcl_sysinfo_cpus */
+	DWORD_PTR mask = 0;
+
+	for(int cpu = 0; cpu < (int) sizeof(DWORD_PTR) * 8; cpu++)
+		if(pcl_cpuset_has(set, cpu))
+			mask |= (DWORD_PTR) 1 << cpu;
+
+	if(!mask)
+		return SETERRMSG(PCL_ENOTSUP, "only CPUs in the first processor group are supported", 0);
+
+	return SetThreadAffinityMask(GetCurrentThread(), mask) ? 0 : SETLASTERR();
+
+#else
+	/* Darwin only offers affinity tags, which are hints for sharing a cache */
+	return SETERRMSG(PCL_ENOTSUP, "thread affinity is not supported on this platform", 0);
+#endif
+}
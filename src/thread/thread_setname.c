@@ -0,0 +1,70 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <pcl/thread.h>
+#include <pcl/error.h>
+#include <pcl/string.h>
+#include <pcl/alloc.h>
+
+#ifdef PCL_WINDOWS
+#	include <windows.h>
+#endif
+
+int
+pcl_thread_setname(const char *name)
+{
+	if(!name)
+		return BADARG();
+
+#ifdef PCL_LINUX
+	/* the kernel limit is 16 bytes including the NUL */
+	char buf[16];
+	pcl_strncpy(buf, sizeof(buf), name, strnlen(name, sizeof(buf) - 1));
+
+	int err = pthread_setname_np(pthread_self(), buf);
+	return err ? SETOSERR(err) : 0;
+
+#elif defined(PCL_DARWIN)
+	int err = pthread_setname_np(name);
+	return err ? SETOSERR(err) : 0;
+
+#else
+	pchar_t *wname = pcl_utf8_to_pcs(name, 0, NULL);
+
+	if(!wname)
+		return TRC();
+
+	HRESULT hr = SetThreadDescription(GetCurrentThread(), wname);
+	pcl_free(wname);
+
+	return FAILED(hr) ? SETOSERR(HRESULT_CODE(hr)) : 0;
+#endif
+}
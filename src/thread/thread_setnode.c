@@ -0,0 +1,69 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <pcl/thread.h>
+#include <pcl/error.h>
+
+#ifdef PCL_LINUX
+#	include <errno.h>
+#	include <unistd.h>
+#	include <sys/syscall.h>
+#	include <linux/mempolicy.h>
+#endif
+
+int
+pcl_thread_setnode(int node)
+{
+	pcl_cpuset_t cpus;
+
+	if(pcl_sysinfo_nodecpus(node, &cpus))
+		return TRC();
+
+	/* Darwin has no NUMA and no affinity, node 0 is the whole machine */
+#ifndef PCL_DARWIN
+	if(pcl_thread_setaffinity(&cpus))
+		return TRC();
+#endif
+
+#ifdef PCL_LINUX
+	/* Prefer the node's memory for new pages without failing allocations when it is
+	 * full. Kernels built without NUMA support return ENOSYS, which is fine for node 0.
+	 */
+	unsigned long mask[PCL_CPUSET_SIZE / (8 * sizeof(unsigned long))] = {0};
+	mask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+
+	if(syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, (unsigned long) PCL_CPUSET_SIZE) &&
+		 errno != ENOSYS)
+		return SETLASTERR();
+#endif
+
+	return 0;
+}
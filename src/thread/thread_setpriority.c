@@ -0,0 +1,112 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <pcl/thread.h>
+#include <pcl/error.h>
+
+#ifdef PCL_LINUX
+#	include <sched.h>
+#	include <unistd.h>
+#	include <sys/syscall.h>
+#	include <sys/resource.h>
+#elif defined(PCL_WINDOWS)
+#	include <windows.h>
+#endif
+
+int
+pcl_thread_setpriority(int policy, int priority)
+{
+	if(policy == PCL_THREAD_SCHED_OTHER)
+	{
+		if(priority < -20 || priority > 19)
+			return SETERRMSG(PCL_EINVAL, "nice value out of range: %d", priority);
+	}
+	else if(policy == PCL_THREAD_SCHED_FIFO || policy == PCL_THREAD_SCHED_RR)
+	{
+		if(priority < 1 || priority > 99)
+			return SETERRMSG(PCL_EINVAL, "realtime priority out of range: %d", priority);
+	}
+	else
+	{
+		return SETERRMSG(PCL_EINVAL, "unknown scheduling policy: %d", policy);
+	}
+
+#ifdef PCL_WINDOWS
+	int level = THREAD_PRIORITY_TIME_CRITICAL;
+
+	if(policy == PCL_THREAD_SCHED_OTHER)
+	{
+		if(priority <= -15)
+			level = THREAD_PRIORITY_HIGHEST;
+		else if(priority < 0)
+			level = THREAD_PRIORITY_ABOVE_NORMAL;
+		else if(priority == 0)
+			level = THREAD_PRIORITY_NORMAL;
+		else if(priority < 15)
+			level = THREAD_PRIORITY_BELOW_NORMAL;
+		else
+			level = THREAD_PRIORITY_LOWEST;
+	}
+
+	return SetThreadPriority(GetCurrentThread(), level) ? 0 : SETLASTERR();
+
+#else
+	struct sched_param param = {0};
+	int native = SCHED_OTHER;
+
+	if(policy == PCL_THREAD_SCHED_FIFO)
+		native = SCHED_FIFO;
+	else if(policy == PCL_THREAD_SCHED_RR)
+		native = SCHED_RR;
+
+	if(native != SCHED_OTHER)
+	{
+		int max = sched_get_priority_max(native);
+		param.sched_priority = priority < max ? priority : max;
+	}
+
+	int err = pthread_setschedparam(pthread_self(), native, &param);
+
+	if(err)
+		return SETOSERR(err);
+
+#	ifdef PCL_LINUX
+	/* Linux applies nice values per thread when given a thread id */
+	if(native == SCHED_OTHER && setpriority(PRIO_PROCESS, (id_t) syscall(SYS_gettid), priority))
+		return SETLASTERR();
+#	else
+	if(native == SCHED_OTHER && priority != 0)
+		return SETERRMSG(PCL_ENOTSUP, "per-thread nice values are not supported", 0);
+#	endif
+
+	return 0;
+#endif
+}
@@ -0,0 +1,164 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL__THREADPOOL_H
+#define LIBPCL__THREADPOOL_H
+
+#include <pcl/threadpool.h>
+#include <pcl/queue.h>
+#include <pcl/error.h>
+#include <pcl/atomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TP_CACHELINE 64
+#define TP_DEQUESIZE 256
+
+/* memory-ordered operations on deque indices, counters and slots. TP_LOADP and TP_STOREP
+ * are for pointers.
+ */
+#define TP_LOAD(p) pcl_atomic_load64((int64_t *) (p), PCL_ATOMIC_RELAXED)
+#define TP_LOAD_ACQ(p) pcl_atomic_load64((int64_t *) (p), PCL_ATOMIC_ACQUIRE)
+#define TP_LOAD_SEQ(p) pcl_atomic_load64((int64_t *) (p), PCL_ATOMIC_SEQ_CST)
+#define TP_STORE(p, v) pcl_atomic_store64((int64_t *) (p), (int64_t) (v), PCL_ATOMIC_RELAXED)
+#define TP_LOADP(p) pcl_atomic_loadptr((void **) (p), PCL_ATOMIC_ACQUIRE)
+#define TP_STOREP(p, v) pcl_atomic_storeptr((void **) (p), (v), PCL_ATOMIC_RELEASE)
+#define TP_FETCH_ADD(p, v) pcl_atomic_fetch_add64((int64_t *) (p), (int64_t) (v), PCL_ATOMIC_SEQ_CST)
+#define TP_CAS(p, expected, desired) pcl_atomic_cas64((int64_t *) (p), \
+	&(int64_t){(int64_t) (expected)}, (int64_t) (desired), PCL_ATOMIC_SEQ_CST)
+#define TP_FENCE_REL() pcl_atomic_fence(PCL_ATOMIC_RELEASE)
+#define TP_FENCE() pcl_atomic_fence(PCL_ATOMIC_SEQ_CST)
+
+typedef struct
+{
+	pcl_task_t task;
+	pcl_thread_start_t routine;
+	void *arg;
+	pcl_future_t *future;
+} ipcl_task_t;
+
+struct tag_pcl_future
+{
+	pcl_threadpool_t *tp;
+	void *result;
+
+	/* 1 until the task completes */
+	int64_t pending;
+
+	/* owned by the task and the caller */
+	int64_t refs;
+};
+
+/* Deque storage. Arrays replaced by a larger one are kept on the prev list until the deque is
+ * freed, since a thief may still be reading them.
+ */
+typedef struct tag_ipcl_deque_array
+{
+	int64_t size;
+	struct tag_ipcl_deque_array *prev;
+	ipcl_task_t *slots[];
+} ipcl_deque_array_t;
+
+/* Chase-Lev deque: the owner pushes and takes at bottom, thieves steal at top. */
+typedef struct
+{
+	int64_t top;
+	char pad1[TP_CACHELINE - sizeof(int64_t)];
+	int64_t bottom;
+	ipcl_deque_array_t *array;
+	char pad2[TP_CACHELINE - sizeof(int64_t) - sizeof(void *)];
+} ipcl_deque_t;
+
+typedef struct
+{
+	ipcl_deque_t deque;
+	pcl_threadpool_t *tp;
+	pthread_t thread;
+	bool started;
+	uint32_t seed;
+} ipcl_worker_t;
+
+struct tag_pcl_threadpool
+{
+	int nworkers;
+	ipcl_worker_t **workers;
+
+	/* the calling thread's worker, NULL outside of the pool */
+	pthread_key_t key;
+
+	/* tasks submitted from outside the pool */
+	pthread_mutex_t injectlock;
+	pcl_queue_t *inject;
+	int64_t injected;
+
+	/* tasks waiting in a deque or the inject queue */
+	int64_t queued;
+
+	/* tasks submitted but not completed */
+	int64_t pending;
+
+	/* idle workers wait on work, threads waiting for a counter to reach zero wait on done */
+	pthread_mutex_t lock;
+	pthread_cond_t work;
+	pthread_cond_t done;
+	int64_t sleepers;
+	int64_t waiters;
+	bool shutdown;
+};
+
+PCL_PRIVATE void ipcl_deque_init(ipcl_deque_t *d);
+PCL_PRIVATE void ipcl_deque_push(ipcl_deque_t *d, ipcl_task_t *task);
+PCL_PRIVATE ipcl_task_t *ipcl_deque_take(ipcl_deque_t *d);
+PCL_PRIVATE ipcl_task_t *ipcl_deque_steal(ipcl_deque_t *d);
+PCL_PRIVATE void ipcl_deque_free(ipcl_deque_t *d);
+
+/* queue a task on the caller's deque, or the inject queue outside of the pool */
+PCL_PRIVATE void ipcl_threadpool_enqueue(pcl_threadpool_t *tp, ipcl_task_t *task);
+
+/* get a task from w's deque, the inject queue or another worker. w can be NULL. */
+PCL_PRIVATE ipcl_task_t *ipcl_threadpool_find(pcl_threadpool_t *tp, ipcl_worker_t *w);
+
+/* run and free a task */
+PCL_PRIVATE void ipcl_threadpool_run(pcl_threadpool_t *tp, ipcl_task_t *task);
+
+/* decrement a counter, waking joiners when it reaches zero */
+PCL_PRIVATE void ipcl_threadpool_done(pcl_threadpool_t *tp, int64_t *counter);
+
+/* wait for a counter to reach zero, workers run tasks meanwhile */
+PCL_PRIVATE void ipcl_threadpool_join(pcl_threadpool_t *tp, int64_t *counter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPCL__THREADPOOL_H
@@ -0,0 +1,142 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_threadpool.h"
+#include <pcl/alloc.h>
+
+static ipcl_deque_array_t *
+array_new(int64_t size, ipcl_deque_array_t *prev)
+{
+	ipcl_deque_array_t *a = pcl_malloc(sizeof(ipcl_deque_array_t) + size * sizeof(ipcl_task_t *));
+
+	a->size = size;
+	a->prev = prev;
+	return a;
+}
+
+void
+ipcl_deque_init(ipcl_deque_t *d)
+{
+	d->top = d->bottom = 0;
+	d->array = array_new(TP_DEQUESIZE, NULL);
+}
+
+void
+ipcl_deque_push(ipcl_deque_t *d, ipcl_task_t *task)
+{
+	int64_t b = TP_LOAD(&d->bottom);
+	int64_t t = TP_LOAD_ACQ(&d->top);
+	ipcl_deque_array_t *a = d->array; /* only the owner replaces it */
+
+	if(b - t > a->size - 1)
+	{
+		ipcl_deque_array_t *grown = array_new(a->size * 2, a);
+
+		for(int64_t i = t; i < b; i++)
+			grown->slots[i & (grown->size - 1)] = TP_LOADP(&a->slots[i & (a->size - 1)]);
+
+		TP_STOREP(&d->array, grown);
+		a = grown;
+	}
+
+	TP_STOREP(&a->slots[b & (a->size - 1)], task);
+	TP_FENCE_REL();
+	TP_STORE(&d->bottom, b + 1);
+}
+
+ipcl_task_t *
+ipcl_deque_take(ipcl_deque_t *d)
+{
+	int64_t b = TP_LOAD(&d->bottom) - 1;
+	ipcl_deque_array_t *a = d->array;
+
+	TP_STORE(&d->bottom, b);
+	TP_FENCE();
+
+	int64_t t = TP_LOAD(&d->top);
+
+	if(t > b)
+	{
+		TP_STORE(&d->bottom, b + 1);
+		return NULL;
+	}
+
+	ipcl_task_t *task = (ipcl_task_t *) TP_LOADP(&a->slots[b & (a->size - 1)]);
+
+	/* last item, race thieves for it */
+	if(t == b)
+	{
+		if(!TP_CAS(&d->top, t, t + 1))
+			task = NULL;
+
+		TP_STORE(&d->bottom, b + 1);
+	}
+
+	return task;
+}
+
+ipcl_task_t *
+ipcl_deque_steal(ipcl_deque_t *d)
+{
+	int64_t t = TP_LOAD_ACQ(&d->top);
+
+	TP_FENCE();
+
+	int64_t b = TP_LOAD_ACQ(&d->bottom);
+
+	if(t >= b)
+		return NULL;
+
+	ipcl_deque_array_t *a = (ipcl_deque_array_t *) TP_LOADP(&d->array);
+	ipcl_task_t *task = (ipcl_task_t *) TP_LOADP(&a->slots[t & (a->size - 1)]);
+
+	/* lost to the owner or another thief */
+	if(!TP_CAS(&d->top, t, t + 1))
+		return NULL;
+
+	return task;
+}
+
+void
+ipcl_deque_free(ipcl_deque_t *d)
+{
+	ipcl_deque_array_t *a = d->array;
+
+	while(a)
+	{
+		ipcl_deque_array_t *prev = a->prev;
+
+		pcl_free(a);
+		a = prev;
+	}
+
+	d->array = NULL;
+}
@@ -0,0 +1,133 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_threadpool.h"
+#include <pcl/alloc.h>
+#include <pcl/sysinfo.h>
+
+/* pcl_thread_ex dispatches PCL_EVENT_THREADINIT before this runs */
+static void
+worker_start(void *arg)
+{
+	ipcl_worker_t *w = arg;
+	pcl_threadpool_t *tp = w->tp;
+
+	pcl_tls_set(tp->key, w);
+
+	while(true)
+	{
+		ipcl_task_t *task = ipcl_threadpool_find(tp, w);
+
+		if(task)
+		{
+			ipcl_threadpool_run(tp, task);
+			continue;
+		}
+
+		pthread_mutex_lock(&tp->lock);
+		TP_FETCH_ADD(&tp->sleepers, 1);
+
+		while(TP_LOAD_SEQ(&tp->queued) <= 0 && !tp->shutdown)
+			pthread_cond_wait(&tp->work, &tp->lock);
+
+		TP_FETCH_ADD(&tp->sleepers, -1);
+
+		/* on shutdown, leave once nothing is queued */
+		bool finished = tp->shutdown && TP_LOAD_SEQ(&tp->queued) <= 0;
+
+		pthread_mutex_unlock(&tp->lock);
+
+		if(finished)
+			break;
+	}
+}
+
+pcl_threadpool_t *
+pcl_threadpool(int nthreads)
+{
+	if(nthreads < 0)
+		return R_SETERRMSG(NULL, PCL_EINVAL, "invalid number of threads: %d", nthreads);
+
+	if(nthreads == 0)
+	{
+		pcl_sysinfo_t info;
+
+		pcl_sysinfo(&info);
+		nthreads = info.cpu_cores > 0 ? info.cpu_cores : 1;
+	}
+
+	pcl_threadpool_t *tp = pcl_zalloc(sizeof(pcl_threadpool_t));
+
+	if(pcl_tls_alloc(&tp->key, NULL))
+	{
+		pcl_free(tp);
+		return R_TRC(NULL);
+	}
+
+	tp->workers = pcl_zalloc(nthreads * sizeof(ipcl_worker_t *));
+	tp->inject = pcl_queue(NULL);
+	pthread_mutex_init(&tp->injectlock, NULL);
+	pthread_mutex_init(&tp->lock, NULL);
+	pthread_cond_init(&tp->work, NULL);
+	pthread_cond_init(&tp->done, NULL);
+
+	/* all workers must exist before any of them starts stealing */
+	for(int i = 0; i < nthreads; i++)
+	{
+		ipcl_worker_t *w = pcl_zalloc(sizeof(ipcl_worker_t));
+
+		ipcl_deque_init(&w->deque);
+		w->tp = tp;
+		w->seed = 2654435761u * (uint32_t) (i + 1);
+		tp->workers[i] = w;
+	}
+
+	tp->nworkers = nthreads;
+
+	pcl_thread_attr_t attr;
+
+	pcl_thread_attr_init(&attr);
+	attr.name = "pcl-threadpool";
+	attr.joinable = true;
+
+	for(int i = 0; i < nthreads; i++)
+	{
+		if(pcl_thread_ex(&tp->workers[i]->thread, &attr, worker_start, tp->workers[i]))
+		{
+			pcl_threadpool_free(tp);
+			return R_TRC(NULL);
+		}
+
+		tp->workers[i]->started = true;
+	}
+
+	return tp;
+}
@@ -0,0 +1,106 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_threadpool.h"
+
+typedef struct
+{
+	pcl_threadpool_range_t body;
+	void *arg;
+	uint64_t next;
+	uint64_t end;
+	uint64_t grain;
+
+	/* helper tasks that have not finished */
+	int64_t helpers;
+	pcl_threadpool_t *tp;
+} range_t;
+
+static void
+run_chunks(range_t *r)
+{
+	while(true)
+	{
+		uint64_t begin = (uint64_t) TP_FETCH_ADD(&r->next, r->grain);
+
+		if(begin >= r->end)
+			break;
+
+		uint64_t end = r->end - begin > r->grain ? begin + r->grain : r->end;
+
+		r->body((size_t) begin, (size_t) end, r->arg);
+	}
+}
+
+static void
+helper(void *arg)
+{
+	range_t *r = arg;
+
+	run_chunks(r);
+
+	/* r lives on the caller's stack, it may be gone after this */
+	ipcl_threadpool_done(r->tp, &r->helpers);
+}
+
+int
+pcl_threadpool_for(pcl_threadpool_t *tp, size_t begin, size_t end, size_t grain,
+	pcl_threadpool_range_t body, void *arg)
+{
+	if(!tp || !body)
+		return BADARG();
+
+	if(end <= begin)
+		return 0;
+
+	uint64_t count = end - begin;
+
+	if(grain == 0)
+	{
+		grain = (size_t) (count / ((uint64_t) tp->nworkers * 4));
+		if(grain == 0)
+			grain = 1;
+	}
+
+	uint64_t chunks = (count + grain - 1) / grain;
+	range_t r = {.body = body, .arg = arg, .next = begin, .end = end, .grain = grain, .tp = tp};
+
+	/* the caller runs chunks too, so one helper per worker at most */
+	r.helpers = (int64_t) (chunks - 1 < (uint64_t) tp->nworkers ? chunks - 1 : (uint64_t) tp->nworkers);
+
+	for(int64_t i = 0, n = r.helpers; i < n; i++)
+		pcl_threadpool_submit(tp, helper, &r);
+
+	run_chunks(&r);
+	ipcl_threadpool_join(tp, &r.helpers);
+
+	return 0;
+}
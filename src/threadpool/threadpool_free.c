@@ -0,0 +1,72 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_threadpool.h"
+#include <pcl/alloc.h>
+
+int
+pcl_threadpool_free(pcl_threadpool_t *tp)
+{
+	if(!tp)
+		return 0;
+
+	/* the calling task would be joining its own worker */
+	if(pcl_tls_get(tp->key))
+		return SETERRMSG(PCL_EDEADLK, "cannot free a thread pool from one of its tasks", 0);
+
+	pthread_mutex_lock(&tp->lock);
+	tp->shutdown = true;
+	pthread_cond_broadcast(&tp->work);
+	pthread_mutex_unlock(&tp->lock);
+
+	for(int i = 0; i < tp->nworkers; i++)
+	{
+		if(tp->workers[i]->started)
+			pthread_join(tp->workers[i]->thread, NULL);
+	}
+
+	/* workers steal from each other until they all exited */
+	for(int i = 0; i < tp->nworkers; i++)
+	{
+		ipcl_deque_free(&tp->workers[i]->deque);
+		pcl_free(tp->workers[i]);
+	}
+
+	pcl_queue_free(tp->inject);
+	pthread_mutex_destroy(&tp->injectlock);
+	pthread_mutex_destroy(&tp->lock);
+	pthread_cond_destroy(&tp->work);
+	pthread_cond_destroy(&tp->done);
+	pcl_tls_free(tp->key);
+	pcl_free(tp->workers);
+	pcl_free(tp);
+	return 0;
+}
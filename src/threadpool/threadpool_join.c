@@ -0,0 +1,93 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_threadpool.h"
+#include <pcl/time.h>
+
+void
+ipcl_threadpool_done(pcl_threadpool_t *tp, int64_t *counter)
+{
+	if(TP_FETCH_ADD(counter, -1) == 1 && TP_LOAD_SEQ(&tp->waiters) > 0)
+	{
+		pthread_mutex_lock(&tp->lock);
+		pthread_cond_broadcast(&tp->done);
+		pthread_mutex_unlock(&tp->lock);
+	}
+}
+
+void
+ipcl_threadpool_join(pcl_threadpool_t *tp, int64_t *counter)
+{
+	ipcl_worker_t *w = pcl_tls_get(tp->key);
+
+	while(TP_LOAD_ACQ(counter) > 0)
+	{
+		/* a worker helps out, the counter may depend on tasks queued behind it */
+		if(w)
+		{
+			ipcl_task_t *task = ipcl_threadpool_find(tp, w);
+
+			if(task)
+			{
+				ipcl_threadpool_run(tp, task);
+				continue;
+			}
+		}
+
+		pthread_mutex_lock(&tp->lock);
+		TP_FETCH_ADD(&tp->waiters, 1);
+
+		if(TP_LOAD_SEQ(counter) > 0)
+		{
+			if(w)
+			{
+				/* briefly, new tasks do not signal done */
+				pcl_time_t now = pcl_time();
+				struct timespec ts = {.tv_sec = now.sec, .tv_nsec = now.nsec + 1000000};
+
+				if(ts.tv_nsec >= PCL_NSECS)
+				{
+					ts.tv_sec++;
+					ts.tv_nsec -= PCL_NSECS;
+				}
+
+				pthread_cond_timedwait(&tp->done, &tp->lock, &ts);
+			}
+			else
+			{
+				pthread_cond_wait(&tp->done, &tp->lock);
+			}
+		}
+
+		TP_FETCH_ADD(&tp->waiters, -1);
+		pthread_mutex_unlock(&tp->lock);
+	}
+}
@@ -0,0 +1,128 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_threadpool.h"
+#include <pcl/alloc.h>
+
+void
+ipcl_threadpool_enqueue(pcl_threadpool_t *tp, ipcl_task_t *task)
+{
+	ipcl_worker_t *w = pcl_tls_get(tp->key);
+
+	TP_FETCH_ADD(&tp->pending, 1);
+
+	if(w)
+	{
+		ipcl_deque_push(&w->deque, task);
+	}
+	else
+	{
+		pthread_mutex_lock(&tp->injectlock);
+		pcl_queue_add(tp->inject, task);
+		TP_FETCH_ADD(&tp->injected, 1);
+		pthread_mutex_unlock(&tp->injectlock);
+	}
+
+	/* Pairs with the idle check in the worker loop: either the worker sees queued > 0 or
+	 * this sees it sleeping and signals under the lock it waits with.
+	 */
+	TP_FETCH_ADD(&tp->queued, 1);
+
+	if(TP_LOAD_SEQ(&tp->sleepers) > 0)
+	{
+		pthread_mutex_lock(&tp->lock);
+		pthread_cond_signal(&tp->work);
+		pthread_mutex_unlock(&tp->lock);
+	}
+}
+
+ipcl_task_t *
+ipcl_threadpool_find(pcl_threadpool_t *tp, ipcl_worker_t *w)
+{
+	ipcl_task_t *task = w ? ipcl_deque_take(&w->deque) : NULL;
+
+	if(!task && TP_LOAD(&tp->injected) > 0)
+	{
+		pthread_mutex_lock(&tp->injectlock);
+
+		if((task = pcl_queue_remove(tp->inject)))
+			TP_FETCH_ADD(&tp->injected, -1);
+
+		pthread_mutex_unlock(&tp->injectlock);
+	}
+
+	if(!task)
+	{
+		/* steal, starting at a random victim to spread contention */
+		uint32_t start = 0;
+
+		if(w)
+		{
+			w->seed ^= w->seed << 13;
+			w->seed ^= w->seed >> 17;
+			w->seed ^= w->seed << 5;
+			start = w->seed;
+		}
+
+		for(int i = 0; i < tp->nworkers && !task; i++)
+		{
+			ipcl_worker_t *victim = tp->workers[(start + i) % tp->nworkers];
+
+			if(victim != w)
+				task = ipcl_deque_steal(&victim->deque);
+		}
+	}
+
+	if(task)
+		TP_FETCH_ADD(&tp->queued, -1);
+
+	return task;
+}
+
+void
+ipcl_threadpool_run(pcl_threadpool_t *tp, ipcl_task_t *task)
+{
+	if(task->routine)
+	{
+		task->routine(task->arg);
+	}
+	else
+	{
+		pcl_future_t *f = task->future;
+
+		f->result = task->task(task->arg);
+		ipcl_threadpool_done(tp, &f->pending);
+		pcl_future_free(f);
+	}
+
+	pcl_free(task);
+	ipcl_threadpool_done(tp, &tp->pending);
+}
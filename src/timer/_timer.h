@@ -0,0 +1,122 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LIBPCL__TIMER_H
+#define LIBPCL__TIMER_H
+
+#include <pcl/timer.h>
+#include <pcl/error.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TIMER_LEVELS 4
+#define TIMER_ROOTBITS 8
+#define TIMER_LEVELBITS 6
+#define TIMER_ROOTSIZE (1 << TIMER_ROOTBITS)
+#define TIMER_ROOTMASK (TIMER_ROOTSIZE - 1)
+#define TIMER_LEVELSIZE (1 << TIMER_LEVELBITS)
+#define TIMER_LEVELMASK (TIMER_LEVELSIZE - 1)
+
+/* furthest tick a timer can be placed at, relative to the current tick */
+#define TIMER_MAXDELTA ((uint64_t) 1 << (TIMER_ROOTBITS + (TIMER_LEVELS - 1) * TIMER_LEVELBITS))
+
+/* timers are allocated in slabs and recycled through a free list */
+#define TIMER_SLABSIZE 256
+
+/* circular doubly linked list, slots are list heads */
+typedef struct tag_ipcl_timer_link
+{
+	struct tag_ipcl_timer_link *next;
+	struct tag_ipcl_timer_link *prev;
+} ipcl_timer_link_t;
+
+struct tag_pcl_timer
+{
+	/* must be first, links are cast to timers */
+	ipcl_timer_link_t link;
+	uint64_t expires;
+	pcl_timer_handler_t handler;
+	void *udata;
+	pcl_timerwheel_t *tw;
+	bool pending;
+};
+
+typedef struct tag_ipcl_timer_slab
+{
+	struct tag_ipcl_timer_slab *next;
+	pcl_timer_t timers[TIMER_SLABSIZE];
+} ipcl_timer_slab_t;
+
+/* The root level holds timers expiring within TIMER_ROOTSIZE ticks, one slot per tick. Each
+ * higher level slot covers a whole lower level and is cascaded down when the lower level
+ * wraps around.
+ */
+struct tag_pcl_timerwheel
+{
+	pcl_clock_t start;
+	pcl_clock_t resolution;
+
+	/* next tick to process */
+	uint64_t tick;
+	size_t count;
+
+	/* timer whose handler is running */
+	pcl_timer_t *firing;
+
+	ipcl_timer_link_t root[TIMER_ROOTSIZE];
+	ipcl_timer_link_t levels[TIMER_LEVELS - 1][TIMER_LEVELSIZE];
+
+	pcl_timer_t *free;
+	ipcl_timer_slab_t *slabs;
+};
+
+/* convert a pcl_clock value to a tick, rounding up */
+PCL_PRIVATE uint64_t ipcl_timer_tick(pcl_timerwheel_t *tw, pcl_clock_t clock);
+
+/* place a timer in the slot for its expiry */
+PCL_PRIVATE void ipcl_timer_insert(pcl_timerwheel_t *tw, pcl_timer_t *timer);
+
+/* remove a timer from its slot */
+PCL_PRIVATE void ipcl_timer_unlink(pcl_timer_t *timer);
+
+/* move all timers in src to the empty list head dst */
+PCL_PRIVATE void ipcl_timer_splice(ipcl_timer_link_t *src, ipcl_timer_link_t *dst);
+
+/* return a timer to the free list */
+PCL_PRIVATE void ipcl_timer_release(pcl_timerwheel_t *tw, pcl_timer_t *timer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPCL__TIMER_H
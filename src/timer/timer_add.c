@@ -0,0 +1,76 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_timer.h"
+#include <pcl/alloc.h>
+#include <pcl/time.h>
+
+pcl_timer_t *
+pcl_timer_add(pcl_timerwheel_t *tw, pcl_clock_t timeout, pcl_timer_handler_t handler,
+	void *udata)
+{
+	if(!tw || !handler || timeout < 0)
+		return R_SETERR(NULL, PCL_EINVAL);
+
+	if(!tw->free)
+	{
+		ipcl_timer_slab_t *slab = pcl_malloc(sizeof(ipcl_timer_slab_t));
+
+		slab->next = tw->slabs;
+		tw->slabs = slab;
+
+		for(int i = 0; i < TIMER_SLABSIZE; i++)
+			ipcl_timer_release(tw, &slab->timers[i]);
+	}
+
+	pcl_timer_t *timer = tw->free;
+
+	tw->free = (pcl_timer_t *) timer->link.next;
+	timer->expires = ipcl_timer_tick(tw, pcl_clock() + timeout);
+	timer->handler = handler;
+	timer->udata = udata;
+	timer->tw = tw;
+	timer->pending = true;
+
+	ipcl_timer_insert(tw, timer);
+	tw->count++;
+
+	return timer;
+}
+
+void
+ipcl_timer_release(pcl_timerwheel_t *tw, pcl_timer_t *timer)
+{
+	timer->pending = false;
+	timer->handler = NULL;
+	timer->link.next = (ipcl_timer_link_t *) tw->free;
+	tw->free = timer;
+}
@@ -0,0 +1,105 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_timer.h"
+#include <math.h>
+
+uint64_t
+ipcl_timer_tick(pcl_timerwheel_t *tw, pcl_clock_t clock)
+{
+	if(clock <= tw->start)
+		return 0;
+
+	return (uint64_t) ceill((clock - tw->start) / tw->resolution);
+}
+
+void
+ipcl_timer_insert(pcl_timerwheel_t *tw, pcl_timer_t *timer)
+{
+	/* overdue timers fire on the next tick processed */
+	uint64_t expires = timer->expires > tw->tick ? timer->expires : tw->tick;
+	uint64_t delta = expires - tw->tick;
+	ipcl_timer_link_t *slot;
+
+	if(delta < TIMER_ROOTSIZE)
+	{
+		slot = &tw->root[expires & TIMER_ROOTMASK];
+	}
+	else
+	{
+		/* beyond the wheel, park in the last level and re-evaluate when cascaded */
+		if(delta >= TIMER_MAXDELTA)
+		{
+			expires = tw->tick + TIMER_MAXDELTA - 1;
+			delta = TIMER_MAXDELTA - 1;
+		}
+
+		int level = 0;
+		int shift = TIMER_ROOTBITS;
+
+		while(delta >= ((uint64_t) 1 << (shift + TIMER_LEVELBITS)))
+		{
+			level++;
+			shift += TIMER_LEVELBITS;
+		}
+
+		slot = &tw->levels[level][(expires >> shift) & TIMER_LEVELMASK];
+	}
+
+	timer->link.next = slot;
+	timer->link.prev = slot->prev;
+	slot->prev->next = &timer->link;
+	slot->prev = &timer->link;
+}
+
+void
+ipcl_timer_unlink(pcl_timer_t *timer)
+{
+	timer->link.prev->next = timer->link.next;
+	timer->link.next->prev = timer->link.prev;
+	timer->link.next = timer->link.prev = NULL;
+}
+
+void
+ipcl_timer_splice(ipcl_timer_link_t *src, ipcl_timer_link_t *dst)
+{
+	if(src->next == src)
+	{
+		dst->next = dst->prev = dst;
+		return;
+	}
+
+	dst->next = src->next;
+	dst->prev = src->prev;
+	dst->next->prev = dst;
+	dst->prev->next = dst;
+	src->next = src->prev = src;
+}
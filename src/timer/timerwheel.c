@@ -0,0 +1,55 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_timer.h"
+#include <pcl/alloc.h>
+#include <pcl/time.h>
+
+pcl_timerwheel_t *
+pcl_timerwheel(pcl_clock_t resolution)
+{
+	if(resolution < 0)
+		return R_SETERRMSG(NULL, PCL_EINVAL, "invalid timer resolution: %Lf", resolution);
+
+	pcl_timerwheel_t *tw = pcl_zalloc(sizeof(pcl_timerwheel_t));
+
+	tw->resolution = resolution > 0 ? resolution : PCL_TIMER_RESOLUTION;
+	tw->start = pcl_clock();
+
+	for(int i = 0; i < TIMER_ROOTSIZE; i++)
+		tw->root[i].next = tw->root[i].prev = &tw->root[i];
+
+	for(int l = 0; l < TIMER_LEVELS - 1; l++)
+		for(int i = 0; i < TIMER_LEVELSIZE; i++)
+			tw->levels[l][i].next = tw->levels[l][i].prev = &tw->levels[l][i];
+
+	return tw;
+}
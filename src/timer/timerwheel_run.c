@@ -0,0 +1,115 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "_timer.h"
+#include <pcl/time.h>
+
+/* move a higher level slot down the wheel, returns the slot index */
+static int
+cascade(pcl_timerwheel_t *tw, int level)
+{
+	int index = (int) (tw->tick >> (TIMER_ROOTBITS + level * TIMER_LEVELBITS)) & TIMER_LEVELMASK;
+	ipcl_timer_link_t list;
+
+	ipcl_timer_splice(&tw->levels[level][index], &list);
+
+	while(list.next != &list)
+	{
+		pcl_timer_t *timer = (pcl_timer_t *) list.next;
+
+		ipcl_timer_unlink(timer);
+		ipcl_timer_insert(tw, timer);
+	}
+
+	return index;
+}
+
+int
+pcl_timerwheel_run(pcl_timerwheel_t *tw, pcl_clock_t now)
+{
+	if(!tw)
+		return BADARG();
+
+	int fired = 0;
+
+	if(now <= 0)
+		now = pcl_clock();
+
+	if(now < tw->start)
+		return 0;
+
+	/* last tick that has fully started, timers expiring at or before it are due */
+	uint64_t target = (uint64_t) ((now - tw->start) / tw->resolution);
+
+	while(tw->tick <= target)
+	{
+		if(tw->count == 0)
+		{
+			tw->tick = target + 1;
+			break;
+		}
+
+		int index = (int) (tw->tick & TIMER_ROOTMASK);
+
+		/* root wrapped around, cascade each level until one has not wrapped */
+		if(index == 0)
+		{
+			for(int level = 0; level < TIMER_LEVELS - 1 && cascade(tw, level) == 0; level++)
+				;
+		}
+
+		ipcl_timer_link_t list;
+
+		ipcl_timer_splice(&tw->root[index], &list);
+
+		/* advance first, timers added by handlers must not land in this slot */
+		tw->tick++;
+
+		while(list.next != &list)
+		{
+			pcl_timer_t *timer = (pcl_timer_t *) list.next;
+
+			ipcl_timer_unlink(timer);
+			timer->pending = false;
+			tw->count--;
+
+			tw->firing = timer;
+			timer->handler(timer, timer->udata);
+			tw->firing = NULL;
+			fired++;
+
+			if(!timer->pending)
+				ipcl_timer_release(tw, timer);
+		}
+	}
+
+	return fired;
+}
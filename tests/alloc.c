@@ -0,0 +1,165 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "test.h"
+#include <pcl/alloc.h>
+#include <pcl/thread.h>
+#include <pcl/atomic.h>
+#include <pcl/error.h>
+#include <pcl/time.h>
+#include <string.h>
+
+#define THREADS 4
+#define BLOCKS 2000
+
+static void *blocks[THREADS][BLOCKS];
+static pcl_atomic_t corrupt;
+static pcl_atomic_t done;
+
+static size_t
+block_size(int i)
+{
+	/* cycles through every small class plus some large sizes */
+	return i % 10 == 9 ? (size_t) (1500 + i) : (size_t) (i * 37) % 1025;
+}
+
+static void
+churn(void *arg)
+{
+	const pcl_allocator_t *a = pcl_allocator_tcache();
+	int id = (int) (intptr_t) arg;
+
+	for(int round = 0; round < 4; round++)
+	{
+		for(int i = 0; i < BLOCKS; i++)
+		{
+			blocks[id][i] = a->alloc(a->ctx, block_size(i));
+			memset(blocks[id][i], id + 1, block_size(i));
+		}
+
+		/* keep the last round alive for the main thread to release */
+		for(int i = 0; i < BLOCKS; i++)
+		{
+			unsigned char *p = blocks[id][i];
+
+			for(size_t k = 0; k < block_size(i); k++)
+				if(p[k] != id + 1)
+					pcl_atomic_add_fetch(&corrupt, 1);
+
+			if(round < 3)
+				a->release(a->ctx, p);
+		}
+	}
+
+	pcl_atomic_add_fetch(&done, 1);
+}
+
+/**$ The allocator can only be replaced before pcl_init */
+TESTCASE(alloc_allocator)
+{
+	ASSERT_TRUE(pcl_get_allocator() == pcl_allocator_libc(), "libc is not the default");
+	ASSERT_STREQ(pcl_allocator_tcache()->name, "tcache", "wrong name");
+	ASSERT_NULL(pcl_set_allocator(pcl_allocator_tcache()), "allocator changed after pcl_init");
+	ASSERT_INTEQ(pcl_errno, PCL_EBUSY, "wrong error");
+	ASSERT_TRUE(pcl_get_allocator() == pcl_allocator_libc(), "allocator changed after failure");
+	return true;
+}
+
+/**$ Thread-caching allocator reuses, zeroes and resizes blocks */
+TESTCASE(alloc_tcache)
+{
+	const pcl_allocator_t *a = pcl_allocator_tcache();
+
+	for(size_t n = 0; n <= 4096; n += 8)
+	{
+		unsigned char *p = a->alloc(a->ctx, n);
+
+		ASSERT_NOTNULL(p, "alloc failed");
+		ASSERT_INTEQ((uintptr_t) p % 16, 0, "block is not 16 byte aligned");
+		memset(p, 0xAB, n);
+		a->release(a->ctx, p);
+	}
+
+	/* the thread cache hands back the block it just took */
+	void *p = a->alloc(a->ctx, 100);
+	a->release(a->ctx, p);
+	ASSERT_TRUE(a->alloc(a->ctx, 112) == p, "same class was not reused");
+	memset(p, 0xFF, 112);
+	a->release(a->ctx, p);
+
+	unsigned char *z = a->zalloc(a->ctx, 100);
+	ASSERT_TRUE(z == p, "zalloc did not reuse the block");
+
+	for(int i = 0; i < 100; i++)
+		ASSERT_INTEQ(z[i], 0, "zalloc returned dirty memory");
+
+	/* grow within the class, into a larger class and past the small limit */
+	for(int i = 0; i < 100; i++)
+		z[i] = (unsigned char) i;
+
+	ASSERT_TRUE(a->resize(a->ctx, z, 110) == z, "resize within class moved");
+	size_t sizes[] = {500, 4000, 70000, 2000, 100};
+
+	for(int k = 0; k < countof(sizes); k++)
+	{
+		z = a->resize(a->ctx, z, sizes[k]);
+		ASSERT_NOTNULL(z, "resize failed");
+
+		for(int i = 0; i < 100; i++)
+			ASSERT_INTEQ(z[i], i, "resize lost data");
+	}
+
+	a->release(a->ctx, z);
+	return true;
+}
+
+/**$ Thread-caching allocator under concurrent and cross-thread use */
+TESTCASE(alloc_tcache_threads)
+{
+	const pcl_allocator_t *a = pcl_allocator_tcache();
+
+	corrupt = done = 0;
+
+	for(int i = 0; i < THREADS; i++)
+		pcl_thread(NULL, churn, (void *) (intptr_t) i);
+
+	while(pcl_atomic_fetch(&done) < THREADS)
+		pcl_sleep(1000000, NULL, 0);
+
+	ASSERT_INTEQ(corrupt, 0, "blocks overlapped");
+
+	/* blocks from exited threads are released here */
+	for(int id = 0; id < THREADS; id++)
+		for(int i = 0; i < BLOCKS; i++)
+			a->release(a->ctx, blocks[id][i]);
+
+	return true;
+}
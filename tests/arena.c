@@ -0,0 +1,154 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "test.h"
+#include <pcl/arena.h>
+#include <pcl/array.h>
+#include <pcl/buf.h>
+#include <pcl/error.h>
+#include <string.h>
+
+/**$ Arena allocations honor alignment and grow across chunks */
+TESTCASE(arena_alloc)
+{
+	pcl_arena_t *a = pcl_arena(1024);
+
+	char *s = pcl_arena_strdup(a, "hello");
+	ASSERT_STREQ(s, "hello", "strdup failed");
+
+	for(int i = 0; i < 200; i++)
+	{
+		char *p = pcl_arena_alloc(a, (size_t) i % 50 + 1);
+
+		ASSERT_NOTNULL(p, "alloc failed");
+		ASSERT_INTEQ((uintptr_t) p % PCL_ARENA_ALIGN, 0, "not aligned");
+		memset(p, i, (size_t) i % 50 + 1);
+	}
+
+	char *big = pcl_arena_aligned(a, 256, 256);
+	ASSERT_INTEQ((uintptr_t) big % 256, 0, "not aligned to 256");
+	ASSERT_NULL(pcl_arena_aligned(a, 8, 3), "accepted bad alignment");
+	ASSERT_INTEQ(pcl_errno, PCL_EINVAL, "wrong error");
+
+	/* larger than a chunk */
+	char *huge = pcl_arena_zalloc(a, 5000);
+	ASSERT_NOTNULL(huge, "oversized alloc failed");
+	ASSERT_INTEQ(huge[4999], 0, "zalloc not zeroed");
+
+	/* the latest allocation resizes in place */
+	char *r = pcl_arena_alloc(a, 16);
+	ASSERT_TRUE(pcl_arena_realloc(a, r, 16, 64) == r, "last allocation moved");
+	pcl_arena_alloc(a, 16);
+	memcpy(r, "0123456789", 11);
+	char *r2 = pcl_arena_realloc(a, r, 64, 128);
+	ASSERT_TRUE(r2 != r, "earlier allocation grew in place");
+	ASSERT_STREQ(r2, "0123456789", "realloc lost data");
+	ASSERT_STREQ(s, "hello", "earlier allocation was overwritten");
+
+	pcl_arena_free(a);
+	return true;
+}
+
+/**$ Rewind releases back to a savepoint and reset keeps chunks */
+TESTCASE(arena_rewind)
+{
+	pcl_arena_t *a = pcl_arena(4096);
+	pcl_arena_mark_t outer, inner;
+
+	pcl_arena_mark(a, &outer);
+	ASSERT_INTEQ(pcl_arena_used(a), 0, "new arena in use");
+
+	char *keep = pcl_arena_strdup(a, "keep");
+	size_t used = pcl_arena_used(a);
+
+	pcl_arena_mark(a, &inner);
+	char *first = pcl_arena_alloc(a, 8);
+
+	for(int i = 0; i < 100; i++)
+		pcl_arena_alloc(a, 200);
+
+	pcl_arena_alloc(a, 10000);
+	ASSERT_TRUE(pcl_arena_used(a) > 30000, "allocations not counted");
+
+	pcl_arena_rewind(a, &inner);
+	ASSERT_INTEQ(pcl_arena_used(a), used, "rewind did not restore usage");
+	ASSERT_STREQ(keep, "keep", "rewind released memory before the mark");
+
+	/* the next allocation reuses the rewound space */
+	char *next = pcl_arena_alloc(a, 8);
+	ASSERT_TRUE(next == first, "rewound space not reused");
+
+	pcl_arena_rewind(a, &outer);
+	ASSERT_INTEQ(pcl_arena_used(a), 0, "rewind to start left memory in use");
+
+	for(int i = 0; i < 100; i++)
+		pcl_arena_alloc(a, 200);
+
+	pcl_arena_reset(a);
+	ASSERT_INTEQ(pcl_arena_used(a), 0, "reset left memory in use");
+	ASSERT_NOTNULL(pcl_arena_alloc(a, 200), "alloc after reset failed");
+
+	pcl_arena_free(a);
+	return true;
+}
+
+/**$ Buffers and arrays can live in an arena */
+TESTCASE(arena_containers)
+{
+	pcl_arena_t *a = pcl_arena(0);
+	pcl_buf_t *b = pcl_buf_arena(a, 4, PclBufText);
+
+	ASSERT_NOTNULL(b, "buf failed");
+	ASSERT_TRUE(b->arena == a, "buf has no arena");
+
+	for(int i = 0; i < 100; i++)
+		pcl_buf_putf(b, "%d,", i);
+
+	ASSERT_TRUE(strncmp(b->data, "0,1,2,3,", 8) == 0, "wrong buf contents");
+	ASSERT_TRUE(strstr(b->data, "98,99,") != NULL, "buf lost data");
+
+	pcl_buf_t *copy = pcl_buf_arena(a, 0, PclBufText);
+	ASSERT_NOTNULL(pcl_buf_copy(copy, b), "copy failed");
+	ASSERT_STREQ(copy->data, b->data, "wrong copy");
+	ASSERT_NULL(pcl_buf_free(b), "free failed");
+
+	pcl_array_t *arr = pcl_array_arena(a, 2, NULL);
+
+	for(intptr_t i = 0; i < 100; i++)
+		ASSERT_INTEQ(pcl_array_append(arr, (void *) i), (int) i + 1, "append failed");
+
+	for(intptr_t i = 0; i < 100; i++)
+		ASSERT_TRUE(arr->elements[i] == (void *) i, "wrong element");
+
+	pcl_array_free(arr);
+	pcl_arena_free(a);
+	return true;
+}
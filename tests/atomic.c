@@ -0,0 +1,120 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "test.h"
+#include <pcl/atomic.h>
+#include <pcl/threadpool.h>
+
+typedef struct
+{
+	int64_t hits;
+	int32_t flags;
+	void *last;
+} atomic_stats_t;
+
+static void
+count_hits(size_t begin, size_t end, void *arg)
+{
+	atomic_stats_t *stats = arg;
+
+	for(size_t i = begin; i < end; i++)
+	{
+		pcl_atomic_fetch_add64(&stats->hits, 1, PCL_ATOMIC_RELAXED);
+		pcl_atomic_fetch_or32(&stats->flags, 1 << (i % 31), PCL_ATOMIC_RELAXED);
+		pcl_atomic_storeptr(&stats->last, (void *) (i + 1), PCL_ATOMIC_RELEASE);
+	}
+}
+
+/**$ Bitwise, exchange and compare and exchange operations with explicit memory orders */
+TESTCASE(atomic_ops)
+{
+	int32_t v32 = 0x0F;
+	int64_t v64 = 100;
+	void *ptr = NULL;
+	int dummy;
+
+	ASSERT_INTEQ(pcl_atomic_fetch_or32(&v32, 0xF0, PCL_ATOMIC_RELAXED), 0x0F, "fetch_or32");
+	ASSERT_INTEQ(pcl_atomic_fetch_and32(&v32, 0x3C, PCL_ATOMIC_ACQ_REL), 0xFF, "fetch_and32");
+	ASSERT_INTEQ(pcl_atomic_fetch_xor32(&v32, 0xFF, PCL_ATOMIC_SEQ_CST), 0x3C, "fetch_xor32");
+	ASSERT_INTEQ(pcl_atomic_load32(&v32, PCL_ATOMIC_ACQUIRE), 0xC3, "load32");
+
+	ASSERT_INTEQ(pcl_atomic_fetch_add64(&v64, -1, PCL_ATOMIC_RELAXED), 100, "fetch_add64");
+	ASSERT_INTEQ(pcl_atomic_exchange64(&v64, 7, PCL_ATOMIC_ACQ_REL), 99, "exchange64");
+
+	int64_t expected = 8;
+	ASSERT_TRUE(!pcl_atomic_cas64(&v64, &expected, 9, PCL_ATOMIC_SEQ_CST), "cas64 should fail");
+	ASSERT_INTEQ(expected, 7, "cas64 did not return current value");
+
+	/* weak CAS may fail spuriously, loop like callers do */
+	while(!pcl_atomic_cas64_weak(&v64, &expected, expected * 2, PCL_ATOMIC_RELEASE))
+		;
+	ASSERT_INTEQ(pcl_atomic_load64(&v64, PCL_ATOMIC_RELAXED), 14, "cas64_weak");
+
+	void *want = NULL;
+	ASSERT_TRUE(pcl_atomic_casptr(&ptr, &want, &dummy, PCL_ATOMIC_ACQ_REL), "casptr failed");
+	ASSERT_TRUE(pcl_atomic_loadptr(&ptr, PCL_ATOMIC_ACQUIRE) == &dummy, "loadptr");
+	ASSERT_TRUE(pcl_atomic_exchangeptr(&ptr, NULL, PCL_ATOMIC_SEQ_CST) == &dummy, "exchangeptr");
+	ASSERT_NULL(ptr, "exchangeptr did not store");
+
+	/* the old sequentially consistent API */
+	pcl_atomic_t a = 5;
+	ASSERT_INTEQ(pcl_atomic_compare_exchange(&a, 4, 6), 5, "compare_exchange failure");
+	ASSERT_INTEQ(pcl_atomic_compare_exchange(&a, 5, 6), 5, "compare_exchange success");
+	ASSERT_INTEQ(pcl_atomic_add_fetch(&a, 4), 10, "add_fetch");
+
+#ifdef PCL_HAVE_ATOMIC_CAS128
+	_Alignas(16) uint128_t wide = {.low = 1, .high = 2};
+	uint128_t old = {.low = 1, .high = 3};
+
+	ASSERT_TRUE(!pcl_atomic_cas128(&wide, &old, (uint128_t) {.low = 5, .high = 6}), "cas128 should fail");
+	ASSERT_TRUE(old.low == 1 && old.high == 2, "cas128 did not return current value");
+	ASSERT_TRUE(pcl_atomic_cas128(&wide, &old, (uint128_t) {.low = 5, .high = 6}), "cas128 failed");
+	ASSERT_TRUE(wide.low == 5 && wide.high == 6, "cas128 did not store");
+#endif
+
+	pcl_atomic_fence(PCL_ATOMIC_SEQ_CST);
+	return true;
+}
+
+/**$ Relaxed counters and flags updated from many threads */
+TESTCASE(atomic_threads)
+{
+	atomic_stats_t stats = {0};
+	pcl_threadpool_t *tp = pcl_threadpool(4);
+
+	pcl_threadpool_for(tp, 0, 100000, 100, count_hits, &stats);
+	pcl_threadpool_free(tp);
+
+	ASSERT_INTEQ(pcl_atomic_load64(&stats.hits, PCL_ATOMIC_RELAXED), 100000, "lost increments");
+	ASSERT_INTEQ(pcl_atomic_load32(&stats.flags, PCL_ATOMIC_RELAXED), 0x7FFFFFFF, "lost flags");
+	ASSERT_NOTNULL(pcl_atomic_loadptr(&stats.last, PCL_ATOMIC_ACQUIRE), "pointer never stored");
+	return true;
+}
@@ -31,6 +31,7 @@
 
 #include "test.h"
 #include <pcl/buf.h>
+#include <pcl/error.h>
 #include <string.h>
 
 /**$ Put data in binary mode */
@@ -231,3 +232,59 @@ TESTCASE(buf_textw_putchar)
 	return true;
 }
 
+
+/**$ Reserve space and append without capacity checks, then terminate a lazy buffer */
+TESTCASE(buf_reserve_append)
+{
+	pcl_buf_t *b = pcl_buf_lazynul(pcl_buf_init(NULL, 0, PclBufText), true);
+	ASSERT_INTEQ(pcl_buf_reserve(b, 11), 0, "reserve failed");
+	ASSERT_TRUE(b->size > 11, "reserve did not leave room for NUL");
+	pcl_buf_append(b, "Hello", 5);
+	pcl_buf_appendc(b, ' ');
+	pcl_buf_append(b, "World", 5);
+	ASSERT_INTEQ(b->len, 11, "wrong buf length");
+	ASSERT_NOTNULL(pcl_buf_terminate(b), "terminate failed");
+	ASSERT_STREQ(b->data, "Hello World", "wrong buf data contents");
+	pcl_buf_free(b);
+	return true;
+}
+
+/**$ Capped and page-aligned growth strategies */
+TESTCASE(buf_growth)
+{
+	pcl_buf_t *b = pcl_buf_init(NULL, 4, PclBufText);
+	ASSERT_INTEQ(pcl_buf_setgrowth(b, PclBufGrowCapped, 8), 0, "setgrowth capped failed");
+	ASSERT_INTEQ(pcl_buf_putstr(b, "1234567"), 7, "put within cap failed");
+	ASSERT_INTEQ(pcl_buf_putchar(b, '8'), -1, "put beyond cap succeeded");
+	ASSERT_INTEQ(pcl_errno, PCL_EBUF, "wrong error for capped buffer");
+	ASSERT_STREQ(b->data, "1234567", "capped buffer was modified");
+
+	ASSERT_INTEQ(pcl_buf_setgrowth(b, PclBufGrowPage, 0), 0, "setgrowth page failed");
+	ASSERT_INTEQ(pcl_buf_putstr(b, "8"), 1, "put after uncapping failed");
+	ASSERT_INTEQ((int) (b->size % 4096), 0, "size is not page aligned");
+	ASSERT_INTEQ(pcl_buf_setgrowth(b, PclBufGrowGeometric, 50), -1, "accepted shrinking factor");
+	pcl_buf_free(b);
+	return true;
+}
+
+/**$ Formatted puts that do not fit the spare capacity are formatted again after growing */
+TESTCASE(buf_putf_grow)
+{
+	char expect[601];
+	memset(expect, 'x', 600);
+	expect[600] = 0;
+
+	pcl_buf_t *b = pcl_buf_init(NULL, 8, PclBufBinary);
+	ASSERT_INTEQ(pcl_buf_putf(b, "%s", expect), 601, "wrong return value binary putf");
+	ASSERT_INTEQ(b->data[600], 0, "binary string missing NUL");
+	ASSERT_INTEQ(b->data[601], 0, "buf data missing NUL");
+	ASSERT_STREQ(b->data, expect, "wrong binary buf contents");
+	pcl_buf_free(b);
+
+	b = pcl_buf_init(NULL, 8, PclBufTextW);
+	ASSERT_INTEQ(pcl_buf_putf(b, L"%d-%hs", 42, expect), 603, "wrong return value wide putf");
+	ASSERT_INTEQ(((wchar_t *) b->data)[603], 0, "buf data missing NUL");
+	ASSERT_INTEQ(((wchar_t *) b->data)[3], L'x', "wrong wide buf contents");
+	pcl_buf_free(b);
+	return true;
+}
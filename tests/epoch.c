@@ -0,0 +1,180 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "test.h"
+#include <pcl/epoch.h>
+#include <pcl/thread.h>
+#include <pcl/atomic.h>
+#include <pcl/alloc.h>
+#include <pcl/error.h>
+#include <pcl/time.h>
+
+#define READERS 4
+#define UPDATES 2000
+#define MAGIC 0x5EED
+
+typedef struct
+{
+	int magic;
+	int version;
+} config_t;
+
+static config_t *current;
+static pcl_atomic_t freed;
+static pcl_atomic_t stale;
+static pcl_atomic_t running;
+static pcl_atomic_t done;
+
+static void
+config_free(void *item)
+{
+	config_t *c = item;
+
+	/* poison it so a reader that still holds it notices */
+	c->magic = 0;
+	pcl_free(c);
+	pcl_atomic_add_fetch(&freed, 1);
+}
+
+static config_t *
+config_new(int version)
+{
+	config_t *c = pcl_malloc(sizeof(config_t));
+
+	c->magic = MAGIC;
+	c->version = version;
+	return c;
+}
+
+static void
+reader(void *arg)
+{
+	bool qsbr = arg != NULL;
+	int last = 0;
+
+	if(qsbr)
+		pcl_epoch_enter();
+
+	while(pcl_atomic_fetch(&running))
+	{
+		if(!qsbr)
+			pcl_epoch_enter();
+
+		config_t *c = pcl_atomic_loadptr((void **) &current, PCL_ATOMIC_ACQUIRE);
+
+		if(c->magic != MAGIC || c->version < last)
+			pcl_atomic_add_fetch(&stale, 1);
+
+		last = c->version;
+
+		if(qsbr)
+			pcl_epoch_quiescent();
+		else
+			pcl_epoch_exit();
+	}
+
+	if(qsbr)
+		pcl_epoch_exit();
+
+	pcl_atomic_add_fetch(&done, 1);
+}
+
+static void
+count_free(void *item)
+{
+	UNUSED(item);
+	pcl_atomic_add_fetch(&freed, 1);
+}
+
+/**$ Retired items are freed only outside critical sections */
+TESTCASE(epoch_retire)
+{
+	static int items[256];
+
+	freed = 0;
+	ASSERT_INTEQ(pcl_epoch_enter(), 0, "enter failed");
+	ASSERT_INTEQ(pcl_epoch_enter(), 0, "nested enter failed");
+	ASSERT_INTEQ(pcl_epoch_retire(&items[0], count_free), 0, "retire failed");
+	ASSERT_INTEQ(pcl_epoch_synchronize(), -1, "synchronize inside a critical section");
+	ASSERT_INTEQ(pcl_errno, PCL_EDEADLK, "wrong error");
+	pcl_epoch_exit();
+
+	ASSERT_INTEQ(pcl_epoch_reclaim(), 0, "freed while the thread was still inside");
+	pcl_epoch_exit();
+
+	ASSERT_INTEQ(pcl_epoch_retire(&items[1], count_free), 0, "retire failed");
+	ASSERT_INTEQ(pcl_epoch_pending(), 2, "wrong pending count");
+	ASSERT_INTEQ(pcl_epoch_synchronize(), 0, "synchronize failed");
+	ASSERT_INTEQ(pcl_epoch_pending(), 0, "items left after synchronize");
+	ASSERT_INTEQ(freed, 2, "wrong number of items freed");
+
+	/* batches reclaim on their own */
+	for(int i = 0; i < countof(items); i++)
+		pcl_epoch_retire(&items[i], count_free);
+
+	ASSERT_TRUE(freed > 2, "no batch reclamation");
+	ASSERT_TRUE(pcl_epoch_pending() < countof(items), "nothing reclaimed");
+	pcl_epoch_synchronize();
+	ASSERT_INTEQ(freed, countof(items) + 2, "wrong number of items freed");
+	ASSERT_INTEQ(pcl_epoch_retire(NULL, NULL), -1, "retired NULL");
+	return true;
+}
+
+/**$ Readers never see a freed item while a writer keeps replacing it */
+TESTCASE(epoch_threads)
+{
+	freed = stale = done = 0;
+	running = 1;
+	current = config_new(0);
+
+	for(int i = 0; i < READERS; i++)
+		pcl_thread(NULL, reader, i == 0 ? (void *) 1 : NULL);
+
+	for(int i = 1; i <= UPDATES; i++)
+	{
+		config_t *old = pcl_atomic_exchangeptr((void **) &current, config_new(i), PCL_ATOMIC_ACQ_REL);
+		ASSERT_INTEQ(pcl_epoch_retire(old, config_free), 0, "retire failed");
+
+		if(i % 256 == 0)
+			pcl_sleep(1000000, NULL, 0);
+	}
+
+	pcl_atomic_exchange(&running, 0);
+
+	while(pcl_atomic_fetch(&done) < READERS)
+		pcl_sleep(1000000, NULL, 0);
+
+	ASSERT_INTEQ(pcl_epoch_synchronize(), 0, "synchronize failed");
+	ASSERT_INTEQ(stale, 0, "reader saw a freed or older item");
+	ASSERT_INTEQ(freed, UPDATES, "not every replaced item was freed");
+	pcl_free(current);
+	return true;
+}
@@ -0,0 +1,165 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "test.h"
+#include <pcl/event.h>
+#include <pcl/threadpool.h>
+#include <pcl/atomic.h>
+#include <pcl/epoch.h>
+
+#define EVENT_PING (PCL_EVENT_USERBASE + 1)
+#define EVENT_PONG (PCL_EVENT_USERBASE + 2)
+#define EVENT_OTHER (PCL_EVENT_USERBASE + 3)
+
+static pcl_atomic_t all_count;
+static pcl_atomic_t ping_count;
+static pcl_atomic_t pong_count;
+
+static void
+on_all(uint32_t event, void *data)
+{
+	(void) data;
+
+	if(event >= PCL_EVENT_USERBASE)
+		pcl_atomic_add_fetch(&all_count, 1);
+}
+
+/* answers every ping with a pong, dispatched re-entrantly */
+static void
+on_ping(uint32_t event, void *data)
+{
+	(void) event;
+	pcl_atomic_add_fetch(&ping_count, 1);
+	pcl_event_dispatch(EVENT_PONG, data);
+}
+
+static void
+on_pong(uint32_t event, void *data)
+{
+	(void) event;
+	(void) data;
+	pcl_atomic_add_fetch(&pong_count, 1);
+}
+
+static pcl_atomic_t churning;
+
+/* dispatches while the main thread changes subscriptions */
+static void *
+dispatcher(void *arg)
+{
+	(void) arg;
+
+	while(pcl_atomic_fetch(&churning))
+		pcl_event_dispatch(EVENT_PING, NULL);
+
+	return NULL;
+}
+
+static void
+ping(size_t begin, size_t end, void *arg)
+{
+	(void) arg;
+
+	for(size_t i = begin; i < end; i++)
+		pcl_event_dispatch(EVENT_PING, NULL);
+}
+
+/**$ Per-event subscriptions, re-entrant dispatch and concurrent dispatch from many threads */
+TESTCASE(event_dispatch)
+{
+	all_count = ping_count = pong_count = 0;
+
+	pcl_event_register(on_all);
+	pcl_event_subscribe(EVENT_PING, on_ping);
+	pcl_event_subscribe(EVENT_PONG, on_pong);
+
+	pcl_event_dispatch(EVENT_PING, NULL);
+	pcl_event_dispatch(EVENT_OTHER, NULL);
+
+	ASSERT_INTEQ(ping_count, 1, "ping handler not called once");
+	ASSERT_INTEQ(pong_count, 1, "re-entrant pong not dispatched");
+	ASSERT_INTEQ(all_count, 3, "broadcast handler missed events");
+
+	pcl_threadpool_t *tp = pcl_threadpool(4);
+	pcl_threadpool_for(tp, 0, 10000, 0, ping, NULL);
+	pcl_threadpool_free(tp);
+
+	ASSERT_INTEQ(pcl_atomic_fetch(&ping_count), 10001, "concurrent pings lost");
+	ASSERT_INTEQ(pcl_atomic_fetch(&pong_count), 10001, "concurrent pongs lost");
+
+	pcl_event_unsubscribe(EVENT_PONG, on_pong);
+	pcl_event_dispatch(EVENT_PING, NULL);
+	ASSERT_INTEQ(pcl_atomic_fetch(&pong_count), 10001, "unsubscribed handler called");
+
+	pcl_event_unsubscribe(EVENT_PING, on_ping);
+	pcl_event_unregister(on_all);
+	all_count = 0;
+	pcl_event_dispatch(EVENT_PING, NULL);
+	ASSERT_INTEQ(all_count, 0, "unregistered handler called");
+	return true;
+}
+
+/**$ Replaced handler snapshots are reclaimed under subscription churn */
+TESTCASE(event_churn)
+{
+	ping_count = pong_count = 0;
+	churning = 1;
+
+	pcl_threadpool_t *tp = pcl_threadpool(2);
+	pcl_future_t *a = pcl_threadpool_async(tp, dispatcher, NULL);
+	pcl_future_t *b = pcl_threadpool_async(tp, dispatcher, NULL);
+
+	for(int i = 0; i < 1000; i++)
+	{
+		pcl_event_subscribe(EVENT_PONG, on_pong);
+		pcl_event_unsubscribe(EVENT_PONG, on_pong);
+	}
+
+	pcl_atomic_exchange(&churning, 0);
+	pcl_future_wait(a);
+	pcl_future_wait(b);
+	pcl_future_free(a);
+	pcl_future_free(b);
+	pcl_threadpool_free(tp);
+
+	/* without dispatchers, this thread retires every snapshot it replaces */
+	for(int i = 0; i < 1000; i++)
+	{
+		pcl_event_subscribe(EVENT_PONG, on_pong);
+		pcl_event_unsubscribe(EVENT_PONG, on_pong);
+	}
+
+	ASSERT_TRUE(pcl_epoch_pending() <= 2 * PCL_EPOCH_BATCH, "snapshots not reclaimed");
+	ASSERT_INTEQ(pcl_epoch_synchronize(), 0, "synchronize failed");
+	ASSERT_INTEQ(pcl_epoch_pending(), 0, "snapshots still pending");
+	ASSERT_INTEQ(pong_count, 0, "unsubscribed handler called");
+	return true;
+}
@@ -33,9 +33,15 @@
 #include <pcl/json.h>
 #include <pcl/alloc.h>
 #include <pcl/array.h>
+#include <pcl/buf.h>
+#include <pcl/file.h>
+#include <pcl/process.h>
+#include <pcl/thread.h>
 #include <string.h>
 #include <stdio.h>
 
+#define LINES_TESTFILE _P("_testlines_")
+
 #define ENCODED_TEST_FILE "{\"str-ascii-escape\":\"Unit \\u001f Separator\",\"false\":false,\"true\":true,\"null\":null,\"integer\":9223372036854775807,\"negative-integer\":-9223372036854775807,\"real\":83765523.234874,\"negative-real\":-83765523.234874,\"real-exp\":19999390000,\"negative-real-exp\":-19999390000,\"empty-object\":{},\"empty-array\":[],\"array\":[\"אָדוֹם\",\"အပြာ\",\"zelená\",\"黄\",\"purple\"],\"object\":{\"math symbols\":\"∮ E⋅da = Q,  n → ∞, ∑ f(i) = ∏ g(i), ∀x∈ℝ: ⌈x⌉ = −⌊−x⌋, α ∧ ¬β = ¬(¬α ∨ β)\",\"array\":[12,-1273.273,\"string\",true,null,{},[]]},\"array-objects\":[{\"str-utf16\":\"CJK UNIFIED IDEOGRAPH 阳 and 好\",\"str-utf16-surrogate\":\"MUSICAL SYMBOL G CLEF (1D11E) 𝄞\",\"real\":909374653.6736,\"array\":[0,false,\"string\",[1,2,3],{\"a\":\"b\"}]},{\"key\":\"string\"},{\"key\":null}]}"
 
 static char *loadjson(int *lenp)
@@ -296,3 +302,483 @@ TESTCASE(json_query)
 
 	return true;
 }
+
+/**$ Use JSON path filter expressions to select array elements */
+TESTCASE(json_filter)
+{
+	int len;
+	char *data = loadjson(&len);
+
+	ASSERT_NOTNULL(data, "failed to open test-data.json");
+
+	pcl_json_t *root = pcl_json_decode(data, (int) len, NULL);
+
+	ASSERT_NOTNULL(root, "failed to decode json string");
+
+	pcl_array_t *arr = pcl_json_query(root, "$['array-objects'][?(@.key)]");
+	ASSERT_NOTNULL(arr, "existence filter failed");
+	ASSERT_INTEQ(arr->count, 2, "wrong count for existence filter");
+	pcl_array_free(arr);
+
+	arr = pcl_json_query(root, "$['array-objects'][?(@.key == 'string')].key");
+	ASSERT_NOTNULL(arr, "equality filter failed");
+	ASSERT_INTEQ(arr->count, 1, "wrong count for equality filter");
+	ASSERT_STREQ(((pcl_json_t *) arr->elements[0])->string, "string", "wrong equality result");
+	pcl_array_free(arr);
+
+	arr = pcl_json_query(root, "$['array-objects'][?(@.key != null)]");
+	ASSERT_NOTNULL(arr, "inequality filter failed");
+	ASSERT_INTEQ(arr->count, 1, "wrong count for inequality filter");
+	pcl_array_free(arr);
+
+	arr = pcl_json_query(root, "$['array-objects'][?(@.real > 1000)].array[?(@ >= 0)]");
+	ASSERT_NOTNULL(arr, "relational filter failed");
+	ASSERT_INTEQ(arr->count, 1, "wrong count for relational filter");
+	ASSERT_TRUE(pcl_json_isint((pcl_json_t *) arr->elements[0]), "wrong type for relational filter");
+	pcl_array_free(arr);
+
+	arr = pcl_json_query(root, "$.object.array[?(@ < 0)]");
+	ASSERT_NOTNULL(arr, "current node filter failed");
+	ASSERT_INTEQ(arr->count, 1, "wrong count for current node filter");
+	ASSERT_DOUBLEEQ(((pcl_json_t *) arr->elements[0])->real, -1273.273, "wrong filter result");
+	pcl_array_free(arr);
+
+	ASSERT_NULL(pcl_json_compile("$.array[?(@.a ~ 1)]"), "bad operator compiled");
+	ASSERT_NULL(pcl_json_compile("$.array[?(@.a == [1])]"), "non-scalar operand compiled");
+	ASSERT_NULL(pcl_json_compile("$.array[?(@.a == 1]"), "missing paren compiled");
+
+	pcl_json_free(root);
+	return true;
+}
+
+static bool
+count_visitor(pcl_json_t *value, void *udata)
+{
+	int *count = udata;
+
+	(*count)++;
+	return pcl_json_isstr(value) && *count < 3;
+}
+
+/**$ Visit json path matches without allocating results */
+TESTCASE(json_visit)
+{
+	int len;
+	char *data = loadjson(&len);
+
+	ASSERT_NOTNULL(data, "failed to open test-data.json");
+
+	pcl_json_t *root = pcl_json_decode(data, (int) len, NULL);
+
+	ASSERT_NOTNULL(root, "failed to decode json string");
+
+	pcl_json_path_t *path = pcl_json_compile("$.array[*]");
+	ASSERT_NOTNULL(path, "failed to compile path");
+
+	int count = 0;
+	ASSERT_INTEQ(pcl_json_visit(root, path, count_visitor, &count), 3, "visitor did not stop");
+	ASSERT_INTEQ(count, 3, "wrong visitor count");
+
+	pcl_json_t *val = pcl_json_arrget(pcl_json_objget(root, "array"), 0);
+	ASSERT_INTEQ(val->nrefs, 1, "visit modified reference count");
+
+	pcl_json_freepath(path);
+	pcl_json_free(root);
+	return true;
+}
+
+typedef struct
+{
+	long long next;
+	long long sum;
+	bool ordered;
+} lines_state_t;
+
+static bool
+lines_handler(pcl_json_t *doc, void *udata)
+{
+	lines_state_t *state = udata;
+	long long n = pcl_json_objgetint(doc, "n");
+
+	if(state->ordered && n != state->next)
+		state->ordered = false;
+
+	state->next++;
+	state->sum += n;
+	pcl_json_free(doc);
+	return true;
+}
+
+/* count documents {"n":0} through {"n":count-1} with a blank line in between */
+static char *
+make_lines(int count, size_t *lenp)
+{
+	char *data = pcl_malloc(count * 24);
+	size_t len = 0;
+
+	for(int i = 0; i < count; i++)
+	{
+		if(i == count / 200)
+			len += sprintf(data + len, "\n  \n");
+
+		/* last line has no trailing newline */
+		len += sprintf(data + len, i + 1 < count ? "{\"n\":%d}\n" : "{\"n\":%d}", i);
+	}
+
+	*lenp = len;
+	return data;
+}
+
+typedef struct
+{
+	pcl_file_t *file;
+	const char *data;
+	size_t len;
+} lines_writer_t;
+
+/* feeds a pipe, closing it signals end of file */
+static void
+lines_writer(void *arg)
+{
+	lines_writer_t *w = arg;
+
+	pcl_json_write_file(w->data, w->len, w->file);
+	pcl_file_close(w->file);
+}
+
+static int
+write_lines_file(const char *data, size_t len)
+{
+	pcl_file_t *file = pcl_file_open(LINES_TESTFILE, PCL_O_CREAT | PCL_O_TRUNC | PCL_O_WRONLY, 0644);
+
+	if(!file)
+		return -1;
+
+	int r = pcl_json_write_file(data, len, file);
+
+	pcl_file_close(file);
+	return r;
+}
+
+/**$ Decode newline-delimited json on multiple threads, ordered and unordered */
+TESTCASE(json_decode_lines)
+{
+	/* large enough to span multiple chunks */
+	int count = 200000;
+	size_t len;
+	char *data = make_lines(count, &len);
+
+	lines_state_t state = {.next = 0, .sum = 0, .ordered = true};
+	long long sum = (long long) count * (count - 1) / 2;
+
+	int r = pcl_json_decode_lines(data, len, 4, 0, lines_handler, &state);
+	ASSERT_INTEQ(r, count, "wrong number of ordered documents");
+	ASSERT_TRUE(state.ordered, "documents delivered out of order");
+	ASSERT_INTEQ(state.sum, sum, "wrong ordered sum");
+
+	state.next = state.sum = 0;
+	r = pcl_json_decode_lines(data, len, 4, PCL_JSON_UNORDERED, lines_handler, &state);
+	ASSERT_INTEQ(r, count, "wrong number of unordered documents");
+	ASSERT_INTEQ(state.sum, sum, "wrong unordered sum");
+
+	/* break a line in the middle of the input */
+	data[len / 2] = '#';
+	r = pcl_json_decode_lines(data, len, 4, 0, lines_handler, &state);
+	ASSERT_INTEQ(r, -1, "invalid json line was decoded");
+
+	pcl_free(data);
+	return true;
+}
+
+/**$ Read newline-delimited json from a mapped file and from a pipe */
+TESTCASE(json_readlines)
+{
+	/* the pipe is read in chunks, lines are carried across them */
+	int count = 200000;
+	size_t len;
+	char *data = make_lines(count, &len);
+	lines_state_t state = {.next = 0, .sum = 0, .ordered = true};
+	long long sum = (long long) count * (count - 1) / 2;
+
+	ASSERT_INTEQ(write_lines_file(data, len), 0, "cannot write lines file");
+
+	pcl_file_t *file = pcl_file_open(LINES_TESTFILE, PCL_O_RDONLY);
+	ASSERT_NOTNULL(file, "cannot open lines file");
+	ASSERT_INTEQ(pcl_json_readlines(file, 4, 0, lines_handler, &state), count,
+		"wrong number of mapped documents");
+	ASSERT_TRUE(state.ordered, "mapped documents delivered out of order");
+	ASSERT_INTEQ(state.sum, sum, "wrong mapped sum");
+	pcl_file_close(file);
+
+	pcl_file_t *pipes[2];
+	pthread_t t;
+	pcl_thread_attr_t attr;
+	lines_writer_t writer = {.data = data, .len = len};
+
+	ASSERT_INTEQ(pcl_proc_pipe(pipes, 0, 0), 0, "cannot create pipe");
+	writer.file = pipes[1];
+	pcl_thread_attr_init(&attr);
+	attr.joinable = true;
+	ASSERT_INTEQ(pcl_thread_ex(&t, &attr, lines_writer, &writer), 0, "cannot start writer");
+
+	state.next = state.sum = 0;
+	ASSERT_INTEQ(pcl_json_readlines(pipes[0], 4, 0, lines_handler, &state), count,
+		"wrong number of streamed documents");
+	ASSERT_TRUE(state.ordered, "streamed documents delivered out of order");
+	ASSERT_INTEQ(state.sum, sum, "wrong streamed sum");
+	pthread_join(t, NULL);
+	pcl_file_close(pipes[0]);
+	pcl_free(data);
+
+	/* a malformed line fails both paths, small enough to fit within the pipe buffer */
+	data = make_lines(1000, &len);
+	strchr(data + len / 2, ':')[1] = '#';
+
+	ASSERT_INTEQ(write_lines_file(data, len), 0, "cannot write lines file");
+	file = pcl_file_open(LINES_TESTFILE, PCL_O_RDONLY);
+	ASSERT_NOTNULL(file, "cannot open lines file");
+	ASSERT_INTEQ(pcl_json_readlines(file, 2, 0, lines_handler, &state), -1,
+		"invalid mapped line was decoded");
+	pcl_file_close(file);
+	(void) pcl_unlink(LINES_TESTFILE);
+
+	ASSERT_INTEQ(pcl_proc_pipe(pipes, 0, 0), 0, "cannot create pipe");
+	ASSERT_INTEQ(pcl_json_write_file(data, len, pipes[1]), 0, "cannot fill pipe");
+	pcl_file_close(pipes[1]);
+	ASSERT_INTEQ(pcl_json_readlines(pipes[0], 2, 0, lines_handler, &state), -1,
+		"invalid streamed line was decoded");
+	pcl_file_close(pipes[0]);
+
+	pcl_free(data);
+	return true;
+}
+
+typedef int (*binary_encoder_t)(pcl_json_t *value, pcl_buf_t *b);
+typedef pcl_json_t *(*binary_decoder_t)(const void *data, size_t len, const void **end);
+
+static bool binary_roundtrip(binary_encoder_t encode, binary_decoder_t decode)
+{
+	int len;
+	char *data = loadjson(&len);
+
+	if(!data)
+		return false;
+
+	pcl_json_t *root = pcl_json_decode(data, (int) len, NULL);
+	pcl_buf_t *b = pcl_buf_init(NULL, 64, PclBufBinary);
+
+	int n = encode(root, b);
+	pcl_json_free(root);
+
+	const void *end = NULL;
+	root = n > 0 ? decode(b->data, b->len, &end) : NULL;
+
+	bool ok = root && end == b->data + b->len;
+	pcl_buf_free(b);
+
+	if(ok)
+	{
+		char *s = pcl_json_encode(root, false);
+		ok = strcmp(s, ENCODED_TEST_FILE) == 0;
+		pcl_free(s);
+	}
+
+	pcl_json_free(root);
+	return ok;
+}
+
+/**$ Encode and decode CBOR */
+TESTCASE(json_cbor)
+{
+	static const uint8_t expect[] = {
+		0x86, 0x01, 0x20, 0x61, 0x61, 0xf5, 0xf6, 0xfa, 0x3f, 0xc0, 0x00, 0x00
+	};
+
+	pcl_json_t *arr = pcl_json_decode("[1,-1,\"a\",true,null,1.5]", 0, NULL);
+	pcl_buf_t *b = pcl_buf_init(NULL, 16, PclBufBinary);
+
+	ASSERT_INTEQ(pcl_json_encode_cbor(arr, b), sizeof(expect), "wrong cbor length");
+	ASSERT_TRUE(memcmp(b->data, expect, sizeof(expect)) == 0, "wrong cbor encoding");
+	pcl_json_free(arr);
+	pcl_buf_free(b);
+
+	/* indefinite length map with a chunked key and a half float */
+	static const uint8_t indef[] = {
+		0xbf, 0x7f, 0x61, 0x6b, 0x61, 0x31, 0xff, 0xf9, 0x3c, 0x00, 0xff
+	};
+
+	pcl_json_t *obj = pcl_json_decode_cbor(indef, sizeof(indef), NULL);
+	ASSERT_NOTNULL(obj, "failed to decode indefinite map");
+	ASSERT_DOUBLEEQ(pcl_json_objgetreal(obj, "k1"), 1.0, "wrong half float value");
+	pcl_json_free(obj);
+
+	/* truncated text string */
+	ASSERT_NULL(pcl_json_decode_cbor("\x63\x61\x62", 3, NULL), "truncated cbor was decoded");
+
+	ASSERT_TRUE(binary_roundtrip(pcl_json_encode_cbor, pcl_json_decode_cbor),
+		"cbor round trip failed");
+
+	return true;
+}
+
+/**$ Encode and decode MessagePack */
+TESTCASE(json_msgpack)
+{
+	static const uint8_t expect[] = {
+		0x96, 0x01, 0xff, 0xa1, 0x61, 0xc3, 0xc0, 0xca, 0x3f, 0xc0, 0x00, 0x00
+	};
+
+	pcl_json_t *arr = pcl_json_decode("[1,-1,\"a\",true,null,1.5]", 0, NULL);
+	pcl_buf_t *b = pcl_buf_init(NULL, 16, PclBufBinary);
+
+	ASSERT_INTEQ(pcl_json_encode_msgpack(arr, b), sizeof(expect), "wrong msgpack length");
+	ASSERT_TRUE(memcmp(b->data, expect, sizeof(expect)) == 0, "wrong msgpack encoding");
+	pcl_json_free(arr);
+	pcl_buf_free(b);
+
+	/* int 16 and bin 8, which has no json equivalent */
+	pcl_json_t *val = pcl_json_decode_msgpack("\xd1\xfc\x18", 3, NULL);
+	ASSERT_NOTNULL(val, "failed to decode int 16");
+	ASSERT_INTEQ(val->integer, -1000, "wrong int 16 value");
+	pcl_json_free(val);
+	ASSERT_NULL(pcl_json_decode_msgpack("\xc4\x01\x00", 3, NULL), "bin 8 was decoded");
+
+	ASSERT_TRUE(binary_roundtrip(pcl_json_encode_msgpack, pcl_json_decode_msgpack),
+		"msgpack round trip failed");
+
+	return true;
+}
+
+static int buf_write(const void *data, size_t len, void *udata)
+{
+	pcl_buf_t *b = udata;
+
+	/* the encoder never flushes an empty buffer */
+	if(len == 0)
+		return -1;
+
+	pcl_buf_put(b, data, (int) len);
+	return 0;
+}
+
+/**$ Stream a json document through a write callback */
+TESTCASE(json_encode_stream)
+{
+	int len;
+	char *data = loadjson(&len);
+
+	ASSERT_NOTNULL(data, "failed to open test-data.json");
+
+	pcl_json_t *root = pcl_json_decode(data, (int) len, NULL);
+	pcl_buf_t *b = pcl_buf_init(NULL, 64, PclBufText);
+
+	for(int format = 0; format < 2; format++)
+	{
+		char *s = pcl_json_encode(root, format);
+
+		pcl_buf_reset(b);
+		ASSERT_INTEQ(pcl_json_encode_stream(root, format, buf_write, b), 0, "stream failed");
+		ASSERT_STREQ(b->data, s, "wrong streamed value");
+		pcl_free(s);
+	}
+
+	pcl_json_free(root);
+	pcl_buf_free(b);
+
+	return true;
+}
+
+/**$ Write a document with the json writer, large enough to flush several times */
+TESTCASE(json_writer)
+{
+	pcl_json_t *root = pcl_json_obj();
+	pcl_json_t *arr = pcl_json_arr();
+
+	pcl_json_objputint(root, "count", 20000, 0);
+	pcl_json_objput(root, "rows", arr, 0);
+	pcl_json_objput(root, "empty", pcl_json_arr(), 0);
+
+	for(int i = 0; i < 20000; i++)
+		pcl_json_arraddstr(arr, "row \"value\"", 0);
+
+	pcl_buf_t *b = pcl_buf_init(NULL, 64, PclBufText);
+
+	for(int format = 0; format < 2; format++)
+	{
+		pcl_buf_reset(b);
+
+		pcl_json_writer_t *w = pcl_json_writer(format, buf_write, b);
+		pcl_json_t *row = pcl_json_str("row \"value\"", 0);
+		pcl_json_t *count = pcl_json_int(20000);
+
+		pcl_json_writer_beginobj(w);
+		ASSERT_INTEQ(pcl_json_writer_value(w, row), -1, "value accepted before object key");
+		pcl_json_writer_key(w, "count");
+		pcl_json_writer_value(w, count);
+		pcl_json_writer_key(w, "rows");
+		pcl_json_writer_beginarr(w);
+
+		for(int i = 0; i < 20000; i++)
+			pcl_json_writer_value(w, row);
+
+		pcl_json_writer_end(w);
+		pcl_json_writer_key(w, "empty");
+		pcl_json_writer_beginarr(w);
+		pcl_json_writer_end(w);
+		ASSERT_INTEQ(pcl_json_writer_end(w), 0, "failed to end root object");
+		ASSERT_INTEQ(pcl_json_writer_close(w), 0, "failed to close writer");
+		pcl_json_free(row);
+		pcl_json_free(count);
+
+		char *s = pcl_json_encode(root, format);
+		ASSERT_STREQ(b->data, s, "writer output differs from pcl_json_encode");
+		pcl_free(s);
+	}
+
+	pcl_json_free(root);
+	pcl_buf_free(b);
+
+	return true;
+}
+
+/**$ Encode large arrays and objects on multiple threads */
+TESTCASE(json_encode_parallel)
+{
+	char key[32];
+	pcl_json_t *root = pcl_json_obj();
+	pcl_json_t *rows = pcl_json_arr();
+	pcl_json_t *index = pcl_json_obj();
+
+	pcl_json_objput(root, "rows", rows, 0);
+	pcl_json_objput(root, "index", index, 0);
+
+	for(int i = 0; i < 20000; i++)
+	{
+		pcl_json_t *row = pcl_json_obj();
+
+		pcl_json_objputint(row, "id", i, 0);
+		pcl_json_objputstr(row, "name", "row \"name\"", 0);
+		pcl_json_objput(row, "empty", pcl_json_arr(), 0);
+		pcl_json_arradd(rows, row, 0);
+
+		if(i % 4 == 0)
+		{
+			sprintf(key, "key%d", i);
+			pcl_json_objputreal(index, key, i / 8.0, 0);
+		}
+	}
+
+	for(int format = 0; format < 2; format++)
+	{
+		char *serial = pcl_json_encode(root, format);
+		char *parallel = pcl_json_encode_parallel(root, format, 4);
+
+		ASSERT_STREQ(parallel, serial, "parallel output differs from pcl_json_encode");
+		pcl_free(serial);
+		pcl_free(parallel);
+	}
+
+	pcl_json_free(root);
+
+	return true;
+}
@@ -0,0 +1,229 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "test.h"
+#include <pcl/memprof.h>
+#include <pcl/alloc.h>
+#include <pcl/json.h>
+#include <pcl/thread.h>
+#include <pcl/atomic.h>
+#include <pcl/error.h>
+#include <pcl/time.h>
+#include <stdio.h>
+#include <string.h>
+
+#define THREADS 4
+#define ROUNDS 1000
+
+/* with PCL_TEST_MEMPROF set, test.c enables the profiler before pcl_init with a 256K stack
+ * threshold. Otherwise these cases only check that it cannot be enabled late.
+ */
+#define LARGE (300 * 1024)
+
+static int small_line;
+static int large_line;
+static int thread_line;
+static pcl_atomic_t done;
+
+static void *
+alloc_small(size_t n)
+{
+	small_line = __LINE__ + 1;
+	return pcl_malloc(n);
+}
+
+static void *
+alloc_large(size_t n)
+{
+	large_line = __LINE__ + 1;
+	return pcl_malloc(n);
+}
+
+/* only the main thread asks for the line */
+static void *
+alloc_thread(size_t n, int *line)
+{
+	if(line)
+		*line = __LINE__ + 1;
+	return pcl_malloc(n);
+}
+
+static pcl_json_t *
+find_site(pcl_json_t *root, int line)
+{
+	pcl_json_t *sites = pcl_json_objget(root, "sites");
+
+	for(int i = 0; i < pcl_json_count(sites); i++)
+	{
+		pcl_json_t *site = pcl_json_arrget(sites, i);
+
+		if(pcl_json_objgetint(site, "line") == line &&
+			strstr(pcl_json_objgetstr(site, "file"), "memprof.c"))
+		{
+			return site;
+		}
+	}
+
+	return NULL;
+}
+
+static void
+churn(void *arg)
+{
+	UNUSED(arg);
+
+	for(int i = 0; i < ROUNDS; i++)
+		pcl_free(alloc_thread(64, NULL));
+
+	pcl_atomic_add_fetch(&done, 1);
+}
+
+/**$ Profiler counts allocations, frees, live and peak bytes per call site */
+TESTCASE(memprof_sites)
+{
+	void *ptrs[10];
+
+	ASSERT_INTEQ(pcl_memprof_enable(0, 0), -1, "enabled after pcl_init");
+	ASSERT_INTEQ(pcl_errno, PCL_EBUSY, "wrong error");
+
+	if(!pcl_memprof_enabled())
+		TESTSKIP("set PCL_TEST_MEMPROF to enable the profiler");
+
+	for(int i = 0; i < countof(ptrs); i++)
+		ptrs[i] = alloc_small(100);
+
+	for(int i = 0; i < 4; i++)
+		pcl_free(ptrs[i]);
+
+	pcl_json_t *root = pcl_memprof_json();
+	ASSERT_NOTNULL(root, "json failed");
+
+	pcl_json_t *site = find_site(root, small_line);
+	ASSERT_NOTNULL(site, "site not found");
+	ASSERT_INTEQ(pcl_json_objgetint(site, "allocs"), 10, "wrong allocs");
+	ASSERT_INTEQ(pcl_json_objgetint(site, "frees"), 4, "wrong frees");
+	ASSERT_INTEQ(pcl_json_objgetint(site, "bytes"), 1000, "wrong bytes");
+	ASSERT_INTEQ(pcl_json_objgetint(site, "live"), 600, "wrong live bytes");
+	ASSERT_INTEQ(pcl_json_objgetint(site, "peak"), 1000, "wrong peak");
+	ASSERT_NULL(pcl_json_objget(site, "stacks"), "small allocation sampled");
+	ASSERT_TRUE(pcl_json_objgetint(root, "live") >= 600, "wrong total live bytes");
+	pcl_json_free(root);
+
+	for(int i = 4; i < countof(ptrs); i++)
+		pcl_free(ptrs[i]);
+
+	root = pcl_memprof_json();
+	ASSERT_INTEQ(pcl_json_objgetint(find_site(root, small_line), "live"), 0, "blocks still live");
+	pcl_json_free(root);
+	return true;
+}
+
+/**$ Profiler samples stacks of large allocations and reports leaks */
+TESTCASE(memprof_stacks)
+{
+	if(!pcl_memprof_enabled())
+		TESTSKIP("set PCL_TEST_MEMPROF to enable the profiler");
+
+	char *p = alloc_large(LARGE);
+
+	ASSERT_NOTNULL(p, "alloc failed");
+	memset(p, 1, LARGE);
+
+	pcl_json_t *root = pcl_memprof_json();
+	pcl_json_t *stacks = pcl_json_objget(find_site(root, large_line), "stacks");
+
+	ASSERT_NOTNULL(stacks, "no stack samples");
+	ASSERT_INTEQ(pcl_json_count(stacks), 1, "wrong number of samples");
+	ASSERT_TRUE(pcl_json_count(pcl_json_arrget(stacks, 0)) > 0, "empty stack");
+	pcl_json_free(root);
+
+	/* the resize moves the block to the resizing site */
+	p = pcl_realloc(p, LARGE * 2);
+	ASSERT_NOTNULL(p, "realloc failed");
+
+	FILE *fp = tmpfile();
+	char line[512];
+	bool found = false;
+
+	ASSERT_NOTNULL(fp, "tmpfile failed");
+	ASSERT_TRUE(pcl_memprof_leaks(fp) >= 1, "leak not reported");
+
+	rewind(fp);
+	while(!found && fgets(line, sizeof(line), fp))
+		found = strstr(line, "memprof_stacks(") != NULL;
+
+	fclose(fp);
+	ASSERT_TRUE(found, "leak site not reported");
+
+	root = pcl_memprof_json();
+	ASSERT_INTEQ(pcl_json_objgetint(find_site(root, large_line), "live"), 0,
+		"realloc not counted as a free");
+	pcl_json_free(root);
+
+	pcl_free(p);
+	return true;
+}
+
+/**$ Profiler merges counters from threads */
+TESTCASE(memprof_threads)
+{
+	long long allocs = 0;
+
+	if(!pcl_memprof_enabled())
+		TESTSKIP("set PCL_TEST_MEMPROF to enable the profiler");
+
+	done = 0;
+	pcl_free(alloc_thread(64, &thread_line));
+
+	for(int i = 0; i < THREADS; i++)
+		pcl_thread(NULL, churn, NULL);
+
+	while(pcl_atomic_fetch(&done) < THREADS)
+		pcl_sleep(1000000, NULL, 0);
+
+	/* exiting threads merge what is left, shortly after signaling done */
+	for(int i = 0; i < 1000 && allocs != THREADS * ROUNDS + 1; i++)
+	{
+		pcl_json_t *root = pcl_memprof_json();
+		pcl_json_t *site = find_site(root, thread_line);
+
+		allocs = site ? pcl_json_objgetint(site, "allocs") : 0;
+
+		if(allocs == THREADS * ROUNDS + 1)
+			ASSERT_INTEQ(pcl_json_objgetint(site, "live"), 0, "wrong live bytes");
+
+		pcl_json_free(root);
+		pcl_sleep(1000000, NULL, 0);
+	}
+
+	ASSERT_INTEQ(allocs, THREADS * ROUNDS + 1, "thread counters not merged");
+	return true;
+}
@@ -0,0 +1,285 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "test.h"
+#include <pcl/memtag.h>
+#include <pcl/alloc.h>
+#include <pcl/buf.h>
+#include <pcl/htable.h>
+#include <pcl/json.h>
+#include <pcl/thread.h>
+#include <pcl/atomic.h>
+#include <pcl/error.h>
+#include <pcl/time.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define THREADS 4
+
+/* accounting is only enabled when PCL_TEST_MEMTAG is set, see test.c. Otherwise these cases
+ * only check that it cannot be enabled late.
+ */
+
+static int limit_events;
+static int thread_tag;
+static pcl_atomic_t done;
+
+static void
+count_limits(const char *type, void *ptr, size_t siz, PCL_LOCATION_PARAMS)
+{
+	UNUSED(ptr);
+	UNUSED(siz);
+	UNUSED(file);
+	UNUSED(func);
+	UNUSED(line);
+
+	if(strcmp(type, PCL_MEMORY_LIMIT) == 0)
+		limit_events++;
+}
+
+static int64_t
+live(int tag)
+{
+	pcl_memtag_usage_t u;
+
+	return pcl_memtag_usage(tag, &u) ? -1 : u.live;
+}
+
+static void
+churn(void *arg)
+{
+	UNUSED(arg);
+
+	pcl_memtag_set(thread_tag);
+
+	for(int i = 0; i < 1000; i++)
+		pcl_free(pcl_malloc(100));
+
+	pcl_atomic_add_fetch(&done, 1);
+}
+
+/**$ Memory is charged to the thread's tag and the tag it was allocated under */
+TESTCASE(memtag_usage)
+{
+	pcl_memtag_usage_t u;
+
+	ASSERT_INTEQ(pcl_memtag_enable(), -1, "enabled after pcl_init");
+	ASSERT_INTEQ(pcl_errno, PCL_EBUSY, "wrong error");
+
+	if(!pcl_memtag_enabled())
+		TESTSKIP("set PCL_TEST_MEMTAG to enable accounting");
+
+	int tag = pcl_memtag_register("test");
+	ASSERT_TRUE(tag >= PCL_MEMTAG_USER, "register failed");
+	ASSERT_INTEQ(pcl_memtag_set(PCL_MEMTAG_MAX), -1, "set an unknown tag");
+	ASSERT_INTEQ(pcl_memtag_limit(PCL_MEMTAG_NONE, 1), -1, "limited untagged memory");
+
+	ASSERT_INTEQ(pcl_memtag_set(tag), PCL_MEMTAG_NONE, "wrong previous tag");
+	ASSERT_INTEQ(pcl_memtag_get(), tag, "tag not set");
+
+	char *p = pcl_malloc(1000);
+	ASSERT_INTEQ(live(tag), 1000, "malloc not charged");
+
+	ASSERT_INTEQ(pcl_memtag_set(PCL_MEMTAG_NONE), tag, "wrong previous tag");
+	p = pcl_realloc(p, 3000);
+	ASSERT_INTEQ(live(tag), 3000, "realloc not charged to the original tag");
+	pcl_free(p);
+
+	ASSERT_INTEQ(pcl_memtag_usage(tag, &u), 0, "usage failed");
+	ASSERT_STREQ(u.name, "test", "wrong name");
+	ASSERT_INTEQ(u.live, 0, "free not credited");
+	ASSERT_INTEQ(u.peak, 3000, "wrong peak");
+	ASSERT_INTEQ(u.limit, 0, "wrong limit");
+
+	/* threads charging the same tag */
+	thread_tag = tag;
+	done = 0;
+
+	for(int i = 0; i < THREADS; i++)
+		pcl_thread(NULL, churn, NULL);
+
+	while(pcl_atomic_fetch(&done) < THREADS)
+		pcl_sleep(1000000, NULL, 0);
+
+	ASSERT_INTEQ(live(tag), 0, "thread frees not credited");
+	return true;
+}
+
+/**$ Modules charge their own tag unless the thread already has one */
+TESTCASE(memtag_modules)
+{
+	const char *text = "{\"name\":\"a fairly long string value\",\"list\":[1,2,3,\"four\"]}";
+
+	if(!pcl_memtag_enabled())
+		TESTSKIP("set PCL_TEST_MEMTAG to enable accounting");
+
+	int tenant = pcl_memtag_register("tenant");
+
+	/* the first decode creates the node pool, whose own state is kept */
+	pcl_json_free(pcl_json_decode(text, 0, NULL));
+
+	int64_t htable = live(PCL_MEMTAG_HTABLE);
+	int64_t buf = live(PCL_MEMTAG_BUF);
+	int64_t json = live(PCL_MEMTAG_JSON);
+
+	pcl_htable_t *ht = pcl_htable(64);
+	ASSERT_TRUE(live(PCL_MEMTAG_HTABLE) > htable, "htable not charged");
+	pcl_htable_free(ht);
+	ASSERT_INTEQ(live(PCL_MEMTAG_HTABLE), htable, "htable not credited");
+
+	pcl_buf_t *b = pcl_buf_init(NULL, 100, PclBufText);
+	ASSERT_TRUE(live(PCL_MEMTAG_BUF) >= buf + 100, "buf not charged");
+	pcl_buf_free(b);
+	ASSERT_INTEQ(live(PCL_MEMTAG_BUF), buf, "buf not credited");
+
+	pcl_json_t *doc = pcl_json_decode(text, 0, NULL);
+	ASSERT_NOTNULL(doc, "decode failed");
+	ASSERT_TRUE(live(PCL_MEMTAG_JSON) > json, "decode not charged");
+	pcl_json_free(doc);
+	ASSERT_INTEQ(live(PCL_MEMTAG_JSON), json, "decode not credited");
+
+	/* the outermost tag wins */
+	pcl_memtag_set(tenant);
+	doc = pcl_json_decode(text, 0, NULL);
+	pcl_memtag_set(PCL_MEMTAG_NONE);
+
+	ASSERT_NOTNULL(doc, "decode failed");
+	ASSERT_TRUE(live(tenant) > 0, "decode not charged to tenant");
+	ASSERT_INTEQ(live(PCL_MEMTAG_JSON), json, "decode charged to json");
+	pcl_json_free(doc);
+	ASSERT_INTEQ(live(tenant), 0, "decode not credited to tenant");
+	return true;
+}
+
+/**$ Pooled objects are charged per object, so pool slabs do not stay charged to a tag */
+TESTCASE(memtag_pool)
+{
+	if(!pcl_memtag_enabled())
+		TESTSKIP("set PCL_TEST_MEMTAG to enable accounting");
+
+	/* enough nodes to carve several slabs */
+	size_t len = 20000 * 4;
+	char *text = malloc(len + 16);
+	char *p = text;
+
+	*p++ = '[';
+	for(int i = 0; i < 20000; i++)
+		p += sprintf(p, "%s%d", i ? "," : "", i % 100);
+	*p++ = ']';
+	*p = 0;
+
+	int tenant = pcl_memtag_register("pooled");
+
+	pcl_json_free(pcl_json_decode("[1]", 0, NULL));
+
+	int64_t json = live(PCL_MEMTAG_JSON);
+
+	for(int round = 0; round < 2; round++)
+	{
+		pcl_memtag_set(tenant);
+		pcl_json_t *doc = pcl_json_decode(text, 0, NULL);
+		pcl_memtag_set(PCL_MEMTAG_NONE);
+
+		ASSERT_NOTNULL(doc, "decode failed");
+		ASSERT_TRUE(live(tenant) >= 20000 * (int64_t) sizeof(void *), "nodes not charged");
+		pcl_json_free(doc);
+		ASSERT_INTEQ(live(tenant), 0, "nodes not credited");
+	}
+
+	free(text);
+	ASSERT_INTEQ(live(PCL_MEMTAG_JSON), json, "slabs charged to json");
+	return true;
+}
+
+/**$ Exceeding a soft limit calls the memory handler and fails decoding cleanly */
+TESTCASE(memtag_limit)
+{
+	pcl_memtag_usage_t u;
+
+	if(!pcl_memtag_enabled())
+		TESTSKIP("set PCL_TEST_MEMTAG to enable accounting");
+
+	int tag = pcl_memtag_register("limited");
+
+	/* ~300K of decoded strings */
+	size_t len = 10000 * 32;
+	char *text = malloc(len + 16);
+	char *p = text;
+
+	*p++ = '[';
+	for(int i = 0; i < 10000; i++)
+		p += sprintf(p, "%s\"string number %010d\"", i ? "," : "", i);
+	*p++ = ']';
+	*p = 0;
+
+	ASSERT_INTEQ(pcl_memtag_limit(tag, 64 * 1024), 0, "limit failed");
+
+	pcl_memory_handler_t prev = pcl_set_memory_handler(count_limits);
+	limit_events = 0;
+
+	pcl_memtag_set(tag);
+	pcl_json_t *doc = pcl_json_decode(text, 0, NULL);
+	int err = pcl_errno;
+
+	pcl_json_t *small = pcl_json_decode("[1,2,3]", 0, NULL);
+	pcl_memtag_set(PCL_MEMTAG_NONE);
+	pcl_set_memory_handler(prev);
+	free(text);
+
+	ASSERT_NULL(doc, "decode over the limit succeeded");
+	ASSERT_INTEQ(err, PCL_ENOMEM, "wrong error");
+	ASSERT_INTEQ(limit_events, 1, "memory handler not called once");
+	ASSERT_NOTNULL(small, "decode under the limit failed");
+	pcl_json_free(small);
+
+	ASSERT_INTEQ(pcl_memtag_usage(tag, &u), 0, "usage failed");
+	ASSERT_INTEQ(u.exceeded, 1, "wrong exceeded count");
+	ASSERT_TRUE(u.peak > 64 * 1024, "peak below the limit");
+	ASSERT_TRUE(u.live < 64 * 1024, "partial document not freed");
+	ASSERT_TRUE(!pcl_memtag_exceeded(tag), "still over the limit");
+
+	/* buffers refuse to grow while over the limit */
+	pcl_memtag_limit(tag, 1024);
+	pcl_memtag_set(tag);
+	pcl_buf_t *b = pcl_buf_init(NULL, 16, PclBufBinary);
+	char block[4096] = {0};
+
+	pcl_set_memory_handler(count_limits);
+	ASSERT_TRUE(pcl_buf_put(b, block, sizeof(block)) >= 0, "first growth failed");
+	ASSERT_INTEQ(pcl_buf_put(b, block, sizeof(block)), -1, "growth over the limit succeeded");
+	ASSERT_INTEQ(pcl_errno, PCL_ENOMEM, "wrong error");
+	pcl_set_memory_handler(prev);
+
+	pcl_buf_free(b);
+	pcl_memtag_set(PCL_MEMTAG_NONE);
+	pcl_memtag_limit(tag, 0);
+	return true;
+}
@@ -0,0 +1,159 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "test.h"
+#include <pcl/pool.h>
+#include <pcl/thread.h>
+#include <pcl/atomic.h>
+#include <pcl/error.h>
+#include <pcl/time.h>
+#include <string.h>
+
+#define THREADS 4
+#define OBJECTS 3000
+
+typedef struct
+{
+	int owner;
+	int magic;
+	char payload[40];
+} object_t;
+
+static pcl_pool_t *shared;
+static object_t *handoff[THREADS][OBJECTS];
+static pcl_atomic_t corrupt;
+static pcl_atomic_t done;
+
+static void
+object_init(void *obj, void *udata)
+{
+	((object_t *) obj)->magic = (int) (intptr_t) udata;
+}
+
+static void
+churn(void *arg)
+{
+	int id = (int) (intptr_t) arg;
+
+	for(int round = 0; round < 3; round++)
+	{
+		for(int i = 0; i < OBJECTS; i++)
+		{
+			object_t *o = handoff[id][i] = pcl_pool_get(shared);
+
+			if(o->magic != 7)
+				pcl_atomic_add_fetch(&corrupt, 1);
+
+			o->owner = id;
+			memset(o->payload, id, sizeof(o->payload));
+		}
+
+		for(int i = 0; i < OBJECTS; i++)
+		{
+			object_t *o = handoff[id][i];
+
+			if(o->owner != id || o->payload[39] != id)
+				pcl_atomic_add_fetch(&corrupt, 1);
+
+			/* the last round is put by the main thread */
+			if(round < 2)
+				pcl_pool_put(shared, o);
+		}
+	}
+
+	pcl_atomic_add_fetch(&done, 1);
+}
+
+/**$ Pool objects are zeroed, constructed and recycled */
+TESTCASE(pool_get_put)
+{
+	pcl_pool_t *p = pcl_pool_typed(object_t, PCL_POOL_ZERO, object_init, (void *) 42);
+	object_t *objs[5000];
+
+	ASSERT_NOTNULL(p, "create failed");
+	ASSERT_NULL(pcl_pool(0, 0, NULL, NULL), "accepted zero size");
+	ASSERT_INTEQ(pcl_errno, PCL_EINVAL, "wrong error");
+
+	/* spans several slabs */
+	for(int i = 0; i < countof(objs); i++)
+	{
+		objs[i] = pcl_pool_get(p);
+		ASSERT_NOTNULL(objs[i], "get failed");
+		ASSERT_INTEQ((uintptr_t) objs[i] % 16, 0, "object is not 16 byte aligned");
+		ASSERT_INTEQ(objs[i]->magic, 42, "constructor not called");
+		ASSERT_INTEQ(objs[i]->owner, 0, "object not zeroed");
+		objs[i]->owner = i + 1;
+	}
+
+	for(int i = 0; i < countof(objs); i++)
+		ASSERT_INTEQ(objs[i]->owner, i + 1, "objects overlap");
+
+	for(int i = 0; i < countof(objs); i++)
+		pcl_pool_put(p, objs[i]);
+
+	/* the magazine hands back the object just put */
+	object_t *o = pcl_pool_get(p);
+	o->owner = 99;
+	pcl_pool_put(p, o);
+	ASSERT_TRUE(pcl_pool_get(p) == o, "object was not recycled");
+	ASSERT_INTEQ(o->owner, 0, "recycled object not zeroed");
+	pcl_pool_free(p);
+
+	/* a new pool reuses the slot but not the freed pool's cached objects */
+	p = pcl_pool(24, 0, NULL, NULL);
+	o = pcl_pool_get(p);
+	ASSERT_NOTNULL(o, "get from new pool failed");
+	pcl_pool_put(p, o);
+	pcl_pool_free(p);
+	return true;
+}
+
+/**$ Pool shared by threads that put each other's objects */
+TESTCASE(pool_threads)
+{
+	shared = pcl_pool_typed(object_t, 0, object_init, (void *) 7);
+	corrupt = done = 0;
+
+	for(int i = 0; i < THREADS; i++)
+		pcl_thread(NULL, churn, (void *) (intptr_t) i);
+
+	while(pcl_atomic_fetch(&done) < THREADS)
+		pcl_sleep(1000000, NULL, 0);
+
+	ASSERT_INTEQ(corrupt, 0, "objects were handed out twice");
+
+	for(int id = 0; id < THREADS; id++)
+		for(int i = 0; i < OBJECTS; i++)
+			pcl_pool_put(shared, handoff[id][i]);
+
+	pcl_pool_free(shared);
+	return true;
+}
@@ -0,0 +1,165 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "test.h"
+#include <pcl/queue.h>
+#include <pcl/stack.h>
+#include <pcl/pqueue.h>
+
+static int cleaned;
+
+static void
+count_cleanup(void *item)
+{
+	(void) item;
+	cleaned++;
+}
+
+/**$ Queue FIFO order across chunk boundaries, reuse after draining and clear with cleanup */
+TESTCASE(queue)
+{
+	pcl_queue_t *q = pcl_queue_sized(100, count_cleanup);
+
+	for(int round = 0; round < 3; round++)
+	{
+		for(intptr_t i = 1; i <= 200; i++)
+			pcl_queue_add(q, (void *) i);
+
+		ASSERT_INTEQ(pcl_queue_size(q), 200, "wrong queue size");
+
+		for(intptr_t i = 1; i <= 200; i++)
+		{
+			ASSERT_INTEQ((intptr_t) pcl_queue_peek(q), i, "wrong queue peek");
+			ASSERT_INTEQ((intptr_t) pcl_queue_remove(q), i, "wrong queue order");
+		}
+
+		ASSERT_TRUE(pcl_queue_empty(q), "queue should be empty");
+		ASSERT_NULL(pcl_queue_remove(q), "remove from empty queue");
+	}
+
+	/* interleaved adds and removes keep the head and tail in different chunks */
+	intptr_t next = 1;
+	for(intptr_t i = 1; i <= 500; i++)
+	{
+		pcl_queue_add(q, (void *) i);
+		if(i % 3 == 0)
+			ASSERT_INTEQ((intptr_t) pcl_queue_remove(q), next++, "wrong interleaved order");
+	}
+
+	cleaned = 0;
+	pcl_queue_clear(q);
+	ASSERT_INTEQ(cleaned, 500 - 166, "wrong cleanup count");
+	ASSERT_INTEQ(pcl_queue_size(q), 0, "cleared queue not empty");
+
+	pcl_queue_add(q, (void *) 7);
+	ASSERT_INTEQ((intptr_t) pcl_queue_remove(q), 7, "add after clear failed");
+	pcl_queue_free(q);
+	return true;
+}
+
+/**$ Stack LIFO order across chunk boundaries, reuse after draining and clear with cleanup */
+TESTCASE(stack)
+{
+	pcl_stack_t *s = pcl_stack(count_cleanup);
+
+	for(int round = 0; round < 3; round++)
+	{
+		for(intptr_t i = 1; i <= 200; i++)
+			pcl_stack_push(s, (void *) i);
+
+		ASSERT_INTEQ(pcl_stack_size(s), 200, "wrong stack size");
+
+		for(intptr_t i = 200; i >= 1; i--)
+		{
+			ASSERT_INTEQ((intptr_t) pcl_stack_peek(s), i, "wrong stack peek");
+			ASSERT_INTEQ((intptr_t) pcl_stack_pop(s), i, "wrong stack order");
+		}
+
+		ASSERT_TRUE(pcl_stack_empty(s), "stack should be empty");
+		ASSERT_NULL(pcl_stack_pop(s), "pop from empty stack");
+	}
+
+	for(intptr_t i = 1; i <= 130; i++)
+		pcl_stack_push(s, (void *) i);
+
+	cleaned = 0;
+	pcl_stack_clear(s);
+	ASSERT_INTEQ(cleaned, 130, "wrong cleanup count");
+	ASSERT_INTEQ(pcl_stack_size(s), 0, "cleared stack not empty");
+	pcl_stack_free(s);
+	return true;
+}
+
+/**$ Priority queue ordering, decrease-key, increase-key and removal by handle */
+TESTCASE(pqueue)
+{
+	int handles[1000];
+	int64_t key, prev = INT64_MIN;
+	pcl_pqueue_t *pq = pcl_pqueue(0, count_cleanup);
+
+	ASSERT_NULL(pcl_pqueue(1, NULL), "arity 1 should fail");
+
+	/* keys 0..999 in scrambled order */
+	for(intptr_t i = 0; i < 1000; i++)
+		handles[i] = pcl_pqueue_push(pq, (i * 7919) % 1000, (void *) (i + 1));
+
+	ASSERT_INTEQ(pcl_pqueue_size(pq), 1000, "wrong pqueue size");
+	ASSERT_INTEQ((intptr_t) pcl_pqueue_peek(pq, &key), 1, "wrong head");
+	ASSERT_INTEQ(key, 0, "wrong head key");
+
+	/* decrease-key moves an item to the head, increasing it moves it to the tail */
+	ASSERT_INTEQ(pcl_pqueue_update(pq, handles[500], -1), 0, "decrease-key failed");
+	ASSERT_INTEQ((intptr_t) pcl_pqueue_peek(pq, &key), 501, "decrease-key not at head");
+	ASSERT_INTEQ(key, -1, "wrong decreased key");
+	ASSERT_INTEQ(pcl_pqueue_update(pq, handles[500], 5000), 0, "increase-key failed");
+
+	ASSERT_INTEQ((intptr_t) pcl_pqueue_remove(pq, handles[0]), 1, "remove by handle failed");
+	ASSERT_NULL(pcl_pqueue_remove(pq, handles[0]), "removed handle still valid");
+
+	for(int i = 0; i < 998; i++, prev = key)
+	{
+		ASSERT_NOTNULL(pcl_pqueue_pop(pq, &key), "pop returned NULL");
+		ASSERT_TRUE(key >= prev, "keys out of order");
+	}
+
+	ASSERT_INTEQ((intptr_t) pcl_pqueue_pop(pq, &key), 501, "increase-key not at tail");
+	ASSERT_INTEQ(key, 5000, "wrong increased key");
+	ASSERT_TRUE(pcl_pqueue_empty(pq), "pqueue should be empty");
+
+	/* released handles are reused */
+	for(intptr_t i = 0; i < 10; i++)
+		ASSERT_TRUE(pcl_pqueue_push(pq, 10 - i, (void *) i) < 1000, "handle not reused");
+
+	cleaned = 0;
+	pcl_pqueue_free(pq);
+	ASSERT_INTEQ(cleaned, 10, "wrong cleanup count");
+	return true;
+}
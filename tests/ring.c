@@ -0,0 +1,149 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "test.h"
+#include <pcl/ring.h>
+#include <pcl/thread.h>
+#include <pcl/atomic.h>
+#include <pcl/time.h>
+
+#define PRODUCERS 4
+#define CONSUMERS 3
+#define ITEMS 50000
+
+typedef struct
+{
+	pcl_ring_t *ring;
+	pcl_atomic_t ids;
+	pcl_atomic_t sum;
+	pcl_atomic_t count;
+	pcl_atomic_t done;
+} ring_test_t;
+
+static void
+producer(void *arg)
+{
+	ring_test_t *t = arg;
+	int id = (int) pcl_atomic_add_fetch(&t->ids, 1);
+	void *batch[8];
+
+	/* alternate single puts and batched pushes, items are 1..ITEMS */
+	for(intptr_t i = 1; i <= ITEMS; )
+	{
+		if(id & 1)
+		{
+			int n = 0;
+
+			while(n < 8 && i + n <= ITEMS)
+			{
+				batch[n] = (void *) (i + n);
+				n++;
+			}
+
+			int pushed = pcl_ring_pushv(t->ring, batch, n);
+			i += pushed;
+		}
+		else
+		{
+			pcl_ring_put(t->ring, (void *) i++);
+		}
+	}
+
+	pcl_atomic_add_fetch(&t->done, 1);
+}
+
+static void
+consumer(void *arg)
+{
+	ring_test_t *t = arg;
+	void *item;
+
+	while((item = pcl_ring_take(t->ring)))
+	{
+		pcl_atomic_add_fetch(&t->sum, (intptr_t) item);
+		pcl_atomic_add_fetch(&t->count, 1);
+	}
+
+	pcl_atomic_add_fetch(&t->done, 1);
+}
+
+/**$ Single-producer/single-consumer ring order, capacity and batches */
+TESTCASE(ring_spsc)
+{
+	void *items[16];
+	pcl_ring_t *r = pcl_ring(5, PCL_RING_SPSC);
+
+	for(intptr_t i = 1; i <= 8; i++)
+		ASSERT_TRUE(pcl_ring_push(r, (void *) i), "push failed before ring was full");
+
+	ASSERT_TRUE(!pcl_ring_push(r, (void *) 9), "push succeeded on a full ring");
+	ASSERT_INTEQ((int) pcl_ring_size(r), 8, "wrong ring size");
+	ASSERT_INTEQ((int) (intptr_t) pcl_ring_pop(r), 1, "wrong first item");
+	ASSERT_INTEQ(pcl_ring_popv(r, items, 16), 7, "wrong popv count");
+	ASSERT_INTEQ((int) (intptr_t) items[6], 8, "wrong last item");
+	ASSERT_NULL(pcl_ring_pop(r), "pop on an empty ring returned an item");
+
+	for(intptr_t i = 0; i < 16; i++)
+		items[i] = (void *) (i + 100);
+
+	ASSERT_INTEQ(pcl_ring_pushv(r, items, 16), 8, "pushv did not stop at capacity");
+	ASSERT_INTEQ((int) (intptr_t) pcl_ring_pop(r), 100, "wrong item after wrap");
+	pcl_ring_free(r);
+	return true;
+}
+
+/**$ Blocking multi-producer/multi-consumer ring delivers every item exactly once */
+TESTCASE(ring_mpmc)
+{
+	ring_test_t t = {0};
+	t.ring = pcl_ring(64, PCL_RING_MPMC | PCL_RING_BLOCKING);
+
+	for(int i = 0; i < CONSUMERS; i++)
+		pcl_thread(NULL, consumer, &t);
+
+	for(int i = 0; i < PRODUCERS; i++)
+		pcl_thread(NULL, producer, &t);
+
+	while(pcl_atomic_fetch(&t.done) < PRODUCERS)
+		pcl_sleep(1000000, NULL, 0);
+
+	pcl_ring_close(t.ring);
+	ASSERT_INTEQ(pcl_ring_put(t.ring, (void *) 1), -1, "put succeeded on a closed ring");
+
+	while(pcl_atomic_fetch(&t.done) < PRODUCERS + CONSUMERS)
+		pcl_sleep(1000000, NULL, 0);
+
+	pcl_ring_free(t.ring);
+
+	ASSERT_INTEQ((int) t.count, PRODUCERS * ITEMS, "wrong number of items consumed");
+	ASSERT_TRUE(t.sum == (pcl_atomic_t) PRODUCERS * ITEMS * (ITEMS + 1) / 2, "wrong item sum");
+	return true;
+}
@@ -0,0 +1,143 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "test.h"
+#include <pcl/rope.h>
+#include <pcl/file.h>
+#include <pcl/error.h>
+#include <string.h>
+
+#define TESTFILE _P("_testrope_")
+
+static int released;
+
+static void
+release(void *data)
+{
+	UNUSED(data);
+	released++;
+}
+
+/**$ Append, prepend and consume copied and borrowed segments */
+TESTCASE(rope)
+{
+	char out[64];
+	static const char body[] = "0123456789";
+	pcl_rope_t *r = pcl_rope(4);
+
+	released = 0;
+	ASSERT_INTEQ(pcl_rope_append(r, "abcdef", 6), 0, "append failed");
+	ASSERT_INTEQ(pcl_rope_appendref(r, body, 10, release), 0, "appendref failed");
+	ASSERT_INTEQ(pcl_rope_prepend(r, "<<", 2), 0, "prepend failed");
+	ASSERT_INTEQ(pcl_rope_prependref(r, "[", 1, NULL), 0, "prependref failed");
+	ASSERT_INTEQ(pcl_rope_append(r, "xyz", 3), 0, "append failed");
+	ASSERT_INTEQ((int) pcl_rope_len(r), 22, "wrong rope length");
+
+	pcl_iovec_t iov[16];
+	ASSERT_INTEQ(pcl_rope_iov(r, iov, 16), 6, "wrong number of segments");
+	ASSERT_TRUE(iov[4].iov_base == body, "borrowed segment was copied");
+
+	memset(out, 0, sizeof(out));
+	ASSERT_INTEQ((int) pcl_rope_copy(r, out, sizeof(out)), 22, "wrong copy length");
+	ASSERT_STREQ(out, "[<<abcdef0123456789xyz", "wrong rope contents");
+
+	pcl_rope_consume(r, 12);
+	ASSERT_INTEQ(released, 0, "released a partially consumed segment");
+	pcl_rope_consume(r, 7);
+	ASSERT_INTEQ(released, 1, "borrowed segment not released");
+
+	memset(out, 0, sizeof(out));
+	pcl_rope_copy(r, out, sizeof(out));
+	ASSERT_STREQ(out, "xyz", "wrong contents after consume");
+
+	pcl_rope_appendref(r, body, 10, release);
+	pcl_rope_free(r);
+	ASSERT_INTEQ(released, 2, "free did not release borrowed segment");
+	return true;
+}
+
+/**$ Write a rope to a file with gather writes and read it back with a scatter read */
+TESTCASE(rope_write)
+{
+	char out[12000];
+	char big[5000];
+	pcl_rope_t *r = pcl_rope(0);
+
+	memset(big, 'b', sizeof(big));
+	pcl_rope_append(r, "head", 4);
+	pcl_rope_appendref(r, big, sizeof(big), NULL);
+	pcl_rope_append(r, big, sizeof(big));
+	pcl_rope_prependref(r, "<", 1, NULL);
+
+	pcl_file_t *file = pcl_file_open(TESTFILE, PCL_O_CREAT | PCL_O_TRUNC | PCL_O_RDWR, 0644);
+	ASSERT_NOTNULL(file, "file open failed");
+	ASSERT_INTEQ(pcl_rope_write(r, file), 0, "rope write failed");
+	ASSERT_INTEQ((int) pcl_rope_len(r), 0, "rope not consumed");
+	pcl_file_close(file);
+	pcl_rope_free(r);
+
+	file = pcl_file_open(TESTFILE, PCL_O_RDONLY);
+	ASSERT_NOTNULL(file, "file reopen failed");
+	char head[5];
+	pcl_iovec_t iov[2] = {{head, sizeof(head)}, {out, 5}};
+	ASSERT_INTEQ(pcl_file_readv(file, iov, 2), 10, "scatter read failed");
+	ASSERT_INTEQ(memcmp(head, "<head", 5), 0, "wrong scatter head");
+	int n = 5, r2;
+	while((r2 = pcl_file_read(file, out + n, sizeof(out) - n)) > 0)
+		n += r2;
+	pcl_file_close(file);
+	(void) pcl_unlink(TESTFILE);
+
+	ASSERT_INTEQ(n, 10000, "wrong file size");
+	ASSERT_INTEQ(out[0], 'b', "wrong scatter tail");
+	ASSERT_INTEQ(out[n - 1], 'b', "wrong file tail");
+	return true;
+}
+
+/**$ Writing a rope to a full device fails instead of retrying */
+TESTCASE(rope_write_full)
+{
+#ifdef PCL_LINUX
+	char data[1000];
+	pcl_rope_t *r = pcl_rope(0);
+
+	memset(data, 'x', sizeof(data));
+	pcl_rope_append(r, data, sizeof(data));
+
+	pcl_file_t *file = pcl_file_open(_P("/dev/full"), PCL_O_WRONLY);
+	ASSERT_NOTNULL(file, "cannot open /dev/full");
+	ASSERT_INTEQ(pcl_rope_write(r, file), -1, "write to a full device succeeded");
+	ASSERT_INTEQ((int) pcl_rope_len(r), (int) sizeof(data), "rope consumed");
+	pcl_file_close(file);
+	pcl_rope_free(r);
+#endif
+	return true;
+}
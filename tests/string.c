@@ -0,0 +1,120 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "test.h"
+#include <pcl/string.h>
+#include <pcl/error.h>
+#include <pcl/io.h>
+#include <pcl/alloc.h>
+#include <stddef.h>
+#include <string.h>
+
+/**$ Validate UTF-8 on both sides of the vectorized block size */
+TESTCASE(utf8_check)
+{
+	static const char *valid[] = {"a", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9D\x84\x9E",
+		"\xED\x9F\xBF", "\xF4\x8F\xBF\xBF"};
+
+	/* overlong, continuation without lead, surrogate, too large and truncated */
+	static const char *invalid[] = {"\xC0\xAF", "\x80", "\xED\xA0\x80", "\xF4\x90\x80\x80",
+		"\xE2\x82", "\xF5\x80\x80\x80"};
+
+	char buf[256];
+
+	/* place each sequence at every offset of a 150 byte ASCII string, which covers the scalar
+	 * path, both halves of a 64-byte block, block boundaries and the padded tail
+	 */
+	for(int off = 0; off < 146; off++)
+	{
+		for(int i = 0; i < 6; i++)
+		{
+			memset(buf, 'x', 150);
+			memcpy(buf + off, valid[i], strlen(valid[i]));
+			ASSERT_INTEQ(pcl_utf8_check(buf, 150), 0, "valid sequence rejected");
+
+			memset(buf, 'x', 150);
+			memcpy(buf + off, invalid[i], strlen(invalid[i]));
+			ASSERT_INTEQ(pcl_utf8_check(buf, 150), -1, "invalid sequence accepted");
+			ASSERT_INTEQ(pcl_errno, PCL_EILSEQ, "wrong error code");
+		}
+	}
+
+	/* a sequence truncated by the end of input */
+	memset(buf, 'x', 128);
+	memcpy(buf + 126, "\xE2\x82", 2);
+	ASSERT_INTEQ(pcl_utf8_check(buf, 128), -1, "truncated sequence accepted");
+
+	pcl_err_clear();
+	return true;
+}
+
+/**$ PCL printf extensions, passthrough formats and cached translations */
+TESTCASE(sprintf_ext)
+{
+	char buf[64];
+	char fmt[32];
+
+	ASSERT_INTEQ(pcl_sprintf(buf, sizeof(buf), "100%% %3d", 5), 8, "wrong passthrough length");
+	ASSERT_STREQ(buf, "100%   5", "wrong passthrough output");
+
+	/* alternate form flag and ptrdiff_t length are plain printf */
+	ASSERT_INTEQ(pcl_sprintf(buf, sizeof(buf), "%#x %td", 255, (ptrdiff_t) -7), 7,
+		"wrong flag passthrough length");
+	ASSERT_STREQ(buf, "0xff -7", "wrong flag passthrough output");
+	pcl_sprintf(buf, sizeof(buf), "%Ps %#x %td", "dir", 255, (ptrdiff_t) -7);
+	ASSERT_STREQ(buf, "dir 0xff -7", "wrong flag translated output");
+
+	/* twice: translate then cache hit */
+	for(int i = 0; i < 2; i++)
+	{
+		pcl_sprintf(buf, sizeof(buf), "%Ps%/%Pc %d%%", "dir", 'f', i);
+		ASSERT_STREQ(buf, i ? "dir" PCL_PATHSEP "f 1%" : "dir" PCL_PATHSEP "f 0%", "wrong extension output");
+	}
+
+	/* same pointer, different format must not hit the cache */
+	strcpy(fmt, "a%/%Ps");
+	pcl_sprintf(buf, sizeof(buf), fmt, "b");
+	ASSERT_STREQ(buf, "a" PCL_PATHSEP "b", "wrong first reused format output");
+	strcpy(fmt, "%Ps%/c");
+	pcl_sprintf(buf, sizeof(buf), fmt, "b");
+	ASSERT_STREQ(buf, "b" PCL_PATHSEP "c", "stale cached format");
+
+	/* larger than the stack format buffer */
+	char *big = pcl_malloc(6001);
+	memset(big, 'x', 6000);
+	strcpy(big + 5996, "%Ps");
+	char *out = NULL;
+	ASSERT_INTEQ(pcl_asprintf(&out, big, "yz"), 5998, "wrong large format length");
+	ASSERT_STREQ(out + 5994, "xxyz", "wrong large format output");
+	pcl_free(out);
+	pcl_free(big);
+	return true;
+}
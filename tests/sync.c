@@ -0,0 +1,257 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "test.h"
+#include <pcl/sync.h>
+#include <pcl/thread.h>
+#include <pcl/atomic.h>
+#include <pcl/error.h>
+#include <pcl/time.h>
+
+#define THREADS 4
+#define ROUNDS 20000
+
+typedef struct
+{
+	pcl_lock_t lock;
+	pcl_rwlock_t rwlock;
+	pcl_cond_t cond;
+	pcl_barrier_t barrier;
+	pcl_syncstats_t stats;
+	int64_t a;
+	int64_t b;
+	int ready;
+	pcl_atomic_t torn;
+	pcl_atomic_t done;
+} sync_test_t;
+
+static void
+wait_done(sync_test_t *t, int n)
+{
+	while(pcl_atomic_fetch(&t->done) < n)
+		pcl_sleep(1000000, NULL, 0);
+}
+
+static void
+lock_worker(void *arg)
+{
+	sync_test_t *t = arg;
+
+	for(int i = 0; i < ROUNDS; i++)
+	{
+		pcl_lock_acquire(&t->lock);
+		t->a++;
+		pcl_lock_release(&t->lock);
+	}
+
+	pcl_atomic_add_fetch(&t->done, 1);
+}
+
+static void
+rwlock_reader(void *arg)
+{
+	sync_test_t *t = arg;
+
+	for(int i = 0; i < ROUNDS; i++)
+	{
+		pcl_rwlock_rdlock(&t->rwlock);
+		if(t->a != t->b)
+			pcl_atomic_add_fetch(&t->torn, 1);
+		pcl_rwlock_rdunlock(&t->rwlock);
+	}
+
+	pcl_atomic_add_fetch(&t->done, 1);
+}
+
+static void
+rwlock_writer(void *arg)
+{
+	sync_test_t *t = arg;
+
+	for(int i = 0; i < ROUNDS / 10; i++)
+	{
+		pcl_rwlock_wrlock(&t->rwlock);
+		t->a++;
+		t->b++;
+		pcl_rwlock_wrunlock(&t->rwlock);
+	}
+
+	pcl_atomic_add_fetch(&t->done, 1);
+}
+
+static void
+cond_waiter(void *arg)
+{
+	sync_test_t *t = arg;
+
+	pcl_lock_acquire(&t->lock);
+
+	while(!t->ready)
+		pcl_cond_wait(&t->cond, &t->lock);
+
+	t->a++;
+	pcl_lock_release(&t->lock);
+	pcl_atomic_add_fetch(&t->done, 1);
+}
+
+static void
+barrier_worker(void *arg)
+{
+	sync_test_t *t = arg;
+
+	/* phase i writes are only checked after everyone passed the barrier */
+	for(int i = 0; i < 100; i++)
+	{
+		pcl_atomic_fetch_add64(&t->a, 1, PCL_ATOMIC_RELAXED);
+
+		if(pcl_barrier_wait(&t->barrier) == PCL_BARRIER_SERIAL)
+			pcl_atomic_fetch_add64(&t->b, 1, PCL_ATOMIC_RELAXED);
+
+		if(pcl_atomic_load64(&t->a, PCL_ATOMIC_RELAXED) < (i + 1) * THREADS)
+			pcl_atomic_add_fetch(&t->torn, 1);
+
+		pcl_barrier_wait(&t->barrier);
+	}
+
+	pcl_atomic_add_fetch(&t->done, 1);
+}
+
+/**$ Adaptive lock provides mutual exclusion and counts acquisitions */
+TESTCASE(sync_lock)
+{
+	sync_test_t t = {0};
+
+	ASSERT_INTEQ(pcl_lock_init(&t.lock, &t.stats), 0, "lock init failed");
+	ASSERT_TRUE(pcl_lock_try(&t.lock), "try failed on a free lock");
+	ASSERT_TRUE(!pcl_lock_try(&t.lock), "try succeeded on a held lock");
+	pcl_lock_release(&t.lock);
+
+	for(int i = 0; i < THREADS; i++)
+		pcl_thread(NULL, lock_worker, &t);
+
+	wait_done(&t, THREADS);
+
+	ASSERT_INTEQ(t.a, THREADS * ROUNDS, "lost updates");
+	ASSERT_INTEQ(t.stats.acquisitions, THREADS * ROUNDS + 1, "wrong acquisition count");
+	ASSERT_TRUE(t.stats.contended <= t.stats.acquisitions, "more contended than acquired");
+	return true;
+}
+
+/**$ Readers never observe a half finished write */
+TESTCASE(sync_rwlock)
+{
+	int policies[] = {PCL_RWLOCK_PREFER_WRITER, PCL_RWLOCK_PREFER_READER};
+
+	for(int p = 0; p < 2; p++)
+	{
+		sync_test_t t = {0};
+
+		ASSERT_INTEQ(pcl_rwlock_init(&t.rwlock, policies[p], &t.stats), 0, "rwlock init failed");
+		ASSERT_TRUE(pcl_rwlock_tryrdlock(&t.rwlock), "tryrdlock failed");
+		ASSERT_TRUE(pcl_rwlock_tryrdlock(&t.rwlock), "second tryrdlock failed");
+		ASSERT_TRUE(!pcl_rwlock_trywrlock(&t.rwlock), "trywrlock succeeded with readers");
+		pcl_rwlock_rdunlock(&t.rwlock);
+		pcl_rwlock_rdunlock(&t.rwlock);
+		ASSERT_TRUE(pcl_rwlock_trywrlock(&t.rwlock), "trywrlock failed");
+		ASSERT_TRUE(!pcl_rwlock_tryrdlock(&t.rwlock), "tryrdlock succeeded with a writer");
+		pcl_rwlock_wrunlock(&t.rwlock);
+
+		for(int i = 0; i < THREADS; i++)
+			pcl_thread(NULL, rwlock_reader, &t);
+
+		for(int i = 0; i < 2; i++)
+			pcl_thread(NULL, rwlock_writer, &t);
+
+		wait_done(&t, THREADS + 2);
+
+		ASSERT_INTEQ(t.torn, 0, "reader saw a partial write");
+		ASSERT_INTEQ(t.a, 2 * (ROUNDS / 10), "lost writes");
+		ASSERT_INTEQ(t.rwlock.state, 0, "rwlock not fully released");
+		ASSERT_INTEQ(t.stats.acquisitions, THREADS * ROUNDS + 2 * (ROUNDS / 10) + 3,
+			"wrong acquisition count");
+	}
+
+	ASSERT_INTEQ(pcl_rwlock_init(&(pcl_rwlock_t){0}, 7, NULL), -1, "bad policy accepted");
+	return true;
+}
+
+/**$ Condition variable timeouts and broadcast wakeups */
+TESTCASE(sync_cond)
+{
+	sync_test_t t = {0};
+
+	pcl_lock_init(&t.lock, NULL);
+	pcl_cond_init(&t.cond, &t.stats);
+
+	pcl_lock_acquire(&t.lock);
+	pcl_clock_t start = pcl_clock();
+	ASSERT_INTEQ(pcl_cond_timedwait(&t.cond, &t.lock, 20 * PCL_CLOCK_MSEC), -1, "wait did not time out");
+	ASSERT_INTEQ(pcl_errno, PCL_ETIMEOUT, "wrong error");
+	ASSERT_TRUE(pcl_clock() - start >= 20 * PCL_CLOCK_MSEC, "timed out early");
+	ASSERT_TRUE(!pcl_lock_try(&t.lock), "lock not reacquired after timeout");
+	pcl_lock_release(&t.lock);
+
+	for(int i = 0; i < THREADS; i++)
+		pcl_thread(NULL, cond_waiter, &t);
+
+	/* let the waiters park, though correctness does not depend on it */
+	pcl_sleep(10000000, NULL, 0);
+
+	pcl_lock_acquire(&t.lock);
+	t.ready = 1;
+	pcl_cond_broadcast(&t.cond);
+	pcl_lock_release(&t.lock);
+
+	wait_done(&t, THREADS);
+	ASSERT_INTEQ(t.a, THREADS, "not every waiter woke up");
+	ASSERT_INTEQ(t.cond.waiters, 0, "waiters left behind");
+	ASSERT_TRUE(t.stats.acquisitions >= THREADS + 1, "waits not counted");
+	return true;
+}
+
+/**$ Barrier releases all threads together, once per cycle */
+TESTCASE(sync_barrier)
+{
+	sync_test_t t = {0};
+
+	ASSERT_INTEQ(pcl_barrier_init(&t.barrier, 0, NULL), -1, "zero count accepted");
+	ASSERT_INTEQ(pcl_barrier_init(&t.barrier, THREADS, &t.stats), 0, "barrier init failed");
+
+	for(int i = 0; i < THREADS; i++)
+		pcl_thread(NULL, barrier_worker, &t);
+
+	wait_done(&t, THREADS);
+
+	ASSERT_INTEQ(t.torn, 0, "thread passed the barrier early");
+	ASSERT_INTEQ(t.b, 100, "wrong number of serial threads");
+	ASSERT_INTEQ(t.stats.acquisitions, THREADS * 200, "wrong arrival count");
+	return true;
+}
@@ -45,6 +45,8 @@
 
 #include "test.h"
 #include <pcl/init.h>
+#include <pcl/memprof.h>
+#include <pcl/memtag.h>
 #include <stdio.h>
 #include <ctype.h>
 #include <stdbool.h>
@@ -64,6 +66,8 @@
 static int num_suites = 0;
 static int num_tests = 0;
 static int num_failed = 0;
+static int num_skipped = 0;
+static bool case_skipped;
 static char **suites_to_run;
 
 typedef bool (*casefunc_t)(void);
@@ -136,13 +140,17 @@ static void run_case(const char *name, const char *summary)
 		return;
 	}
 
+	case_skipped = false;
+
 	bool success = casefunc();
 
 	if(!success)
 		num_failed++;
+	else if(case_skipped)
+		num_skipped++;
 
-	const char *status = success ? "Success" : "Failed";
-	int color = success ? 32 : 31; // green or red
+	const char *status = !success ? "Failed" : case_skipped ? "Skipped" : "Success";
+	int color = !success ? 31 : case_skipped ? 33 : 32; // red, yellow or green
 
 	printf("  Status: \x1B[%dm%s\x1B[0m\n\n", color, status);
 }
@@ -319,6 +327,14 @@ int main(int argc, char **argv)
 	(void) argc;
 	suites_to_run = argv + 1;
 
+	/* exercises the profiler hooks in every suite, set PCL_TEST_MEMPROF for a second run */
+	if(getenv("PCL_TEST_MEMPROF"))
+		pcl_memprof_enable(256 * 1024, 0);
+
+	/* likewise the accounting hooks with PCL_TEST_MEMTAG */
+	if(getenv("PCL_TEST_MEMTAG"))
+		pcl_memtag_enable();
+
 	pcl_init();
 
 #ifdef PCL_WINDOWS
@@ -340,7 +356,8 @@ int main(int argc, char **argv)
 
 	find_suites();
 
-	printf("Report\n  Suites: %d\n  Tests: %d\n  Failed: %d\n", num_suites, num_tests, num_failed);
+	printf("Report\n  Suites: %d\n  Tests: %d\n  Skipped: %d\n  Failed: %d\n", num_suites, num_tests,
+		num_skipped, num_failed);
 
 	return 0;
 }
@@ -349,6 +366,18 @@ int main(int argc, char **argv)
  * Public API used by test case files, normally via macros in test.h
  */
 
+void
+test_skip(PCL_LOCATION_PARAMS, const char *message)
+{
+	case_skipped = true;
+	file = BASENAME(file);
+	printf(PRINTLOC "skipped", PCL_LOCATION_VALS);
+
+	if(message)
+		printf(": %s", message);
+	printf("\n");
+}
+
 bool
 assert_int_equal(PCL_LOCATION_PARAMS, long long actual, long long expected, const char *message)
 {
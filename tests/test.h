@@ -37,6 +37,12 @@
 
 #define TESTCASE(name) PCL_PUBLIC bool testcase_ ## name(void)
 
+/* ends a test case that cannot run in this configuration, reported as skipped */
+#define TESTSKIP(message) do{ \
+  test_skip(PCL_LOCATION_ARGS, message); \
+  return true; \
+}while(0)
+
 #define ASSERT_INTEQ(actual, expected, message) do{ \
   if(!assert_int_equal(PCL_LOCATION_ARGS, actual, expected, message)) \
     return false; \
@@ -107,6 +113,8 @@ bool assert_null(PCL_LOCATION_PARAMS, const void *ptr, const char *message);
 
 bool assert_notnull(PCL_LOCATION_PARAMS, const void *ptr, const char *message);
 
+void test_skip(PCL_LOCATION_PARAMS, const char *message);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,152 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "test.h"
+#include <pcl/thread.h>
+#include <pcl/sysinfo.h>
+#include <pcl/error.h>
+#include <string.h>
+
+#ifdef PCL_LINUX
+#	include <sched.h>
+#endif
+
+typedef struct
+{
+	char name[32];
+	int cpu;
+	bool ran;
+} thread_test_t;
+
+static void
+inspect(void *arg)
+{
+	thread_test_t *t = arg;
+
+	t->ran = true;
+#ifdef PCL_LINUX
+	pthread_getname_np(pthread_self(), t->name, sizeof(t->name));
+	t->cpu = sched_getcpu();
+#endif
+}
+
+/* first CPU this process may run on, CPU 0 can be outside a restricted cpuset */
+static int
+first_cpu(void)
+{
+	pcl_cpu_t cpu;
+
+#ifdef PCL_LINUX
+	cpu_set_t set;
+
+	if(sched_getaffinity(0, sizeof(set), &set) == 0)
+		for(int i = 0; i < CPU_SETSIZE; i++)
+			if(CPU_ISSET(i, &set))
+				return i;
+#endif
+
+	return pcl_sysinfo_cpus(&cpu, 1) > 0 ? cpu.cpu : 0;
+}
+
+/**$ Extended thread creation applies name, affinity, node and priority */
+TESTCASE(thread_attr)
+{
+	pthread_t t;
+	pcl_cpuset_t cpus;
+	thread_test_t info = {0};
+	pcl_thread_attr_t attr;
+	int cpu = first_cpu();
+
+	pcl_cpuset_zero(&cpus);
+	pcl_cpuset_add(&cpus, cpu);
+
+	pcl_thread_attr_init(&attr);
+	attr.name = "pcl-test-worker-long-name";
+	attr.affinity = &cpus;
+	attr.numa_node = 0;
+	attr.policy = PCL_THREAD_SCHED_OTHER;
+	attr.priority = 5;
+	attr.stack_size = 256 * 1024;
+	attr.joinable = true;
+
+	ASSERT_INTEQ(pcl_thread_ex(&t, &attr, inspect, &info), 0, "pcl_thread_ex failed");
+	pthread_join(t, NULL);
+
+	ASSERT_TRUE(info.ran, "routine did not run");
+#ifdef PCL_LINUX
+	ASSERT_STREQ(info.name, "pcl-test-worker", "name not set or not truncated");
+	ASSERT_INTEQ(info.cpu, cpu, "affinity not applied");
+#endif
+
+	/* setup failures are reported to the creator and the routine never runs */
+	memset(&info, 0, sizeof(info));
+	pcl_thread_attr_init(&attr);
+	attr.policy = PCL_THREAD_SCHED_FIFO;
+	attr.priority = 500;
+	attr.joinable = true;
+
+	ASSERT_INTEQ(pcl_thread_ex(&t, &attr, inspect, &info), -1, "bad priority accepted");
+	ASSERT_INTEQ(pcl_errno, PCL_EINVAL, "wrong error");
+	ASSERT_TRUE(!info.ran, "routine ran after a setup failure");
+	return true;
+}
+
+/**$ CPU topology is consistent with the logical CPU count */
+TESTCASE(sysinfo_topology)
+{
+	pcl_sysinfo_t info;
+	pcl_cpu_t cpus[PCL_CPUSET_SIZE];
+	pcl_cpuset_t node0;
+
+	pcl_sysinfo(&info);
+
+	int count = pcl_sysinfo_cpus(cpus, countof(cpus));
+
+	ASSERT_INTEQ(count, info.cpu_cores, "cpu count does not match cpu_cores");
+	ASSERT_TRUE(info.cpu_physical > 0 && info.cpu_physical <= info.cpu_cores, "bad physical count");
+	/* hybrid CPUs mix cores with and without SMT */
+	ASSERT_TRUE(info.cpu_physical <= info.cpu_cores &&
+		info.cpu_cores <= info.cpu_physical * info.cpu_smt, "bad SMT count");
+	ASSERT_TRUE(info.numa_nodes >= 1, "no NUMA nodes");
+	ASSERT_INTEQ(pcl_sysinfo_cpus(NULL, 0), count, "count only call differs");
+
+	for(int i = 0; i < count; i++)
+	{
+		ASSERT_TRUE(cpus[i].thread < info.cpu_smt, "SMT index out of range");
+		ASSERT_TRUE(cpus[i].node < info.numa_nodes, "node out of range");
+	}
+
+	ASSERT_INTEQ(pcl_sysinfo_nodecpus(0, &node0), 0, "node 0 lookup failed");
+	ASSERT_TRUE(pcl_cpuset_has(&node0, cpus[0].cpu), "first cpu not on node 0");
+	ASSERT_INTEQ(pcl_sysinfo_nodecpus(PCL_CPUSET_SIZE - 1, &node0), -1, "missing node found");
+	ASSERT_INTEQ(pcl_errno, PCL_ENOTFOUND, "wrong error");
+	return true;
+}
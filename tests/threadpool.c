@@ -0,0 +1,199 @@
+/*
+  Portable C Library (PCL)
+  Copyright (c) 1999-2021 Andrew Chernow
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+  * Neither the name of the copyright holder nor the names of its
+    contributors may be used to endorse or promote products derived from
+    this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "test.h"
+#include <pcl/threadpool.h>
+#include <pcl/atomic.h>
+#include <pcl/event.h>
+#include <pcl/error.h>
+
+#define WORKERS 4
+
+static pcl_threadpool_t *pool;
+static pcl_atomic_t threadinits;
+
+static void
+count_threadinit(uint32_t event, void *data)
+{
+	(void) data;
+
+	if(event == PCL_EVENT_THREADINIT)
+		pcl_atomic_add_fetch(&threadinits, 1);
+}
+
+static void
+increment(void *arg)
+{
+	pcl_atomic_add_fetch((pcl_atomic_t *) arg, 1);
+}
+
+static void *
+square(void *arg)
+{
+	intptr_t n = (intptr_t) arg;
+	return (void *) (n * n);
+}
+
+/* a task per call, workers wait on futures of tasks they submitted */
+static void *
+fib(void *arg)
+{
+	intptr_t n = (intptr_t) arg;
+
+	if(n < 2)
+		return (void *) n;
+
+	pcl_future_t *a = pcl_threadpool_async(pool, fib, (void *) (n - 1));
+	pcl_future_t *b = pcl_threadpool_async(pool, fib, (void *) (n - 2));
+	intptr_t r = (intptr_t) pcl_future_wait(a) + (intptr_t) pcl_future_wait(b);
+
+	pcl_future_free(a);
+	pcl_future_free(b);
+	return (void *) r;
+}
+
+static void
+sum_range(size_t begin, size_t end, void *arg)
+{
+	pcl_atomic_t sum = 0;
+
+	for(size_t i = begin; i < end; i++)
+		sum += (pcl_atomic_t) i;
+
+	pcl_atomic_add_fetch((pcl_atomic_t *) arg, sum);
+}
+
+/* parallel for from within a task */
+static void *
+nested_for(void *arg)
+{
+	pcl_atomic_t sum = 0;
+
+	(void) arg;
+	pcl_threadpool_for(pool, 0, 1000, 10, sum_range, &sum);
+	return (void *) (intptr_t) sum;
+}
+
+/* a task cannot join its own worker */
+static void *
+free_pool(void *arg)
+{
+	(void) arg;
+
+	if(pcl_threadpool_free(pool) == 0)
+		return (void *) 0;
+
+	return (void *) (intptr_t) pcl_errno;
+}
+
+/**$ Submit many short tasks, wait for them and shut down */
+TESTCASE(threadpool_submit)
+{
+	pcl_atomic_t count = 0;
+
+	threadinits = 0;
+	pcl_event_register(count_threadinit);
+	pool = pcl_threadpool(WORKERS);
+	ASSERT_NOTNULL(pool, "failed to create pool");
+	ASSERT_INTEQ(pcl_threadpool_size(pool), WORKERS, "wrong number of workers");
+
+	for(int i = 0; i < 20000; i++)
+		ASSERT_INTEQ(pcl_threadpool_submit(pool, increment, &count), 0, "submit failed");
+
+	ASSERT_INTEQ(pcl_threadpool_wait(pool), 0, "wait failed");
+	ASSERT_INTEQ(pcl_atomic_fetch(&count), 20000, "not all tasks ran");
+
+	/* shutdown runs what is still queued */
+	for(int i = 0; i < 1000; i++)
+		pcl_threadpool_submit(pool, increment, &count);
+
+	pcl_threadpool_free(pool);
+	pcl_event_unregister(count_threadinit);
+
+	ASSERT_INTEQ(pcl_atomic_fetch(&count), 21000, "shutdown dropped tasks");
+	ASSERT_INTEQ(pcl_atomic_fetch(&threadinits), WORKERS, "workers did not dispatch THREADINIT");
+	return true;
+}
+
+/**$ Futures from outside and inside the pool, including nested waits */
+TESTCASE(threadpool_future)
+{
+	pcl_future_t *futures[100];
+
+	pool = pcl_threadpool(WORKERS);
+
+	for(intptr_t i = 0; i < 100; i++)
+		futures[i] = pcl_threadpool_async(pool, square, (void *) i);
+
+	for(intptr_t i = 0; i < 100; i++)
+	{
+		ASSERT_INTEQ((intptr_t) pcl_future_wait(futures[i]), i * i, "wrong future result");
+		ASSERT_TRUE(pcl_future_done(futures[i]), "future not done after wait");
+		pcl_future_free(futures[i]);
+	}
+
+	pcl_future_t *f = pcl_threadpool_async(pool, fib, (void *) 18);
+	ASSERT_INTEQ((intptr_t) pcl_future_wait(f), 2584, "wrong nested result");
+	pcl_future_free(f);
+
+	f = pcl_threadpool_async(pool, free_pool, NULL);
+	ASSERT_INTEQ((intptr_t) pcl_future_wait(f), PCL_EDEADLK, "freed the pool from a task");
+	pcl_future_free(f);
+
+	/* free drains the task, the future outlives the pool */
+	f = pcl_threadpool_async(pool, square, (void *) 7);
+	ASSERT_INTEQ(pcl_threadpool_free(pool), 0, "free failed");
+	ASSERT_TRUE(pcl_future_done(f), "free did not run the task");
+	ASSERT_INTEQ((intptr_t) pcl_future_wait(f), 49, "wrong result after free");
+	pcl_future_free(f);
+	return true;
+}
+
+/**$ Parallel for over a range, from outside and inside the pool */
+TESTCASE(threadpool_for)
+{
+	pcl_atomic_t sum = 0;
+	pool = pcl_threadpool(WORKERS);
+
+	ASSERT_INTEQ(pcl_threadpool_for(pool, 0, 1000000, 0, sum_range, &sum), 0, "for failed");
+	ASSERT_INTEQ(sum, 499999500000LL, "wrong parallel sum");
+
+	sum = 0;
+	pcl_threadpool_for(pool, 5, 6, 0, sum_range, &sum);
+	ASSERT_INTEQ(sum, 5, "wrong single index sum");
+
+	pcl_future_t *f = pcl_threadpool_async(pool, nested_for, NULL);
+	ASSERT_INTEQ((intptr_t) pcl_future_wait(f), 499500, "wrong nested parallel sum");
+	pcl_future_free(f);
+
+	pcl_threadpool_free(pool);
+	return true;
+}
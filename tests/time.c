@@ -31,6 +31,7 @@
 
 #include "test.h"
 #include <pcl/time.h>
+#include <pcl/timer.h>
 #include <pcl/stat.h>
 #include <string.h>
 
@@ -129,3 +130,68 @@ TESTCASE(utimes)
 
 	return true;
 }
+
+#define MSECS(n) ((pcl_clock_t) (n) * PCL_CLOCK_MSEC)
+#define SECS(n) ((pcl_clock_t) (n) * PCL_CLOCK_SEC)
+
+static int timer_order[8];
+static int timer_count;
+
+static void
+on_timer(pcl_timer_t *timer, void *udata)
+{
+	(void) timer;
+	timer_order[timer_count++] = (int) (intptr_t) udata;
+}
+
+static void
+on_rearm(pcl_timer_t *timer, void *udata)
+{
+	int *n = udata;
+
+	if(++*n < 3)
+		pcl_timer_reset(timer, 0);
+}
+
+/**$ Timer wheel expiry order, cancellation, cascading of long timeouts and rearming */
+TESTCASE(timerwheel)
+{
+	int rearmed = 0;
+	pcl_timerwheel_t *tw = pcl_timerwheel(0);
+	pcl_clock_t base = pcl_clock();
+
+	pcl_timer_add(tw, MSECS(30), on_timer, (void *) 3);
+	pcl_timer_add(tw, MSECS(10), on_timer, (void *) 1);
+	pcl_timer_t *cancelled = pcl_timer_add(tw, MSECS(20), on_timer, (void *) 2);
+	pcl_timer_add(tw, SECS(7200), on_timer, (void *) 5);
+	pcl_timer_add(tw, SECS(5), on_timer, (void *) 4);
+
+	ASSERT_INTEQ(pcl_timerwheel_size(tw), 5, "wrong timer count");
+	ASSERT_TRUE(pcl_timerwheel_next(tw) <= MSECS(11), "next expiry too late");
+	ASSERT_INTEQ(pcl_timer_cancel(cancelled), 0, "cancel failed");
+	ASSERT_INTEQ(pcl_timerwheel_size(tw), 4, "cancel did not remove timer");
+
+	ASSERT_INTEQ(pcl_timerwheel_run(tw, base + MSECS(5)), 0, "timer fired early");
+	ASSERT_INTEQ(pcl_timerwheel_run(tw, base + MSECS(35)), 2, "wrong short timers");
+	ASSERT_INTEQ(pcl_timerwheel_run(tw, base + SECS(4)), 0, "timer fired early");
+	ASSERT_INTEQ(pcl_timerwheel_run(tw, base + SECS(6)), 1, "wrong level 1 timer");
+	ASSERT_INTEQ(pcl_timerwheel_run(tw, base + SECS(7199)), 0, "timer fired early");
+	ASSERT_INTEQ(pcl_timerwheel_run(tw, base + SECS(7201)), 1, "wrong level 3 timer");
+
+	ASSERT_INTEQ(timer_count, 4, "wrong number of handlers called");
+	ASSERT_INTEQ(timer_order[0], 1, "timers fired out of order");
+	ASSERT_INTEQ(timer_order[1], 3, "timers fired out of order");
+	ASSERT_INTEQ(timer_order[2], 4, "timers fired out of order");
+	ASSERT_INTEQ(timer_order[3], 5, "timers fired out of order");
+
+	ASSERT_INTEQ(pcl_timerwheel_size(tw), 0, "timers still pending");
+	ASSERT_TRUE(pcl_timerwheel_next(tw) < 0, "next expiry without timers");
+
+	/* a handler rearming its own timer */
+	pcl_timer_add(tw, 0, on_rearm, &rearmed);
+	pcl_timerwheel_run(tw, base + SECS(7202));
+	ASSERT_INTEQ(rearmed, 3, "timer not rearmed");
+
+	pcl_timerwheel_free(tw);
+	return true;
+}